@@ -0,0 +1,161 @@
+/******************************************************************************\
+ * This benchmark measures the overhead of per-actor runtime statistics. It    *
+ * runs a fan-in and a request/response workload once with and once without    *
+ * setting `scheduler.enable-actor-metrics`.                                   *
+ *                                                                             *
+ * Output format: CSV with columns workload, metrics, msgs, ms, msgs/s         *
+ * followed by the overhead of metrics per workload, based on the best run.    *
+\******************************************************************************/
+
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+behavior producer(event_based_actor* self, actor aggregator, size_t msgs) {
+  for (size_t i = 0; i < msgs; ++i)
+    self->send(aggregator, static_cast<int64_t>(i));
+  self->quit();
+  return {};
+}
+
+behavior aggregator(event_based_actor* self, size_t total, actor listener) {
+  auto received = std::make_shared<size_t>(0);
+  return {
+    [=](int64_t) {
+      if (++*received == total) {
+        self->send(listener, static_cast<int64_t>(total));
+        self->quit();
+      }
+    }
+  };
+}
+
+behavior ping(event_based_actor* self, actor pong, size_t rounds,
+              actor listener) {
+  auto remaining = std::make_shared<size_t>(rounds);
+  // sends one request at a time to measure the round-trip
+  auto step = std::make_shared<std::function<void ()>>();
+  *step = [=] {
+    self->request(pong, infinite, int64_t{1}).then([=](int64_t) {
+      if (--*remaining == 0) {
+        self->send(listener, static_cast<int64_t>(rounds));
+        self->quit();
+        // break the cycle between `step` and its closure
+        *step = nullptr;
+        return;
+      }
+      (*step)();
+    });
+  };
+  return {
+    [=](ok_atom) {
+      (*step)();
+    }
+  };
+}
+
+behavior pong() {
+  return {
+    [](int64_t x) {
+      return x;
+    }
+  };
+}
+
+template <class F>
+int64_t measure(F f) {
+  auto t0 = hrc::now();
+  f();
+  auto t1 = hrc::now();
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  return duration_cast<microseconds>(t1 - t0).count();
+}
+
+struct timings {
+  // best time of all runs in microseconds
+  int64_t fan_in_us;
+  int64_t request_response_us;
+};
+
+void print(const char* workload, bool metrics, size_t total, int64_t us) {
+  auto per_sec = us > 0 ? (total * 1000000) / static_cast<size_t>(us) : 0;
+  cout << workload << ", " << (metrics ? "on" : "off") << ", " << total
+       << ", " << (us / 1000) << ", " << per_sec << endl;
+}
+
+void print_overhead(const char* workload, int64_t off_us, int64_t on_us) {
+  auto overhead = off_us > 0 ? 100. * static_cast<double>(on_us - off_us)
+                               / static_cast<double>(off_us)
+                             : 0.;
+  cout << workload << ", overhead, " << overhead << "%" << endl;
+}
+
+void run(bool metrics, size_t producers, size_t msgs, timings& best) {
+  actor_system_config cfg;
+  cfg.scheduler_enable_actor_metrics = metrics;
+  actor_system sys{cfg};
+  scoped_actor self{sys};
+  auto total = producers * msgs;
+  auto us = measure([&] {
+    auto aggr = sys.spawn(aggregator, total, actor{self});
+    for (size_t i = 0; i < producers; ++i)
+      sys.spawn(producer, aggr, msgs);
+    self->receive([](int64_t) {
+      // nop
+    });
+  });
+  print("fan-in", metrics, total, us);
+  best.fan_in_us = std::min(best.fan_in_us, us);
+  us = measure([&] {
+    auto p = sys.spawn(ping, sys.spawn(pong), msgs, actor{self});
+    self->send(p, ok_atom::value);
+    self->receive([](int64_t) {
+      // nop
+    });
+  });
+  print("request-response", metrics, msgs, us);
+  best.request_response_us = std::min(best.request_response_us, us);
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t msgs = 100000;
+  size_t producers = 16;
+  size_t runs = 3;
+  if (argc > 1)
+    msgs = static_cast<size_t>(std::atoi(argv[1]));
+  if (argc > 2)
+    producers = static_cast<size_t>(std::atoi(argv[2]));
+  if (argc > 3)
+    runs = static_cast<size_t>(std::atoi(argv[3]));
+  cout << "workload, metrics, msgs, ms, msgs/s" << endl;
+  auto inf = std::numeric_limits<int64_t>::max();
+  timings off{inf, inf};
+  timings on{inf, inf};
+  for (size_t i = 0; i < runs; ++i) {
+    run(false, producers, msgs, off);
+    run(true, producers, msgs, on);
+  }
+  // compares the best run of each configuration
+  print_overhead("fan-in", off.fan_in_us, on.fan_in_us);
+  print_overhead("request-response", off.request_response_us,
+                 on.request_response_us);
+}
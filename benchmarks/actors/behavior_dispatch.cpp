@@ -0,0 +1,108 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/int_list.hpp"
+#include "caf/detail/behavior_impl.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+using arg_types = std::tuple<int8_t, int16_t, int32_t, int64_t,
+                             uint8_t, uint16_t, uint32_t, uint64_t>;
+
+template <long I>
+using arg_t = typename std::tuple_element<I % 8, arg_types>::type;
+
+// handler `I` accepts a distinct pair of integer types
+template <long I>
+struct handler {
+  size_t* hits;
+  void operator()(arg_t<I>, arg_t<I / 8>) {
+    ++*hits;
+  }
+};
+
+template <long I>
+message make_input() {
+  return make_message(arg_t<I>{}, arg_t<I / 8>{});
+}
+
+template <long... Is>
+behavior make_handlers(size_t* hits, detail::int_list<Is...>) {
+  return {handler<Is>{hits}...};
+}
+
+size_t run(behavior& bhvr, message& msg, size_t rounds) {
+  auto t0 = hrc::now();
+  for (size_t i = 0; i < rounds; ++i)
+    bhvr(msg);
+  auto t1 = hrc::now();
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  return static_cast<size_t>(duration_cast<nanoseconds>(t1 - t0).count());
+}
+
+template <long N>
+void run(size_t rounds) {
+  size_t hits = 0;
+  typename detail::il_range<0, N>::type indices;
+  auto bhvr = make_handlers(&hits, indices);
+  auto first = make_input<0>();
+  auto last = make_input<N - 1>();
+  auto miss = make_message(1.0);
+  auto t_first = run(bhvr, first, rounds);
+  auto t_last = run(bhvr, last, rounds);
+  auto t_miss = run(bhvr, miss, rounds);
+  if (hits != 2 * rounds)
+    cout << "*** dispatch failed, hits: " << hits << endl;
+  cout << N << ", "
+       << (N > static_cast<long>(detail::behavior_impl::linear_dispatch_limit)
+           ? "indexed" : "linear")
+       << ", " << t_first / rounds << ", " << t_last / rounds << ", "
+       << t_miss / rounds << endl;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t rounds = 1000000;
+  if (argc > 1)
+    rounds = static_cast<size_t>(std::atoi(argv[1]));
+  cout << "handlers, dispatch, first-ns, last-ns, miss-ns" << endl;
+  run<2>(rounds);
+  run<4>(rounds);
+  run<8>(rounds);
+  run<9>(rounds);
+  run<16>(rounds);
+  run<32>(rounds);
+  run<48>(rounds);
+  run<64>(rounds);
+}
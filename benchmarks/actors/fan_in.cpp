@@ -0,0 +1,94 @@
+/******************************************************************************\
+ * This benchmark measures the throughput of an aggregator actor receiving    *
+ * messages from many producers. It compares handling each message with the   *
+ * behavior against handling runs of messages with a batch handler.           *
+ *                                                                            *
+ * Output format: CSV with columns mode, producers, msgs, ms, msgs/s          *
+\******************************************************************************/
+
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+behavior producer(event_based_actor* self, actor aggregator, size_t msgs) {
+  for (size_t i = 0; i < msgs; ++i)
+    self->send(aggregator, static_cast<int64_t>(i));
+  self->quit();
+  return {};
+}
+
+behavior aggregator(event_based_actor* self, bool batched, size_t total,
+                    actor listener) {
+  auto received = std::make_shared<size_t>(0);
+  auto sum = std::make_shared<int64_t>(0);
+  auto check_done = [=] {
+    if (*received == total) {
+      self->send(listener, *sum);
+      self->quit();
+    }
+  };
+  if (batched)
+    self->set_batch_handler<int64_t>([=](std::vector<int64_t>& xs) {
+      for (auto x : xs)
+        *sum += x;
+      *received += xs.size();
+      check_done();
+    });
+  return {
+    [=](int64_t x) {
+      *sum += x;
+      ++*received;
+      check_done();
+    }
+  };
+}
+
+void run(actor_system& sys, bool batched, size_t producers, size_t msgs) {
+  scoped_actor self{sys};
+  auto total = producers * msgs;
+  auto t0 = hrc::now();
+  auto aggr = sys.spawn(aggregator, batched, total, actor{self});
+  for (size_t i = 0; i < producers; ++i)
+    sys.spawn(producer, aggr, msgs);
+  self->receive([](int64_t) {
+    // nop
+  });
+  auto t1 = hrc::now();
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto us = duration_cast<microseconds>(t1 - t0).count();
+  auto per_sec = us > 0 ? (total * 1000000) / static_cast<size_t>(us) : 0;
+  cout << (batched ? "batch" : "behavior") << ", " << producers << ", "
+       << total << ", " << (us / 1000) << ", " << per_sec << endl;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t msgs = 100000;
+  size_t max_producers = 64;
+  if (argc > 1)
+    msgs = static_cast<size_t>(std::atoi(argv[1]));
+  if (argc > 2)
+    max_producers = static_cast<size_t>(std::atoi(argv[2]));
+  actor_system_config cfg;
+  actor_system sys{cfg};
+  cout << "mode, producers, msgs, ms, msgs/s" << endl;
+  for (size_t producers = 1; producers <= max_producers; producers *= 4) {
+    run(sys, false, producers, msgs);
+    run(sys, true, producers, msgs);
+  }
+}
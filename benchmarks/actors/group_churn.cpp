@@ -0,0 +1,119 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+// drops all messages to measure the cost of the fan-out itself
+class sink : public monitorable_actor {
+public:
+  sink(actor_config& cfg) : monitorable_actor(cfg) {
+    // nop
+  }
+
+  void enqueue(mailbox_element_ptr, execution_unit*) override {
+    // nop
+  }
+};
+
+strong_actor_ptr make_sink(actor_system& sys) {
+  actor_config cfg;
+  return make_actor<sink, strong_actor_ptr>(sys.next_actor_id(), sys.node(),
+                                            &sys, cfg);
+}
+
+void run(actor_system& sys, size_t subscribers, size_t churners,
+         size_t publishers, size_t msgs) {
+  auto grp = sys.groups().anonymous();
+  std::vector<strong_actor_ptr> sinks;
+  for (size_t i = 0; i < subscribers; ++i) {
+    sinks.emplace_back(make_sink(sys));
+    grp.subscribe(sinks.back());
+  }
+  std::atomic<bool> done{false};
+  std::atomic<size_t> churn_ops{0};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < churners; ++i)
+    threads.emplace_back([&] {
+      auto x = make_sink(sys);
+      size_t ops = 0;
+      while (!done) {
+        grp.subscribe(x);
+        grp.unsubscribe(x.get());
+        ops += 2;
+      }
+      churn_ops += ops;
+    });
+  auto t0 = hrc::now();
+  std::vector<std::thread> pubs;
+  for (size_t i = 0; i < publishers; ++i)
+    pubs.emplace_back([&] {
+      auto msg = make_message(int32_t{42});
+      for (size_t j = 0; j < msgs; ++j)
+        grp.get()->enqueue(nullptr, invalid_message_id, msg, nullptr);
+    });
+  for (auto& t : pubs)
+    t.join();
+  auto t1 = hrc::now();
+  done = true;
+  for (auto& t : threads)
+    t.join();
+  for (auto& x : sinks)
+    grp.unsubscribe(x.get());
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto us = duration_cast<microseconds>(t1 - t0).count();
+  if (us <= 0)
+    us = 1;
+  auto total = publishers * msgs;
+  cout << subscribers << ", " << churners << ", " << publishers << ", "
+       << (total * 1000000) / static_cast<size_t>(us) << ", "
+       << (churn_ops * 1000000) / static_cast<size_t>(us) << endl;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t msgs = 2000;
+  if (argc > 1)
+    msgs = static_cast<size_t>(std::atoi(argv[1]));
+  actor_system_config cfg;
+  actor_system sys{cfg};
+  cout << "subscribers, churners, publishers, publishes/s, churn-ops/s"
+       << endl;
+  for (size_t subscribers : {10, 100, 1000})
+    for (size_t churners : {0, 1, 4})
+      for (size_t publishers : {1, 4})
+        run(sys, subscribers, churners, publishers, msgs);
+}
@@ -0,0 +1,150 @@
+/******************************************************************************\
+ * This benchmark measures how many payload bytes a pipeline of relay actors  *
+ * copies while passing a large buffer from one end to the other. Relays     *
+ * either receive the buffer via const reference and send a copy, receive a  *
+ * mutable reference and move it, or receive an rvalue reference and move it. *
+ *                                                                            *
+ * Output format: CSV with columns mode, hops, bytes, copied, copied/hop, ms  *
+\******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+// counts the number of bytes copied via copy constructor or assignment
+std::atomic<size_t> bytes_copied;
+
+class buffer {
+public:
+  buffer() = default;
+
+  explicit buffer(size_t n) : xs_(n) {
+    // nop
+  }
+
+  buffer(buffer&&) = default;
+
+  buffer& operator=(buffer&&) = default;
+
+  buffer(const buffer& other) : xs_(other.xs_) {
+    bytes_copied += xs_.size();
+  }
+
+  buffer& operator=(const buffer& other) {
+    xs_ = other.xs_;
+    bytes_copied += xs_.size();
+    return *this;
+  }
+
+  size_t size() const {
+    return xs_.size();
+  }
+
+private:
+  std::vector<char> xs_;
+};
+
+} // namespace <anonymous>
+
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(buffer)
+
+using namespace caf;
+
+namespace {
+
+enum class mode {
+  const_ref,
+  mutable_ref,
+  rvalue_ref
+};
+
+const char* to_string(mode x) {
+  switch (x) {
+    case mode::const_ref:
+      return "const-ref";
+    case mode::mutable_ref:
+      return "mutable-ref";
+    default:
+      return "rvalue-ref";
+  }
+}
+
+behavior relay(event_based_actor* self, mode m, actor next) {
+  switch (m) {
+    case mode::const_ref:
+      return {
+        [=](const buffer& x) {
+          self->send(next, x);
+        }
+      };
+    case mode::mutable_ref:
+      return {
+        [=](buffer& x) {
+          self->send(next, std::move(x));
+        }
+      };
+    default:
+      return {
+        [=](buffer&& x) {
+          self->send(next, std::move(x));
+        }
+      };
+  }
+}
+
+void run(actor_system& sys, mode m, size_t hops, size_t bytes,
+         size_t rounds) {
+  scoped_actor self{sys};
+  actor next = self;
+  std::vector<actor> relays;
+  for (size_t i = 0; i < hops; ++i) {
+    next = sys.spawn(relay, m, next);
+    relays.push_back(next);
+  }
+  bytes_copied = 0;
+  auto t0 = hrc::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    self->send(next, buffer{bytes});
+    self->receive([](buffer&&) {
+      // nop
+    });
+  }
+  auto t1 = hrc::now();
+  for (auto& x : relays)
+    anon_send_exit(x, exit_reason::user_shutdown);
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  auto copied = bytes_copied.load() / rounds;
+  cout << to_string(m) << ", " << hops << ", " << bytes << ", " << copied
+       << ", " << (copied / hops) << ", "
+       << duration_cast<milliseconds>(t1 - t0).count() << endl;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t bytes = 1024 * 1024;
+  size_t rounds = 100;
+  if (argc > 1)
+    bytes = static_cast<size_t>(std::atoi(argv[1]));
+  if (argc > 2)
+    rounds = static_cast<size_t>(std::atoi(argv[2]));
+  actor_system_config cfg;
+  actor_system sys{cfg};
+  cout << "mode, hops, bytes, copied, copied/hop, ms" << endl;
+  for (size_t hops = 1; hops <= 16; hops *= 4)
+    for (auto m : {mode::const_ref, mode::mutable_ref, mode::rvalue_ref})
+      run(sys, m, hops, bytes, rounds);
+}
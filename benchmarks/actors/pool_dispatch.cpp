@@ -0,0 +1,104 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+// drops all messages to measure the cost of the dispatching itself
+class sink : public monitorable_actor {
+public:
+  sink(actor_config& cfg) : monitorable_actor(cfg) {
+    // nop
+  }
+
+  void enqueue(mailbox_element_ptr, execution_unit*) override {
+    // nop
+  }
+};
+
+void run(actor_system& sys, const char* name, actor_pool::policy pol,
+         size_t workers, size_t senders, size_t msgs) {
+  scoped_execution_unit ctx{&sys};
+  auto fac = [&] {
+    actor_config cfg;
+    return make_actor<sink, actor>(sys.next_actor_id(), sys.node(), &sys,
+                                   cfg);
+  };
+  auto pool = actor_pool::make(&ctx, workers, fac, std::move(pol));
+  auto t0 = hrc::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < senders; ++i)
+    threads.emplace_back([&, i] {
+      for (size_t j = 0; j < msgs; ++j)
+        pool->enqueue(nullptr, invalid_message_id,
+                      make_message(static_cast<uint64_t>(i * msgs + j)),
+                      nullptr);
+    });
+  for (auto& t : threads)
+    t.join();
+  auto t1 = hrc::now();
+  anon_send_exit(pool, exit_reason::user_shutdown);
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto us = duration_cast<microseconds>(t1 - t0).count();
+  if (us <= 0)
+    us = 1;
+  cout << name << ", " << workers << ", " << senders << ", "
+       << (senders * msgs * 1000000) / static_cast<size_t>(us) << endl;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t msgs = 200000;
+  if (argc > 1)
+    msgs = static_cast<size_t>(std::atoi(argv[1]));
+  actor_system_config cfg;
+  actor_system sys{cfg};
+  auto key = [](const type_erased_tuple& x) {
+    return x.get_as<uint64_t>(0);
+  };
+  cout << "policy, workers, senders, msgs/s" << endl;
+  for (size_t workers : {4, 32})
+    for (size_t senders : {1, 4}) {
+      run(sys, "round_robin", actor_pool::round_robin(), workers, senders,
+          msgs);
+      run(sys, "random", actor_pool::random(), workers, senders, msgs);
+      run(sys, "join_shortest_queue", actor_pool::join_shortest_queue(),
+          workers, senders, msgs);
+      run(sys, "power_of_two_choices", actor_pool::power_of_two_choices(),
+          workers, senders, msgs);
+      run(sys, "consistent_hashing", actor_pool::consistent_hashing(key),
+          workers, senders, msgs);
+    }
+}
@@ -0,0 +1,102 @@
+/******************************************************************************\
+ * This benchmark measures request/response round trips between a client and *
+ * a server actor. The client keeps a fixed number of requests in flight and *
+ * issues a new request from each response handler, i.e., each round trip    *
+ * adds and removes one response handler and one request timeout.            *
+ *                                                                            *
+ * Output format: CSV with columns mode, in_flight, requests, ms, requests/s  *
+\******************************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+behavior server(event_based_actor*) {
+  return {
+    [](int64_t x) {
+      return x;
+    }
+  };
+}
+
+struct client_state {
+  size_t sent = 0;
+  size_t received = 0;
+};
+
+// multiplexed responses via `then`, each handler sends the next request
+void send_next(stateful_actor<client_state>* self, const actor& srv,
+               const duration& timeout, size_t total, const actor& listener) {
+  auto n = static_cast<int64_t>(self->state.sent++);
+  self->request(srv, timeout, n).then([=](int64_t) {
+    if (++self->state.received == total) {
+      self->send(listener, ok_atom::value);
+      self->quit();
+    } else if (self->state.sent < total) {
+      send_next(self, srv, timeout, total, listener);
+    }
+  });
+}
+
+behavior client(stateful_actor<client_state>* self, actor srv,
+                duration timeout, size_t in_flight, size_t total,
+                actor listener) {
+  for (size_t i = 0; i < in_flight && i < total; ++i)
+    send_next(self, srv, timeout, total, listener);
+  return {
+    [](int64_t) {
+      // nop
+    }
+  };
+}
+
+void run(actor_system& sys, bool with_timeout, size_t in_flight,
+         size_t total) {
+  scoped_actor self{sys};
+  auto srv = sys.spawn(server);
+  duration timeout = with_timeout ? duration{std::chrono::seconds(10)}
+                                  : duration{};
+  auto t0 = hrc::now();
+  sys.spawn(client, srv, timeout, in_flight, total, actor{self});
+  self->receive([](ok_atom) {
+    // nop
+  });
+  auto t1 = hrc::now();
+  anon_send_exit(srv, exit_reason::user_shutdown);
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto us = duration_cast<microseconds>(t1 - t0).count();
+  auto per_sec = us > 0 ? (total * 1000000) / static_cast<size_t>(us) : 0;
+  cout << (with_timeout ? "timeout" : "infinite") << ", " << in_flight
+       << ", " << total << ", " << (us / 1000) << ", " << per_sec << endl;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t requests = 100000;
+  size_t max_in_flight = 1024;
+  if (argc > 1)
+    requests = static_cast<size_t>(std::atoi(argv[1]));
+  if (argc > 2)
+    max_in_flight = static_cast<size_t>(std::atoi(argv[2]));
+  actor_system_config cfg;
+  actor_system sys{cfg};
+  cout << "mode, in_flight, requests, ms, requests/s" << endl;
+  for (size_t in_flight = 1; in_flight <= max_in_flight; in_flight *= 4) {
+    run(sys, false, in_flight, requests);
+    run(sys, true, in_flight, requests);
+  }
+}
@@ -0,0 +1,121 @@
+/******************************************************************************\
+ * This benchmark measures the aggregate throughput of remote messaging over  *
+ * many connections between two actor systems in the same process. Each       *
+ * connection carries a stream of small messages from one producer to one     *
+ * sink. Both systems use the same number of middleman I/O loops.             *
+ *                                                                            *
+ * Output format: CSV with columns threads, connections, msgs, ms, msgs/s     *
+\******************************************************************************/
+
+#include <chrono>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+behavior sink(event_based_actor*) {
+  auto received = std::make_shared<uint64_t>(0);
+  return {
+    [=](int64_t) {
+      ++*received;
+    },
+    [=](get_atom) {
+      return *received;
+    }
+  };
+}
+
+behavior producer(event_based_actor* self, actor dest, size_t msgs,
+                  actor listener) {
+  for (size_t i = 0; i < msgs; ++i)
+    self->send(dest, static_cast<int64_t>(i));
+  // the reply arrives after the sink processed all previous messages
+  self->request(dest, infinite, get_atom::value).then(
+    [=](uint64_t received) {
+      self->send(listener, received);
+      self->quit();
+    }
+  );
+  return {};
+}
+
+class config : public actor_system_config {
+public:
+  config(size_t threads) {
+    load<io::middleman>();
+    middleman_network_threads = threads;
+  }
+};
+
+bool run(size_t threads, size_t connections, size_t msgs) {
+  config server_cfg{threads};
+  actor_system server{server_cfg};
+  config client_cfg{threads};
+  actor_system client{client_cfg};
+  // each sink has its own port, hence its own connection
+  std::vector<actor> sinks;
+  for (size_t i = 0; i < connections; ++i) {
+    auto port = server.middleman().publish(server.spawn(sink), 0,
+                                           "127.0.0.1");
+    if (!port) {
+      cerr << "publish failed: " << server.render(port.error()) << endl;
+      return false;
+    }
+    auto x = client.middleman().remote_actor("127.0.0.1", *port);
+    if (!x) {
+      cerr << "connect failed: " << client.render(x.error()) << endl;
+      return false;
+    }
+    sinks.push_back(*x);
+  }
+  scoped_actor self{client};
+  auto t0 = hrc::now();
+  for (auto& x : sinks)
+    client.spawn(producer, x, msgs, actor{self});
+  uint64_t total = 0;
+  for (size_t i = 0; i < connections; ++i)
+    self->receive([&](uint64_t received) {
+      total += received;
+    });
+  auto t1 = hrc::now();
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto us = duration_cast<microseconds>(t1 - t0).count();
+  auto per_sec = us > 0 ? (total * 1000000) / static_cast<uint64_t>(us) : 0;
+  cout << threads << ", " << connections << ", " << total << ", "
+       << (us / 1000) << ", " << per_sec << endl;
+  for (auto& x : sinks)
+    anon_send_exit(x, exit_reason::user_shutdown);
+  return true;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t msgs = 100000;
+  size_t connections = 16;
+  size_t max_threads = 4;
+  if (argc > 1)
+    msgs = static_cast<size_t>(std::atoi(argv[1]));
+  if (argc > 2)
+    connections = static_cast<size_t>(std::atoi(argv[2]));
+  if (argc > 3)
+    max_threads = static_cast<size_t>(std::atoi(argv[3]));
+  cout << "threads, connections, msgs, ms, msgs/s" << endl;
+  for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    if (!run(threads, connections, msgs))
+      return EXIT_FAILURE;
+}
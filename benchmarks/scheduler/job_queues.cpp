@@ -0,0 +1,98 @@
+/******************************************************************************\
+ * This benchmark compares the spinlocked `double_ended_queue` with the       *
+ * lock-free `work_stealing_queue` used by the work-stealing scheduler. It    *
+ * measures (1) the owner-only path of a worker enqueueing and dequeueing     *
+ * its own jobs and (2) the same path while other threads steal concurrently. *
+ *                                                                            *
+ * Output format: CSV with columns queue, scenario, thieves, ops, ms, ops/s   *
+\******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+#include "caf/detail/double_ended_queue.hpp"
+#include "caf/detail/work_stealing_queue.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+struct job {
+  size_t value;
+};
+
+void print(const char* queue, const char* scenario, size_t thieves,
+           size_t ops, hrc::duration runtime) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  auto us = duration_cast<microseconds>(runtime).count();
+  auto ops_per_sec = us > 0 ? (ops * 1000000) / static_cast<size_t>(us) : 0;
+  cout << queue << ", " << scenario << ", " << thieves << ", " << ops << ", "
+       << (us / 1000) << ", " << ops_per_sec << endl;
+}
+
+// simulates a worker that keeps enqueueing and dequeueing its own jobs
+template <class Queue>
+size_t owner_loop(Queue& q, std::vector<job>& jobs, size_t rounds) {
+  size_t result = 0;
+  for (size_t r = 0; r < rounds; ++r) {
+    for (auto& x : jobs)
+      q.prepend(&x);
+    for (auto x = q.take_head(); x != nullptr; x = q.take_head())
+      result += x->value;
+  }
+  return result;
+}
+
+template <class Queue>
+void run(const char* name, size_t rounds, size_t max_thieves) {
+  std::vector<job> jobs(64);
+  for (size_t i = 0; i < jobs.size(); ++i)
+    jobs[i].value = i;
+  auto ops = rounds * jobs.size();
+  for (size_t thieves = 0; thieves <= max_thieves; ++thieves) {
+    Queue q;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thieves; ++i)
+      threads.emplace_back([&] {
+        while (!done)
+          if (q.take_tail() == nullptr)
+            std::this_thread::yield();
+      });
+    auto t0 = hrc::now();
+    owner_loop(q, jobs, rounds);
+    auto t1 = hrc::now();
+    done = true;
+    for (auto& t : threads)
+      t.join();
+    print(name, thieves == 0 ? "owner-only" : "stealing", thieves, ops,
+          t1 - t0);
+  }
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t rounds = 100000;
+  size_t max_thieves = 3;
+  if (argc > 1)
+    rounds = static_cast<size_t>(std::atoi(argv[1]));
+  if (argc > 2)
+    max_thieves = static_cast<size_t>(std::atoi(argv[2]));
+  cout << "queue, scenario, thieves, ops, ms, ops/s" << endl;
+  run<detail::double_ended_queue<job>>("double_ended_queue", rounds,
+                                       max_thieves);
+  run<detail::work_stealing_queue<job>>("work_stealing_queue", rounds,
+                                        max_thieves);
+}
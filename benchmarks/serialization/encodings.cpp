@@ -0,0 +1,93 @@
+/******************************************************************************\
+ * This benchmark compares the binary encodings of the stream serializers by  *
+ * serializing and deserializing typical CAF message shapes: small requests  *
+ * consisting of an atom and a few integers, key-value updates with short    *
+ * strings, batches of integers, and messages carrying node IDs.             *
+ *                                                                            *
+ * Output format: CSV with columns shape, encoding, bytes, ser-ns, deser-ns   *
+\******************************************************************************/
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+
+#include "caf/all.hpp"
+#include "caf/binary_encoding.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
+using std::cout;
+using std::endl;
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+const char* to_string(binary_encoding x) {
+  switch (x) {
+    case binary_encoding::fixed:
+      return "fixed";
+    case binary_encoding::varint:
+      return "varint";
+    default:
+      return "compact";
+  }
+}
+
+void run(execution_unit* ctx, const char* shape, const message& msg,
+         binary_encoding enc, size_t rounds) {
+  std::vector<char> buf;
+  auto& x = const_cast<message&>(msg);
+  auto t0 = hrc::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    buf.clear();
+    binary_serializer sink{ctx, buf};
+    sink.encoding(enc);
+    sink(x);
+  }
+  auto t1 = hrc::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    message y;
+    binary_deserializer source{ctx, buf};
+    source.encoding(enc);
+    source(y);
+  }
+  auto t2 = hrc::now();
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  cout << shape << ", " << to_string(enc) << ", " << buf.size() << ", "
+       << duration_cast<nanoseconds>(t1 - t0).count() / rounds << ", "
+       << duration_cast<nanoseconds>(t2 - t1).count() / rounds << endl;
+}
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t rounds = 100000;
+  if (argc > 1)
+    rounds = static_cast<size_t>(std::atoi(argv[1]));
+  actor_system_config cfg;
+  cfg.add_message_type<std::vector<int64_t>>("vector<int64_t>");
+  actor_system sys{cfg};
+  scoped_execution_unit ctx{&sys};
+  std::vector<std::pair<const char*, message>> shapes{
+    {"request", make_message(atom("get"), int32_t{42}, uint64_t{7})},
+    {"update", make_message(atom("put"), std::string{"user.name"},
+                            std::string{"alice"})},
+    {"batch", make_message(atom("batch"),
+                           std::vector<int64_t>(64, int64_t{-3}))},
+    {"ints", make_message(int16_t{-1}, int32_t{1000}, int64_t{-100000},
+                          uint32_t{5})},
+    {"node", make_message(atom("connect"), sys.node(), uint16_t{4242})}
+  };
+  cout << "shape, encoding, bytes, ser-ns, deser-ns" << endl;
+  for (auto& kvp : shapes)
+    for (auto enc : {binary_encoding::fixed, binary_encoding::varint,
+                     binary_encoding::compact})
+      run(&ctx, kvp.first, kvp.second, enc, rounds);
+}
@@ -0,0 +1,204 @@
+/******************************************************************************\
+ * This benchmark measures the throughput and the number of heap allocations *
+ * of all inspectors shipped with CAF: the binary serializer, the binary     *
+ * deserializer, a stream serializer writing into a preallocated buffer, the *
+ * stringification inspector, and deep_to_string. Inputs cover primitive     *
+ * types, strings, vectors, maps, nested custom types, messages, and node    *
+ * IDs. An optional second argument only runs inputs with matching names.   *
+ *                                                                            *
+ * Output format: CSV with columns inspector, type, bytes, ns/op, MB/s,       *
+ *                allocs/op                                                   *
+\******************************************************************************/
+
+#include <map>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+#include "caf/all.hpp"
+#include "caf/streambuf.hpp"
+#include "caf/binary_serializer.hpp"
+#include "caf/binary_deserializer.hpp"
+
+#include "caf/detail/stringification_inspector.hpp"
+
+using std::cout;
+using std::endl;
+
+namespace {
+
+// counts all calls to the global operator new
+std::atomic<size_t> allocations;
+
+} // namespace <anonymous>
+
+// keeps GCC from pairing inlined calls to free with operator new, which
+// triggers false positives of -Wmismatched-new-delete
+#if defined(__GNUC__) && !defined(__clang__)
+#  define CAF_BENCH_NOINLINE __attribute__((noinline))
+#else
+#  define CAF_BENCH_NOINLINE
+#endif
+
+CAF_BENCH_NOINLINE void* operator new(size_t n) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  auto result = malloc(n == 0 ? 1 : n);
+  if (result == nullptr)
+    throw std::bad_alloc{};
+  return result;
+}
+
+CAF_BENCH_NOINLINE void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+using namespace caf;
+
+namespace {
+
+using hrc = std::chrono::high_resolution_clock;
+
+struct point {
+  int32_t x;
+  int32_t y;
+};
+
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f, point& x) {
+  return f(meta::type_name("point"), x.x, x.y);
+}
+
+struct shape {
+  std::string name;
+  std::vector<point> points;
+  std::map<std::string, double> attributes;
+};
+
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f, shape& x) {
+  return f(meta::type_name("shape"), x.name, x.points, x.attributes);
+}
+
+// runs `f` `rounds` times and prints one CSV line
+template <class F>
+void measure(const char* inspector, const std::string& type, size_t bytes,
+             size_t rounds, F f) {
+  auto allocs_before = allocations.load();
+  auto t0 = hrc::now();
+  for (size_t i = 0; i < rounds; ++i)
+    f();
+  auto t1 = hrc::now();
+  auto allocs = allocations.load() - allocs_before;
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  auto ns = static_cast<double>(duration_cast<nanoseconds>(t1 - t0).count());
+  auto ns_per_op = ns / static_cast<double>(rounds);
+  // bytes per nanosecond equals 1000 MB per second
+  auto mb_per_sec = ns > 0 ? static_cast<double>(bytes * rounds) * 1000. / ns
+                           : 0.;
+  cout << inspector << ", " << type << ", " << bytes << ", "
+       << static_cast<size_t>(ns_per_op) << ", "
+       << static_cast<size_t>(mb_per_sec) << ", "
+       << std::fixed << std::setprecision(2)
+       << static_cast<double>(allocs) / static_cast<double>(rounds) << endl;
+}
+
+class suite {
+public:
+  suite(execution_unit* ctx, size_t rounds, std::string filter)
+      : ctx_(ctx),
+        rounds_(rounds),
+        filter_(std::move(filter)) {
+    // nop
+  }
+
+  template <class T>
+  void run(const std::string& type, const T& value) {
+    if (!filter_.empty() && type.find(filter_) == std::string::npos)
+      return;
+    auto x = value;
+    std::vector<char> buf;
+    binary_serializer{ctx_, buf}(x);
+    auto n = buf.size();
+    measure("binary_serializer", type, n, rounds_, [&] {
+      buf.clear();
+      binary_serializer sink{ctx_, buf};
+      sink(x);
+    });
+    measure("binary_deserializer", type, n, rounds_, [&] {
+      T y;
+      binary_deserializer source{ctx_, buf};
+      source(y);
+    });
+    std::vector<char> storage(n);
+    measure("stream_serializer", type, n, rounds_, [&] {
+      stream_serializer<charbuf> sink{ctx_, storage.data(), storage.size()};
+      sink(x);
+    });
+    std::string str;
+    measure("stringification_inspector", type, deep_to_string(x).size(),
+            rounds_, [&] {
+      str.clear();
+      detail::stringification_inspector f{str};
+      f(x);
+    });
+    measure("deep_to_string", type, str.size(), rounds_, [&] {
+      str = deep_to_string(x);
+    });
+  }
+
+private:
+  execution_unit* ctx_;
+  size_t rounds_;
+  std::string filter_;
+};
+
+} // namespace <anonymous>
+
+int main(int argc, char** argv) {
+  size_t rounds = 100000;
+  std::string filter;
+  if (argc > 1)
+    rounds = static_cast<size_t>(std::atoi(argv[1]));
+  if (argc > 2)
+    filter = argv[2];
+  actor_system_config cfg;
+  cfg.add_message_type<point>("point");
+  cfg.add_message_type<shape>("shape");
+  cfg.add_message_type<std::vector<int32_t>>("vector<int32_t>");
+  actor_system sys{cfg};
+  scoped_execution_unit ctx{&sys};
+  suite s{&ctx, rounds, std::move(filter)};
+  shape triangle;
+  triangle.name = "triangle";
+  triangle.points = {point{0, 0}, point{100, 0}, point{50, 87}};
+  triangle.attributes = {{"area", 4350.}, {"stroke", 1.5}};
+  std::vector<int32_t> ints(256);
+  for (size_t i = 0; i < ints.size(); ++i)
+    ints[i] = static_cast<int32_t>(i * i);
+  std::vector<std::string> strings(64, "lorem ipsum");
+  std::map<std::string, int64_t> dict;
+  for (int64_t i = 0; i < 64; ++i)
+    dict.emplace("key" + std::to_string(i), i);
+  cout << "inspector, type, bytes, ns/op, MB/s, allocs/op" << endl;
+  s.run("int32_t", int32_t{-42});
+  s.run("uint64_t", uint64_t{0xDEADBEEF});
+  s.run("double", 3.14159);
+  s.run("atom_value", atom("update"));
+  s.run("string/16", std::string(16, 'x'));
+  s.run("string/4096", std::string(4096, 'x'));
+  s.run("vector<int32_t>/256", ints);
+  s.run("vector<string>/64", strings);
+  s.run("map<string,int64_t>/64", dict);
+  s.run("shape", triangle);
+  s.run("message", make_message(atom("update"), int32_t{42},
+                                std::string{"hello world"}, triangle));
+  s.run("message/vector", make_message(ints));
+  s.run("node_id", sys.node());
+}
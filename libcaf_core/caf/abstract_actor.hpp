@@ -110,6 +110,10 @@ public:
   /// an empty set if this actor is untyped.
   virtual std::set<std::string> message_types() const;
 
+  /// Returns the number of pending messages if this actor keeps track of
+  /// it or 0 otherwise.
+  virtual size_t mailbox_depth() const;
+
   /// Returns the ID of this actor.
   actor_id id() const noexcept;
 
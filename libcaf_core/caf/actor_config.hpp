@@ -24,6 +24,7 @@
 
 #include "caf/fwd.hpp"
 #include "caf/input_range.hpp"
+#include "caf/overload_policy.hpp"
 #include "caf/abstract_channel.hpp"
 
 namespace caf {
@@ -34,11 +35,17 @@ public:
   int flags;
   input_range<const group>* groups;
   std::function<behavior (local_actor*)> init_fun;
+  /// Maximum number of pending messages, 0 means unbounded.
+  size_t mailbox_capacity;
+  /// Handles messages exceeding `mailbox_capacity`.
+  overload_policy mailbox_overload_policy;
 
   explicit actor_config(execution_unit* ptr = nullptr)
       : host(ptr),
         flags(abstract_channel::is_abstract_actor_flag),
-        groups(nullptr) {
+        groups(nullptr),
+        mailbox_capacity(0),
+        mailbox_overload_policy(overload_policy::drop_newest) {
     // nop
   }
 
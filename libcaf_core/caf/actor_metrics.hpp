@@ -0,0 +1,222 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_ACTOR_METRICS_HPP
+#define CAF_ACTOR_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "caf/fwd.hpp"
+#include "caf/config.hpp"
+#include "caf/ref_counted.hpp"
+#include "caf/intrusive_ptr.hpp"
+
+#include "caf/meta/type_name.hpp"
+
+namespace caf {
+
+/// A point-in-time copy of the runtime statistics of a single actor.
+/// Rates over an interval result from subtracting two snapshots.
+struct actor_metrics_snapshot {
+  /// ID of the observed actor.
+  actor_id id;
+
+  /// Name of the observed actor as returned by `local_actor::name`.
+  std::string name;
+
+  /// Number of messages put into the mailbox.
+  uint64_t enqueued;
+
+  /// Number of messages taken out of the mailbox.
+  uint64_t dequeued;
+
+  /// Number of pending messages in the mailbox.
+  uint64_t mailbox_size;
+
+  /// Number of processed messages per `actor_metrics::handler_kind`.
+  std::vector<uint64_t> handled;
+
+  /// Estimated processing time in nanoseconds per
+  /// `actor_metrics::handler_kind`, extrapolated from the sampled
+  /// activations.
+  std::vector<uint64_t> handler_ns;
+
+  /// Number of sampled activations per latency bucket, where the upper bound
+  /// of each bucket is given by `actor_metrics::latency_bucket_bound`.
+  std::vector<uint64_t> latency_histogram;
+
+  /// Nanoseconds since the actor started collecting metrics.
+  uint64_t uptime_ns;
+
+  /// Returns the total number of processed messages.
+  uint64_t processed() const;
+
+  /// Returns the total processing time in nanoseconds.
+  uint64_t processing_ns() const;
+
+  /// Returns the average number of enqueued messages per second.
+  double enqueue_rate() const;
+
+  /// Returns the average number of dequeued messages per second.
+  double dequeue_rate() const;
+};
+
+/// @relates actor_metrics_snapshot
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f,
+                                        actor_metrics_snapshot& x) {
+  return f(meta::type_name("actor_metrics_snapshot"), x.id, x.name,
+           x.enqueued, x.dequeued, x.mailbox_size, x.handled, x.handler_ns,
+           x.latency_histogram, x.uptime_ns);
+}
+
+/// Collects runtime statistics of a single actor, i.e., message rates,
+/// mailbox depth and processing times. Senders only touch the enqueue
+/// counter, all other counters have a single writer (the observed actor)
+/// and are stored without read-modify-write operations. Reading the clock
+/// costs more than many message handlers, hence the actor only measures
+/// every `sample_interval`-th activation, while message counts are exact.
+class actor_metrics : public ref_counted {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using clock_type = std::chrono::steady_clock;
+
+  /// Classifies message handlers for accounting processing time.
+  enum handler_kind : uint8_t {
+    /// The current behavior, including its timeout handler.
+    behavior_handler,
+    /// A one-shot handler for an awaited or multiplexed response.
+    response_handler,
+    /// The default handler for unexpected messages.
+    default_handler,
+    /// System messages such as `exit_msg` or `down_msg`.
+    system_handler,
+    /// A batch handler installed via `set_batch_handler`.
+    batch_handler
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  static constexpr size_t num_handler_kinds = 5;
+
+  /// Number of latency buckets, the first bucket counts processing times
+  /// below 1us and each following bucket doubles the upper bound.
+  static constexpr size_t num_latency_buckets = 24;
+
+  /// Number of activations per measured activation.
+  static constexpr uint64_t sample_interval = 16;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  actor_metrics(actor_id aid);
+
+  ~actor_metrics() override;
+
+  // -- properties -------------------------------------------------------------
+
+  inline actor_id id() const {
+    return id_;
+  }
+
+  /// Sets the name of the observed actor. Must point to a string literal.
+  inline void name(const char* x) {
+    name_ = x;
+  }
+
+  // -- event handlers ---------------------------------------------------------
+
+  /// Counts a message put into the mailbox.
+  inline void enqueued() {
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// Counts `n` messages taken out of the mailbox.
+  inline void dequeued(size_t n = 1) {
+    inc(dequeued_, n);
+  }
+
+  /// Returns whether the actor should measure its next activation.
+  inline bool sample() {
+    return ticks_++ % sample_interval == 0;
+  }
+
+  /// Accounts `n` messages processed by a handler of kind `kind`.
+  inline void processed(handler_kind kind, size_t n = 1) {
+    CAF_ASSERT(kind < num_handler_kinds);
+    inc(handled_[kind], n);
+  }
+
+  /// Accounts `n` messages processed by a handler of kind `kind` in `t`
+  /// during a sampled activation.
+  void processed(handler_kind kind, clock_type::duration t, size_t n = 1);
+
+  // -- observers --------------------------------------------------------------
+
+  /// Returns a consistent-enough copy of all counters. Can
+  /// safely run concurrently to the observed actor.
+  actor_metrics_snapshot snapshot() const;
+
+  /// Returns the number of pending messages without copying all counters.
+  /// Can safely run concurrently to the observed actor.
+  uint64_t mailbox_size() const;
+
+  /// Returns the histogram bucket for a processing time of `ns`.
+  static size_t latency_bucket(uint64_t ns);
+
+  /// Returns the exclusive upper bound of bucket `i` in nanoseconds.
+  static uint64_t latency_bucket_bound(size_t i);
+
+  /// Returns a human-readable name for `x`.
+  static const char* name_of(handler_kind x);
+
+private:
+  using counter = std::atomic<uint64_t>;
+
+  // increments a counter with a single writer
+  static inline void inc(counter& x, uint64_t n) {
+    x.store(x.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  actor_id id_;
+  const char* name_;
+  clock_type::time_point start_;
+  // number of activations, only accessed by the observed actor
+  uint64_t ticks_;
+  // written by all senders, keep away from the counters of the actor
+  char pad1_[CAF_CACHE_LINE_SIZE];
+  counter enqueued_;
+  char pad2_[CAF_CACHE_LINE_SIZE - sizeof(counter)];
+  counter dequeued_;
+  std::array<counter, num_handler_kinds> handled_;
+  std::array<counter, num_handler_kinds> handler_ns_;
+  std::array<counter, num_latency_buckets> latency_;
+};
+
+/// @relates actor_metrics
+using actor_metrics_ptr = intrusive_ptr<actor_metrics>;
+
+} // namespace caf
+
+#endif // CAF_ACTOR_METRICS_HPP
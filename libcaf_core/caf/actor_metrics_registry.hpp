@@ -0,0 +1,71 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_ACTOR_METRICS_REGISTRY_HPP
+#define CAF_ACTOR_METRICS_REGISTRY_HPP
+
+#include <vector>
+#include <unordered_map>
+
+#include "caf/fwd.hpp"
+#include "caf/optional.hpp"
+#include "caf/actor_metrics.hpp"
+
+#include "caf/detail/shared_spinlock.hpp"
+
+namespace caf {
+
+/// Keeps track of the metrics of all actors running in an actor system. Only
+/// populated if `scheduler.enable-actor-metrics` is set. Actors register at
+/// launch and unregister on cleanup, hence the registry never delays the
+/// message processing itself.
+class actor_metrics_registry {
+public:
+  friend class actor_system;
+
+  /// Returns the metrics of `key` or `nullptr`.
+  actor_metrics_ptr get(actor_id key) const;
+
+  /// Associates an actor with its metrics.
+  void put(actor_id key, actor_metrics_ptr value);
+
+  /// Removes the metrics of an actor.
+  void erase(actor_id key);
+
+  /// Returns the number of observed actors.
+  size_t size() const;
+
+  /// Returns a snapshot of `key` if it is observed, `none` otherwise.
+  optional<actor_metrics_snapshot> snapshot(actor_id key) const;
+
+  /// Returns snapshots of all observed actors ordered by actor ID.
+  std::vector<actor_metrics_snapshot> snapshot() const;
+
+private:
+  actor_metrics_registry() = default;
+
+  using entries = std::unordered_map<actor_id, actor_metrics_ptr>;
+
+  mutable detail::shared_spinlock mtx_;
+  entries entries_;
+};
+
+} // namespace caf
+
+#endif // CAF_ACTOR_METRICS_REGISTRY_HPP
@@ -21,6 +21,7 @@
 #define CAF_ACTOR_POOL_HPP
 
 #include <vector>
+#include <cstdint>
 #include <functional>
 
 #include "caf/locks.hpp"
@@ -31,6 +32,7 @@
 
 #include "caf/detail/split_join.hpp"
 #include "caf/detail/shared_spinlock.hpp"
+#include "caf/detail/atomic_snapshot.hpp"
 
 namespace caf {
 
@@ -53,7 +55,10 @@ namespace caf {
 /// Neither does it live in its own thread. Messages are dispatched immediately
 /// during the enqueue operation. Any user-defined policy thus has to dispatch
 /// messages with as little overhead as possible, because the dispatching
-/// runs in the context of the sender.
+/// runs in the context of the sender. The pool dispatches without locking:
+/// policies receive an immutable snapshot of the workers and may run
+/// concurrently, i.e., they must synchronize their own state. The `uplock`
+/// argument does not own a lock and remains for source compatibility only.
 /// @experimental
 class actor_pool : public monitorable_actor {
 public:
@@ -62,6 +67,7 @@ public:
   using factory = std::function<actor ()>;
   using policy = std::function<void (actor_system&, uplock&, const actor_vec&,
                                      mailbox_element_ptr&, execution_unit*)>;
+  using key_function = std::function<uint64_t (const type_erased_tuple&)>;
 
   /// Returns a simple round robin dispatching policy.
   static policy round_robin();
@@ -72,6 +78,32 @@ public:
   /// Returns a random dispatching policy.
   static policy random();
 
+  /// Returns a policy dispatching to the worker with the fewest pending
+  /// messages, selecting among workers with equal depth in round robin
+  /// order. Only workers spawned with `bounded_mailbox` or with
+  /// `scheduler.enable-actor-metrics` set report their mailbox depth. All
+  /// other workers, e.g., workers spawned with default options, proxies, or
+  /// blocking actors, always report a depth of 0, i.e., the policy silently
+  /// degrades to `round_robin` for them. Workers report their depth via
+  /// `abstract_actor::mailbox_depth`, i.e., one virtual function call per
+  /// inspected worker and message.
+  static policy join_shortest_queue();
+
+  /// Returns a policy comparing the mailbox depth of two randomly selected
+  /// workers and dispatching to the less loaded one. Scales better than
+  /// `join_shortest_queue` for large pools, since it only inspects two
+  /// workers per message. Relies on the same depth reports as
+  /// `join_shortest_queue` and degrades to a random selection for workers
+  /// that do not report their mailbox depth.
+  static policy power_of_two_choices();
+
+  /// Returns a policy dispatching all messages with the same key to the
+  /// same worker, where `f` extracts the key from the content of a
+  /// message, e.g., via `get_as<uint64_t>(0)`. Uses
+  /// rendezvous hashing, i.e., adding or removing a worker only remaps the
+  /// keys of that worker.
+  static policy consistent_hashing(key_function f);
+
   /// Returns a split/join dispatching policy. The function object `sf`
   /// distributes a work item to all workers (split step) and the function
   /// object `jf` joins individual results into a single one with `init`
@@ -107,15 +139,12 @@ protected:
   void on_cleanup() override;
 
 private:
-  bool filter(upgrade_lock<detail::shared_spinlock>&,
-              const strong_actor_ptr& sender, message_id mid,
-              message_view& content, execution_unit* host);
+  bool filter(const actor_vec& workers, const strong_actor_ptr& sender,
+              message_id mid, message_view& content, execution_unit* host);
 
-  // call without workers_mtx_ held
   void quit(execution_unit* host);
 
-  detail::shared_spinlock workers_mtx_;
-  std::vector<actor> workers_;
+  detail::atomic_snapshot<actor_vec> workers_;
   policy policy_;
   exit_reason planned_reason_;
 };
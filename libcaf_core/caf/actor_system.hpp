@@ -41,9 +41,12 @@
 #include "caf/string_algorithms.hpp"
 #include "caf/scoped_execution_unit.hpp"
 #include "caf/uniform_type_info_map.hpp"
+#include "caf/actor_metrics_registry.hpp"
 #include "caf/composable_behavior_based_actor.hpp"
 #include "caf/prohibit_top_level_spawn_marker.hpp"
 
+#include "caf/telemetry/metric_registry.hpp"
+
 #include "caf/detail/spawn_fwd.hpp"
 #include "caf/detail/init_fun_factory.hpp"
 
@@ -239,6 +242,13 @@ public:
   /// Returns the system-wide actor registry.
   actor_registry& registry();
 
+  /// Returns the system-wide registry for counters, gauges and histograms.
+  telemetry::metric_registry& metrics();
+
+  /// Returns the system-wide registry for per-actor runtime statistics, which
+  /// remains empty unless `scheduler.enable-actor-metrics` is set.
+  caf::actor_metrics_registry& actor_metrics();
+
   /// Returns the system-wide factory for custom types and actors.
   const uniform_type_info_map& types() const;
 
@@ -469,6 +479,10 @@ private:
                   "Probably you have tried to spawn a broker or opencl actor.");
   }
 
+  /// Sets the mailbox capacity and overload policy of `cfg`
+  /// to the values found in the system config.
+  void set_default_mailbox_bounds(actor_config& cfg) const;
+
   expected<strong_actor_ptr> dyn_spawn_impl(const std::string& name,
                                             message& args,
                                             execution_unit* ctx,
@@ -485,6 +499,8 @@ private:
                 : 0;
     if (has_detach_flag(Os) || std::is_base_of<blocking_actor, C>::value)
       cfg.flags |= abstract_actor::is_detached_flag;
+    if (has_bounded_mailbox_flag(Os) && cfg.mailbox_capacity == 0)
+      set_default_mailbox_bounds(cfg);
     if (!cfg.host)
       cfg.host = dummy_execution_unit();
     auto res = make_actor<C>(next_actor_id(), node(), this,
@@ -501,7 +517,9 @@ private:
   uniform_type_info_map types_;
   node_id node_;
   caf::logger logger_;
+  telemetry::metric_registry metrics_;
   actor_registry registry_;
+  caf::actor_metrics_registry actor_metrics_;
   group_manager groups_;
   module_array modules_;
   io::middleman* middleman_;
@@ -510,6 +528,7 @@ private:
   bool await_actors_before_shutdown_;
   strong_actor_ptr config_serv_;
   strong_actor_ptr spawn_serv_;
+  strong_actor_ptr metrics_serv_;
   std::atomic<size_t> detached;
   mutable std::mutex detached_mtx;
   mutable std::condition_variable detached_cv;
@@ -236,14 +236,18 @@ public:
 
   // -- config parameters of the scheduler -------------------------------------
   atom_value scheduler_policy;
+  atom_value scheduler_affinity;
   size_t scheduler_max_threads;
   size_t scheduler_max_throughput;
   bool scheduler_enable_profiling;
   size_t scheduler_profiling_ms_resolution;
   std::string scheduler_profiling_output_file;
+  bool scheduler_enable_actor_metrics;
 
   // -- config parameters for work-stealing ------------------------------------
 
+  atom_value work_stealing_queue_type;
+  atom_value work_stealing_poll_strategy;
   size_t work_stealing_aggressive_poll_attempts;
   size_t work_stealing_aggressive_steal_interval;
   size_t work_stealing_moderate_poll_attempts;
@@ -252,6 +256,15 @@ public:
   size_t work_stealing_relaxed_steal_interval;
   size_t work_stealing_relaxed_sleep_duration_us;
 
+  // -- config parameters for bounded mailboxes --------------------------------
+
+  size_t mailbox_capacity;
+  atom_value mailbox_overload_policy;
+
+  // -- config parameters for priority-aware mailboxes -------------------------
+
+  atom_value mailbox_priority_policy;
+
   // -- config parameters of the middleman -------------------------------------
 
   atom_value middleman_network_backend;
@@ -259,6 +272,22 @@ public:
   bool middleman_enable_automatic_connections;
   size_t middleman_max_consecutive_reads;
   size_t middleman_heartbeat_interval;
+  bool middleman_enable_compact_header;
+  size_t middleman_network_threads;
+  uint16_t middleman_metrics_port;
+  std::string middleman_metrics_host;
+  size_t middleman_coalescing_delay_us;
+  size_t middleman_coalescing_bytes;
+  atom_value middleman_compression;
+  size_t middleman_compression_threshold;
+  bool middleman_enable_compact_encoding;
+
+  // -- config parameters of the logger ---------------------------------------
+
+  size_t logger_buffer_size;
+  atom_value logger_verbosity;
+  std::string logger_component_verbosity;
+  std::string logger_actor_verbosity;
 
   // -- config parameters of the OpenCL module ---------------------------------
 
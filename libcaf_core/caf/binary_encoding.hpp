@@ -0,0 +1,42 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_BINARY_ENCODING_HPP
+#define CAF_BINARY_ENCODING_HPP
+
+#include <cstdint>
+
+namespace caf {
+
+/// Selects the wire format of `stream_serializer` and `stream_deserializer`.
+/// Sequence sizes are variable-byte encoded regardless of this setting.
+enum class binary_encoding : uint8_t {
+  /// Writes integers and atoms with fixed width in network byte order.
+  fixed,
+  /// Writes integers and atoms as variable-byte sequences, mapping signed
+  /// integers to unsigned integers via zigzag encoding first.
+  varint,
+  /// Like `varint`, but also strips the redundant bits of the `0xF` prefix
+  /// from atoms, i.e., atoms with up to 8 characters need at most 7 bytes.
+  compact
+};
+
+} // namespace caf
+
+#endif // CAF_BINARY_ENCODING_HPP
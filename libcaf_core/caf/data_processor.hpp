@@ -88,7 +88,10 @@ public:
     ldouble_v,
     string8_v,
     string16_v,
-    string32_v
+    string32_v,
+    /// Not part of `builtin_t`, allows processors to encode atoms differently
+    /// from other 64-bit integers.
+    atom_v
   };
 
   // -- constructors, destructors, and assignment operators --------------------
@@ -168,6 +171,10 @@ public:
     return apply_builtin(string32_v, &x);
   }
 
+  error apply(atom_value& x) {
+    return apply_builtin(atom_v, &x);
+  }
+
   template <class D, atom_value V>
   static error apply_atom_constant(D& self, atom_constant<V>&) {
     static_assert(!D::writes_state, "cannot deserialize an atom_constant");
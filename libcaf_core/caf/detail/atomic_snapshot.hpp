@@ -0,0 +1,153 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_ATOMIC_SNAPSHOT_HPP
+#define CAF_DETAIL_ATOMIC_SNAPSHOT_HPP
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+
+#include "caf/config.hpp"
+#include "caf/ref_counted.hpp"
+#include "caf/intrusive_ptr.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Stores an immutable value of type `T` that readers access without
+/// locking and writers replace atomically (copy-on-write). Readers obtain
+/// a reference-counted snapshot that stays valid after writers published
+/// a new value. Writers serialize among themselves and wait for readers
+/// that might still be acquiring the previous value before releasing it.
+template <class T>
+class atomic_snapshot {
+private:
+  // stores the value and its reference count in a single allocation
+  struct node : ref_counted {
+    explicit node(T x) : value(std::move(x)) {
+      // nop
+    }
+
+    T value;
+  };
+
+public:
+  /// Grants shared ownership of a published value.
+  class pointer {
+  public:
+    pointer() = default;
+
+    explicit pointer(node* ptr) : ptr_(ptr) {
+      // nop
+    }
+
+    const T& operator*() const {
+      return ptr_->value;
+    }
+
+    const T* operator->() const {
+      return &ptr_->value;
+    }
+
+    explicit operator bool() const {
+      return static_cast<bool>(ptr_);
+    }
+
+    friend bool operator==(const pointer& x, const pointer& y) {
+      return x.ptr_ == y.ptr_;
+    }
+
+    friend bool operator!=(const pointer& x, const pointer& y) {
+      return x.ptr_ != y.ptr_;
+    }
+
+  private:
+    intrusive_ptr<node> ptr_;
+  };
+
+  atomic_snapshot() : atomic_snapshot(T{}) {
+    // nop
+  }
+
+  explicit atomic_snapshot(T init)
+      : current_(new node(std::move(init))),
+        epoch_(0) {
+    readers_[0].value = 0;
+    readers_[1].value = 0;
+  }
+
+  atomic_snapshot(const atomic_snapshot&) = delete;
+  atomic_snapshot& operator=(const atomic_snapshot&) = delete;
+
+  ~atomic_snapshot() {
+    intrusive_ptr_release(current_.load());
+  }
+
+  /// Returns the current value. Never blocks.
+  pointer load() const {
+    auto& readers = readers_[epoch_.load() & 1].value;
+    ++readers;
+    pointer result{current_.load()};
+    --readers;
+    return result;
+  }
+
+  /// Applies `f` to a copy of the current value and publishes the copy if
+  /// `f` returns `true`. Returns the result of `f`.
+  template <class F>
+  bool update(F f) {
+    std::unique_lock<std::mutex> guard{mtx_};
+    T tmp = current_.load()->value;
+    if (!f(tmp))
+      return false;
+    intrusive_ptr<node> old{current_.exchange(new node(std::move(tmp))),
+                            false};
+    // a reader may have loaded the old value without adding a reference
+    // yet, hence we wait until both reader counters have drained once;
+    // flipping the epoch before waiting keeps new readers out of the
+    // drained counter
+    for (int i = 0; i < 2; ++i) {
+      auto prev = epoch_++ & 1;
+      while (readers_[prev].value.load() != 0)
+        std::this_thread::yield();
+    }
+    return true;
+  }
+
+private:
+  // keeps each reader counter in its own cache line, since all readers
+  // of a snapshot write to one of them
+  struct padded_counter {
+    std::atomic<size_t> value;
+    char pad[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+  };
+
+  std::atomic<node*> current_;
+  std::atomic<size_t> epoch_;
+  char pad_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+  mutable padded_counter readers_[2];
+  std::mutex mtx_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_ATOMIC_SNAPSHOT_HPP
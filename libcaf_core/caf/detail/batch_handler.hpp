@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_BATCH_HANDLER_HPP
+#define CAF_DETAIL_BATCH_HANDLER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+#include "caf/type_nr.hpp"
+#include "caf/type_erased_tuple.hpp"
+
+#include "caf/detail/scope_guard.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Collects the content of consecutive messages with the same type
+/// and passes them to a user-defined callback all at once.
+class batch_handler {
+public:
+  explicit batch_handler(uint32_t token) : type_token_(token) {
+    // nop
+  }
+
+  virtual ~batch_handler() {
+    // nop
+  }
+
+  /// Returns the type token of messages accepted by this handler.
+  inline uint32_t type_token() const {
+    return type_token_;
+  }
+
+  /// Returns whether `x` contains exactly one element of the batch type.
+  virtual bool matches(const type_erased_tuple& x) const = 0;
+
+  /// Moves the content of `x` into the current batch.
+  /// @pre `matches(x)`
+  virtual void add(type_erased_tuple& x) = 0;
+
+  /// Returns the number of elements in the current batch.
+  virtual size_t size() const = 0;
+
+  /// Passes the current batch to the callback and clears it afterwards.
+  /// The callback runs without a sender, i.e., the owning actor sets its
+  /// current element to an empty asynchronous message with no sender.
+  virtual void flush() = 0;
+
+private:
+  uint32_t type_token_;
+};
+
+template <class T>
+class batch_handler_impl final : public batch_handler {
+public:
+  using callback = std::function<void (std::vector<T>&)>;
+
+  batch_handler_impl(callback fun)
+      : batch_handler(make_type_token<T>()),
+        fun_(std::move(fun)) {
+    // nop
+  }
+
+  bool matches(const type_erased_tuple& x) const override {
+    return x.type_token() == type_token() && x.match_elements<T>();
+  }
+
+  void add(type_erased_tuple& x) override {
+    xs_.emplace_back(x.move_if_unshared<T>(0));
+  }
+
+  size_t size() const override {
+    return xs_.size();
+  }
+
+  void flush() override {
+    // clear the buffer even if the callback throws, but keep its capacity
+    // to avoid re-allocating it on each batch
+    auto guard = make_scope_guard([&] { xs_.clear(); });
+    fun_(xs_);
+  }
+
+private:
+  callback fun_;
+  std::vector<T> xs_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_BATCH_HANDLER_HPP
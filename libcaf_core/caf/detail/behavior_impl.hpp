@@ -83,10 +83,19 @@ public:
 
   pointer or_else(const pointer& other);
 
+  /// Behaviors with more cases than this sort their cases by type token
+  /// and dispatch via binary search instead of a linear scan.
+  static constexpr size_t linear_dispatch_limit = 8;
+
 protected:
+  /// Sorts `[begin_, end_)` by type token if the behavior exceeds the
+  /// `linear_dispatch_limit`. Cases with equal tokens keep their order.
+  void init_dispatch_index();
+
   duration timeout_;
   match_case_info* begin_;
   match_case_info* end_;
+  bool indexed_;
 };
 
 template <class Tuple>
@@ -180,6 +189,7 @@ private:
             std::integral_constant<size_t, Last>) {
     this->begin_ = arr_.data();
     this->end_ = arr_.data() + arr_.size();
+    this->init_dispatch_index();
     std::integral_constant<bool, has_timeout> token;
     set_timeout(token);
   }
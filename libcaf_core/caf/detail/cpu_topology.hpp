@@ -0,0 +1,72 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_CPU_TOPOLOGY_HPP
+#define CAF_DETAIL_CPU_TOPOLOGY_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "caf/atom.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Describes the position of a logical CPU in the memory hierarchy.
+struct cpu_info {
+  /// Logical CPU ID as used by the operating system.
+  int id;
+  /// Physical package (socket) of the CPU.
+  int package;
+  /// NUMA node of the CPU.
+  int numa_node;
+  /// Lowest CPU ID sharing the last-level (L3) cache with this CPU.
+  int l3_cache;
+};
+
+/// Returns the topology of all online CPUs this process may run on, parsed
+/// from `/sys/devices/system/cpu` on Linux and restricted to the affinity
+/// mask of the process, which also reflects cgroup cpusets. Returns an empty
+/// vector on other platforms or if the topology is unavailable.
+std::vector<cpu_info> get_cpu_topology();
+
+/// Parses a CPU list in the format of the Linux kernel, e.g., "0-3,8,10-11".
+std::vector<int> parse_cpu_list(const std::string& str);
+
+/// Returns 0 if `x` and `y` share a last-level cache, 1 if they share
+/// a NUMA node and 2 otherwise.
+int cpu_distance(const cpu_info& x, const cpu_info& y);
+
+/// Selects a CPU for each of the `num_workers` workers. The strategy
+/// `compact` fills up one last-level cache and NUMA node before moving
+/// on to the next, whereas `scatter` distributes workers round-robin
+/// over all NUMA nodes. Returns an empty vector if `topology` is empty
+/// or `strategy` is unknown.
+std::vector<cpu_info> place_workers(std::vector<cpu_info> topology,
+                                    size_t num_workers, atom_value strategy);
+
+/// Pins the calling thread to the logical CPU `cpu_id`. Returns `false` if
+/// the operating system rejected the request or is not supported.
+bool set_thread_affinity(int cpu_id);
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_CPU_TOPOLOGY_HPP
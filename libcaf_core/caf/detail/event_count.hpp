@@ -0,0 +1,126 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_EVENT_COUNT_HPP
+#define CAF_DETAIL_EVENT_COUNT_HPP
+
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <condition_variable>
+
+namespace caf {
+namespace detail {
+
+/// Allows threads to block until a condition becomes true without missing
+/// notifications and without burdening notifiers with a lock as long as no
+/// thread is waiting. Waiting threads use the following protocol:
+///
+/// ~~~
+/// for (;;) {
+///   auto key = ec.prepare_wait();
+///   if (condition()) {
+///     ec.cancel_wait();
+///     break;
+///   }
+///   ec.wait(key);
+/// }
+/// ~~~
+///
+/// Notifiers first make the condition true and then call `notify_one` or
+/// `notify_all`, which costs a single atomic load if no thread is waiting.
+class event_count {
+public:
+  using key_type = uint64_t;
+
+  event_count() : epoch_(0), waiters_(0) {
+    // nop
+  }
+
+  event_count(const event_count&) = delete;
+  event_count& operator=(const event_count&) = delete;
+
+  /// Registers the calling thread as waiter. Callers must check their
+  /// condition afterwards and then call either `cancel_wait` or `wait`.
+  key_type prepare_wait() {
+    waiters_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load();
+  }
+
+  /// Unregisters the calling thread after `prepare_wait`.
+  void cancel_wait() {
+    waiters_.fetch_sub(1);
+  }
+
+  /// Blocks the calling thread until any notification happened
+  /// after the call to `prepare_wait` that returned `key`.
+  void wait(key_type key) {
+    { // lifetime scope of guard
+      std::unique_lock<std::mutex> guard{mtx_};
+      cv_.wait(guard, [&] { return epoch_.load() != key; });
+    }
+    waiters_.fetch_sub(1);
+  }
+
+  /// Wakes up one waiting thread, if any.
+  void notify_one() {
+    if (has_waiters()) {
+      advance();
+      cv_.notify_one();
+    }
+  }
+
+  /// Wakes up all waiting threads.
+  void notify_all() {
+    if (has_waiters()) {
+      advance();
+      cv_.notify_all();
+    }
+  }
+
+  /// Returns the number of threads currently inside `prepare_wait` / `wait`.
+  size_t waiters() const {
+    return waiters_.load(std::memory_order_relaxed);
+  }
+
+private:
+  bool has_waiters() {
+    // pairs with the fence in `prepare_wait`: either the waiter observes the
+    // modified condition or we observe the waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return waiters_.load(std::memory_order_relaxed) > 0;
+  }
+
+  void advance() {
+    std::unique_lock<std::mutex> guard{mtx_};
+    ++epoch_;
+  }
+
+  std::atomic<key_type> epoch_;
+  std::atomic<size_t> waiters_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_EVENT_COUNT_HPP
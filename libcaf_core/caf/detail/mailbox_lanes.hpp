@@ -0,0 +1,132 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_MAILBOX_LANES_HPP
+#define CAF_DETAIL_MAILBOX_LANES_HPP
+
+#include <cstddef>
+
+#include "caf/priority_policy.hpp"
+#include "caf/mailbox_element.hpp"
+#include "caf/message_priority.hpp"
+
+#include "caf/detail/disposer.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Sorts the elements of a mailbox into one FIFO lane per message priority
+/// on the reader side. Appending an element is O(1) regardless of its
+/// priority and the reader selects lanes according to a `priority_policy`.
+/// @warning Not thread-safe, only the owner of the mailbox may access it.
+class mailbox_lanes {
+public:
+  using pointer = mailbox_element*;
+
+  explicit mailbox_lanes(priority_policy policy);
+
+  ~mailbox_lanes();
+
+  mailbox_lanes(const mailbox_lanes&) = delete;
+  mailbox_lanes& operator=(const mailbox_lanes&) = delete;
+
+  /// Returns the lane for elements with priority `x`, whereas lane 0 is the
+  /// most urgent one.
+  static inline size_t lane_of(message_priority x) {
+    switch (x) {
+      case message_priority::system:
+        return 0;
+      case message_priority::urgent:
+        return 1;
+      case message_priority::high:
+        return 2;
+      case message_priority::bulk:
+        return 4;
+      default:
+        return 3;
+    }
+  }
+
+  /// Returns the lane for elements with message ID `mid`.
+  static inline size_t lane_of(message_id mid) {
+    return lane_of(mid.priority());
+  }
+
+  /// Appends `x` to the end of its lane and takes ownership of it.
+  void push_back(pointer x);
+
+  /// Removes the next element according to the priority policy or returns
+  /// `nullptr` if all lanes are empty.
+  pointer take_front();
+
+  /// Returns the first element of `lane` without removing it or `nullptr`
+  /// if the lane is empty.
+  inline pointer front(size_t lane) const {
+    return lanes_[lane].head;
+  }
+
+  /// Removes the first element of `lane` regardless of the priority policy
+  /// or returns `nullptr` if the lane is empty.
+  pointer pop_front(size_t lane);
+
+  /// Queries whether all lanes are empty.
+  inline bool empty() const {
+    return size_ == 0;
+  }
+
+  /// Returns the number of elements in all lanes.
+  inline size_t size() const {
+    return size_;
+  }
+
+  /// Applies `f` to all elements before deleting them.
+  template <class F>
+  void clear(F& f) {
+    for (auto& l : lanes_) {
+      while (l.head != nullptr) {
+        auto next = l.head->next;
+        f(*l.head);
+        disposer{}(l.head);
+        l.head = next;
+      }
+      l.tail = nullptr;
+    }
+    size_ = 0;
+  }
+
+private:
+  struct lane {
+    pointer head = nullptr;
+    pointer tail = nullptr;
+  };
+
+  pointer take_front(lane& l);
+
+  priority_policy policy_;
+  lane lanes_[message_priorities];
+  size_t size_;
+  // lane and number of remaining elements the weighted policy takes from it
+  size_t current_;
+  size_t credit_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_MAILBOX_LANES_HPP
@@ -21,6 +21,7 @@
 #define CAF_DETAIL_PSEUDO_TUPLE_HPP
 
 #include <cstddef>
+#include <utility>
 
 #include "caf/param.hpp"
 #include "caf/config.hpp"
@@ -61,6 +62,18 @@ struct pseudo_tuple {
   }
 };
 
+/// Maps the argument types of a callback to the element types of a pseudo
+/// tuple. Rvalue references remain for moving elements into the callback.
+template <class T>
+struct pseudo_tuple_arg {
+  using type = typename std::decay<T>::type;
+};
+
+template <class T>
+struct pseudo_tuple_arg<T&&> {
+  using type = T&&;
+};
+
 template <class T>
 struct pseudo_tuple_access {
   using result_type = T&;
@@ -85,6 +98,20 @@ struct pseudo_tuple_access<const T> {
   }
 };
 
+// moves the element out of the tuple, the caller
+// is responsible for detaching shared data first
+template <class T>
+struct pseudo_tuple_access<T&&> {
+  using result_type = T&&;
+
+  template <class Tuple>
+  static T&& get(Tuple& xs, size_t pos) {
+    auto vp = xs.get_mutable(pos);
+    CAF_ASSERT(vp != nullptr);
+    return std::move(*reinterpret_cast<T*>(vp));
+  }
+};
+
 template <class T>
 struct pseudo_tuple_access<param<T>> {
   using result_type = param<T>;
@@ -0,0 +1,190 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_DETAIL_RESPONSE_HANDLER_HPP
+#define CAF_DETAIL_RESPONSE_HANDLER_HPP
+
+#include <tuple>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+#include "caf/fwd.hpp"
+#include "caf/behavior.hpp"
+#include "caf/match_case.hpp"
+
+#include "caf/detail/invoke_result_visitor.hpp"
+
+namespace caf {
+namespace detail {
+
+/// A type-erased, one-shot callback for a single response message. Unlike
+/// `behavior`, a response handler stores its callbacks in place as long as
+/// they fit into `inline_size` bytes, i.e., adding a response handler
+/// usually does not allocate memory.
+class response_handler {
+public:
+  /// Maximum size of callbacks stored without heap allocation.
+  static constexpr size_t inline_size = 128;
+
+  response_handler() : ptr_(nullptr) {
+    // nop
+  }
+
+  template <class F, class... Fs,
+            class E = typename std::enable_if<
+                        !std::is_same<typename std::decay<F>::type,
+                                      response_handler>::value
+                        && !std::is_same<typename std::decay<F>::type,
+                                         behavior>::value
+                      >::type>
+  explicit response_handler(F f, Fs... fs) : ptr_(nullptr) {
+    emplace<callbacks<F, Fs...>>(std::move(f), std::move(fs)...);
+  }
+
+  /// Wraps a full behavior, e.g., for handlers with a timeout.
+  explicit response_handler(behavior bhvr);
+
+  response_handler(response_handler&& other);
+
+  response_handler& operator=(response_handler&& other);
+
+  response_handler(const response_handler&) = delete;
+  response_handler& operator=(const response_handler&) = delete;
+
+  ~response_handler();
+
+  /// Returns whether this handler stores any callback.
+  explicit operator bool() const {
+    return ptr_ != nullptr;
+  }
+
+  /// Returns whether this handler stores its callbacks without heap memory.
+  bool is_inline() const {
+    return ptr_ == reinterpret_cast<const impl*>(&storage_);
+  }
+
+  /// Tries to invoke a callback with `xs`.
+  /// @returns `true` if a callback accepted `xs`, `false` otherwise.
+  bool operator()(type_erased_tuple& xs);
+
+  /// Tries to invoke a callback with `xs`.
+  /// @returns `true` if a callback accepted `xs`, `false` otherwise.
+  bool operator()(message& xs);
+
+private:
+  class impl {
+  public:
+    virtual ~impl();
+
+    virtual match_case::result invoke(invoke_result_visitor& f,
+                                      type_erased_tuple& xs) = 0;
+
+    /// Move-constructs this object into `storage`.
+    virtual impl* move_to(void* storage) = 0;
+  };
+
+  // adds a move constructor to `trivial_match_case`
+  template <class F>
+  class callback : public trivial_match_case<F> {
+  public:
+    using super = trivial_match_case<F>;
+
+    explicit callback(F f) : super(std::move(f)) {
+      // nop
+    }
+
+    callback(callback&& other) : super(std::move(other.fun_)) {
+      // nop
+    }
+  };
+
+  template <class... Fs>
+  class callbacks final : public impl {
+  public:
+    explicit callbacks(Fs... fs) : xs_(callback<Fs>{std::move(fs)}...) {
+      // nop
+    }
+
+    callbacks(callbacks&&) = default;
+
+    match_case::result invoke(invoke_result_visitor& f,
+                              type_erased_tuple& xs) override {
+      return invoke_impl(f, xs, std::integral_constant<size_t, 0>{});
+    }
+
+    impl* move_to(void* storage) override {
+      return new (storage) callbacks(std::move(*this));
+    }
+
+  private:
+    template <size_t I>
+    match_case::result invoke_impl(invoke_result_visitor& f,
+                                   type_erased_tuple& xs,
+                                   std::integral_constant<size_t, I>) {
+      auto res = std::get<I>(xs_).invoke(f, xs);
+      if (res != match_case::no_match)
+        return res;
+      return invoke_impl(f, xs, std::integral_constant<size_t, I + 1>{});
+    }
+
+    match_case::result invoke_impl(invoke_result_visitor&, type_erased_tuple&,
+                                   std::integral_constant<size_t,
+                                                          sizeof...(Fs)>) {
+      return match_case::no_match;
+    }
+
+    std::tuple<callback<Fs>...> xs_;
+  };
+
+  class behavior_callback;
+
+  template <class T, class... Ts>
+  void emplace(Ts&&... xs) {
+    using fits = std::integral_constant<bool,
+                                        sizeof(T) <= inline_size
+                                        && alignof(T) <= alignof(storage_type)>;
+    emplace<T>(fits{}, std::forward<Ts>(xs)...);
+  }
+
+  template <class T, class... Ts>
+  void emplace(std::true_type, Ts&&... xs) {
+    ptr_ = new (&storage_) T(std::forward<Ts>(xs)...);
+  }
+
+  template <class T, class... Ts>
+  void emplace(std::false_type, Ts&&... xs) {
+    ptr_ = new T(std::forward<Ts>(xs)...);
+  }
+
+  void reset();
+
+  using storage_type =
+    typename std::aligned_storage<inline_size,
+                                  alignof(std::max_align_t)>::type;
+
+  impl* ptr_;
+  storage_type storage_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_RESPONSE_HANDLER_HPP
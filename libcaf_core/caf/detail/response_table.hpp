@@ -0,0 +1,201 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#ifndef CAF_DETAIL_RESPONSE_TABLE_HPP
+#define CAF_DETAIL_RESPONSE_TABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "caf/message_id.hpp"
+
+namespace caf {
+namespace detail {
+
+/// Maps IDs of pending requests to values of type `T` using open addressing
+/// with linear probing. The table stores all values in a single vector and
+/// only allocates memory when exceeding its previous maximum size, i.e.,
+/// inserting and erasing entries is allocation-free in steady state.
+///
+/// Request IDs are consecutive numbers. Hence, using the lower bits of an
+/// ID as its slot distributes pending requests evenly without hashing.
+/// @pre `T` is default constructible and move assignable.
+template <class T>
+class response_table {
+public:
+  using key_type = message_id;
+
+  using mapped_type = T;
+
+  response_table() : size_(0) {
+    // nop
+  }
+
+  response_table(const response_table&) = delete;
+  response_table& operator=(const response_table&) = delete;
+
+  /// Returns the number of stored values.
+  size_t size() const {
+    return size_;
+  }
+
+  /// Returns whether no value is stored.
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  /// Returns the value for `k` or `nullptr` if no such value exists.
+  T* find(key_type k) {
+    if (size_ == 0)
+      return nullptr;
+    auto i = index_of(k.integer_value());
+    return i != npos ? &slots_[i].value : nullptr;
+  }
+
+  /// Stores `x` for `k` unless the table already contains `k`.
+  /// @returns A pointer to the value for `k` and whether `x` was inserted.
+  /// @pre `k.valid()`
+  std::pair<T*, bool> emplace(key_type k, T x) {
+    auto key = k.integer_value();
+    if (size_ > 0) {
+      auto i = index_of(key);
+      if (i != npos)
+        return {&slots_[i].value, false};
+    }
+    // keep the load factor below 1/2 to keep probe sequences short
+    if ((size_ + 1) * 2 > slots_.size())
+      grow();
+    auto i = insert(key, std::move(x));
+    ++size_;
+    return {&slots_[i].value, true};
+  }
+
+  /// Removes the value for `k`.
+  /// @returns `true` if a value was removed, `false` otherwise.
+  bool erase(key_type k) {
+    if (size_ == 0)
+      return false;
+    auto i = index_of(k.integer_value());
+    if (i == npos)
+      return false;
+    // backward shift deletion: move entries up to close the gap
+    auto mask = slots_.size() - 1;
+    auto j = i;
+    for (;;) {
+      j = (j + 1) & mask;
+      if (slots_[j].key == empty_key)
+        break;
+      auto home = slots_[j].key & mask;
+      // entry `j` may move into the gap at `i` unless its home slot lies
+      // cyclically within (i, j]
+      auto stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+      if (!stays) {
+        slots_[i].key = slots_[j].key;
+        slots_[i].value = std::move(slots_[j].value);
+        i = j;
+      }
+    }
+    slots_[i].key = empty_key;
+    slots_[i].value = T{};
+    --size_;
+    return true;
+  }
+
+  /// Calls `f(k, x)` for each key `k` and its value `x`.
+  template <class F>
+  void for_each(F f) {
+    for (auto& x : slots_)
+      if (x.key != empty_key)
+        f(message_id::from_integer_value(x.key), x.value);
+  }
+
+  /// Removes all values without releasing memory.
+  void clear() {
+    for (auto& x : slots_) {
+      x.key = empty_key;
+      x.value = T{};
+    }
+    size_ = 0;
+  }
+
+private:
+  // valid request IDs are never 0
+  static constexpr uint64_t empty_key = 0;
+
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  static constexpr size_t initial_capacity = 16;
+
+  struct slot {
+    slot() : key(empty_key) {
+      // nop
+    }
+    uint64_t key;
+    T value;
+  };
+
+  size_t index_of(uint64_t key) const {
+    auto mask = slots_.size() - 1;
+    for (auto i = key & mask; ; i = (i + 1) & mask) {
+      if (slots_[i].key == key)
+        return i;
+      if (slots_[i].key == empty_key)
+        return npos;
+    }
+  }
+
+  size_t insert(uint64_t key, T&& x) {
+    auto mask = slots_.size() - 1;
+    auto i = key & mask;
+    while (slots_[i].key != empty_key)
+      i = (i + 1) & mask;
+    slots_[i].key = key;
+    slots_[i].value = std::move(x);
+    return i;
+  }
+
+  void grow() {
+    std::vector<slot> tmp(slots_.empty() ? initial_capacity
+                                         : slots_.size() * 2);
+    tmp.swap(slots_);
+    for (auto& x : tmp)
+      if (x.key != empty_key)
+        insert(x.key, std::move(x.value));
+  }
+
+  size_t size_;
+  std::vector<slot> slots_;
+};
+
+template <class T>
+constexpr uint64_t response_table<T>::empty_key;
+
+template <class T>
+constexpr size_t response_table<T>::npos;
+
+template <class T>
+constexpr size_t response_table<T>::initial_capacity;
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_RESPONSE_TABLE_HPP
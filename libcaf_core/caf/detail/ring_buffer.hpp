@@ -0,0 +1,153 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_RING_BUFFER_HPP
+#define CAF_DETAIL_RING_BUFFER_HPP
+
+#include "caf/config.hpp"
+
+#include <new>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace caf {
+namespace detail {
+
+/// A lock-free single-producer single-consumer ring buffer for records of
+/// variable size. Producers never block: `push` fails if the buffer has not
+/// enough free space left. Records are stored in a contiguous memory region
+/// and are aligned to 16 bytes. Records that would wrap around the end of the
+/// buffer are stored at the beginning instead, leaving a padding record.
+class ring_buffer {
+public:
+  static constexpr size_t alignment = 16;
+
+  /// Creates a ring buffer with a capacity of at least `min_capacity` bytes.
+  explicit ring_buffer(size_t min_capacity)
+      : head_(0),
+        tail_(0),
+        capacity_(round_up(min_capacity)),
+        mask_(capacity_ - 1),
+        data_(new char[capacity_]) {
+    // nop
+  }
+
+  ring_buffer(const ring_buffer&) = delete;
+  ring_buffer& operator=(const ring_buffer&) = delete;
+
+  /// Reserves `size` bytes for a new record and calls `f(ptr)` to let it
+  /// write the record to `ptr`. Returns `false` without calling `f` if the
+  /// buffer has not enough free space.
+  /// @warning Call only from the producer.
+  template <class F>
+  bool push(size_t size, F f) {
+    auto n = aligned(sizeof(header) + size);
+    auto t = tail_.load(std::memory_order_relaxed);
+    auto h = head_.load(std::memory_order_acquire);
+    auto offset = t & mask_;
+    // skip the remainder of the buffer if the record does not fit
+    auto pad = capacity_ - offset < n ? capacity_ - offset : size_t{0};
+    if (t + pad + n - h > capacity_)
+      return false;
+    if (pad > 0) {
+      new (data_.get() + offset) header{pad, padding};
+      t += pad;
+      offset = 0;
+    }
+    auto ptr = data_.get() + offset;
+    new (ptr) header{n, size};
+    f(ptr + sizeof(header));
+    tail_.store(t + n, std::memory_order_release);
+    return true;
+  }
+
+  /// Calls `f(ptr, size)` for each record in the buffer and releases its
+  /// memory afterwards. Returns the number of consumed records.
+  /// @warning Call only from the consumer.
+  template <class F>
+  size_t consume(F f) {
+    size_t result = 0;
+    auto h = head_.load(std::memory_order_relaxed);
+    auto t = tail_.load(std::memory_order_acquire);
+    while (h != t) {
+      auto ptr = data_.get() + (h & mask_);
+      auto hdr = reinterpret_cast<header*>(ptr);
+      if (hdr->size != padding) {
+        f(static_cast<const char*>(ptr + sizeof(header)), hdr->size);
+        ++result;
+      }
+      h += hdr->capacity;
+      head_.store(h, std::memory_order_release);
+    }
+    return result;
+  }
+
+  /// Returns whether the buffer was empty at some point during the call.
+  bool empty() const {
+    return head_.load(std::memory_order_relaxed)
+           == tail_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the capacity of the buffer in bytes.
+  size_t capacity() const {
+    return capacity_;
+  }
+
+private:
+  // precedes each record in the buffer
+  struct header {
+    // number of bytes occupied by this record including the header
+    size_t capacity;
+    // number of bytes written by the producer or `padding`
+    size_t size;
+  };
+
+  static_assert(sizeof(header) <= alignment,
+                "a padding record must be able to store its header");
+
+  static constexpr size_t padding = static_cast<size_t>(-1);
+
+  static size_t aligned(size_t x) {
+    return (x + alignment - 1) & ~(alignment - 1);
+  }
+
+  static size_t round_up(size_t x) {
+    size_t result = 64;
+    while (result < x)
+      result <<= 1;
+    return result;
+  }
+
+  // written only by the consumer
+  std::atomic<size_t> head_;
+  char pad1_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+  // written only by the producer
+  std::atomic<size_t> tail_;
+  char pad2_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+  size_t capacity_;
+  size_t mask_;
+  std::unique_ptr<char[]> data_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_RING_BUFFER_HPP
@@ -66,6 +66,15 @@ public:
     return take_head();
   }
 
+  /// Returns the element the next call to {@link try_pop} would return
+  /// without dequeueing it or `nullptr` if the mailbox is empty.
+  /// @warning Call only from the reader (owner).
+  pointer peek() {
+    if (head_ != nullptr || fetch_new_data())
+      return head_;
+    return nullptr;
+  }
+
   /// Tries to enqueue a new element to the mailbox.
   /// @threadsafe
   enqueue_result enqueue(pointer new_element) {
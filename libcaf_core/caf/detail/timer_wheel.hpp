@@ -0,0 +1,358 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_TIMER_WHEEL_HPP
+#define CAF_DETAIL_TIMER_WHEEL_HPP
+
+#include <array>
+#include <limits>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+#include "caf/config.hpp"
+
+namespace caf {
+namespace detail {
+
+/// A hierarchical timing wheel as described in "Hashed and Hierarchical
+/// Timing Wheels" (Varghese and Lauck, SOSP 1987). Timeouts are measured
+/// in abstract ticks. The wheel consists of `levels` rings with
+/// `slots_per_level` slots each, where one slot on level `n` spans
+/// `slots_per_level^n` ticks. Inserting and cancelling a timeout takes
+/// constant time. Advancing the wheel by one tick takes constant time plus
+/// the time for expiring due timeouts and for moving timeouts from a higher
+/// level down once per `slots_per_level^n` ticks. Timeouts with the same
+/// expiry expire in the order they were added.
+///
+/// All entries live in a single vector that recycles released entries,
+/// i.e., the wheel only allocates memory when exceeding its previous
+/// maximum number of pending timeouts.
+///
+/// This class is not thread-safe.
+template <class T>
+class timer_wheel {
+public:
+  using value_type = T;
+
+  /// Identifies a pending timeout. Handles remain unique for the lifetime of
+  /// the wheel, i.e., cancelling an expired timeout is a harmless no-op.
+  using handle = uint64_t;
+
+  /// Denotes a timeout that no longer exists.
+  static constexpr handle invalid_handle = 0;
+
+  static constexpr size_t level_bits = 8;
+
+  static constexpr size_t slots_per_level = size_t{1} << level_bits;
+
+  static constexpr size_t levels = 4;
+
+  /// Maximum distance between the current tick and an expiry. The wheel
+  /// stores timeouts that are further away at this distance and
+  /// re-inserts them as time passes.
+  static constexpr uint64_t max_distance
+    = (uint64_t{1} << (level_bits * levels)) - 1;
+
+  timer_wheel() : now_(0), size_(0), free_list_(nil) {
+    heads_.fill(nil);
+    tails_.fill(nil);
+  }
+
+  timer_wheel(const timer_wheel&) = delete;
+  timer_wheel& operator=(const timer_wheel&) = delete;
+
+  /// Returns the current tick.
+  uint64_t now() const {
+    return now_;
+  }
+
+  /// Returns the number of pending timeouts.
+  size_t size() const {
+    return size_;
+  }
+
+  /// Returns whether no timeout is pending.
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  /// Schedules `x` for expiring at tick `expiry`. Expiries in the past
+  /// or present expire on the next tick.
+  handle add(uint64_t expiry, value_type x) {
+    auto i = alloc();
+    auto& e = entries_[i];
+    e.expiry = expiry > now_ ? expiry : now_ + 1;
+    e.value = std::move(x);
+    link(i);
+    ++size_;
+    return make_handle(i, e.generation);
+  }
+
+  /// Removes the timeout identified by `hdl` without expiring it.
+  /// @returns `true` if a pending timeout was removed, `false` otherwise.
+  bool cancel(handle hdl) {
+    return cancel(hdl, [](value_type&) {
+      // nop
+    });
+  }
+
+  /// Removes the timeout identified by `hdl` without expiring it and
+  /// passes its value to `f`.
+  /// @returns `true` if a pending timeout was removed, `false` otherwise.
+  /// @warning `f` must neither add nor cancel timeouts.
+  template <class F>
+  bool cancel(handle hdl, F f) {
+    auto i = static_cast<uint32_t>(hdl & 0xFFFFFFFF);
+    auto generation = static_cast<uint32_t>(hdl >> 32);
+    if (hdl == invalid_handle || i >= entries_.size()
+        || entries_[i].generation != generation
+        || entries_[i].slot == nil)
+      return false;
+    unlink(i);
+    auto value = std::move(entries_[i].value);
+    release(i);
+    --size_;
+    f(value);
+    return true;
+  }
+
+  /// Advances the wheel to tick `t` and calls `f` for all values
+  /// whose expiry is less or equal to `t`.
+  /// @warning `f` must neither add nor cancel timeouts.
+  template <class F>
+  void advance(uint64_t t, F f) {
+    while (now_ < t) {
+      // skip all ticks without any work
+      auto next = next_tick();
+      if (next > t) {
+        now_ = t;
+        return;
+      }
+      now_ = next - 1;
+      step(f);
+    }
+  }
+
+  /// Removes all pending timeouts without expiring them and passes each
+  /// value to `f`.
+  /// @warning `f` must neither add nor cancel timeouts.
+  template <class F>
+  void clear(F f) {
+    for (uint32_t i = 0; i < entries_.size(); ++i) {
+      if (entries_[i].slot != nil) {
+        auto value = std::move(entries_[i].value);
+        release(i);
+        f(value);
+      }
+    }
+    heads_.fill(nil);
+    tails_.fill(nil);
+    size_ = 0;
+  }
+
+  /// Returns the earliest tick at which the wheel may expire timeouts
+  /// or needs to move timeouts down from a higher level. Returns
+  /// `std::numeric_limits<uint64_t>::max()` if the wheel is empty.
+  uint64_t next_tick() const {
+    auto result = std::numeric_limits<uint64_t>::max();
+    if (size_ == 0)
+      return result;
+    auto mask = static_cast<uint64_t>(slots_per_level - 1);
+    // level 0 only holds timeouts for the next `slots_per_level` ticks
+    for (uint64_t t = now_ + 1; t <= now_ + slots_per_level; ++t) {
+      if (heads_[t & mask] != nil) {
+        result = t;
+        break;
+      }
+    }
+    // slots on level n only matter when the wheel reaches their start tick
+    for (size_t level = 1; level < levels; ++level) {
+      auto shift = level_bits * level;
+      for (uint64_t j = 1; j <= slots_per_level; ++j) {
+        auto t = ((now_ >> shift) + j) << shift;
+        if (t >= result)
+          break;
+        if (heads_[level * slots_per_level + ((t >> shift) & mask)] != nil) {
+          result = t;
+          break;
+        }
+      }
+    }
+    return result;
+  }
+
+private:
+  static constexpr uint32_t nil = std::numeric_limits<uint32_t>::max();
+
+  struct entry {
+    entry() : expiry(0), prev(nil), next(nil), slot(nil), generation(1) {
+      // nop
+    }
+    uint64_t expiry;
+    uint32_t prev;
+    uint32_t next;
+    // index into slots_ or `nil` if this entry is unused
+    uint32_t slot;
+    // distinguishes handles for recycled entries
+    uint32_t generation;
+    value_type value;
+  };
+
+  static handle make_handle(uint32_t i, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | i;
+  }
+
+  uint32_t alloc() {
+    if (free_list_ != nil) {
+      auto i = free_list_;
+      free_list_ = entries_[i].next;
+      return i;
+    }
+    entries_.emplace_back();
+    return static_cast<uint32_t>(entries_.size() - 1);
+  }
+
+  void release(uint32_t i) {
+    auto& e = entries_[i];
+    e.value = value_type{};
+    e.slot = nil;
+    e.prev = nil;
+    // never hand out handle 0
+    if (++e.generation == 0)
+      e.generation = 1;
+    e.next = free_list_;
+    free_list_ = i;
+  }
+
+  // computes the slot for `expiry` relative to `now_`
+  uint32_t slot_for(uint64_t expiry) const {
+    auto mask = static_cast<uint64_t>(slots_per_level - 1);
+    auto delta = expiry - now_;
+    if (delta > max_distance) {
+      delta = max_distance;
+      expiry = now_ + delta;
+    }
+    size_t level = 0;
+    while (level + 1 < levels && delta >= (uint64_t{1} << (level_bits
+                                                           * (level + 1))))
+      ++level;
+    auto pos = (expiry >> (level_bits * level)) & mask;
+    return static_cast<uint32_t>(level * slots_per_level + pos);
+  }
+
+  // appends entry `i` to its slot
+  void link(uint32_t i) {
+    auto& e = entries_[i];
+    e.slot = slot_for(e.expiry);
+    auto& tail = tails_[e.slot];
+    e.prev = tail;
+    e.next = nil;
+    if (tail != nil)
+      entries_[tail].next = i;
+    else
+      heads_[e.slot] = i;
+    tail = i;
+  }
+
+  void unlink(uint32_t i) {
+    auto& e = entries_[i];
+    if (e.prev != nil)
+      entries_[e.prev].next = e.next;
+    else
+      heads_[e.slot] = e.next;
+    if (e.next != nil)
+      entries_[e.next].prev = e.prev;
+    else
+      tails_[e.slot] = e.prev;
+  }
+
+  // detaches the list in slot `s` and returns its first entry
+  uint32_t take_slot(size_t s) {
+    auto result = heads_[s];
+    heads_[s] = nil;
+    tails_[s] = nil;
+    return result;
+  }
+
+  template <class F>
+  void step(F& f) {
+    auto mask = static_cast<uint64_t>(slots_per_level - 1);
+    ++now_;
+    // move timeouts down from higher levels whenever the lower level wraps
+    for (size_t level = 1; level < levels; ++level) {
+      if (((now_ >> (level_bits * (level - 1))) & mask) != 0)
+        break;
+      auto pos = (now_ >> (level_bits * level)) & mask;
+      auto i = take_slot(level * slots_per_level + pos);
+      while (i != nil) {
+        auto next = entries_[i].next;
+        link(i);
+        i = next;
+      }
+    }
+    // expire all timeouts in the current slot
+    auto i = take_slot(now_ & mask);
+    while (i != nil) {
+      auto next = entries_[i].next;
+      auto& e = entries_[i];
+      if (e.expiry <= now_) {
+        --size_;
+        auto value = std::move(e.value);
+        release(i);
+        f(value);
+      } else {
+        // expiry is a multiple of the wheel range ahead, keep waiting
+        link(i);
+      }
+      i = next;
+    }
+  }
+
+  uint64_t now_;
+  size_t size_;
+  uint32_t free_list_;
+  std::array<uint32_t, levels * slots_per_level> heads_;
+  std::array<uint32_t, levels * slots_per_level> tails_;
+  std::vector<entry> entries_;
+};
+
+template <class T>
+constexpr typename timer_wheel<T>::handle timer_wheel<T>::invalid_handle;
+
+template <class T>
+constexpr size_t timer_wheel<T>::level_bits;
+
+template <class T>
+constexpr size_t timer_wheel<T>::slots_per_level;
+
+template <class T>
+constexpr size_t timer_wheel<T>::levels;
+
+template <class T>
+constexpr uint64_t timer_wheel<T>::max_distance;
+
+template <class T>
+constexpr uint32_t timer_wheel<T>::nil;
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_TIMER_WHEEL_HPP
@@ -67,6 +67,27 @@ struct void_ptr_access {
   }
 };
 
+// creates a type-erased copy of an element; `make_message` rejects move-only
+// types at compile time, hence the error only triggers for content that was
+// moved from a mailbox element into a message and then copied
+struct tuple_vals_copier {
+  template <class T>
+  type_erased_value_ptr operator()(T& x) const {
+    return copy(x, is_copyable_message_element<T>{});
+  }
+
+  template <class T>
+  type_erased_value_ptr copy(T& x, std::true_type) const {
+    type_erased_value_factory f;
+    return f(x);
+  }
+
+  template <class T>
+  type_erased_value_ptr copy(T&, std::false_type) const {
+    CAF_RAISE_ERROR("cannot copy a move-only message element");
+  }
+};
+
 template <class T, uint16_t N = type_nr<T>::value>
 struct tuple_vals_type_helper {
   static typename message_data::rtti_pair get() noexcept {
@@ -147,7 +168,7 @@ public:
   using Base::copy;
 
   type_erased_value_ptr copy(size_t pos) const override {
-    type_erased_value_factory f;
+    tuple_vals_copier f;
     return mptr()->dispatch(pos, f);
   }
 
@@ -223,8 +244,23 @@ public:
   using super::copy;
 
   message_data::cow_ptr copy() const override {
+    return copy(is_copyable{});
+  }
+
+private:
+  using is_copyable =
+    std::integral_constant<
+      bool,
+      detail::conjunction<is_copyable_message_element<Ts>::value...>::value
+    >;
+
+  message_data::cow_ptr copy(std::true_type) const {
     return message_data::cow_ptr(new tuple_vals(*this), false);
   }
+
+  message_data::cow_ptr copy(std::false_type) const {
+    CAF_RAISE_ERROR("cannot copy a message with move-only elements");
+  }
 };
 
 } // namespace detail
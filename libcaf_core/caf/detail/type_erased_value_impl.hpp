@@ -22,12 +22,14 @@
 
 #include <cstdint>
 #include <typeinfo>
+#include <stdexcept>
 #include <functional>
 
 #include "caf/error.hpp"
 #include "caf/type_erased_value.hpp"
 
 #include "caf/detail/safe_equal.hpp"
+#include "caf/detail/type_traits.hpp"
 #include "caf/detail/try_serialize.hpp"
 
 namespace caf {
@@ -111,7 +113,7 @@ public:
   }
 
   type_erased_value_ptr copy() const override {
-    return type_erased_value_ptr{new type_erased_value_impl(x_)};
+    return copy(is_copyable_message_element<T>{});
   }
 
   // -- conversion operators ---------------------------------------------------
@@ -121,6 +123,16 @@ public:
   }
 
 private:
+  // -- copy utility -----------------------------------------------------------
+
+  type_erased_value_ptr copy(std::true_type) const {
+    return type_erased_value_ptr{new type_erased_value_impl(x_)};
+  }
+
+  type_erased_value_ptr copy(std::false_type) const {
+    CAF_RAISE_ERROR("cannot copy a move-only value");
+  }
+
   // -- address-of-member utility ----------------------------------------------
 
   template <class U>
@@ -376,7 +376,8 @@ struct is_serializable<const T&> : is_serializable<T> {
   // nop
 };
 
-/// Checks wheter `T` is a non-const reference.
+/// Checks wheter `T` is a non-const reference. Rvalue references count
+/// as mutable, since the callee may move from its argument.
 template <class T>
 struct is_mutable_ref : std::false_type { };
 
@@ -386,6 +387,20 @@ struct is_mutable_ref<const T&> : std::false_type { };
 template <class T>
 struct is_mutable_ref<T&> : std::true_type { };
 
+template <class T>
+struct is_mutable_ref<const T&&> : std::false_type { };
+
+template <class T>
+struct is_mutable_ref<T&&> : std::true_type { };
+
+/// Checks whether messages can copy values of type `T`. Messages can only
+/// transfer move-only values, e.g., by sending an rvalue.
+template <class T>
+struct is_copyable_message_element
+  : std::is_copy_constructible<typename std::remove_all_extents<T>::type> {
+  // nop
+};
+
 /// Defines `result_type,` `arg_types,` and `fun_type`. Functor is
 ///    (a) a member function pointer, (b) a function,
 ///    (c) a function pointer, (d) an std::function.
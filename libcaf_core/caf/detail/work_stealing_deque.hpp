@@ -0,0 +1,206 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_WORK_STEALING_DEQUE_HPP
+#define CAF_DETAIL_WORK_STEALING_DEQUE_HPP
+
+#include "caf/config.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace caf {
+namespace detail {
+
+/// A lock-free work-stealing deque based on "Dynamic Circular Work-Stealing
+/// Deque" (Chase and Lev, SPAA 2005) using the C++11 memory model mapping
+/// from "Correct and Efficient Work-Stealing for Weak Memory Models"
+/// (Le et al., PPoPP 2013).
+///
+/// Only the owner of the deque is allowed to call `push_bottom` and
+/// `pop_bottom`, whereas any thread can call `steal`. The owner operates
+/// LIFO on the bottom end while thieves take the oldest element from the top.
+/// The deque grows by doubling its capacity and never shrinks. Retired
+/// buffers remain allocated until the deque is destroyed, because thieves
+/// may still read from them. The total memory is thus bounded by twice the
+/// size of the largest buffer.
+template <class T>
+class work_stealing_deque {
+public:
+  using value_type = T;
+  using pointer = value_type*;
+  using index_type = int64_t;
+
+  static constexpr index_type default_capacity = 64;
+
+  explicit work_stealing_deque(index_type initial_capacity = default_capacity)
+      : top_(0),
+        bottom_(0),
+        buf_(new buffer(round_up(initial_capacity), nullptr)) {
+    // nop
+  }
+
+  work_stealing_deque(const work_stealing_deque&) = delete;
+  work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+  ~work_stealing_deque() {
+    auto ptr = buf_.load();
+    while (ptr) {
+      auto prev = ptr->prev;
+      delete ptr;
+      ptr = prev;
+    }
+  }
+
+  /// Inserts `value` at the bottom end.
+  /// @warning Call only from the owner.
+  void push_bottom(pointer value) {
+    CAF_ASSERT(value != nullptr);
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_acquire);
+    auto buf = buf_.load(std::memory_order_relaxed);
+    if (b - t > buf->capacity - 1) {
+      buf = grow(buf, t, b);
+      buf_.store(buf, std::memory_order_release);
+    }
+    buf->put(b, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /// Removes the most recently pushed element from the bottom end
+  /// or returns `nullptr` if the deque is empty.
+  /// @warning Call only from the owner.
+  pointer pop_bottom() {
+    auto b = bottom_.load(std::memory_order_relaxed) - 1;
+    auto buf = buf_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      // deque was empty
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    auto result = buf->get(b);
+    if (t == b) {
+      // last element, compete with thieves
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed))
+        result = nullptr;
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  /// Removes the oldest element from the top end. Returns `nullptr` if the
+  /// deque is empty or if this thread lost the race for the top element.
+  /// @threadsafe
+  pointer steal() {
+    auto t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = bottom_.load(std::memory_order_acquire);
+    if (t >= b)
+      return nullptr;
+    auto buf = buf_.load(std::memory_order_acquire);
+    auto result = buf->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return nullptr;
+    return result;
+  }
+
+  /// Returns whether the deque was empty at some point during the call.
+  /// @threadsafe
+  bool empty() const {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+  /// Returns the current capacity of the deque.
+  /// @warning Call only from the owner.
+  index_type capacity() const {
+    return buf_.load(std::memory_order_relaxed)->capacity;
+  }
+
+private:
+  // a circular array with a power-of-two capacity
+  struct buffer {
+    buffer(index_type cap, buffer* predecessor)
+        : capacity(cap),
+          mask(cap - 1),
+          items(new std::atomic<pointer>[static_cast<size_t>(cap)]),
+          prev(predecessor) {
+      // nop
+    }
+
+    ~buffer() {
+      delete[] items;
+    }
+
+    pointer get(index_type i) const {
+      return items[i & mask].load(std::memory_order_relaxed);
+    }
+
+    void put(index_type i, pointer x) {
+      items[i & mask].store(x, std::memory_order_relaxed);
+    }
+
+    index_type capacity;
+    index_type mask;
+    std::atomic<pointer>* items;
+    // retired buffer, deleted along with this buffer
+    buffer* prev;
+  };
+
+  static index_type round_up(index_type x) {
+    index_type result = 1;
+    while (result < x)
+      result <<= 1;
+    return result;
+  }
+
+  // copies all elements in [t, b) into a buffer with twice the capacity
+  buffer* grow(buffer* old, index_type t, index_type b) {
+    auto result = new buffer(old->capacity * 2, old);
+    for (auto i = t; i < b; ++i)
+      result->put(i, old->get(i));
+    return result;
+  }
+
+  // read by thieves and the owner, modified via CAS
+  std::atomic<index_type> top_;
+  char pad1_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<index_type>)];
+  // written only by the owner
+  std::atomic<index_type> bottom_;
+  char pad2_[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<index_type>)];
+  // written only by the owner
+  std::atomic<buffer*> buf_;
+};
+
+template <class T>
+constexpr typename work_stealing_deque<T>::index_type
+work_stealing_deque<T>::default_capacity;
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_WORK_STEALING_DEQUE_HPP
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_DETAIL_WORK_STEALING_QUEUE_HPP
+#define CAF_DETAIL_WORK_STEALING_QUEUE_HPP
+
+#include "caf/config.hpp"
+
+#include "caf/detail/double_ended_queue.hpp"
+#include "caf/detail/work_stealing_deque.hpp"
+
+namespace caf {
+namespace detail {
+
+/// A job queue for a single worker that provides the same interface as
+/// `double_ended_queue`, but stores all jobs enqueued by the worker itself
+/// in a lock-free `work_stealing_deque`. Only jobs from other threads, which
+/// cannot push to the deque directly, go through a `double_ended_queue`.
+///
+/// Usage restrictions (in contrast to `double_ended_queue`):
+/// - `prepend` and `take_head` must be called only by the owner
+/// - `append` and `take_tail` are thread-safe
+template <class T>
+class work_stealing_queue {
+public:
+  using value_type = T;
+  using pointer = value_type*;
+
+  /// Enqueues a job from any thread. The job runs after all jobs
+  /// the owner has enqueued via `prepend`.
+  /// @threadsafe
+  void append(pointer value) {
+    inbox_.append(value);
+  }
+
+  /// Enqueues a job to the owner-local deque. Acquires no lock and
+  /// performs no heap allocation unless the deque needs to grow.
+  /// @warning Call only from the owner.
+  void prepend(pointer value) {
+    deque_.push_bottom(value);
+  }
+
+  /// Dequeues the most recently prepended job or, if there is none,
+  /// the oldest appended job. Returns `nullptr` on failure.
+  /// @warning Call only from the owner.
+  pointer take_head() {
+    auto result = deque_.pop_bottom();
+    return result ? result : inbox_.take_head();
+  }
+
+  /// Steals the oldest job from the owner-local deque or, if there is none,
+  /// the oldest appended job. Returns `nullptr` on failure.
+  /// @threadsafe
+  pointer take_tail() {
+    auto result = deque_.steal();
+    return result ? result : inbox_.take_head();
+  }
+
+  /// Returns whether the queue was empty at some point during the call.
+  /// @threadsafe
+  bool empty() const {
+    return deque_.empty() && inbox_.empty();
+  }
+
+private:
+  work_stealing_deque<value_type> deque_;
+  double_ended_queue<value_type> inbox_;
+};
+
+} // namespace detail
+} // namespace caf
+
+#endif // CAF_DETAIL_WORK_STEALING_QUEUE_HPP
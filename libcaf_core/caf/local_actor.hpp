@@ -62,6 +62,7 @@
 #include "caf/scheduler/abstract_coordinator.hpp"
 
 #include "caf/detail/disposer.hpp"
+#include "caf/detail/mailbox_lanes.hpp"
 #include "caf/detail/behavior_stack.hpp"
 #include "caf/detail/typed_actor_util.hpp"
 #include "caf/detail/single_reader_queue.hpp"
@@ -113,7 +114,7 @@ public:
 
   /// Requests a new timeout for `mid`.
   /// @pre `mid.valid()`
-  void request_response_timeout(const duration& dr, message_id mid);
+  virtual void request_response_timeout(const duration& dr, message_id mid);
 
   // -- spawn functions --------------------------------------------------------
 
@@ -326,9 +327,7 @@ public:
     static_assert(response_type_unbox<signatures_of_t<Handle>, token>::valid,
                   "receiver does not accept given message");
     auto mid = current_element_->mid;
-    current_element_->mid = P == message_priority::high
-                            ? mid.with_high_priority()
-                            : mid.with_normal_priority();
+    current_element_->mid = mid.with_priority(P);
     dest->enqueue(make_mailbox_element(std::move(current_element_->sender),
                                        mid, std::move(current_element_->stages),
                                        std::forward<Ts>(xs)...),
@@ -352,6 +351,15 @@ public:
   /// if the mailbox is drained.
   mailbox_element_ptr next_message();
 
+  /// Returns the next message with the same priority as `x` without
+  /// removing it from the mailbox or `nullptr` if no such message exists.
+  /// Actors without `priority_aware` consider all messages.
+  mailbox_element* peek_next_message(const mailbox_element& x);
+
+  /// Removes the message returned by the last call to `peek_next_message`
+  /// for a message with the same priority as `x`.
+  mailbox_element_ptr take_next_message(const mailbox_element& x);
+
   /// Returns whether the mailbox contains at least one element.
   bool has_next_message();
 
@@ -364,6 +372,10 @@ protected:
   // used by both event-based and blocking actors
   mailbox_type mailbox_;
 
+  // sorts new mailbox elements by their priority, only used by actors
+  // spawned with `priority_aware`
+  std::unique_ptr<detail::mailbox_lanes> lanes_;
+
   // identifies the execution unit this actor is currently executed by
   execution_unit* context_;
 
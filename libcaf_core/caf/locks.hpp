@@ -32,6 +32,11 @@ class shared_lock {
 public:
   using lockable = SharedLockable;
 
+  /// Creates a lock that does not own any lockable.
+  shared_lock() : lockable_(nullptr) {
+    // nop
+  }
+
   explicit shared_lock(lockable& arg) : lockable_(&arg) {
     lockable_->lock_shared();
   }
@@ -20,7 +20,12 @@
 #ifndef CAF_DETAIL_LOGGING_HPP
 #define CAF_DETAIL_LOGGING_HPP
 
+#include <mutex>
+#include <atomic>
+#include <memory>
 #include <thread>
+#include <vector>
+#include <limits>
 #include <cstring>
 #include <sstream>
 #include <iostream>
@@ -36,8 +41,8 @@
 
 #include "caf/type_nr.hpp"
 #include "caf/detail/scope_guard.hpp"
+#include "caf/detail/event_count.hpp"
 #include "caf/detail/shared_spinlock.hpp"
-#include "caf/detail/single_reader_queue.hpp"
 
 /*
  * To enable logging, you have to define CAF_DEBUG. This enables
@@ -48,25 +53,51 @@
  * 3: + debug
  * 4: + trace (prints for each logged method entry and exit message)
  *
+ * At runtime, the logger only writes events up to the verbosity configured
+ * for the component (CAF_LOG_COMPONENT) or the actor that produced them.
+ * Log statements with a disabled level cost a single relaxed atomic load.
+ *
  * Note: this logger emits log4j style output; logs are best viewed
  *       using a log4j viewer, e.g., http://code.google.com/p/otroslogviewer/
  *
  */
 namespace caf {
 
+namespace detail {
+
+struct log_thread_buffer;
+
+} // namespace detail
+
 /// Centrally logs events from all actors in an actor system. To enable
 /// logging in your application, you need to define `CAF_LOG_LEVEL`. Per
 /// default, the logger generates log4j compatible output.
+///
+/// Each thread writes its events to its own lock-free ring buffer. Events
+/// store their metadata in binary form and the logger thread formats them
+/// before writing them to the log file. When a ring buffer is full, the
+/// logger drops new events from that thread and reports the number of
+/// dropped events in the log file instead of blocking the caller.
+///
+/// The verbosity of the logger is adjustable at runtime per component and
+/// per actor. Components form a hierarchy with dots as separators, i.e.,
+/// setting the verbosity of "caf.io" also applies to "caf.io.basp" unless
+/// the latter has a verbosity of its own. Events from an actor with an
+/// individual verbosity pass the filter if they pass either the filter for
+/// their component or the filter for the actor.
+///
+/// Each log statement caches the highest level any logger may accept from
+/// it in a `call_site`. Loggers refresh all cached levels whenever their
+/// filters change, hence a disabled statement never takes a lock even if
+/// other components log at a higher level. Individual actor verbosities
+/// apply to all components and thus raise the cached level of all
+/// statements.
 class logger {
 public:
   friend class actor_system;
 
-  struct event {
-    event* next;
-    event* prev;
-    std::string msg;
-    explicit event(std::string log_message = "");
-  };
+  /// Disables all log output when used as verbosity.
+  static constexpr int quiet = -1;
 
   template <class T>
   struct arg_wrapper {
@@ -116,7 +147,7 @@ public:
 
     line_builder& operator<<(const char* str);
 
-    std::string get() const;
+    const std::string& get() const;
 
   private:
     std::string str_;
@@ -136,11 +167,98 @@ public:
   /// Associates an actor ID to the calling thread and returns the last value.
   actor_id thread_local_aid(actor_id aid);
 
-  /// Writes an entry to the log file.
-  void log(int level, const char* component, const std::string& class_name,
+  /// Writes an entry to the log file. The logger extracts the class name
+  /// from `pretty_fun` and strips the path from `file_name` when writing the
+  /// event, hence all pointers must refer to string literals.
+  void log(int level, const char* component, const char* pretty_fun,
            const char* function_name, const char* file_name,
            int line_num, const std::string& msg);
 
+  /// Returns the number of events dropped because of full buffers.
+  size_t dropped_events() const;
+
+  /// Caches the highest level accepted from a single log statement.
+  class call_site {
+  public:
+    friend class logger;
+
+    constexpr call_site(const char* component)
+        : component_(component),
+          threshold_(unregistered),
+          next_(nullptr) {
+      // nop
+    }
+
+    call_site(const call_site&) = delete;
+    call_site& operator=(const call_site&) = delete;
+
+    /// Returns the component of the log statement.
+    inline const char* component() const {
+      return component_;
+    }
+
+    /// Returns the highest level any logger in this process accepts from
+    /// the log statement.
+    inline int threshold() const {
+      return threshold_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    // forces the first check of a log statement into the slow path,
+    // which registers the call site at all loggers
+    static constexpr int unregistered = std::numeric_limits<int>::max();
+
+    const char* component_;
+    std::atomic<int> threshold_;
+    // intrusive list of all registered call sites
+    call_site* next_;
+  };
+
+  /// Returns whether the logger of the calling thread accepts events with
+  /// `level` from the log statement at `site`. The call site must have
+  /// static storage duration.
+  static inline bool accepts(call_site& site, int level) {
+    // fast path: no logger in this process accepts events with `level`
+    // from this log statement
+    return level <= site.threshold() && accepts_impl(site, level);
+  }
+
+  /// Returns whether the logger of the calling thread accepts events with
+  /// `level` from `component`.
+  static inline bool accepts(int level, const char* component) {
+    // fast path: no logger in this process accepts events with `level`
+    return level <= max_verbosity_.load(std::memory_order_relaxed)
+           && accepts_impl(level, component);
+  }
+
+  /// Checks whether this logger accepts events with `level` from `component`
+  /// produced by the actor currently associated to the calling thread.
+  bool filter(int level, const char* component) const;
+
+  /// Returns the verbosity for components without individual verbosity.
+  int verbosity() const;
+
+  /// Sets the verbosity for components without individual verbosity.
+  void verbosity(int level);
+
+  /// Sets the verbosity for `component` and all of its subcomponents
+  /// without individual verbosity.
+  void component_verbosity(const std::string& component, int level);
+
+  /// Removes the individual verbosity of `component`.
+  void erase_component_verbosity(const std::string& component);
+
+  /// Sets the verbosity for events from the actor with ID `aid`.
+  void actor_verbosity(actor_id aid, int level);
+
+  /// Removes the individual verbosity of the actor with ID `aid`.
+  void erase_actor_verbosity(actor_id aid);
+
+  /// Converts a verbosity name (`quiet`, `error`, `warning`, `info`,
+  /// `debug`, or `trace`) to its numeric value.
+  /// @returns `true` on success, `false` if `name` is invalid.
+  static bool parse_verbosity(const std::string& name, int& level);
+
   ~logger();
 
   /** @cond PRIVATE */
@@ -149,8 +267,10 @@ public:
 
   static logger* current_logger();
 
+  /// Writes an entry to the log file of the current logger. All pointers
+  /// must refer to string literals, see `log`.
   static void log_static(int level, const char* component,
-                         const std::string& class_name,
+                         const char* pretty_fun,
                          const char* function_name,
                          const char* file_name, int line_num,
                          const std::string& msg);
@@ -166,13 +286,55 @@ private:
 
   void stop();
 
+  // checks the filters of the current logger
+  static bool accepts_impl(int level, const char* component);
+
+  // registers `site` on first use and checks the filters of the current logger
+  static bool accepts_impl(call_site& site, int level);
+
+  // recomputes the threshold of `site`, requires a lock on all loggers
+  static void refresh(call_site& site);
+
+  // returns the level for `component` without checking actor verbosities,
+  // requires a lock on the filter settings
+  int component_level(const char* component) const;
+
+  // returns the highest level accepted from `component` by any filter
+  int max_level(const char* component) const;
+
+  // returns the highest level accepted by any filter of this logger
+  int max_level() const;
+
+  // recomputes `max_verbosity_` and the thresholds of all call sites from
+  // all loggers in this process
+  static void update_max_verbosity();
+
+  // configures the filters according to `cfg`
+  void init_filters(const actor_system_config& cfg);
+
+  // returns the buffer of the calling thread, creating it on first use
+  detail::log_thread_buffer& thread_buffer();
+
   actor_system& system_;
-  detail::shared_spinlock aids_lock_;
-  std::unordered_map<std::thread::id, actor_id> aids_;
+  // uniquely identifies this logger in thread-local buffer caches
+  uint64_t id_;
+  size_t buffer_size_;
+  std::atomic<bool> running_;
+  std::atomic<size_t> dropped_;
+  // wakes up the logger thread when new events arrive or on shutdown
+  detail::event_count events_;
   std::thread thread_;
-  std::mutex queue_mtx_;
-  std::condition_variable queue_cv_;
-  detail::single_reader_queue<event> queue_;
+  // guards `buffers_`, only acquired once per thread on its first event
+  std::mutex buffers_mtx_;
+  std::vector<std::shared_ptr<detail::log_thread_buffer>> buffers_;
+  // guards all filter settings
+  mutable detail::shared_spinlock filter_lock_;
+  int verbosity_;
+  // sorted by length in descending order for longest-prefix matching
+  std::vector<std::pair<std::string, int>> component_verbosity_;
+  std::unordered_map<actor_id, int> actor_verbosity_;
+  // highest level accepted by any logger in this process
+  static std::atomic<int> max_verbosity_;
 };
 
 } // namespace caf
@@ -202,11 +364,13 @@ private:
 #define CAF_ARG(argument) caf::logger::make_arg_wrapper(#argument, argument)
 
 #ifdef CAF_MSVC
-#define CAF_GET_CLASS_NAME caf::logger::extract_class_name(__FUNCSIG__)
+#define CAF_PRETTY_FUN __FUNCSIG__
 #else // CAF_MSVC
-#define CAF_GET_CLASS_NAME caf::logger::extract_class_name(__PRETTY_FUNCTION__)
+#define CAF_PRETTY_FUN __PRETTY_FUNCTION__
 #endif // CAF_MSVC
 
+#define CAF_GET_CLASS_NAME caf::logger::extract_class_name(CAF_PRETTY_FUN)
+
 #ifndef CAF_LOG_LEVEL
 
 #define CAF_LOG_IMPL(unused1, unused2)
@@ -226,14 +390,20 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
 
 #else // CAF_LOG_LEVEL
 
+// must expand to a string literal, because the logger thread reads the
+// component name after the log statement returned
 #ifndef CAF_LOG_COMPONENT
 #define CAF_LOG_COMPONENT "caf"
 #endif
 
 #define CAF_LOG_IMPL(loglvl, message)                                          \
-  caf::logger::log_static(loglvl, CAF_LOG_COMPONENT, CAF_GET_CLASS_NAME,       \
-                          __func__, __FILE__, __LINE__,                        \
-                          (caf::logger::line_builder{} << message).get())
+  do {                                                                         \
+    static caf::logger::call_site caf_log_site{"" CAF_LOG_COMPONENT};          \
+    if (caf::logger::accepts(caf_log_site, loglvl))                            \
+      caf::logger::log_static(loglvl, "" CAF_LOG_COMPONENT, CAF_PRETTY_FUN,    \
+                              __func__, "" __FILE__, __LINE__,                 \
+                              (caf::logger::line_builder{} << message).get()); \
+  } while (false)
 
 #define CAF_PUSH_AID(aarg)                                                     \
   auto CAF_UNIFYN(caf_tmp_ptr) = caf::logger::current_logger();                \
@@ -265,11 +435,16 @@ inline caf::actor_id caf_set_aid_dummy() { return 0; }
 
 #define CAF_LOG_TRACE(entry_message)                                           \
   const char* CAF_UNIFYN(func_name_) = __func__;                               \
+  const char* CAF_UNIFYN(pretty_fun_) = CAF_PRETTY_FUN;                        \
+  static caf::logger::call_site CAF_UNIFYN(caf_log_exit_site_){               \
+    "" CAF_LOG_COMPONENT};                                                     \
   CAF_LOG_IMPL(CAF_LOG_LEVEL_TRACE, "ENTRY" << entry_message);                 \
   auto CAF_UNIFYN(caf_log_trace_guard_) = ::caf::detail::make_scope_guard([=] {\
-    caf::logger::log_static(CAF_LOG_LEVEL_TRACE, CAF_LOG_COMPONENT,            \
-                            CAF_GET_CLASS_NAME, CAF_UNIFYN(func_name_),        \
-                            __FILE__, __LINE__, "EXIT");                       \
+    if (caf::logger::accepts(CAF_UNIFYN(caf_log_exit_site_),                   \
+                             CAF_LOG_LEVEL_TRACE))                             \
+      caf::logger::log_static(CAF_LOG_LEVEL_TRACE, "" CAF_LOG_COMPONENT,       \
+                              CAF_UNIFYN(pretty_fun_), CAF_UNIFYN(func_name_), \
+                              "" __FILE__, __LINE__, "EXIT");                  \
   })
 
 #endif // CAF_LOG_LEVEL < CAF_LOG_LEVEL_TRACE
@@ -61,7 +61,40 @@ struct is_serializable_or_whitelisted {
                                 || allowed_unsafe_message_type<T>::value;
 };
 
-/// Returns a new `message` containing the values `(x, xs...)`.
+namespace detail {
+
+/// Computes the types a message stores for the arguments `Ts`.
+template <class... Ts>
+struct message_element_types {
+  using type =
+    type_list<
+      typename unbox_message_element<
+        typename strip_and_convert<Ts>::type
+      >::type...
+    >;
+};
+
+/// Returns a new `message` containing the values `(x, xs...)` without
+/// requiring copyable types. Only for converting content that has a single
+/// owner, such as a mailbox element, into a message.
+template <class T, class... Ts>
+message make_message_unchecked(T&& x, Ts&&... xs) {
+  using stored_types = typename message_element_types<T, Ts...>::type;
+  using storage = typename tl_apply<stored_types, tuple_vals>::type;
+  auto ptr = make_counted<storage>(std::forward<T>(x), std::forward<Ts>(xs)...);
+  return message{message_data::cow_ptr{std::move(ptr)}};
+}
+
+inline message make_message_unchecked() {
+  return message{};
+}
+
+} // namespace detail
+
+/// Returns a new `message` containing the values `(x, xs...)`. Messages
+/// share their content on copy and copy it on write, hence all values must
+/// be copyable. Move-only values can only travel as rvalue argument to
+/// `send`, which passes them to the receiver without a `message` object.
 /// @relates message
 template <class T, class... Ts>
 typename std::enable_if<
@@ -71,15 +104,10 @@ typename std::enable_if<
 >::type
 make_message(T&& x, Ts&&... xs) {
   using namespace caf::detail;
-  using stored_types =
-    type_list<
-      typename unbox_message_element<
-        typename strip_and_convert<T>::type
-      >::type,
-      typename unbox_message_element<
-        typename strip_and_convert<Ts>::type
-      >::type...
-    >;
+  using stored_types = typename message_element_types<T, Ts...>::type;
+  static_assert(tl_forall<stored_types, is_copyable_message_element>::value,
+                "at least one type is move-only; messages may get copied, "
+                "send move-only values as rvalue via send() instead");
   static_assert(tl_forall<stored_types, is_serializable_or_whitelisted>::value,
                 "at least one type is neither inspectable via "
                 "inspect(Inspector&, T&) nor serializable via "
@@ -88,9 +116,7 @@ make_message(T&& x, Ts&&... xs) {
                 "you can whitelist individual types by "
                 "specializing `caf::allowed_unsafe_message_type<T>` "
                 "or using the macro CAF_ALLOW_UNSAFE_MESSAGE_TYPE");
-  using storage = typename tl_apply<stored_types, tuple_vals>::type;
-  auto ptr = make_counted<storage>(std::forward<T>(x), std::forward<Ts>(xs)...);
-  return message{detail::message_data::cow_ptr{std::move(ptr)}};
+  return make_message_unchecked(std::forward<T>(x), std::forward<Ts>(xs)...);
 }
 
 /// Returns a copy of @p other.
@@ -105,10 +131,11 @@ inline message make_message() {
   return message{};
 }
 
+/// Converts the content of a mailbox element into a message.
 struct message_factory {
   template <class... Ts>
   message operator()(Ts&&... xs) const {
-    return make_message(std::forward<Ts>(xs)...);
+    return detail::make_message_unchecked(std::forward<Ts>(xs)...);
   }
 };
 
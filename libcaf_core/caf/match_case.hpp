@@ -145,7 +145,10 @@ public:
 
   using intermediate_pseudo_tuple =
     typename detail::tl_apply<
-      decayed_arg_types,
+      typename detail::tl_map<
+        arg_types,
+        detail::pseudo_tuple_arg
+      >::type,
       detail::pseudo_tuple
     >::type;
 
@@ -48,7 +48,11 @@ public:
   static constexpr uint64_t response_flag_mask = 0x8000000000000000;
   static constexpr uint64_t answered_flag_mask = 0x4000000000000000;
   static constexpr uint64_t high_prioity_flag_mask = 0x2000000000000000;
-  static constexpr uint64_t request_id_mask = 0x1FFFFFFFFFFFFFFF;
+  static constexpr uint64_t system_priority_bits = 0x3000000000000000;
+  static constexpr uint64_t urgent_priority_bits = 0x2800000000000000;
+  static constexpr uint64_t bulk_priority_bits = 0x0800000000000000;
+  static constexpr uint64_t priority_mask = 0x3800000000000000;
+  static constexpr uint64_t request_id_mask = 0x07FFFFFFFFFFFFFF;
 
   constexpr message_id() : value_(0) {
     // nop
@@ -69,7 +73,7 @@ public:
   }
 
   inline bool is_async() const {
-    return value_ == 0 || value_ == high_prioity_flag_mask;
+    return (value_ & ~priority_mask) == 0;
   }
 
   inline bool is_response() const {
@@ -80,10 +84,26 @@ public:
     return (value_ & answered_flag_mask) != 0;
   }
 
+  /// Returns whether this ID has the priority `high` or above.
   inline bool is_high_priority() const {
     return (value_ & high_prioity_flag_mask) != 0;
   }
 
+  inline message_priority priority() const {
+    switch (value_ & priority_mask) {
+      case system_priority_bits:
+        return message_priority::system;
+      case urgent_priority_bits:
+        return message_priority::urgent;
+      case high_prioity_flag_mask:
+        return message_priority::high;
+      case bulk_priority_bits:
+        return message_priority::bulk;
+      default:
+        return message_priority::normal;
+    }
+  }
+
   inline bool valid() const {
     return (value_ & request_id_mask) != 0;
   }
@@ -100,12 +120,16 @@ public:
     return message_id(value_ & request_id_mask);
   }
 
+  inline message_id with_priority(message_priority prio) const {
+    return message_id((value_ & ~priority_mask) | priority_bits(prio));
+  }
+
   inline message_id with_high_priority() const {
-    return message_id(value_ | high_prioity_flag_mask);
+    return with_priority(message_priority::high);
   }
 
   inline message_id with_normal_priority() const {
-    return message_id(value_ & ~high_prioity_flag_mask);
+    return with_priority(message_priority::normal);
   }
 
   inline void mark_as_answered() {
@@ -127,7 +151,7 @@ public:
   }
 
   static constexpr message_id make(message_priority prio) {
-    return prio == message_priority::high ? high_prioity_flag_mask : 0;
+    return priority_bits(prio);
   }
 
   long compare(const message_id& other) const {
@@ -145,6 +169,16 @@ private:
     // nop
   }
 
+  // the high priority flag is set for all priorities above `normal`,
+  // which keeps IDs of `normal` and `high` compatible to previous versions
+  static constexpr uint64_t priority_bits(message_priority prio) {
+    return prio == message_priority::system ? system_priority_bits
+           : prio == message_priority::urgent ? urgent_priority_bits
+           : prio == message_priority::high ? high_prioity_flag_mask
+           : prio == message_priority::bulk ? bulk_priority_bits
+           : 0;
+  }
+
   uint64_t value_;
 };
 
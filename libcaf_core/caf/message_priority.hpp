@@ -20,15 +20,27 @@
 #ifndef CAF_PRIORITY_HPP
 #define CAF_PRIORITY_HPP
 
+#include <cstddef>
 #include <cstdint>
 
 namespace caf {
 
+/// Selects the mailbox lane of a message for actors spawned with
+/// `priority_aware`. Lanes are ordered by urgency, i.e., `system` is the
+/// most urgent lane and `bulk` the least urgent one.
+/// @note The numeric values do not reflect the urgency. A value-initialized
+///       priority is `normal` and `high` keeps its previous value.
 enum class message_priority : uint32_t {
   normal,
-  high
+  high,
+  urgent,
+  system,
+  bulk
 };
 
+/// Number of mailbox lanes of priority-aware actors.
+constexpr size_t message_priorities = 5;
+
 } // namespace caf
 
 #endif // CAF_PRIORITY_HPP
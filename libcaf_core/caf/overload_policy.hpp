@@ -0,0 +1,61 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_OVERLOAD_POLICY_HPP
+#define CAF_OVERLOAD_POLICY_HPP
+
+#include <string>
+#include <cstdint>
+
+#include "caf/atom.hpp"
+
+namespace caf {
+
+/// Selects how an actor with a bounded mailbox handles messages
+/// that arrive while its mailbox is full. Responses, timeouts, as well as
+/// exit and down messages are exempt from all policies.
+enum class overload_policy : uint8_t {
+  /// Drops the new message. Requests receive `sec::mailbox_full`.
+  drop_newest,
+  /// Enqueues the new message and drops the oldest message
+  /// on the next dequeue. Requests receive `sec::mailbox_full`.
+  drop_oldest,
+  /// Drops the new message and sends `sec::mailbox_full` to its sender.
+  reject,
+  /// Enqueues the new message and suspends the sender after its current
+  /// message until the mailbox has room again. Messages from senders that
+  /// cannot be suspended, i.e., anything but event-based actors running in
+  /// the scheduler, and further messages from already suspended senders
+  /// receive the same treatment as with `reject`. Hence, the mailbox never
+  /// exceeds its capacity by more than one message per sender.
+  back_pressure
+};
+
+/// Returns the policy for the configuration value `x`, i.e.,
+/// 'drop-new', 'drop-old', 'reject' or 'back-press'. Falls
+/// back to `drop_newest` for unrecognized values.
+/// @relates overload_policy
+overload_policy to_overload_policy(atom_value x);
+
+/// @relates overload_policy
+std::string to_string(overload_policy x);
+
+} // namespace caf
+
+#endif // CAF_OVERLOAD_POLICY_HPP
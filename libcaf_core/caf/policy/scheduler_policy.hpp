@@ -63,6 +63,10 @@ public:
   template <class Worker>
   resumable* dequeue(Worker* self);
 
+  /// Called by each worker thread before entering its scheduling loop.
+  template <class Worker>
+  void init_worker(Worker* self);
+
   /// Performs cleanup action before a shutdown takes place.
   template <class Worker>
   void before_shutdown(Worker* self);
@@ -34,6 +34,12 @@ class unprofiled {
 public:
   virtual ~unprofiled();
 
+  /// Called by each worker thread before entering its scheduling loop.
+  template <class Worker>
+  void init_worker(Worker*) {
+    // nop
+  }
+
   /// Performs cleanup action before a shutdown takes place.
   template <class Worker>
   void before_shutdown(Worker*) {
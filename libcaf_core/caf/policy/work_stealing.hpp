@@ -21,6 +21,7 @@
 #define CAF_POLICY_WORK_STEALING_HPP
 
 #include <deque>
+#include <vector>
 #include <chrono>
 #include <thread>
 #include <random>
@@ -31,19 +32,23 @@
 
 #include "caf/policy/unprofiled.hpp"
 
+#include "caf/detail/event_count.hpp"
 #include "caf/detail/double_ended_queue.hpp"
+#include "caf/detail/work_stealing_queue.hpp"
 
 namespace caf {
 namespace policy {
 
-/// Implements scheduling of actors via work stealing.
+/// Implements scheduling of actors via work stealing, using `Queue` as job
+/// queue for each worker. `Queue` must provide the member functions `append`
+/// and `take_tail` (callable from any thread) as well as `prepend` and
+/// `take_head` (called only by the worker owning the queue).
 /// @extends scheduler_policy
-class work_stealing : public unprofiled {
+template <class Queue>
+class basic_work_stealing : public unprofiled {
 public:
-  ~work_stealing();
-
   // A thread-safe queue implementation.
-  using queue_type = detail::double_ended_queue<resumable>;
+  using queue_type = Queue;
 
   using usec = std::chrono::microseconds;
 
@@ -55,14 +60,20 @@ public:
     usec sleep_duration;
   };
 
-  // The coordinator has only a counter for round-robin enqueue to its workers.
+  // The coordinator has a counter for round-robin enqueue to its workers
+  // and an event count for parking idle workers.
   struct coordinator_data {
-    inline explicit coordinator_data(scheduler::abstract_coordinator*)
-        : next_worker(0) {
+    inline explicit coordinator_data(scheduler::abstract_coordinator* p)
+        : next_worker(0),
+          parking(p->system().config().work_stealing_poll_strategy
+                  == atom("park")) {
       // nop
     }
 
     std::atomic<size_t> next_worker;
+    // idle workers block on `idle_workers` instead of relaxed polling if set
+    bool parking;
+    detail::event_count idle_workers;
   };
 
   // Holds job job queue of a worker and a random number generator.
@@ -92,8 +103,30 @@ public:
     std::default_random_engine rengine;
     std::uniform_int_distribution<size_t> uniform;
     poll_strategy strategies[3];
+    // other workers grouped by their distance in the memory hierarchy,
+    // nearest first; empty if workers run without CPU affinity
+    std::vector<std::vector<size_t>> victims;
   };
 
+  // Groups all other workers by distance if this worker runs on its
+  // assigned CPU. Otherwise, the distances are meaningless and the worker
+  // picks victims uniformly at random.
+  template <class Worker>
+  void init_worker(Worker* self) {
+    auto& placement = self->parent()->worker_placement();
+    if (placement.empty() || !self->pinned())
+      return;
+    auto& victims = d(self).victims;
+    auto& self_cpu = placement[self->id()];
+    std::vector<size_t> tiers[3];
+    for (size_t i = 0; i < placement.size(); ++i)
+      if (i != self->id())
+        tiers[detail::cpu_distance(self_cpu, placement[i])].push_back(i);
+    for (auto& tier : tiers)
+      if (!tier.empty())
+        victims.emplace_back(std::move(tier));
+  }
+
   // Goes on a raid in quest for a shiny new job.
   template <class Worker>
   resumable* try_steal(Worker* self) {
@@ -102,6 +135,18 @@ public:
       // you can't steal from yourself, can you?
       return nullptr;
     }
+    auto& victims = d(self).victims;
+    if (!victims.empty()) {
+      // raid workers sharing a cache or NUMA node before going remote
+      for (auto& tier : victims) {
+        std::uniform_int_distribution<size_t> pick{0, tier.size() - 1};
+        auto victim = tier[pick(d(self).rengine)];
+        auto job = d(p->worker_by_id(victim)).queue.take_tail();
+        if (job)
+          return job;
+      }
+      return nullptr;
+    }
     // roll the dice to pick a victim other than ourselves
     auto victim = d(self).uniform(d(self).rengine);
     if (victim == self->id())
@@ -110,6 +155,59 @@ public:
     return d(p->worker_by_id(victim)).queue.take_tail();
   }
 
+  // Tries to steal a job from each other worker in turn, nearest first.
+  template <class Worker>
+  resumable* try_steal_any(Worker* self) {
+    auto p = self->parent();
+    auto& victims = d(self).victims;
+    if (!victims.empty()) {
+      // the tiers contain all other workers, i.e., we still visit everyone
+      for (auto& tier : victims) {
+        for (auto victim : tier) {
+          auto job = d(p->worker_by_id(victim)).queue.take_tail();
+          if (job)
+            return job;
+        }
+      }
+      return nullptr;
+    }
+    auto n = p->num_workers();
+    for (size_t i = 1; i < n; ++i) {
+      auto victim = (self->id() + i) % n;
+      auto job = d(p->worker_by_id(victim)).queue.take_tail();
+      if (job)
+        return job;
+    }
+    return nullptr;
+  }
+
+  // Blocks until a job becomes available, only used if parking is enabled.
+  template <class Worker>
+  resumable* park(Worker* self) {
+    auto& idle_workers = d(self->parent()).idle_workers;
+    for (;;) {
+      auto key = idle_workers.prepare_wait();
+      // re-check all queues after announcing ourselves as waiter to make
+      // sure we cannot miss a job that was enqueued in the meantime
+      auto job = d(self).queue.take_head();
+      if (!job)
+        job = try_steal_any(self);
+      if (job) {
+        idle_workers.cancel_wait();
+        return job;
+      }
+      idle_workers.wait(key);
+    }
+  }
+
+  // Wakes up a parked worker if parking is enabled.
+  template <class Worker>
+  void notify_idle_worker(Worker* self) {
+    auto& data = d(self->parent());
+    if (data.parking)
+      data.idle_workers.notify_one();
+  }
+
   template <class Coordinator>
   void central_enqueue(Coordinator* self, resumable* job) {
     auto w = self->worker_by_id(d(self).next_worker++ % self->num_workers());
@@ -119,11 +217,13 @@ public:
   template <class Worker>
   void external_enqueue(Worker* self, resumable* job) {
     d(self).queue.append(job);
+    notify_idle_worker(self);
   }
 
   template <class Worker>
   void internal_enqueue(Worker* self, resumable* job) {
     d(self).queue.prepend(job);
+    notify_idle_worker(self);
   }
 
   template <class Worker>
@@ -141,10 +241,16 @@ public:
     // dequeue attempts, finally we assume pretty much nothing is going
     // on and poll every 10 ms; this strategy strives to minimize the
     // downside of "busy waiting", which still performs much better than a
-    // "signalizing" implementation based on mutexes and conition variables
+    // "signalizing" implementation based on mutexes and conition variables;
+    // however, users can choose to park idle workers instead of relaxed
+    // polling to avoid wasting CPU cycles and sleep-induced latency on
+    // mostly idle nodes
     auto& strategies = d(self).strategies;
+    auto parking = d(self->parent()).parking;
     resumable* job = nullptr;
     for (auto& strat : strategies) {
+      if (parking && &strat == &strategies[2])
+        return park(self);
       for (size_t i = 0; i < strat.attempts; i += strat.step_size) {
         job = d(self).queue.take_head();
         if (job)
@@ -159,8 +265,8 @@ public:
           std::this_thread::sleep_for(strat.sleep_duration);
       }
     }
-    // unreachable, because the last strategy loops
-    // until a job has been dequeued
+    // unreachable, because the last strategy either parks or
+    // loops until a job has been dequeued
     return nullptr;
   }
 
@@ -178,6 +284,24 @@ public:
   }
 };
 
+/// Implements scheduling of actors via work stealing
+/// using spinlocked job queues.
+/// @extends scheduler_policy
+class work_stealing
+    : public basic_work_stealing<detail::double_ended_queue<resumable>> {
+public:
+  ~work_stealing();
+};
+
+/// Implements scheduling of actors via work stealing using lock-free
+/// Chase-Lev deques for all jobs a worker enqueues by itself.
+/// @extends scheduler_policy
+class lock_free_work_stealing
+    : public basic_work_stealing<detail::work_stealing_queue<resumable>> {
+public:
+  ~lock_free_work_stealing();
+};
+
 } // namespace policy
 } // namespace caf
 
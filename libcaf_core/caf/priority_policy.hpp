@@ -0,0 +1,51 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_PRIORITY_POLICY_HPP
+#define CAF_PRIORITY_POLICY_HPP
+
+#include <string>
+#include <cstdint>
+
+#include "caf/atom.hpp"
+
+namespace caf {
+
+/// Selects in which order an actor spawned with `priority_aware` consumes
+/// the lanes of its mailbox.
+enum class priority_policy : uint8_t {
+  /// Always consumes the most urgent non-empty lane first. Messages in
+  /// less urgent lanes starve as long as more urgent messages arrive.
+  strict,
+  /// Consumes lanes round-robin, taking up to 16, 8, 4, 2, and 1 messages
+  /// in a row from the lanes `system` to `bulk`.
+  weighted
+};
+
+/// Returns the policy for the configuration value `x`, i.e.,
+/// 'strict' or 'weighted'. Falls back to `strict` for unrecognized values.
+/// @relates priority_policy
+priority_policy to_priority_policy(atom_value x);
+
+/// @relates priority_policy
+std::string to_string(priority_policy x);
+
+} // namespace caf
+
+#endif // CAF_PRIORITY_POLICY_HPP
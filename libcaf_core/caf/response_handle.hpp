@@ -31,6 +31,7 @@
 #include "caf/typed_continue_helper.hpp"
 
 #include "caf/detail/type_list.hpp"
+#include "caf/detail/response_handler.hpp"
 #include "caf/detail/typed_actor_util.hpp"
 
 namespace caf {
@@ -88,7 +89,8 @@ private:
                   "response handlers are not allowed to have a return "
                   "type other than void");
     detail::type_checker<Output, F>::check();
-    self_->add_awaited_response_handler(mid_, message_handler{std::move(f)});
+    self_->add_awaited_response_handler(
+      mid_, detail::response_handler{std::move(f)});
   }
 
   template <class F, class OnError>
@@ -100,8 +102,8 @@ private:
                   "response handlers are not allowed to have a return "
                   "type other than void");
     detail::type_checker<Output, F>::check();
-    self_->add_awaited_response_handler(mid_, behavior{std::move(f),
-                                                       std::move(ef)});
+    self_->add_awaited_response_handler(
+      mid_, detail::response_handler{std::move(f), std::move(ef)});
   }
 
   template <class F>
@@ -113,7 +115,8 @@ private:
                   "response handlers are not allowed to have a return "
                   "type other than void");
     detail::type_checker<Output, F>::check();
-    self_->add_multiplexed_response_handler(mid_, behavior{std::move(f)});
+    self_->add_multiplexed_response_handler(
+      mid_, detail::response_handler{std::move(f)});
   }
 
   template <class F, class OnError>
@@ -125,8 +128,8 @@ private:
                   "response handlers are not allowed to have a return "
                   "type other than void");
     detail::type_checker<Output, F>::check();
-    self_->add_multiplexed_response_handler(mid_, behavior{std::move(f),
-                                                           std::move(ef)});
+    self_->add_multiplexed_response_handler(
+      mid_, detail::response_handler{std::move(f), std::move(ef)});
   }
 
   message_id mid_;
@@ -26,6 +26,10 @@
 #include <exception>
 #endif // CAF_NO_EXCEPTIONS
 
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <type_traits>
 
 #include "caf/fwd.hpp"
@@ -33,6 +37,8 @@
 #include "caf/extend.hpp"
 #include "caf/local_actor.hpp"
 #include "caf/actor_marker.hpp"
+#include "caf/actor_metrics.hpp"
+#include "caf/overload_policy.hpp"
 #include "caf/response_handle.hpp"
 #include "caf/scheduled_actor.hpp"
 
@@ -40,6 +46,10 @@
 #include "caf/mixin/requester.hpp"
 #include "caf/mixin/behavior_changer.hpp"
 
+#include "caf/detail/batch_handler.hpp"
+#include "caf/detail/response_table.hpp"
+#include "caf/detail/response_handler.hpp"
+
 #include "caf/logger.hpp"
 
 namespace caf {
@@ -72,7 +82,7 @@ public:
   // -- member types -----------------------------------------------------------
 
   /// The message ID of an outstanding response with its callback.
-  using pending_response = std::pair<const message_id, behavior>;
+  using pending_response = std::pair<message_id, detail::response_handler>;
 
   /// A pointer to a scheduled actor.
   using pointer = scheduled_actor*;
@@ -156,6 +166,8 @@ public:
 
   bool cleanup(error&& fail_state, execution_unit* host) override;
 
+  void request_response_timeout(const duration& d, message_id mid) override;
+
   // -- overridden functions of resumable --------------------------------------
 
   subtype_t subtype() const override;
@@ -193,6 +205,45 @@ public:
   ///          blocking API calls such as {@link receive()}.
   void quit(error reason = error{});
 
+  /// Asks this actor to suspend itself after handling its current message
+  /// until a call to `resume_after_back_pressure`. Returns `false` if a
+  /// suspension is already pending. Actors with a bounded mailbox and the
+  /// `back_pressure` policy call this on senders whenever the mailbox is full.
+  /// @threadsafe
+  bool request_suspend();
+
+  /// Reschedules this actor after `request_suspend`. Cancels the suspension
+  /// if the actor did not suspend itself yet.
+  /// @threadsafe
+  void resume_after_back_pressure(execution_unit* ctx);
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the maximum number of pending messages
+  /// or 0 if this actor has an unbounded mailbox.
+  inline size_t mailbox_capacity() const {
+    return mailbox_capacity_;
+  }
+
+  /// Returns the number of pending messages if this actor has a bounded
+  /// mailbox. Returns 0 for actors with an unbounded mailbox, since those
+  /// do not keep track of the number of pending messages.
+  inline size_t mailbox_size() const {
+    return mailbox_size_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the runtime statistics of this actor or `nullptr`
+  /// if `scheduler.enable-actor-metrics` is not set. The actor reports
+  /// dequeued messages once per activation, i.e., the mailbox size of the
+  /// metrics includes messages of a running activation until it ends.
+  inline const actor_metrics_ptr& metrics() const {
+    return metrics_;
+  }
+
+  /// Returns `mailbox_size()` for bounded mailboxes or the mailbox size
+  /// reported by `metrics()` if available, 0 otherwise.
+  size_t mailbox_depth() const override;
+
   // -- event handlers ---------------------------------------------------------
 
   /// Sets a custom handler for unexpected messages.
@@ -270,6 +321,32 @@ public:
   }
 # endif // CAF_NO_EXCEPTIONS
 
+  /// Sets a handler for asynchronous messages that consist of a single `T`.
+  /// Instead of dispatching such messages to the current behavior one at a
+  /// time, the actor collects consecutive matching messages from its mailbox
+  /// and invokes `fun` once with a `std::vector<T>&` holding all of them.
+  /// A batch ends at the first non-matching message or after as many messages
+  /// as the scheduler allows per resume. Requests, responses and messages
+  /// arriving while awaiting a response always use the regular path.
+  /// Priority-aware actors collect a batch only from the mailbox lane of its
+  /// first message and their priority policy counts it as one message.
+  /// Since a batch combines messages from any number of senders,
+  /// `current_sender()` returns `nullptr` inside `fun` and
+  /// `current_mailbox_element()` points to an empty asynchronous element.
+  /// Setting a second handler for the same type replaces the first one.
+  template <class T, class F>
+  void set_batch_handler(F fun) {
+    using impl = detail::batch_handler_impl<T>;
+    std::unique_ptr<detail::batch_handler> ptr{new impl(std::move(fun))};
+    for (auto& x : batch_handlers_) {
+      if (dynamic_cast<impl*>(x.get()) != nullptr) {
+        x = std::move(ptr);
+        return;
+      }
+    }
+    batch_handlers_.emplace_back(std::move(ptr));
+  }
+
   /// @cond PRIVATE
 
   // -- timeout management -----------------------------------------------------
@@ -283,26 +360,70 @@ public:
   /// Returns whether `timeout_id` is currently active.
   bool is_active_timeout(uint32_t timeout_id) const;
 
+  /// Cancels the pending timeout for the request with response ID `mid`.
+  void cancel_response_timeout(message_id mid);
+
   // -- message processing -----------------------------------------------------
 
   /// Adds a callback for an awaited response.
   void add_awaited_response_handler(message_id response_id, behavior bhvr);
 
+  /// Adds a callback for an awaited response.
+  void add_awaited_response_handler(message_id response_id,
+                                    detail::response_handler f);
+
   /// Adds a callback for a multiplexed response.
   void add_multiplexed_response_handler(message_id response_id, behavior bhvr);
 
+  /// Adds a callback for a multiplexed response.
+  void add_multiplexed_response_handler(message_id response_id,
+                                        detail::response_handler f);
+
   /// Returns the category of `x`.
   message_category categorize(mailbox_element& x);
 
   /// Tries to consume `x`.
   invoke_message_result consume(mailbox_element& x);
 
+  /// Implements `consume` and stores the kind of the
+  /// selected message handler in `handler_kind_`.
+  invoke_message_result consume_impl(mailbox_element& x);
+
   /// Tries to consume `x`.
   void consume(mailbox_element_ptr x);
 
   /// Tries to consume one element form the cache using the current behavior.
   bool consume_from_cache();
 
+  /// Applies the overload policy to `x` after it exceeded
+  /// the mailbox capacity. Returns whether `x` gets enqueued.
+  bool handle_overload(mailbox_element& x, execution_unit* ctx);
+
+  /// Updates the size of a bounded mailbox after dequeueing `x`. Returns
+  /// `false` if the overload policy requires to drop `x`, `true` otherwise.
+  bool handle_dequeue(mailbox_element& x);
+
+  /// Suspends the sender of `x` until this actor has room in its mailbox.
+  /// Returns `false` if the sender cannot be suspended.
+  bool suspend_sender(mailbox_element& x, execution_unit* ctx);
+
+  /// Reschedules all senders suspended by `suspend_sender`.
+  void resume_suspended_senders(execution_unit* ctx);
+
+  /// Returns the batch handler for `x` or `nullptr` if `x`
+  /// must go through the regular `consume` path.
+  detail::batch_handler* batch_handler_for(mailbox_element& x);
+
+  /// Moves the content of `x` along with up to `max_batch_size - 1`
+  /// immediately following mailbox elements accepted by `bh` into the
+  /// current batch of `bh` and returns the number of collected messages.
+  size_t collect_batch(detail::batch_handler& bh, mailbox_element_ptr x,
+                       size_t max_batch_size);
+
+  /// Interface for activating an actor with the
+  /// current batch of `bh` after `activate`.
+  activation_result reactivate_batch(detail::batch_handler& bh);
+
   /// Activates an actor and runs initialization code if necessary.
   /// @returns `true` if the actor is alive and ready for `reactivate`,
   ///          `false` otherwise.
@@ -325,11 +446,6 @@ public:
            || !multiplexed_responses_.empty();
   }
 
-  inline behavior& current_behavior() {
-    return !awaited_responses_.empty() ? awaited_responses_.front().second
-                                        : bhvr_stack_.back();
-  }
-
   /// Installs a new behavior without performing any type checks.
   void do_become(behavior bhvr, bool discard_old);
 
@@ -351,11 +467,18 @@ protected:
   /// Identifies the timeout messages we are currently waiting for.
   uint32_t timeout_id_;
 
-  /// Stores callbacks for awaited responses.
-  std::forward_list<pending_response> awaited_responses_;
+  /// Identifies the pending timeout message at the clock service.
+  uint64_t timeout_handle_;
+
+  /// Stores clock service handles of pending request timeouts.
+  detail::response_table<uint64_t> response_timeouts_;
+
+  /// Stores callbacks for awaited responses, the last element is the
+  /// currently awaited response.
+  std::vector<pending_response> awaited_responses_;
 
   /// Stores callbacks for multiplexed responses.
-  std::unordered_map<message_id, behavior> multiplexed_responses_;
+  detail::response_table<detail::response_handler> multiplexed_responses_;
 
   /// Customization point for setting a default `message` callback.
   default_handler default_handler_;
@@ -369,9 +492,43 @@ protected:
   /// Customization point for setting a default `exit_msg` callback.
   exit_handler exit_handler_;
 
+  /// Stores the maximum number of pending messages, 0 means unbounded.
+  size_t mailbox_capacity_;
+
+  /// Selects how to handle messages exceeding `mailbox_capacity_`.
+  overload_policy overload_policy_;
+
+  /// Counts pending messages if `mailbox_capacity_ > 0`.
+  std::atomic<size_t> mailbox_size_;
+
+  /// Stores whether this actor runs normally (0), suspends itself after its
+  /// current message (1) or waits for a receiver to reschedule it (2).
+  std::atomic<int> suspend_state_;
+
+  /// Guards `suspended_senders_`.
+  std::mutex suspended_senders_mtx_;
+
+  /// Stores senders waiting for room in this actor's mailbox.
+  std::vector<strong_actor_ptr> suspended_senders_;
+
+  /// Allows the reader to check `suspended_senders_` without locking.
+  std::atomic<bool> has_suspended_senders_;
+
+  /// Stores user-defined callbacks for batched message handling.
+  std::vector<std::unique_ptr<detail::batch_handler>> batch_handlers_;
+
   /// Pointer to a private thread object associated with a detached actor.
   detail::private_thread* private_thread_;
 
+  /// Collects runtime statistics if enabled, `nullptr` otherwise.
+  actor_metrics_ptr metrics_;
+
+  /// Counts messages taken out of the mailbox during the current activation.
+  size_t dequeued_msgs_;
+
+  /// Stores which kind of handler processed the last message.
+  actor_metrics::handler_kind handler_kind_;
+
 # ifndef CAF_NO_EXCEPTIONS
   /// Customization point for setting a default exception callback.
   exception_handler exception_handler_;
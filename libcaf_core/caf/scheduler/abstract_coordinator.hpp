@@ -22,6 +22,7 @@
 
 #include <chrono>
 #include <atomic>
+#include <vector>
 #include <cstddef>
 
 #include "caf/fwd.hpp"
@@ -32,6 +33,12 @@
 #include "caf/actor_addr.hpp"
 #include "caf/actor_system.hpp"
 
+#include "caf/scheduler/clock_service.hpp"
+
+#include "caf/telemetry/metric.hpp"
+
+#include "caf/detail/cpu_topology.hpp"
+
 namespace caf {
 namespace scheduler {
 
@@ -49,13 +56,19 @@ public:
   /// Puts `what` into the queue of a randomly chosen worker.
   virtual void enqueue(resumable* what) = 0;
 
+  /// Delivers `data` to `to` after `rel_time` and returns a handle
+  /// for cancelling the message via `clock().cancel(...)`.
   template <class Duration, class... Data>
-  void delayed_send(Duration rel_time, strong_actor_ptr from,
-                    strong_actor_ptr to, message_id mid, message data) {
-    timer_->enqueue(nullptr, invalid_message_id,
-                    make_message(duration{rel_time}, std::move(from),
-                                 std::move(to), mid, std::move(data)),
-                    nullptr);
+  clock_service::handle delayed_send(Duration rel_time, strong_actor_ptr from,
+                                     strong_actor_ptr to, message_id mid,
+                                     message data) {
+    return clock_.schedule(duration{rel_time}, std::move(from), std::move(to),
+                           mid, std::move(data));
+  }
+
+  /// Returns the service for delivering delayed messages.
+  inline clock_service& clock() {
+    return clock_;
   }
 
   inline actor_system& system() {
@@ -70,6 +83,22 @@ public:
     return num_workers_;
   }
 
+  /// Counts jobs put into a job queue of this scheduler.
+  inline telemetry::counter& jobs_enqueued() {
+    return *jobs_enqueued_;
+  }
+
+  /// Counts jobs taken out of a job queue of this scheduler.
+  inline telemetry::counter& jobs_resumed() {
+    return *jobs_resumed_;
+  }
+
+  /// Returns the CPU for each worker according to `scheduler.affinity`
+  /// or an empty vector if workers run without CPU affinity.
+  inline const std::vector<detail::cpu_info>& worker_placement() const {
+    return worker_placement_;
+  }
+
   void start() override;
 
   void init(actor_system_config& cfg) override;
@@ -92,9 +121,16 @@ protected:
   // configured number of workers
   size_t num_workers_;
 
-  strong_actor_ptr timer_;
+  // CPU of each worker, empty if `scheduler.affinity` is 'none'
+  std::vector<detail::cpu_info> worker_placement_;
+
+  clock_service clock_;
   strong_actor_ptr printer_;
 
+  // metrics of the system-wide registry
+  telemetry::counter* jobs_enqueued_;
+  telemetry::counter* jobs_resumed_;
+
   actor_system& system_;
 };
 
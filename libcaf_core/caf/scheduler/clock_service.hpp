@@ -0,0 +1,121 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_SCHEDULER_CLOCK_SERVICE_HPP
+#define CAF_SCHEDULER_CLOCK_SERVICE_HPP
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+
+#include "caf/fwd.hpp"
+#include "caf/message.hpp"
+#include "caf/duration.hpp"
+#include "caf/message_id.hpp"
+#include "caf/actor_control_block.hpp"
+
+#include "caf/detail/timer_wheel.hpp"
+
+namespace caf {
+namespace scheduler {
+
+/// Delivers delayed messages using a dedicated thread and a hierarchical
+/// timer wheel. Scheduling and cancelling a message takes constant time
+/// and acquires a lock only for the wheel update, i.e., never while
+/// delivering messages. On each tick, the service collects all due
+/// messages at once and delivers them after releasing the lock.
+class clock_service {
+public:
+  /// Identifies a scheduled message.
+  using handle = uint64_t;
+
+  /// Denotes "no message scheduled", cancelling it has no effect.
+  static constexpr handle invalid_handle = 0;
+
+  using clock_type = std::chrono::steady_clock;
+
+  /// Length of one tick. Messages arrive at most one tick late.
+  using resolution = std::chrono::milliseconds;
+
+  clock_service();
+
+  ~clock_service();
+
+  clock_service(const clock_service&) = delete;
+  clock_service& operator=(const clock_service&) = delete;
+
+  /// Starts the thread of this service.
+  void start();
+
+  /// Stops the thread of this service and drops all pending messages.
+  /// The service cannot restart afterwards.
+  void stop();
+
+  /// Delivers `content` from `from` to `to` after `rel_time`. Drops the
+  /// message and returns `invalid_handle` after `stop()`.
+  /// @threadsafe
+  handle schedule(const duration& rel_time, strong_actor_ptr from,
+                  strong_actor_ptr to, message_id mid, message content);
+
+  /// Drops the pending message identified by `hdl`. Has no effect if
+  /// the message was already delivered or if `hdl == invalid_handle`.
+  /// @threadsafe
+  void cancel(handle hdl);
+
+  /// Returns the number of pending messages.
+  /// @threadsafe
+  size_t pending() const;
+
+private:
+  struct delayed_msg {
+    strong_actor_ptr from;
+    strong_actor_ptr to;
+    message_id mid;
+    message content;
+  };
+
+  using wheel_type = detail::timer_wheel<delayed_msg>;
+
+  // returns the number of ticks passed since starting the service, rounded
+  // down for measuring the current time and up for computing an expiry
+  uint64_t ticks(clock_type::time_point t, bool round_up) const;
+
+  void run();
+
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  // tick the thread currently sleeps until
+  uint64_t wakeup_;
+  bool running_;
+  // rejects new messages once set by `stop()`
+  bool stopped_;
+  clock_type::time_point start_;
+  wheel_type wheel_;
+  // due messages, accessed only by the thread of this service
+  std::vector<delayed_msg> batch_;
+  std::thread thread_;
+};
+
+} // namespace scheduler
+} // namespace caf
+
+#endif // CAF_SCHEDULER_CLOCK_SERVICE_HPP
@@ -130,6 +130,7 @@ protected:
   }
 
   void enqueue(resumable* ptr) override {
+    jobs_enqueued_->inc();
     policy_.central_enqueue(this, ptr);
   }
 
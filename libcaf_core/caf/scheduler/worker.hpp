@@ -20,12 +20,14 @@
 #ifndef CAF_SCHEDULER_WORKER_HPP
 #define CAF_SCHEDULER_WORKER_HPP
 
+#include <thread>
 #include <cstddef>
 
 #include "caf/logger.hpp"
 #include "caf/resumable.hpp"
 #include "caf/execution_unit.hpp"
 
+#include "caf/detail/cpu_topology.hpp"
 #include "caf/detail/double_ended_queue.hpp"
 
 namespace caf {
@@ -46,6 +48,7 @@ public:
       : execution_unit(&worker_parent->system()),
         max_throughput_(throughput),
         id_(worker_id),
+        pinned_(false),
         parent_(worker_parent),
         data_(worker_parent) {
     // nop
@@ -77,6 +80,7 @@ public:
   void exec_later(job_ptr job) override {
     CAF_ASSERT(job != nullptr);
     CAF_LOG_TRACE(CAF_ARG(id()) << CAF_ARG(id_of(job)));
+    parent_->jobs_enqueued().inc();
     policy_.internal_enqueue(this, job);
   }
 
@@ -106,14 +110,29 @@ public:
     return max_throughput_;
   }
 
+  /// Returns whether this worker runs on the CPU assigned to it by
+  /// `parent()->worker_placement()`.
+  bool pinned() const {
+    return pinned_;
+  }
+
 private:
   void run() {
     CAF_SET_LOGGER_SYS(&system());
     CAF_LOG_TRACE(CAF_ARG(id_));
+    auto& placement = parent_->worker_placement();
+    if (!placement.empty()) {
+      pinned_ = detail::set_thread_affinity(placement[id_].id);
+      if (!pinned_)
+        CAF_LOG_WARNING("unable to pin worker to CPU, steal without tiers:"
+                        << CAF_ARG(id_) << CAF_ARG(placement[id_].id));
+    }
+    policy_.init_worker(this);
     // scheduling loop
     for (;;) {
       auto job = policy_.dequeue(this);
       CAF_ASSERT(job != nullptr);
+      parent_->jobs_resumed().inc();
       CAF_ASSERT(job->subtype() != resumable::io_actor);
       CAF_LOG_DEBUG("resume actor:" << CAF_ARG(id_of(job)));
       CAF_PUSH_AID_FROM_PTR(dynamic_cast<abstract_actor*>(job));
@@ -123,6 +142,7 @@ private:
       switch (res) {
         case resumable::resume_later: {
           // keep reference to this actor, as it remains in the "loop"
+          parent_->jobs_enqueued().inc();
           policy_.resume_job_later(this, job);
           break;
         }
@@ -150,6 +170,8 @@ private:
   std::thread this_thread_;
   // the worker's ID received from scheduler
   size_t id_;
+  // stores whether this worker runs on its assigned CPU
+  bool pinned_;
   // pointer to central coordinator
   coordinator_ptr parent_;
   // policy-specific data
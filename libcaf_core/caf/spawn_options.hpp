@@ -36,7 +36,8 @@ enum class spawn_options : int {
   detach_flag = 0x04,
   hide_flag = 0x08,
   priority_aware_flag = 0x20,
-  lazy_init_flag = 0x40
+  lazy_init_flag = 0x40,
+  bounded_mailbox_flag = 0x80
 };
 #endif
 
@@ -65,7 +66,8 @@ constexpr spawn_options detached = spawn_options::detach_flag;
 /// Causes the runtime to ignore the new actor in `await_all_actors_done()`.
 constexpr spawn_options hidden = spawn_options::hide_flag;
 
-/// Causes the new actor to evaluate message priorities.
+/// Causes the new actor to evaluate message priorities by sorting its
+/// mailbox into one lane per `message_priority`.
 /// @note This implicitly causes the actor to run in its own thread.
 constexpr spawn_options priority_aware = spawn_options::priority_aware_flag;
 
@@ -73,6 +75,11 @@ constexpr spawn_options priority_aware = spawn_options::priority_aware_flag;
 /// initialization until a message arrives.
 constexpr spawn_options lazy_init = spawn_options::lazy_init_flag;
 
+/// Causes the new actor to limit its mailbox to `mailbox.capacity` messages
+/// and to apply `mailbox.overload-policy` to any message exceeding it.
+/// @note Only applies to event-based actors.
+constexpr spawn_options bounded_mailbox = spawn_options::bounded_mailbox_flag;
+
 /// Checks wheter `haystack` contains `needle`.
 /// @relates spawn_options
 constexpr bool has_spawn_option(spawn_options haystack, spawn_options needle) {
@@ -115,6 +122,12 @@ constexpr bool has_lazy_init_flag(spawn_options opts) {
   return has_spawn_option(opts, lazy_init);
 }
 
+/// Checks wheter the {@link bounded_mailbox} flag is set in `opts`.
+/// @relates spawn_options
+constexpr bool has_bounded_mailbox_flag(spawn_options opts) {
+  return has_spawn_option(opts, bounded_mailbox);
+}
+
 /// @}
 
 /// @cond PRIVATE
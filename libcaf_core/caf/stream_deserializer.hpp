@@ -33,6 +33,7 @@
 #include "caf/sec.hpp"
 #include "caf/logger.hpp"
 #include "caf/deserializer.hpp"
+#include "caf/binary_encoding.hpp"
 
 #include "caf/detail/ieee_754.hpp"
 #include "caf/detail/network_order.hpp"
@@ -77,8 +78,18 @@ public:
       streambuf_(std::forward<S>(sb)) {
   }
 
+  /// Returns the wire format for integers and atoms.
+  binary_encoding encoding() const {
+    return encoding_;
+  }
+
+  /// Sets the wire format for integers and atoms.
+  void encoding(binary_encoding x) {
+    encoding_ = x;
+  }
+
   error begin_object(uint16_t& typenr, std::string& name) override {
-    return error::eval([&] { return apply_int(typenr); },
+    return error::eval([&] { return apply(typenr); },
                        [&] { return typenr == 0 ? apply(name) : error{}; });
   }
 
@@ -105,7 +116,7 @@ protected:
   template <class T>
   error varbyte_decode(T& x) {
     static_assert(std::is_unsigned<T>::value, "T must be an unsigned type");
-    T n = 0;
+    size_t n = 0;
     x = 0;
     uint8_t low7;
     do {
@@ -113,8 +124,11 @@ protected:
        using traits = typename streambuf_type::traits_type;
        if (traits::eq_int_type(c, traits::eof()))
          return sec::end_of_stream;
+      // reject sequences that exceed the number of bits in T
+      if (7 * n >= sizeof(T) * 8)
+        return sec::invalid_argument;
       low7 = static_cast<uint8_t>(traits::to_char_type(c));
-      x |= static_cast<T>((low7 & 0x7F) << (7 * n));
+      x |= static_cast<T>(static_cast<T>(low7 & 0x7F) << (7 * n));
       ++n;
     } while (low7 & 0x80);
     return none;
@@ -127,14 +141,19 @@ protected:
         CAF_ASSERT(type == i8_v || type == u8_v);
         return apply_raw(sizeof(uint8_t), val);
       case i16_v:
+        return apply_signed(*reinterpret_cast<int16_t*>(val));
       case u16_v:
-        return apply_int(*reinterpret_cast<uint16_t*>(val));
+        return apply_unsigned(*reinterpret_cast<uint16_t*>(val));
       case i32_v:
+        return apply_signed(*reinterpret_cast<int32_t*>(val));
       case u32_v:
-        return apply_int(*reinterpret_cast<uint32_t*>(val));
+        return apply_unsigned(*reinterpret_cast<uint32_t*>(val));
       case i64_v:
+        return apply_signed(*reinterpret_cast<int64_t*>(val));
       case u64_v:
-        return apply_int(*reinterpret_cast<uint64_t*>(val));
+        return apply_unsigned(*reinterpret_cast<uint64_t*>(val));
+      case atom_v:
+        return apply_atom(*reinterpret_cast<atom_value*>(val));
       case float_v:
         return apply_float(*reinterpret_cast<float*>(val));
       case double_v:
@@ -199,6 +218,52 @@ private:
     return none;
   }
 
+  template <class T>
+  error apply_unsigned(T& x) {
+    if (encoding_ == binary_encoding::fixed)
+      return apply_int(x);
+    return varbyte_decode(x);
+  }
+
+  template <class T>
+  error apply_signed(T& x) {
+    using unsigned_type = typename std::make_unsigned<T>::type;
+    unsigned_type y = 0;
+    auto e = encoding_ == binary_encoding::fixed ? apply_int(y)
+                                                 : varbyte_decode(y);
+    if (e)
+      return e;
+    if (encoding_ != binary_encoding::fixed)
+      y = static_cast<unsigned_type>((y >> 1) ^ (~(y & 1) + 1));
+    x = static_cast<T>(y);
+    return none;
+  }
+
+  error apply_atom(atom_value& x) {
+    uint64_t y = 0;
+    auto e = apply_unsigned(y);
+    if (e)
+      return e;
+    if (encoding_ == binary_encoding::compact) {
+      // restore the 0xF prefix from the single bit preceding the characters
+      // (see stream_serializer), 0 denotes a fixed-width value
+      if (y == 0) {
+        e = apply_int(y);
+        if (e)
+          return e;
+      } else {
+        size_t n = 0;
+        while (n < 10 && (y >> (n * 6)) > 1)
+          ++n;
+        if ((y >> (n * 6)) != 1)
+          return sec::invalid_argument;
+        y = (y & ~(uint64_t{1} << (n * 6))) | (uint64_t{0xF} << (n * 6));
+      }
+    }
+    x = static_cast<atom_value>(y);
+    return none;
+  }
+
   template <class T>
   error apply_float(T& x) {
     typename detail::ieee_754_trait<T>::packed_type tmp = 0;
@@ -210,6 +275,7 @@ private:
   }
 
   Streambuf streambuf_;
+  binary_encoding encoding_ = binary_encoding::fixed;
 };
 
 } // namespace caf
@@ -32,6 +32,7 @@
 #include "caf/sec.hpp"
 #include "caf/streambuf.hpp"
 #include "caf/serializer.hpp"
+#include "caf/binary_encoding.hpp"
 
 #include "caf/detail/ieee_754.hpp"
 #include "caf/detail/network_order.hpp"
@@ -74,6 +75,16 @@ public:
       streambuf_(std::forward<S>(sb)) {
   }
 
+  /// Returns the wire format for integers and atoms.
+  binary_encoding encoding() const {
+    return encoding_;
+  }
+
+  /// Sets the wire format for integers and atoms.
+  void encoding(binary_encoding x) {
+    encoding_ = x;
+  }
+
   error begin_object(uint16_t& typenr, std::string& name) override {
     return error::eval([&] { return apply(typenr); },
                        [&] { return typenr == 0 ? apply(name) : error{}; });
@@ -128,14 +139,19 @@ protected:
         CAF_ASSERT(type == i8_v || type == u8_v);
         return apply_raw(sizeof(uint8_t), val);
       case i16_v:
+        return apply_signed(*reinterpret_cast<int16_t*>(val));
       case u16_v:
-        return apply_int(*reinterpret_cast<uint16_t*>(val));
+        return apply_unsigned(*reinterpret_cast<uint16_t*>(val));
       case i32_v:
+        return apply_signed(*reinterpret_cast<int32_t*>(val));
       case u32_v:
-        return apply_int(*reinterpret_cast<uint32_t*>(val));
+        return apply_unsigned(*reinterpret_cast<uint32_t*>(val));
       case i64_v:
+        return apply_signed(*reinterpret_cast<int64_t*>(val));
       case u64_v:
-        return apply_int(*reinterpret_cast<uint64_t*>(val));
+        return apply_unsigned(*reinterpret_cast<uint64_t*>(val));
+      case atom_v:
+        return apply_atom(*reinterpret_cast<atom_value*>(val));
       case float_v:
         return apply_int(detail::pack754(*reinterpret_cast<float*>(val)));
       case double_v:
@@ -184,7 +200,46 @@ private:
     return apply_raw(sizeof(T), &y);
   }
 
+  template <class T>
+  error apply_unsigned(T x) {
+    if (encoding_ == binary_encoding::fixed)
+      return apply_int(x);
+    return varbyte_encode(x);
+  }
+
+  template <class T>
+  error apply_signed(T x) {
+    using unsigned_type = typename std::make_unsigned<T>::type;
+    auto y = static_cast<unsigned_type>(x);
+    if (encoding_ == binary_encoding::fixed)
+      return apply_int(y);
+    // zigzag encoding maps small negative values to small unsigned values
+    auto sign = static_cast<unsigned_type>(x >> (sizeof(T) * 8 - 1));
+    return varbyte_encode(static_cast<unsigned_type>((y << 1) ^ sign));
+  }
+
+  error apply_atom(atom_value x) {
+    auto y = static_cast<uint64_t>(x);
+    if (encoding_ != binary_encoding::compact)
+      return apply_unsigned(y);
+    // atoms consist of the prefix 0xF followed by 6 bits per character,
+    // we replace the prefix with a single bit and write 0 followed by
+    // the fixed-width value for atoms not created by `atom()`
+    size_t n = 0;
+    while (n <= 10 && (y >> (n * 6)) != 0xF)
+      ++n;
+    if (n > 10) {
+      uint8_t tag = 0;
+      return error::eval([&] { return apply_raw(1, &tag); },
+                         [&] { return apply_int(y); });
+    }
+    auto chars = n == 0 ? 0 : y & (std::numeric_limits<uint64_t>::max()
+                                   >> (64 - n * 6));
+    return varbyte_encode(chars | (uint64_t{1} << (n * 6)));
+  }
+
   Streambuf streambuf_;
+  binary_encoding encoding_ = binary_encoding::fixed;
 };
 
 } // namespace caf
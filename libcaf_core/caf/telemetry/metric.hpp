@@ -0,0 +1,201 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_TELEMETRY_METRIC_HPP
+#define CAF_TELEMETRY_METRIC_HPP
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "caf/config.hpp"
+
+namespace caf {
+namespace telemetry {
+
+/// Number of shards per counter and histogram. Threads map to shards
+/// round-robin, i.e., threads only share a shard if there are more threads
+/// than shards.
+constexpr size_t num_shards = 16;
+
+/// Returns the index of the next thread in round-robin order.
+size_t next_shard();
+
+/// Returns the shard of the calling thread.
+inline size_t this_shard() {
+  static thread_local size_t result = next_shard();
+  return result;
+}
+
+/// A cache-line aligned integer for avoiding false sharing between shards.
+template <class T>
+struct padded_atomic {
+  std::atomic<T> value;
+  char pad[CAF_CACHE_LINE_SIZE - sizeof(std::atomic<T>)];
+
+  padded_atomic() : value(0) {
+    // nop
+  }
+};
+
+/// Base class for all metrics of a `metric_registry`.
+class metric {
+public:
+  enum metric_type {
+    counter_type,
+    gauge_type,
+    histogram_type
+  };
+
+  /// @param name Metric name as shown to Prometheus, e.g., `caf_foo_total`.
+  /// @param help Human-readable description of the metric.
+  /// @param labels Comma-separated key-value pairs, e.g., `peer="..."`.
+  metric(metric_type type, std::string name, std::string help,
+         std::string labels);
+
+  virtual ~metric();
+
+  inline metric_type type() const {
+    return type_;
+  }
+
+  inline const std::string& name() const {
+    return name_;
+  }
+
+  inline const std::string& help() const {
+    return help_;
+  }
+
+  inline const std::string& labels() const {
+    return labels_;
+  }
+
+  /// Appends all samples of this metric in the text exposition format.
+  virtual void render(std::string& out) const = 0;
+
+  /// Returns the name of `x` as used in `# TYPE` lines.
+  static const char* name_of(metric_type x);
+
+protected:
+  /// Appends `name_suffix{labels,extra_label}` to `out`.
+  void render_name(std::string& out, const char* suffix,
+                   const std::string& extra_label = std::string{}) const;
+
+private:
+  metric_type type_;
+  std::string name_;
+  std::string help_;
+  std::string labels_;
+};
+
+/// A monotonically increasing value. Increments only touch the shard of
+/// the calling thread and thus scale with the number of writers.
+class counter : public metric {
+public:
+  counter(std::string name, std::string help, std::string labels);
+
+  /// Increments the counter by `n`.
+  inline void inc(uint64_t n = 1) {
+    shards_[this_shard()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  /// Returns the sum of all shards.
+  uint64_t value() const;
+
+  void render(std::string& out) const override;
+
+private:
+  std::array<padded_atomic<uint64_t>, num_shards> shards_;
+};
+
+/// A value that can go up and down. Gauges either hold a value or compute
+/// it on each scrape via a callback, e.g., for exporting sizes of queues
+/// that already track their size anyway.
+class gauge : public metric {
+public:
+  friend class metric_registry;
+
+  using callback = std::function<int64_t ()>;
+
+  gauge(std::string name, std::string help, std::string labels,
+        callback f = nullptr);
+
+  inline void inc(int64_t n = 1) {
+    value_.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  inline void dec(int64_t n = 1) {
+    value_.fetch_sub(n, std::memory_order_relaxed);
+  }
+
+  inline void set(int64_t x) {
+    value_.store(x, std::memory_order_relaxed);
+  }
+
+  /// Returns the result of the callback if present, the stored value otherwise.
+  int64_t value() const;
+
+  void render(std::string& out) const override;
+
+private:
+  std::atomic<int64_t> value_;
+  callback f_;
+};
+
+/// Samples observations into buckets with configurable, inclusive upper
+/// bounds plus an implicit `+Inf` bucket.
+class histogram : public metric {
+public:
+  histogram(std::string name, std::string help, std::string labels,
+            std::vector<uint64_t> upper_bounds);
+
+  /// Counts `x` in the first bucket with an upper bound >= `x`.
+  void observe(uint64_t x);
+
+  inline const std::vector<uint64_t>& upper_bounds() const {
+    return bounds_;
+  }
+
+  /// Returns the (non-cumulative) counts of all buckets, including `+Inf`.
+  std::vector<uint64_t> buckets() const;
+
+  /// Returns the sum of all observed values.
+  uint64_t sum() const;
+
+  void render(std::string& out) const override;
+
+private:
+  struct shard {
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+    padded_atomic<uint64_t> sum;
+  };
+
+  std::vector<uint64_t> bounds_;
+  std::array<shard, num_shards> shards_;
+};
+
+} // namespace telemetry
+} // namespace caf
+
+#endif // CAF_TELEMETRY_METRIC_HPP
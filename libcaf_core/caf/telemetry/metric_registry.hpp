@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_TELEMETRY_METRIC_REGISTRY_HPP
+#define CAF_TELEMETRY_METRIC_REGISTRY_HPP
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "caf/telemetry/metric.hpp"
+
+namespace caf {
+namespace telemetry {
+
+/// Owns all metrics of an actor system and renders them in the text
+/// exposition format of Prometheus. Adding a metric with a name and
+/// labels that already exist returns the existing instance, hence
+/// components may register shared metrics independently. References to
+/// metrics remain valid until calling `erase` or destroying the registry.
+class metric_registry {
+public:
+  metric_registry();
+
+  ~metric_registry();
+
+  metric_registry(const metric_registry&) = delete;
+  metric_registry& operator=(const metric_registry&) = delete;
+
+  /// Returns the counter for `name` and `labels`, creating it if needed.
+  counter& add_counter(std::string name, std::string help,
+                       std::string labels = std::string{});
+
+  /// Returns the gauge for `name` and `labels`, creating it if needed.
+  gauge& add_gauge(std::string name, std::string help,
+                   std::string labels = std::string{});
+
+  /// Returns a gauge for `name` and `labels` that calls `f` on each scrape.
+  /// Replaces the callback of an existing gauge.
+  gauge& add_gauge(std::string name, std::string help, gauge::callback f,
+                   std::string labels = std::string{});
+
+  /// Returns the histogram for `name` and `labels`, creating it if needed.
+  histogram& add_histogram(std::string name, std::string help,
+                           std::vector<uint64_t> upper_bounds,
+                           std::string labels = std::string{});
+
+  /// Removes `x` from the registry, invalidating all references to it.
+  void erase(const metric& x);
+
+  /// Returns the number of registered metrics.
+  size_t size() const;
+
+  /// Appends all metrics in the text exposition format to `out`.
+  void render(std::string& out) const;
+
+  /// Returns all metrics in the text exposition format.
+  std::string render() const;
+
+private:
+  metric* find(const std::string& name, const std::string& labels) const;
+
+  // inserts `x` after all metrics with the same name, takes ownership of `x`
+  void insert_impl(metric* x);
+
+  void erase_impl(const metric& x);
+
+  template <class T, class... Ts>
+  T& get_or_add(metric::metric_type type, std::string name, std::string help,
+                std::string labels, Ts&&... xs);
+
+  mutable std::mutex mtx_;
+  // ordered by name to render all metrics of a family in a single group
+  std::vector<std::unique_ptr<metric>> metrics_;
+};
+
+} // namespace telemetry
+} // namespace caf
+
+#endif // CAF_TELEMETRY_METRIC_REGISTRY_HPP
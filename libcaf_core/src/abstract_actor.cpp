@@ -79,6 +79,10 @@ std::set<std::string> abstract_actor::message_types() const {
   return std::set<std::string>{};
 }
 
+size_t abstract_actor::mailbox_depth() const {
+  return 0;
+}
+
 actor_id abstract_actor::id() const noexcept {
   return actor_control_block::from(this)->id();
 }
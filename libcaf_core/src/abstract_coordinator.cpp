@@ -29,8 +29,6 @@
 #include <condition_variable>
 
 #include "caf/send.hpp"
-#include "caf/after.hpp"
-#include "caf/others.hpp"
 #include "caf/duration.hpp"
 #include "caf/actor_system.hpp"
 #include "caf/scoped_actor.hpp"
@@ -54,81 +52,6 @@ namespace scheduler {
 
 namespace {
 
-using hrc = std::chrono::high_resolution_clock;
-
-class timer_actor : public blocking_actor {
-public:
-  explicit timer_actor(actor_config& cfg) : blocking_actor(cfg) {
-    // nop
-  }
-
-  struct delayed_msg {
-    strong_actor_ptr from;
-    strong_actor_ptr to;
-    message_id mid;
-    message msg;
-  };
-
-  void deliver(delayed_msg& dm) {
-    dm.to->enqueue(dm.from, dm.mid, std::move(dm.msg), nullptr);
-  }
-
-  template <class Map, class... Ts>
-  void insert_dmsg(Map& storage, const duration& d, Ts&&... xs) {
-    auto tout = hrc::now();
-    tout += d;
-    delayed_msg dmsg{std::forward<Ts>(xs)...};
-    storage.emplace(std::move(tout), std::move(dmsg));
-  }
-
-  void act() override {
-    // local state
-    accept_one_cond rc;
-    bool running = true;
-    std::multimap<hrc::time_point, delayed_msg> messages;
-    // our message handler
-    behavior nested{
-      [&](const duration& d, strong_actor_ptr& from,
-          strong_actor_ptr& to, message_id mid, message& msg) {
-        insert_dmsg(messages, d, std::move(from),
-                    std::move(to), mid, std::move(msg));
-      },
-      [&](const exit_msg& dm) {
-        if (dm.reason) {
-          fail_state(dm.reason);
-          running = false;
-        }
-      }
-    };
-    auto bhvr = detail::make_blocking_behavior(
-      &nested,
-      others >> [&](message_view& x) -> result<message> {
-        std::cerr << "*** unexpected message in timer_actor: "
-                  << to_string(x.content()) << std::endl;
-        return sec::unexpected_message;
-      }
-    );
-    // loop until receiving an exit message
-    while (running) {
-      if (messages.empty()) {
-        // use regular receive as long as we don't have a pending timeout
-        receive_impl(rc, message_id::make(), bhvr);
-      } else {
-        auto tout = messages.begin()->first;
-        if (await_data(tout)) {
-          receive_impl(rc, message_id::make(), bhvr);
-        } else {
-          auto it = messages.begin();
-          while (it != messages.end() && (it->first) <= tout) {
-            deliver(it->second);
-            it = messages.erase(it);
-          }
-        }
-      }
-    }
-  }
-};
-
 using string_sink = std::function<void (std::string&&)>;
 
 // the first value is the use count, the last ostream_handle that
@@ -307,13 +230,17 @@ actor abstract_coordinator::printer() const {
 void abstract_coordinator::start() {
   CAF_LOG_TRACE("");
   // launch utility actors
-  timer_ = actor_cast<strong_actor_ptr>(system_.spawn<timer_actor, hidden + detached>());
+  clock_.start();
   printer_ = actor_cast<strong_actor_ptr>(system_.spawn<hidden + detached>(printer_loop));
 }
 
 void abstract_coordinator::init(actor_system_config& cfg) {
   max_throughput_ = cfg.scheduler_max_throughput;
   num_workers_ = cfg.scheduler_max_threads;
+  if (cfg.scheduler_affinity != atom("none"))
+    worker_placement_ = detail::place_workers(detail::get_cpu_topology(),
+                                              num_workers_,
+                                              cfg.scheduler_affinity);
 }
 
 actor_system::module::id_t abstract_coordinator::id() const {
@@ -327,9 +254,9 @@ void* abstract_coordinator::subtype_ptr() {
 void abstract_coordinator::stop_actors() {
   CAF_LOG_TRACE("");
   scoped_actor self{system_, true};
-  anon_send_exit(timer_, exit_reason::user_shutdown);
+  clock_.stop();
   anon_send_exit(printer_, exit_reason::user_shutdown);
-  self->wait_for(timer_, printer_);
+  self->wait_for(printer_);
 }
 
 abstract_coordinator::abstract_coordinator(actor_system& sys)
@@ -337,7 +264,21 @@ abstract_coordinator::abstract_coordinator(actor_system& sys)
       max_throughput_(0),
       num_workers_(0),
       system_(sys) {
-  // nop
+  auto& reg = sys.metrics();
+  jobs_enqueued_ = &reg.add_counter("caf_scheduler_jobs_enqueued_total",
+                                    "Number of jobs put into a job queue.");
+  jobs_resumed_ = &reg.add_counter("caf_scheduler_jobs_resumed_total",
+                                   "Number of jobs taken out of a job queue.");
+  auto enqueued = jobs_enqueued_;
+  auto resumed = jobs_resumed_;
+  reg.add_gauge("caf_scheduler_queued_jobs",
+                "Number of jobs waiting in a job queue.",
+                [enqueued, resumed]() -> int64_t {
+                  // read `resumed` first to never observe more resumed jobs
+                  auto n = resumed->value();
+                  auto m = enqueued->value();
+                  return m > n ? static_cast<int64_t>(m - n) : 0;
+                });
 }
 
 void abstract_coordinator::cleanup_and_release(resumable* ptr) {
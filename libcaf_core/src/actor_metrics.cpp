@@ -0,0 +1,159 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/actor_metrics.hpp"
+
+#include <limits>
+
+namespace caf {
+
+constexpr size_t actor_metrics::num_handler_kinds;
+
+constexpr size_t actor_metrics::num_latency_buckets;
+
+constexpr uint64_t actor_metrics::sample_interval;
+
+// -- snapshot -----------------------------------------------------------------
+
+uint64_t actor_metrics_snapshot::processed() const {
+  uint64_t result = 0;
+  for (auto x : handled)
+    result += x;
+  return result;
+}
+
+uint64_t actor_metrics_snapshot::processing_ns() const {
+  uint64_t result = 0;
+  for (auto x : handler_ns)
+    result += x;
+  return result;
+}
+
+double actor_metrics_snapshot::enqueue_rate() const {
+  if (uptime_ns == 0)
+    return 0.;
+  return static_cast<double>(enqueued) * 1e9 / static_cast<double>(uptime_ns);
+}
+
+double actor_metrics_snapshot::dequeue_rate() const {
+  if (uptime_ns == 0)
+    return 0.;
+  return static_cast<double>(dequeued) * 1e9 / static_cast<double>(uptime_ns);
+}
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+actor_metrics::actor_metrics(actor_id aid)
+    : id_(aid),
+      name_("actor"),
+      start_(clock_type::now()),
+      ticks_(0),
+      enqueued_(0),
+      dequeued_(0) {
+  for (auto& x : handled_)
+    x = 0;
+  for (auto& x : handler_ns_)
+    x = 0;
+  for (auto& x : latency_)
+    x = 0;
+}
+
+actor_metrics::~actor_metrics() {
+  // nop
+}
+
+// -- event handlers -----------------------------------------------------------
+
+void actor_metrics::processed(handler_kind kind, clock_type::duration t,
+                              size_t n) {
+  CAF_ASSERT(kind < num_handler_kinds);
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  auto ns = static_cast<uint64_t>(duration_cast<nanoseconds>(t).count());
+  inc(handled_[kind], n);
+  // each sample stands for `sample_interval` activations
+  inc(handler_ns_[kind], ns * sample_interval);
+  // a batch counts as a single activation of the actor
+  inc(latency_[latency_bucket(ns)], 1);
+}
+
+// -- observers ----------------------------------------------------------------
+
+uint64_t actor_metrics::mailbox_size() const {
+  // read dequeued first for the same reason as in `snapshot`
+  auto dequeued = dequeued_.load(std::memory_order_relaxed);
+  auto enqueued = enqueued_.load(std::memory_order_relaxed);
+  return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+actor_metrics_snapshot actor_metrics::snapshot() const {
+  auto load = [](const counter& x) {
+    return x.load(std::memory_order_relaxed);
+  };
+  actor_metrics_snapshot result;
+  result.id = id_;
+  result.name = name_;
+  // read dequeued first, otherwise a concurrent reader could observe
+  // more dequeued than enqueued messages
+  result.dequeued = load(dequeued_);
+  result.enqueued = load(enqueued_);
+  result.mailbox_size = result.enqueued > result.dequeued
+                        ? result.enqueued - result.dequeued
+                        : 0;
+  for (auto& x : handled_)
+    result.handled.push_back(load(x));
+  for (auto& x : handler_ns_)
+    result.handler_ns.push_back(load(x));
+  for (auto& x : latency_)
+    result.latency_histogram.push_back(load(x));
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  auto uptime = duration_cast<nanoseconds>(clock_type::now() - start_);
+  result.uptime_ns = static_cast<uint64_t>(uptime.count());
+  return result;
+}
+
+size_t actor_metrics::latency_bucket(uint64_t ns) {
+  auto us = ns / 1000;
+  size_t result = 0;
+  while (us > 0 && result < num_latency_buckets - 1) {
+    us >>= 1;
+    ++result;
+  }
+  return result;
+}
+
+uint64_t actor_metrics::latency_bucket_bound(size_t i) {
+  if (i >= num_latency_buckets - 1)
+    return std::numeric_limits<uint64_t>::max();
+  return uint64_t{1000} << i;
+}
+
+const char* actor_metrics::name_of(handler_kind x) {
+  static constexpr const char* names[] = {
+    "behavior",
+    "response",
+    "default",
+    "system",
+    "batch"
+  };
+  return x < num_handler_kinds ? names[x] : "invalid";
+}
+
+} // namespace caf
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/actor_metrics_registry.hpp"
+
+#include <algorithm>
+
+#include "caf/locks.hpp"
+
+namespace caf {
+
+namespace {
+
+using exclusive_guard = unique_lock<detail::shared_spinlock>;
+using shared_guard = shared_lock<detail::shared_spinlock>;
+
+} // namespace <anonymous>
+
+actor_metrics_ptr actor_metrics_registry::get(actor_id key) const {
+  shared_guard guard{mtx_};
+  auto i = entries_.find(key);
+  if (i != entries_.end())
+    return i->second;
+  return nullptr;
+}
+
+void actor_metrics_registry::put(actor_id key, actor_metrics_ptr value) {
+  if (!value)
+    return;
+  exclusive_guard guard{mtx_};
+  entries_[key] = std::move(value);
+}
+
+void actor_metrics_registry::erase(actor_id key) {
+  exclusive_guard guard{mtx_};
+  entries_.erase(key);
+}
+
+size_t actor_metrics_registry::size() const {
+  shared_guard guard{mtx_};
+  return entries_.size();
+}
+
+optional<actor_metrics_snapshot>
+actor_metrics_registry::snapshot(actor_id key) const {
+  auto ptr = get(key);
+  if (!ptr)
+    return none;
+  return ptr->snapshot();
+}
+
+std::vector<actor_metrics_snapshot> actor_metrics_registry::snapshot() const {
+  // copy the pointers first to not block actors during snapshotting
+  std::vector<actor_metrics_ptr> ptrs;
+  { // lifetime scope of guard
+    shared_guard guard{mtx_};
+    ptrs.reserve(entries_.size());
+    for (auto& kvp : entries_)
+      ptrs.push_back(kvp.second);
+  }
+  std::sort(ptrs.begin(), ptrs.end(),
+            [](const actor_metrics_ptr& x, const actor_metrics_ptr& y) {
+              return x->id() < y->id();
+            });
+  std::vector<actor_metrics_snapshot> result;
+  result.reserve(ptrs.size());
+  for (auto& ptr : ptrs)
+    result.push_back(ptr->snapshot());
+  return result;
+}
+
+} // namespace caf
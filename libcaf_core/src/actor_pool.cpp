@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <random>
+#include <limits>
 
 #include "caf/send.hpp"
 #include "caf/default_attachable.hpp"
@@ -29,6 +30,53 @@
 
 namespace caf {
 
+namespace {
+
+// generates pseudo-random numbers for concurrent dispatchers (SplitMix64)
+class dispatch_rng {
+public:
+  dispatch_rng() : state_(std::random_device{}()) {
+    // nop
+  }
+
+  dispatch_rng(const dispatch_rng&) : dispatch_rng() {
+    // nop
+  }
+
+  uint64_t next() {
+    auto z = state_.fetch_add(0x9E3779B97F4A7C15, std::memory_order_relaxed)
+             + 0x9E3779B97F4A7C15;
+    return mix(z);
+  }
+
+  // scrambles the bits of `z`
+  static uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+  }
+
+private:
+  std::atomic<uint64_t> state_;
+};
+
+// returns the number of pending messages for workers that keep track of
+// it, i.e., workers with a bounded mailbox or actor metrics, 0 otherwise
+size_t depth_of(const actor& x) {
+  return actor_cast<abstract_actor*>(x)->mailbox_depth();
+}
+
+void broadcast_dispatch(actor_system&, actor_pool::uplock&,
+                        const actor_pool::actor_vec& vec,
+                        mailbox_element_ptr& ptr, execution_unit* host) {
+  CAF_ASSERT(!vec.empty());
+  auto msg = ptr->move_content_to_message();
+  for (auto& worker : vec)
+    worker->enqueue(ptr->sender, ptr->mid, msg, host);
+}
+
+} // namespace <anonymous>
+
 actor_pool::policy actor_pool::round_robin() {
   struct impl {
     impl() : pos_(0) {
@@ -37,57 +85,111 @@ actor_pool::policy actor_pool::round_robin() {
     impl(const impl&) : pos_(0) {
       // nop
     }
-    void operator()(actor_system&, uplock& guard, const actor_vec& vec,
+    void operator()(actor_system&, uplock&, const actor_vec& vec,
                     mailbox_element_ptr& ptr, execution_unit* host) {
       CAF_ASSERT(!vec.empty());
-      actor selected = vec[pos_++ % vec.size()];
-      guard.unlock();
-      selected->enqueue(std::move(ptr), host);
+      auto pos = pos_.fetch_add(1, std::memory_order_relaxed);
+      vec[pos % vec.size()]->enqueue(std::move(ptr), host);
     }
     std::atomic<size_t> pos_;
   };
   return impl{};
 }
 
-namespace {
-
-void broadcast_dispatch(actor_system&, actor_pool::uplock&,
-                        const actor_pool::actor_vec& vec,
-                        mailbox_element_ptr& ptr, execution_unit* host) {
-  CAF_ASSERT(!vec.empty());
-  auto msg = ptr->move_content_to_message();
-  for (auto& worker : vec)
-    worker->enqueue(ptr->sender, ptr->mid, msg, host);
-}
-
-} // namespace <anonymous>
-
 actor_pool::policy actor_pool::broadcast() {
   return broadcast_dispatch;
 }
 
 actor_pool::policy actor_pool::random() {
   struct impl {
-    impl() : rd_() {
+    void operator()(actor_system&, uplock&, const actor_vec& vec,
+                    mailbox_element_ptr& ptr, execution_unit* host) {
+      CAF_ASSERT(!vec.empty());
+      vec[rng_.next() % vec.size()]->enqueue(std::move(ptr), host);
+    }
+    dispatch_rng rng_;
+  };
+  return impl{};
+}
+
+actor_pool::policy actor_pool::join_shortest_queue() {
+  struct impl {
+    impl() : pos_(0) {
       // nop
     }
-    impl(const impl&) : rd_() {
+    impl(const impl&) : pos_(0) {
       // nop
     }
-    void operator()(actor_system&, uplock& guard, const actor_vec& vec,
+    void operator()(actor_system&, uplock&, const actor_vec& vec,
+                    mailbox_element_ptr& ptr, execution_unit* host) {
+      CAF_ASSERT(!vec.empty());
+      // start at a rotating offset to break ties in round robin order
+      auto n = vec.size();
+      auto first = pos_.fetch_add(1, std::memory_order_relaxed) % n;
+      auto selected = first;
+      auto min_depth = std::numeric_limits<size_t>::max();
+      for (size_t i = 0; i < n && min_depth > 0; ++i) {
+        auto pos = (first + i) % n;
+        auto depth = depth_of(vec[pos]);
+        if (depth < min_depth) {
+          min_depth = depth;
+          selected = pos;
+        }
+      }
+      vec[selected]->enqueue(std::move(ptr), host);
+    }
+    std::atomic<size_t> pos_;
+  };
+  return impl{};
+}
+
+actor_pool::policy actor_pool::power_of_two_choices() {
+  struct impl {
+    void operator()(actor_system&, uplock&, const actor_vec& vec,
                     mailbox_element_ptr& ptr, execution_unit* host) {
-      upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-      auto selected =
-          vec[dis_(rd_, decltype(dis_)::param_type(0, vec.size() - 1))];
-      unique_guard.unlock();
+      CAF_ASSERT(!vec.empty());
+      auto n = vec.size();
+      if (n == 1) {
+        vec.front()->enqueue(std::move(ptr), host);
+        return;
+      }
+      // draw two distinct workers from a single random number
+      auto x = rng_.next();
+      auto i = x % n;
+      auto j = (i + 1 + (x >> 32) % (n - 1)) % n;
+      auto& selected = depth_of(vec[j]) < depth_of(vec[i]) ? vec[j]
+                                                           : vec[i];
       selected->enqueue(std::move(ptr), host);
     }
-    std::random_device rd_;
-    std::uniform_int_distribution<size_t> dis_;
+    dispatch_rng rng_;
   };
   return impl{};
 }
 
+actor_pool::policy actor_pool::consistent_hashing(key_function f) {
+  struct impl {
+    void operator()(actor_system&, uplock&, const actor_vec& vec,
+                    mailbox_element_ptr& ptr, execution_unit* host) {
+      CAF_ASSERT(!vec.empty());
+      // rendezvous hashing: select the worker with the highest weight for
+      // the key, which only depends on the key and the ID of the worker
+      auto key = dispatch_rng::mix(key_fun_(ptr->content()));
+      auto selected = vec.begin();
+      uint64_t max_weight = 0;
+      for (auto i = vec.begin(); i != vec.end(); ++i) {
+        auto weight = dispatch_rng::mix(key ^ dispatch_rng::mix((*i)->id()));
+        if (weight > max_weight) {
+          max_weight = weight;
+          selected = i;
+        }
+      }
+      (*selected)->enqueue(std::move(ptr), host);
+    }
+    key_function key_fun_;
+  };
+  return impl{std::move(f)};
+}
+
 actor_pool::~actor_pool() {
   // nop
 }
@@ -108,19 +210,25 @@ actor actor_pool::make(execution_unit* eu, size_t num_workers,
   auto res = make(eu, std::move(pol));
   auto ptr = static_cast<actor_pool*>(actor_cast<abstract_actor*>(res));
   auto res_addr = ptr->address();
+  actor_vec workers;
   for (size_t i = 0; i < num_workers; ++i) {
     auto worker = fac();
     worker->attach(default_attachable::make_monitor(worker.address(), res_addr));
-    ptr->workers_.push_back(std::move(worker));
+    workers.push_back(std::move(worker));
   }
+  ptr->workers_.update([&](actor_vec& xs) {
+    xs.swap(workers);
+    return true;
+  });
   return res;
 }
 
 void actor_pool::enqueue(mailbox_element_ptr what, execution_unit* eu) {
-  upgrade_lock<detail::shared_spinlock> guard{workers_mtx_};
-  if (filter(guard, what->sender, what->mid, *what, eu))
+  auto workers = workers_.load();
+  if (filter(*workers, what->sender, what->mid, *what, eu))
     return;
-  policy_(home_system(), guard, workers_, what, eu);
+  uplock guard;
+  policy_(home_system(), guard, *workers, what, eu);
 }
 
 actor_pool::actor_pool(actor_config& cfg) : monitorable_actor(cfg) {
@@ -131,23 +239,22 @@ void actor_pool::on_cleanup() {
   // nop
 }
 
-bool actor_pool::filter(upgrade_lock<detail::shared_spinlock>& guard,
+bool actor_pool::filter(const actor_vec& workers,
                         const strong_actor_ptr& sender, message_id mid,
                         message_view& mv, execution_unit* eu) {
   auto& content = mv.content();
   CAF_LOG_TRACE(CAF_ARG(mid) << CAF_ARG(content));
   if (content.match_elements<exit_msg>()) {
-    // acquire second mutex as well
-    std::vector<actor> workers;
     auto em = content.get_as<exit_msg>(0).reason;
     if (cleanup(std::move(em), eu)) {
       auto tmp = mv.move_content_to_message();
       // send exit messages *always* to all workers and clear vector afterwards
-      // but first swap workers_ out of the critical section
-      upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-      workers_.swap(workers);
-      unique_guard.unlock();
-      for (auto& w : workers)
+      actor_vec xs;
+      workers_.update([&](actor_vec& ys) {
+        xs.swap(ys);
+        return true;
+      });
+      for (auto& w : xs)
         anon_send(w, tmp);
       unregister_from_system();
     }
@@ -156,46 +263,60 @@ bool actor_pool::filter(upgrade_lock<detail::shared_spinlock>& guard,
   if (content.match_elements<down_msg>()) {
     // remove failed worker from pool
     auto& dm = content.get_as<down_msg>(0);
-    upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-    auto last = workers_.end();
-    auto i = std::find(workers_.begin(), workers_.end(), dm.source);
-    CAF_LOG_DEBUG_IF(i == last, "received down message for an unknown worker");
-    if (i != last)
-      workers_.erase(i);
-    if (workers_.empty()) {
+    auto out_of_workers = false;
+    workers_.update([&](actor_vec& xs) {
+      auto last = xs.end();
+      auto i = std::find(xs.begin(), last, dm.source);
+      CAF_LOG_DEBUG_IF(i == last,
+                       "received down message for an unknown worker");
+      if (i == last)
+        return false;
+      xs.erase(i);
+      out_of_workers = xs.empty();
+      return true;
+    });
+    if (out_of_workers) {
       planned_reason_ = exit_reason::out_of_workers;
-      unique_guard.unlock();
       quit(eu);
     }
     return true;
   }
-  if (content.match_elements<sys_atom, put_atom, actor>()) {
+  // type checks only match the type of atom constants, hence we need to
+  // compare the atom values explicitly
+  auto sys_op = [&](atom_value op) {
+    return content.get_as<atom_value>(0) == sys_atom::value
+           && content.get_as<atom_value>(1) == op;
+  };
+  if (content.match_elements<sys_atom, put_atom, actor>()
+      && sys_op(put_atom::value)) {
     auto& worker = content.get_as<actor>(2);
     worker->attach(default_attachable::make_monitor(worker.address(),
                                                     address()));
-    upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
-    workers_.push_back(worker);
+    workers_.update([&](actor_vec& xs) {
+      xs.push_back(worker);
+      return true;
+    });
     return true;
   }
-  if (content.match_elements<sys_atom, delete_atom, actor>()) {
-    upgrade_to_unique_lock<detail::shared_spinlock> unique_guard{guard};
+  if (content.match_elements<sys_atom, delete_atom, actor>()
+      && sys_op(delete_atom::value)) {
     auto& what = content.get_as<actor>(2);
-    auto last = workers_.end();
-    auto i = std::find(workers_.begin(), last, what);
-    if (i != last) {
-      workers_.erase(i);
-    }
+    workers_.update([&](actor_vec& xs) {
+      auto last = xs.end();
+      auto i = std::find(xs.begin(), last, what);
+      if (i == last)
+        return false;
+      xs.erase(i);
+      return true;
+    });
     return true;
   }
-  if (content.match_elements<sys_atom, get_atom>()) {
-    auto cpy = workers_;
-    guard.unlock();
-    sender->enqueue(nullptr, mid.response_id(),
-                    make_message(std::move(cpy)), eu);
+  if (content.match_elements<sys_atom, get_atom>()
+      && sys_op(get_atom::value)) {
+    sender->enqueue(nullptr, mid.response_id(), make_message(workers), eu);
     return true;
   }
-  if (workers_.empty()) {
-    guard.unlock();
+  if (workers.empty()) {
     if (sender && mid.valid()) {
       // tell client we have ignored this sync message by sending
       // and empty message back
@@ -207,8 +328,8 @@ bool actor_pool::filter(upgrade_lock<detail::shared_spinlock>& guard,
 }
 
 void actor_pool::quit(execution_unit* host) {
-  // we can safely run our cleanup code here without holding
-  // workers_mtx_ because abstract_actor has its own lock
+  // we can safely run our cleanup code here without touching the workers,
+  // because abstract_actor has its own lock
   if (cleanup(planned_reason_, host))
     unregister_from_system();
 }
@@ -157,6 +157,21 @@ behavior spawn_serv_impl(event_based_actor* self) {
   };
 }
 
+behavior metrics_serv_impl(event_based_actor* self) {
+  CAF_LOG_TRACE("");
+  return {
+    [=](get_atom) {
+      return self->home_system().actor_metrics().snapshot();
+    },
+    [=](get_atom, actor_id aid) -> expected<actor_metrics_snapshot> {
+      auto res = self->home_system().actor_metrics().snapshot(aid);
+      if (!res)
+        return sec::invalid_argument;
+      return std::move(*res);
+    }
+  };
+}
+
 class dropping_execution_unit : public execution_unit {
 public:
   dropping_execution_unit(actor_system* sys) : execution_unit(sys) {
@@ -187,6 +202,10 @@ actor_system::actor_system(actor_system_config& cfg)
       detached(0),
       cfg_(cfg) {
   CAF_SET_LOGGER_SYS(this);
+  metrics_.add_gauge("caf_running_actors", "Number of running actors.",
+                     [this]() -> int64_t {
+                       return static_cast<int64_t>(registry_.running());
+                     });
   for (auto& f : cfg.module_factories) {
     auto mod_ptr = f(*this);
     modules_[mod_ptr->id()].reset(mod_ptr);
@@ -202,14 +221,19 @@ actor_system::actor_system(actor_system_config& cfg)
   using steal = scheduler::coordinator<policy::work_stealing>;
   using profiled_share = scheduler::profiled_coordinator<policy::work_sharing>;
   using profiled_steal = scheduler::profiled_coordinator<policy::work_stealing>;
+  using lf_steal = scheduler::coordinator<policy::lock_free_work_stealing>;
+  using profiled_lf_steal =
+    scheduler::profiled_coordinator<policy::lock_free_work_stealing>;
   // set scheduler only if not explicitly loaded by user
   if (!sched) {
     enum sched_conf {
-      stealing          = 0x0001,
-      sharing           = 0x0002,
-      profiled          = 0x0100,
-      profiled_stealing = 0x0101,
-      profiled_sharing  = 0x0102
+      stealing                    = 0x0001,
+      sharing                     = 0x0002,
+      lock_free_stealing          = 0x0003,
+      profiled                    = 0x0100,
+      profiled_stealing           = 0x0101,
+      profiled_sharing            = 0x0102,
+      profiled_lock_free_stealing = 0x0103
     };
     sched_conf sc = stealing;
     if (cfg.scheduler_policy == atom("sharing"))
@@ -219,6 +243,8 @@ actor_system::actor_system(actor_system_config& cfg)
                 << " is an unrecognized scheduler pollicy, "
                    "falling back to 'stealing' (i.e. work-stealing)"
                 << std::endl;
+    if (sc == stealing && cfg.work_stealing_queue_type == atom("lock-free"))
+      sc = lock_free_stealing;
     if (cfg.scheduler_enable_profiling)
       sc = static_cast<sched_conf>(sc | profiled);
     switch (sc) {
@@ -234,6 +260,12 @@ actor_system::actor_system(actor_system_config& cfg)
       case profiled_sharing:
         sched.reset(new profiled_share(*this));
         break;
+      case lock_free_stealing:
+        sched.reset(new lf_steal(*this));
+        break;
+      case profiled_lock_free_stealing:
+        sched.reset(new profiled_lf_steal(*this));
+        break;
     }
   }
   // initialize state for each module and give each module the opportunity
@@ -242,15 +274,20 @@ actor_system::actor_system(actor_system_config& cfg)
     if (mod)
       mod->init(cfg);
   groups_.init(cfg);
-  // spawn config and spawn servers (lazily to not access the scheduler yet)
+  // spawn config, spawn and metrics servers (lazily to not access the scheduler yet)
   static constexpr auto Flags = hidden + lazy_init;
   spawn_serv_ = actor_cast<strong_actor_ptr>(spawn<Flags>(spawn_serv_impl));
   config_serv_ = actor_cast<strong_actor_ptr>(spawn<Flags>(config_serv_impl));
+  if (cfg.scheduler_enable_actor_metrics)
+    metrics_serv_ =
+      actor_cast<strong_actor_ptr>(spawn<Flags>(metrics_serv_impl));
   // fire up remaining modules
   logger_.start();
   registry_.start();
   registry_.put(atom("SpawnServ"), spawn_serv_);
   registry_.put(atom("ConfigServ"), config_serv_);
+  if (metrics_serv_)
+    registry_.put(atom("MetricServ"), metrics_serv_);
   for (auto& mod : modules_)
     if (mod)
       mod->start();
@@ -263,11 +300,15 @@ actor_system::~actor_system() {
   // shutdown system-level servers
   anon_send_exit(spawn_serv_, exit_reason::user_shutdown);
   anon_send_exit(config_serv_, exit_reason::user_shutdown);
+  if (metrics_serv_)
+    anon_send_exit(metrics_serv_, exit_reason::user_shutdown);
   // release memory as soon as possible
   spawn_serv_ = nullptr;
   config_serv_ = nullptr;
+  metrics_serv_ = nullptr;
   registry_.erase(atom("SpawnServ"));
   registry_.erase(atom("ConfigServ"));
+  registry_.erase(atom("MetricServ"));
   // group module is the first one, relies on MM
   groups_.stop();
   // stop modules in reverse order
@@ -299,6 +340,14 @@ actor_registry& actor_system::registry() {
   return registry_;
 }
 
+telemetry::metric_registry& actor_system::metrics() {
+  return metrics_;
+}
+
+actor_metrics_registry& actor_system::actor_metrics() {
+  return actor_metrics_;
+}
+
 const uniform_type_info_map& actor_system::types() const {
   return types_;
 }
@@ -369,6 +418,12 @@ void actor_system::await_detached_threads() {
     detached_cv.wait(guard);
 }
 
+void actor_system::set_default_mailbox_bounds(actor_config& cfg) const {
+  cfg.mailbox_capacity = cfg_.mailbox_capacity;
+  cfg.mailbox_overload_policy
+    = to_overload_policy(cfg_.mailbox_overload_policy);
+}
+
 expected<strong_actor_ptr>
 actor_system::dyn_spawn_impl(const std::string& name, message& args,
                              execution_unit* ctx, bool check_interface,
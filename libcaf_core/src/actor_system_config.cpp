@@ -82,11 +82,15 @@ actor_system_config::actor_system_config()
       slave_mode_fun(nullptr) {
   // (1) hard-coded defaults
   scheduler_policy = atom("stealing");
+  scheduler_affinity = atom("none");
   scheduler_max_threads = std::max(std::thread::hardware_concurrency(),
                                    unsigned{4});
   scheduler_max_throughput = std::numeric_limits<size_t>::max();
   scheduler_enable_profiling = false;
   scheduler_profiling_ms_resolution = 100;
+  scheduler_enable_actor_metrics = false;
+  work_stealing_queue_type = atom("spinlock");
+  work_stealing_poll_strategy = atom("sleep");
   work_stealing_aggressive_poll_attempts = 100;
   work_stealing_aggressive_steal_interval = 10;
   work_stealing_moderate_poll_attempts = 500;
@@ -94,14 +98,30 @@ actor_system_config::actor_system_config()
   work_stealing_moderate_sleep_duration_us = 50;
   work_stealing_relaxed_steal_interval = 1;
   work_stealing_relaxed_sleep_duration_us = 10000;
+  mailbox_capacity = 1024;
+  mailbox_overload_policy = atom("drop-new");
+  mailbox_priority_policy = atom("strict");
   middleman_network_backend = atom("default");
   middleman_enable_automatic_connections = false;
   middleman_max_consecutive_reads = 50;
   middleman_heartbeat_interval = 0;
+  middleman_enable_compact_header = false;
+  middleman_network_threads = 1;
+  middleman_metrics_port = 0;
+  middleman_metrics_host = "127.0.0.1";
+  middleman_coalescing_delay_us = 0;
+  middleman_coalescing_bytes = 16384;
+  middleman_compression = atom("none");
+  middleman_compression_threshold = 1024;
+  middleman_enable_compact_encoding = false;
+  logger_buffer_size = 1024 * 1024;
+  logger_verbosity = atom("trace");
   // fill our options vector for creating INI and CLI parsers
   opt_group{options_, "scheduler"}
   .add(scheduler_policy, "policy",
        "sets the scheduling policy to either 'stealing' (default) or 'sharing'")
+  .add(scheduler_affinity, "affinity",
+       "pins workers to CPUs: 'none' (default), 'compact' or 'scatter'")
   .add(scheduler_max_threads, "max-threads",
        "sets a fixed number of worker threads for the scheduler")
   .add(scheduler_max_throughput, "max-throughput",
@@ -111,8 +131,14 @@ actor_system_config::actor_system_config()
   .add(scheduler_profiling_ms_resolution, "profiling-ms-resolution",
        "sets the rate in ms in which the profiler collects data")
   .add(scheduler_profiling_output_file, "profiling-output-file",
-       "sets the output file for the profiler");
+       "sets the output file for the profiler")
+  .add(scheduler_enable_actor_metrics, "enable-actor-metrics",
+       "enables or disables per-actor runtime statistics");
   opt_group(options_, "work-stealing")
+  .add(work_stealing_queue_type, "queue-type",
+       "sets the job queue of workers to either 'spinlock' or 'lock-free'")
+  .add(work_stealing_poll_strategy, "poll-strategy",
+       "sets the relaxed polling of idle workers to either 'sleep' or 'park'")
   .add(work_stealing_aggressive_poll_attempts, "aggressive-poll-attempts",
        "sets the number of zero-sleep-interval polling attempts")
   .add(work_stealing_aggressive_steal_interval, "aggressive-steal-interval",
@@ -127,9 +153,19 @@ actor_system_config::actor_system_config()
        "sets the frequency of steal attempts during relaxed polling")
   .add(work_stealing_relaxed_sleep_duration_us, "relaxed-sleep-duration",
        "sets the sleep interval between poll attempts during relaxed polling");
+  opt_group{options_, "mailbox"}
+  .add(mailbox_capacity, "capacity",
+       "sets the capacity of actors spawned with the bounded_mailbox option")
+  .add(mailbox_overload_policy, "overload-policy",
+       "sets the policy for full mailboxes to either 'drop-new' (default), "
+       "'drop-old', 'reject' or 'back-press'")
+  .add(mailbox_priority_policy, "priority-policy",
+       "sets the lane order of priority-aware actors to either 'strict' "
+       "(default) or 'weighted'");
   opt_group{options_, "middleman"}
   .add(middleman_network_backend, "network-backend",
-       "sets the network backend to either 'default' or 'asio' (if available)")
+       "sets the network backend to 'default', 'asio', or 'io_uring' "
+       "(if available)")
   .add(middleman_app_identifier, "app-identifier",
        "sets the application identifier of this node")
   .add(middleman_enable_automatic_connections, "enable-automatic-connections",
@@ -137,7 +173,40 @@ actor_system_config::actor_system_config()
   .add(middleman_max_consecutive_reads, "max-consecutive-reads",
        "sets the maximum number of consecutive I/O reads per broker")
   .add(middleman_heartbeat_interval, "heartbeat-interval",
-       "sets the interval (ms) of heartbeat, 0 (default) means disabling it");
+       "sets the interval (ms) of heartbeat, 0 (default) means disabling it")
+  .add(middleman_enable_compact_header, "enable-compact-header",
+       "enables or disables the compact BASP header format (off per default)")
+  .add(middleman_network_threads, "network-threads",
+       "sets the number of I/O loops distributing connections (default: 1)")
+  .add(middleman_metrics_port, "metrics-port",
+       "serves metrics via HTTP on given port, 0 (default) disables it")
+  .add(middleman_metrics_host, "metrics-host",
+       "sets the address for serving metrics (default: 127.0.0.1), "
+       "an empty string accepts connections on all interfaces")
+  .add(middleman_coalescing_delay_us, "coalescing-delay",
+       "sets the maximum delay (us) for coalescing outgoing BASP messages, "
+       "0 (default) disables coalescing")
+  .add(middleman_coalescing_bytes, "coalescing-bytes",
+       "sets the number of buffered bytes that trigger an early flush when "
+       "coalescing outgoing BASP messages")
+  .add(middleman_compression, "compression",
+       "sets the accepted BASP payload compression to 'none' (default), "
+       "'auto', 'lz', 'lz4', or 'zstd' (if available)")
+  .add(middleman_compression_threshold, "compression-threshold",
+       "sets the minimum payload size in bytes for compressing messages")
+  .add(middleman_enable_compact_encoding, "enable-compact-encoding",
+       "enables or disables variable-byte encoding of integers and atoms in "
+       "BASP payloads (off per default)");
+  opt_group{options_, "logger"}
+  .add(logger_buffer_size, "buffer-size",
+       "sets the size of the per-thread event buffers in bytes")
+  .add(logger_verbosity, "verbosity",
+       "sets the default verbosity to 'quiet', 'error', 'warning', 'info', "
+       "'debug', or 'trace' (default)")
+  .add(logger_component_verbosity, "component-verbosity",
+       "sets the verbosity per component, e.g., 'caf.io.basp=trace,caf=info'")
+  .add(logger_actor_verbosity, "actor-verbosity",
+       "sets the verbosity per actor ID, e.g., '42=trace'");
   opt_group(options_, "opencl")
   .add(opencl_device_ids, "device-ids",
        "restricts which OpenCL devices are accessed by CAF");
@@ -267,11 +336,36 @@ actor_system_config& actor_system_config::parse(message& args,
   };
   verify_atom_opt({atom("default"),
 #                  ifdef CAF_USE_ASIO
-                   atom("asio")
+                   atom("asio"),
+#                  endif
+#                  ifdef CAF_USE_URING
+                   atom("io_uring"),
 #                  endif
                   }, middleman_network_backend, "middleman.network-backend");
+  verify_atom_opt({atom("none"), atom("auto"), atom("lz"),
+#                  ifdef CAF_USE_LZ4
+                   atom("lz4"),
+#                  endif
+#                  ifdef CAF_USE_ZSTD
+                   atom("zstd"),
+#                  endif
+                  }, middleman_compression, "middleman.compression");
   verify_atom_opt({atom("stealing"), atom("sharing")},
                   scheduler_policy, "scheduler.policy ");
+  verify_atom_opt({atom("none"), atom("compact"), atom("scatter")},
+                  scheduler_affinity, "scheduler.affinity");
+  verify_atom_opt({atom("spinlock"), atom("lock-free")},
+                  work_stealing_queue_type, "work-stealing.queue-type");
+  verify_atom_opt({atom("sleep"), atom("park")},
+                  work_stealing_poll_strategy, "work-stealing.poll-strategy");
+  verify_atom_opt({atom("drop-new"), atom("drop-old"), atom("reject"),
+                   atom("back-press")},
+                  mailbox_overload_policy, "mailbox.overload-policy");
+  verify_atom_opt({atom("strict"), atom("weighted")},
+                  mailbox_priority_policy, "mailbox.priority-policy");
+  verify_atom_opt({atom("trace"), atom("debug"), atom("info"),
+                   atom("warning"), atom("error"), atom("quiet")},
+                  logger_verbosity, "logger.verbosity");
   if (res.opts.count("caf#dump-config")) {
     cli_helptext_printed = true;
     std::string category;
@@ -19,6 +19,8 @@
 
 #include "caf/detail/behavior_impl.hpp"
 
+#include <algorithm>
+
 #include "caf/message_handler.hpp"
 #include "caf/make_type_erased_tuple_view.hpp"
 
@@ -80,6 +82,8 @@ public:
 
 } // namespace <anonymous>
 
+constexpr size_t behavior_impl::linear_dispatch_limit;
+
 behavior_impl::~behavior_impl() {
   // nop
 }
@@ -87,10 +91,17 @@ behavior_impl::~behavior_impl() {
 behavior_impl::behavior_impl(duration tout)
     : timeout_(tout),
       begin_(nullptr),
-      end_(nullptr) {
+      end_(nullptr),
+      indexed_(false) {
   // nop
 }
 
+void behavior_impl::init_dispatch_index() {
+  indexed_ = static_cast<size_t>(end_ - begin_) > linear_dispatch_limit;
+  if (indexed_)
+    std::stable_sort(begin_, end_);
+}
+
 match_case::result
 behavior_impl::invoke_empty(detail::invoke_result_visitor& f) {
   auto xs = make_type_erased_tuple_view();
@@ -100,16 +111,30 @@ behavior_impl::invoke_empty(detail::invoke_result_visitor& f) {
 match_case::result behavior_impl::invoke(detail::invoke_result_visitor& f,
                                          type_erased_tuple& xs) {
   auto msg_token = xs.type_token();
-  for (auto i = begin_; i != end_; ++i)
-    if (i->type_token == msg_token)
-      switch (i->ptr->invoke(f, xs)) {
-        case match_case::no_match:
-          break;
-        case match_case::match:
-          return match_case::match;
-        case match_case::skip:
-          return match_case::skip;
-      };
+  auto first = begin_;
+  if (indexed_) {
+    // all cases with equal tokens form a contiguous range in declaration
+    // order, because tokens are only a pre-filter for try_match
+    first = std::lower_bound(begin_, end_, msg_token,
+                             [](const match_case_info& x, uint32_t y) {
+                               return x.type_token < y;
+                             });
+  }
+  for (auto i = first; i != end_; ++i) {
+    if (i->type_token != msg_token) {
+      if (indexed_)
+        break;
+      continue;
+    }
+    switch (i->ptr->invoke(f, xs)) {
+      case match_case::no_match:
+        break;
+      case match_case::match:
+        return match_case::match;
+      case match_case::skip:
+        return match_case::skip;
+    };
+  }
   return match_case::no_match;
 }
 
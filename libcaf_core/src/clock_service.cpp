@@ -0,0 +1,157 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/scheduler/clock_service.hpp"
+
+#include <limits>
+
+#include "caf/logger.hpp"
+
+namespace caf {
+namespace scheduler {
+
+constexpr clock_service::handle clock_service::invalid_handle;
+
+clock_service::clock_service()
+    : wakeup_(std::numeric_limits<uint64_t>::max()),
+      running_(false),
+      stopped_(false),
+      start_(clock_type::now()) {
+  // nop
+}
+
+clock_service::~clock_service() {
+  stop();
+}
+
+void clock_service::start() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  if (running_ || stopped_)
+    return;
+  running_ = true;
+  thread_ = std::thread{[=] { run(); }};
+}
+
+void clock_service::stop() {
+  bool was_running;
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard{mtx_};
+    if (stopped_)
+      return;
+    stopped_ = true;
+    was_running = running_;
+    running_ = false;
+    cv_.notify_all();
+  }
+  if (was_running)
+    thread_.join();
+  // destroy pending messages outside of the lock
+  std::vector<delayed_msg> dropped;
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard{mtx_};
+    wheel_.clear([&](delayed_msg& x) {
+      dropped.emplace_back(std::move(x));
+    });
+  }
+}
+
+clock_service::handle clock_service::schedule(const duration& rel_time,
+                                              strong_actor_ptr from,
+                                              strong_actor_ptr to,
+                                              message_id mid,
+                                              message content) {
+  auto now = clock_type::now();
+  auto t = now;
+  t += rel_time;
+  auto expiry = ticks(t, true);
+  std::unique_lock<std::mutex> guard{mtx_};
+  // nobody delivers messages after `stop()`, hence we drop them right away
+  // instead of keeping them until the destructor runs
+  if (stopped_) {
+    CAF_LOG_DEBUG("clock stopped, drop delayed message");
+    return invalid_handle;
+  }
+  // an empty wheel may lag behind, because the thread sleeps until it has
+  // work; catching up now avoids stepping through all missed ticks later
+  if (wheel_.empty())
+    wheel_.advance(ticks(now, false), [](delayed_msg&) {});
+  auto result = wheel_.add(expiry, delayed_msg{std::move(from), std::move(to),
+                                               mid, std::move(content)});
+  if (expiry < wakeup_)
+    cv_.notify_one();
+  return result;
+}
+
+void clock_service::cancel(handle hdl) {
+  if (hdl == invalid_handle)
+    return;
+  // destroy the message outside of the lock, since releasing actor handles
+  // may destroy actors that in turn cancel their pending messages
+  delayed_msg dropped;
+  std::unique_lock<std::mutex> guard{mtx_};
+  wheel_.cancel(hdl, [&](delayed_msg& x) {
+    dropped = std::move(x);
+  });
+}
+
+size_t clock_service::pending() const {
+  std::unique_lock<std::mutex> guard{mtx_};
+  return wheel_.size();
+}
+
+uint64_t clock_service::ticks(clock_type::time_point t, bool round_up) const {
+  if (t <= start_)
+    return 0;
+  auto d = std::chrono::duration_cast<std::chrono::nanoseconds>(t - start_);
+  auto res = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    resolution{1});
+  auto result = static_cast<uint64_t>(d.count() / res.count());
+  if (round_up && d.count() % res.count() != 0)
+    ++result;
+  return result;
+}
+
+void clock_service::run() {
+  CAF_LOG_TRACE("");
+  std::unique_lock<std::mutex> guard{mtx_};
+  while (running_) {
+    wheel_.advance(ticks(clock_type::now(), false), [&](delayed_msg& x) {
+      batch_.emplace_back(std::move(x));
+    });
+    if (!batch_.empty()) {
+      guard.unlock();
+      for (auto& x : batch_)
+        if (x.to)
+          x.to->enqueue(std::move(x.from), x.mid, std::move(x.content),
+                        nullptr);
+      batch_.clear();
+      guard.lock();
+      continue;
+    }
+    wakeup_ = wheel_.next_tick();
+    if (wakeup_ == std::numeric_limits<uint64_t>::max())
+      cv_.wait(guard);
+    else
+      cv_.wait_until(guard, start_ + resolution{wakeup_});
+    wakeup_ = std::numeric_limits<uint64_t>::max();
+  }
+}
+
+} // namespace scheduler
+} // namespace caf
@@ -0,0 +1,206 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/cpu_topology.hpp"
+
+#include <map>
+#include <tuple>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+
+#include "caf/config.hpp"
+
+#ifdef CAF_LINUX
+#  include <dirent.h>
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+#ifdef CAF_LINUX
+
+constexpr const char sysfs_cpu_dir[] = "/sys/devices/system/cpu";
+constexpr const char sysfs_node_dir[] = "/sys/devices/system/node";
+
+bool read_line(const std::string& path, std::string& result) {
+  std::ifstream in{path};
+  return static_cast<bool>(std::getline(in, result));
+}
+
+int read_int(const std::string& path, int fallback) {
+  std::string line;
+  if (!read_line(path, line) || line.empty())
+    return fallback;
+  return std::atoi(line.c_str());
+}
+
+// maps each CPU ID to its NUMA node
+std::map<int, int> read_numa_nodes() {
+  std::map<int, int> result;
+  auto dir = opendir(sysfs_node_dir);
+  if (!dir)
+    return result;
+  while (auto entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, 4, "node") != 0 || name.size() == 4
+        || !isdigit(name[4]))
+      continue;
+    auto node = std::atoi(name.c_str() + 4);
+    std::string cpus;
+    if (read_line(std::string{sysfs_node_dir} + "/" + name + "/cpulist", cpus))
+      for (auto cpu : parse_cpu_list(cpus))
+        result[cpu] = node;
+  }
+  closedir(dir);
+  return result;
+}
+
+#endif // CAF_LINUX
+
+} // namespace <anonymous>
+
+std::vector<cpu_info> get_cpu_topology() {
+  std::vector<cpu_info> result;
+# ifdef CAF_LINUX
+  std::string online;
+  if (!read_line(std::string{sysfs_cpu_dir} + "/online", online))
+    return result;
+  // CPUs outside of our affinity mask (e.g., restricted by a cgroup cpuset
+  // or taskset) are online but unavailable to this process
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  auto have_mask = sched_getaffinity(0, sizeof(cpu_set_t), &allowed) == 0;
+  auto nodes = read_numa_nodes();
+  for (auto id : parse_cpu_list(online)) {
+    if (have_mask && (id >= CPU_SETSIZE || !CPU_ISSET(id, &allowed)))
+      continue;
+    auto prefix = std::string{sysfs_cpu_dir} + "/cpu" + std::to_string(id);
+    cpu_info x;
+    x.id = id;
+    x.package = read_int(prefix + "/topology/physical_package_id", 0);
+    auto i = nodes.find(id);
+    x.numa_node = i != nodes.end() ? i->second : x.package;
+    // index3 is the L3 cache on all common x86 and ARM systems
+    std::string shared;
+    if (read_line(prefix + "/cache/index3/shared_cpu_list", shared)) {
+      auto xs = parse_cpu_list(shared);
+      x.l3_cache = xs.empty() ? id : *std::min_element(xs.begin(), xs.end());
+    } else {
+      // assume one shared cache per NUMA node if we cannot tell
+      x.l3_cache = -1 - x.numa_node;
+    }
+    result.push_back(x);
+  }
+# endif
+  return result;
+}
+
+std::vector<int> parse_cpu_list(const std::string& str) {
+  std::vector<int> result;
+  auto i = str.begin();
+  auto e = str.end();
+  auto read_num = [&](int& x) -> bool {
+    if (i == e || !isdigit(*i))
+      return false;
+    x = 0;
+    while (i != e && isdigit(*i))
+      x = x * 10 + (*i++ - '0');
+    return true;
+  };
+  while (i != e) {
+    int first;
+    if (!read_num(first))
+      return {};
+    auto last = first;
+    if (i != e && *i == '-') {
+      ++i;
+      if (!read_num(last) || last < first)
+        return {};
+    }
+    for (auto x = first; x <= last; ++x)
+      result.push_back(x);
+    if (i != e && (*i == ',' || *i == '\n'))
+      ++i;
+  }
+  return result;
+}
+
+int cpu_distance(const cpu_info& x, const cpu_info& y) {
+  if (x.l3_cache == y.l3_cache && x.numa_node == y.numa_node)
+    return 0;
+  if (x.numa_node == y.numa_node)
+    return 1;
+  return 2;
+}
+
+std::vector<cpu_info> place_workers(std::vector<cpu_info> topology,
+                                    size_t num_workers, atom_value strategy) {
+  std::vector<cpu_info> result;
+  if (topology.empty())
+    return result;
+  auto key = [](const cpu_info& x) {
+    return std::make_tuple(x.numa_node, x.l3_cache, x.id);
+  };
+  std::sort(topology.begin(), topology.end(),
+            [&](const cpu_info& x, const cpu_info& y) {
+              return key(x) < key(y);
+            });
+  if (strategy == atom("compact")) {
+    for (size_t i = 0; i < num_workers; ++i)
+      result.push_back(topology[i % topology.size()]);
+  } else if (strategy == atom("scatter")) {
+    // split CPUs by NUMA node and then take one CPU from each node in turn
+    std::vector<std::vector<cpu_info>> nodes;
+    for (auto& x : topology)
+      if (nodes.empty() || nodes.back().front().numa_node != x.numa_node)
+        nodes.emplace_back(1, x);
+      else
+        nodes.back().push_back(x);
+    std::vector<cpu_info> order;
+    for (size_t i = 0; order.size() < topology.size(); ++i)
+      for (auto& node : nodes)
+        if (i < node.size())
+          order.push_back(node[i]);
+    for (size_t i = 0; i < num_workers; ++i)
+      result.push_back(order[i % order.size()]);
+  }
+  return result;
+}
+
+bool set_thread_affinity(int cpu_id) {
+# ifdef CAF_LINUX
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu_id, &cpus);
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                &cpus) == 0;
+# else
+  static_cast<void>(cpu_id);
+  return false;
+# endif
+}
+
+} // namespace detail
+} // namespace caf
@@ -17,10 +17,12 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#include <map>
 #include <set>
 #include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 #include <condition_variable>
 
 #include "caf/locks.hpp"
@@ -31,15 +33,17 @@
 #include "caf/serializer.hpp"
 #include "caf/deserializer.hpp"
 #include "caf/event_based_actor.hpp"
+#include "caf/forwarding_actor_proxy.hpp"
 
 #include "caf/group_manager.hpp"
 
+#include "caf/detail/atomic_snapshot.hpp"
+
 namespace caf {
 
 namespace {
 
 using exclusive_guard = unique_lock<detail::shared_spinlock>;
-using shared_guard = shared_lock<detail::shared_spinlock>;
 using upgrade_guard = upgrade_lock<detail::shared_spinlock>;
 using upgrade_to_unique_guard = upgrade_to_unique_lock<detail::shared_spinlock>;
 
@@ -63,8 +67,8 @@ public:
   void send_all_subscribers(const strong_actor_ptr& sender, const message& msg,
                             execution_unit* host) {
     CAF_LOG_TRACE(CAF_ARG(sender) << CAF_ARG(msg));
-    shared_guard guard(mtx_);
-    for (auto& s : subscribers_)
+    auto xs = subscribers_.load();
+    for (auto& s : *xs)
       s->enqueue(sender, invalid_message_id, msg, host);
   }
 
@@ -78,24 +82,38 @@ public:
   std::pair<bool, size_t> add_subscriber(strong_actor_ptr who) {
     CAF_LOG_TRACE(CAF_ARG(who));
     if (!who)
-      return {false, subscribers_.size()};
-    exclusive_guard guard(mtx_);
-    auto res = subscribers_.emplace(std::move(who)).second;
-    return {res, subscribers_.size()};
+      return {false, subscribers_.load()->size()};
+    size_t n = 0;
+    auto res = subscribers_.update([&](subscriber_list& xs) {
+      auto i = std::lower_bound(xs.begin(), xs.end(), who);
+      if (i != xs.end() && *i == who) {
+        n = xs.size();
+        return false;
+      }
+      xs.insert(i, std::move(who));
+      n = xs.size();
+      return true;
+    });
+    return {res, n};
   }
 
   std::pair<bool, size_t> erase_subscriber(const actor_control_block* who) {
     CAF_LOG_TRACE(""); // serializing who would cause a deadlock
-    exclusive_guard guard(mtx_);
     auto cmp = [](const strong_actor_ptr& lhs, const actor_control_block* rhs) {
       return actor_addr::compare(lhs.get(), rhs) < 0;
     };
-    auto e = subscribers_.end();
-    auto i = std::lower_bound(subscribers_.begin(), e, who, cmp);
-    if (i == e || actor_addr::compare(i->get(), who) != 0)
-      return {false, subscribers_.size()};
-    subscribers_.erase(i);
-    return {true, subscribers_.size()};
+    size_t n = 0;
+    auto res = subscribers_.update([&](subscriber_list& xs) {
+      auto e = xs.end();
+      auto i = std::lower_bound(xs.begin(), e, who, cmp);
+      n = xs.size();
+      if (i == e || actor_addr::compare(i->get(), who) != 0)
+        return false;
+      xs.erase(i);
+      --n;
+      return true;
+    });
+    return {res, n};
   }
 
   bool subscribe(strong_actor_ptr who) override {
@@ -127,8 +145,10 @@ public:
   ~local_group();
 
 protected:
-  detail::shared_spinlock mtx_;
-  std::set<strong_actor_ptr> subscribers_;
+  // sorted, immutable arrays that publishers iterate without locking
+  using subscriber_list = std::vector<strong_actor_ptr>;
+
+  detail::atomic_snapshot<subscriber_list> subscribers_;
   actor broker_;
 };
 
@@ -164,8 +184,9 @@ public:
       CAF_LOG_TRACE(CAF_ARG(dm));
       auto first = acquaintances_.begin();
       auto last = acquaintances_.end();
-      auto i = std::find_if(first, last, [&](const actor& a) {
-        return a == dm.source;
+      auto i = std::find_if(first, last,
+                            [&](const acquaintance_map::value_type& kvp) {
+        return kvp.first == dm.source;
       });
       if (i != last)
         acquaintances_.erase(i);
@@ -174,7 +195,12 @@ public:
     return {
       [=](join_atom, const actor& other) {
         CAF_LOG_TRACE(CAF_ARG(other));
-        if (acquaintances_.insert(other).second) {
+        // resolve the proxy type once instead of for each message
+        forwarding_actor_proxy* proxy = nullptr;
+        if (other->node() != system().node())
+          proxy = dynamic_cast<forwarding_actor_proxy*>(
+            actor_cast<abstract_actor*>(other));
+        if (acquaintances_.emplace(other, proxy).second) {
           monitor(other);
         }
       },
@@ -200,12 +226,41 @@ private:
     auto src = current_element_->sender;
     CAF_LOG_DEBUG(CAF_ARG(acquaintances_.size())
                   << CAF_ARG(src) << CAF_ARG(what));
-    for (auto& acquaintance : acquaintances_)
+    // proxies of remote subscribers sharing a manager receive `what` via a
+    // single message, allowing the manager to serialize it only once
+    std::map<actor, std::vector<strong_actor_ptr>> remotes;
+    for (auto& kvp : acquaintances_) {
+      auto& acquaintance = kvp.first;
+      auto proxy = kvp.second;
+      if (proxy != nullptr) {
+        auto mgr = proxy->manager();
+        if (!mgr.unsafe()) {
+          auto hdl = actor_cast<strong_actor_ptr>(acquaintance);
+          remotes[mgr].emplace_back(std::move(hdl));
+          continue;
+        }
+      }
       acquaintance->enqueue(src, invalid_message_id, what, context());
+    }
+    for (auto& kvp : remotes) {
+      if (kvp.second.size() == 1) {
+        kvp.second.front()->enqueue(src, invalid_message_id, what, context());
+        continue;
+      }
+      kvp.first->enqueue(nullptr, invalid_message_id,
+                         make_message(forward_atom::value, src,
+                                      std::vector<strong_actor_ptr>{},
+                                      std::move(kvp.second),
+                                      message_id::make(), what),
+                         context());
+    }
   }
 
+  // maps acquaintances to their proxy or to `nullptr` for local actors
+  using acquaintance_map = std::map<actor, forwarding_actor_proxy*>;
+
   local_group_ptr group_;
-  std::set<actor> acquaintances_;
+  acquaintance_map acquaintances_;
 };
 
 // Send a join message to the original group if a proxy
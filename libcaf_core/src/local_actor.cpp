@@ -30,6 +30,7 @@
 #include "caf/local_actor.hpp"
 #include "caf/actor_system.hpp"
 #include "caf/actor_ostream.hpp"
+#include "caf/actor_system_config.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/default_attachable.hpp"
 #include "caf/binary_deserializer.hpp"
@@ -47,7 +48,10 @@ local_actor::local_actor(actor_config& cfg)
     : monitorable_actor(cfg),
       context_(cfg.host),
       initial_behavior_fac_(std::move(cfg.init_fun)) {
-  // nop
+  if (getf(is_priority_aware_flag)) {
+    auto policy = home_system().config().mailbox_priority_policy;
+    lanes_.reset(new detail::mailbox_lanes(to_priority_policy(policy)));
+  }
 }
 
 local_actor::~local_actor() {
@@ -97,62 +101,57 @@ void local_actor::on_exit() {
 
 message_id local_actor::new_request_id(message_priority mp) {
   auto result = ++last_request_id_;
-  return mp == message_priority::normal ? result : result.with_high_priority();
+  return result.with_priority(mp);
 }
 
 mailbox_element_ptr local_actor::next_message() {
   if (!getf(is_priority_aware_flag))
     return mailbox_element_ptr{mailbox().try_pop()};
-  // we partition the mailbox into four segments in this case:
-  // <-------- ! was_skipped --------> | <--------  was_skipped  -------->
-  // <-- high prio --><-- low prio --> | <-- high prio --><-- low prio -->
-  auto& cache = mailbox().cache();
-  auto i = cache.begin();
-  auto e = cache.separator();
-  // read elements from mailbox if we don't have a high
-  // priority message or if cache is empty
-  if (i == e || !i->is_high_priority()) {
-    // insert points for high priority
-    auto hp_pos = i;
-    // read whole mailbox at once
-    auto tmp = mailbox().try_pop();
-    while (tmp) {
-      cache.insert(tmp->is_high_priority() ? hp_pos : e, tmp);
-      // adjust high priority insert point on first low prio element insert
-      if (hp_pos == e && !tmp->is_high_priority())
-        --hp_pos;
-      tmp = mailbox().try_pop();
-    }
-  }
-  mailbox_element_ptr result;
-  i = cache.begin();
-  if (i != e)
-    result.reset(cache.take(i));
-  return result;
+  // move all new elements into their lanes, fetching new data swaps the
+  // entire LIFO stack of the mailbox with a single CAS and each element
+  // then costs O(1) regardless of its priority
+  for (auto x = mailbox().try_pop(); x != nullptr; x = mailbox().try_pop())
+    lanes_->push_back(x);
+  return mailbox_element_ptr{lanes_->take_front()};
+}
+
+mailbox_element* local_actor::peek_next_message(const mailbox_element& x) {
+  if (!getf(is_priority_aware_flag))
+    return mailbox().peek();
+  // new elements end up behind all elements that are already in the lane
+  for (auto y = mailbox().try_pop(); y != nullptr; y = mailbox().try_pop())
+    lanes_->push_back(y);
+  return lanes_->front(detail::mailbox_lanes::lane_of(x.mid));
+}
+
+mailbox_element_ptr local_actor::take_next_message(const mailbox_element& x) {
+  if (!getf(is_priority_aware_flag))
+    return mailbox_element_ptr{mailbox().try_pop()};
+  return mailbox_element_ptr{
+    lanes_->pop_front(detail::mailbox_lanes::lane_of(x.mid))};
 }
 
 bool local_actor::has_next_message() {
   if (!getf(is_priority_aware_flag))
     return mailbox_.can_fetch_more();
-  auto& mbox = mailbox();
-  auto& cache = mbox.cache();
-  return cache.begin() != cache.separator() || mbox.can_fetch_more();
+  return !lanes_->empty() || mailbox_.can_fetch_more();
 }
 
 void local_actor::push_to_cache(mailbox_element_ptr ptr) {
   CAF_ASSERT(ptr != nullptr);
   CAF_LOG_TRACE(CAF_ARG(*ptr));
-  if (!getf(is_priority_aware_flag) || !ptr->is_high_priority()) {
-    mailbox().cache().insert(mailbox().cache().end(), ptr.release());
+  auto& cache = mailbox().cache();
+  if (!getf(is_priority_aware_flag)) {
+    cache.insert(cache.end(), ptr.release());
     return;
   }
-  auto high_prio = [](const mailbox_element& val) {
-    return val.is_high_priority();
+  // keep skipped messages sorted by their lane
+  auto lane = detail::mailbox_lanes::lane_of(ptr->mid);
+  auto more_or_equally_urgent = [=](const mailbox_element& x) {
+    return detail::mailbox_lanes::lane_of(x.mid) <= lane;
   };
-  auto& cache = mailbox().cache();
-  auto e = cache.end();
-  cache.insert(std::partition_point(cache.continuation(),
-                                    e, high_prio),
+  cache.insert(std::partition_point(cache.continuation(), cache.end(),
+                                    more_or_equally_urgent),
                ptr.release());
 }
 
@@ -188,6 +187,8 @@ bool local_actor::cleanup(error&& fail_state, execution_unit* host) {
   if (!mailbox_.closed()) {
     detail::sync_request_bouncer f{fail_state};
     mailbox_.close(f);
+    if (lanes_)
+      lanes_->clear(f);
   }
   // tell registry we're done
   unregister_from_system();
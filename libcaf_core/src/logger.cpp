@@ -20,11 +20,12 @@
 #include "caf/logger.hpp"
 
 #include <ctime>
+#include <chrono>
 #include <thread>
 #include <cstring>
 #include <fstream>
 #include <algorithm>
-#include <condition_variable>
+#include <unordered_map>
 
 #include "caf/config.hpp"
 
@@ -39,12 +40,34 @@
 #include "caf/locks.hpp"
 #include "caf/actor_proxy.hpp"
 #include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
 
+#include "caf/detail/ring_buffer.hpp"
 #include "caf/detail/get_process_id.hpp"
-#include "caf/detail/single_reader_queue.hpp"
 
 namespace caf {
 
+namespace detail {
+
+struct log_thread_buffer {
+  log_thread_buffer(size_t size)
+      : events(size),
+        owner(std::this_thread::get_id()),
+        closed(false),
+        dropped(0) {
+    // nop
+  }
+
+  ring_buffer events;
+  std::thread::id owner;
+  // set by the owning thread on exit or by the logger on shutdown
+  std::atomic<bool> closed;
+  // number of events that did not fit into `events`
+  std::atomic<size_t> dropped;
+};
+
+} // namespace detail
+
 namespace {
 
 constexpr const char* log_level_name[] = {
@@ -55,6 +78,46 @@ constexpr const char* log_level_name[] = {
   "TRACE"
 };
 
+constexpr size_t default_buffer_size = 1024 * 1024;
+
+// binary representation of an event, followed by the rendered message
+struct log_record {
+  std::chrono::high_resolution_clock::rep timestamp;
+  actor_id aid;
+  std::thread::id tid;
+  const char* component;
+  const char* pretty_fun;
+  const char* function_name;
+  const char* file_name;
+  int level;
+  int line_num;
+};
+
+std::atomic<uint64_t> next_logger_id{1};
+
+#ifdef CAF_MSVC
+thread_local
+#else
+__thread
+#endif
+actor_id current_actor_id = 0;
+
+// stores the buffers of the calling thread for each logger it wrote to
+struct thread_buffer_cache {
+  using buffer_ptr = std::shared_ptr<detail::log_thread_buffer>;
+
+  using value_type = std::pair<uint64_t, buffer_ptr>;
+
+  ~thread_buffer_cache() {
+    for (auto& x : buffers)
+      x.second->closed = true;
+  }
+
+  std::vector<value_type> buffers;
+};
+
+thread_local thread_buffer_cache thread_buffers;
+
 #ifdef CAF_LOG_LEVEL
 static_assert(CAF_LOG_LEVEL >= 0 && CAF_LOG_LEVEL <= 4,
               "assertion: 0 <= CAF_LOG_LEVEL <= 4");
@@ -123,15 +186,56 @@ void prettify_type_name(std::string& class_name, const char* c_class_name) {
   prettify_type_name(class_name);
 }
 
-} // namespace <anonymous>
+const char* strip_path(const char* file_name) {
+  auto result = strrchr(file_name, '/');
+  return result != nullptr ? result + 1 : file_name;
+}
 
-logger::event::event(std::string x)
-    : next(nullptr),
-      prev(nullptr),
-      msg(std::move(x)) {
-  // nop
+// checks whether `component` equals `prefix` or is a subcomponent of it
+bool is_subcomponent(const char* component, const std::string& prefix) {
+  if (strncmp(component, prefix.c_str(), prefix.size()) != 0)
+    return false;
+  auto c = component[prefix.size()];
+  return c == '\0' || c == '.';
 }
 
+// all loggers in this process, used for computing the upper bound
+// for the verbosity checked in the fast path
+std::mutex& loggers_mtx() {
+  static std::mutex result;
+  return result;
+}
+
+std::vector<logger*>& loggers() {
+  static std::vector<logger*> result;
+  return result;
+}
+
+// head of the intrusive list of all registered call sites, guarded by the
+// mutex for all loggers
+logger::call_site*& call_sites() {
+  static logger::call_site* result = nullptr;
+  return result;
+}
+
+// parses "key=value" pairs separated by commas
+template <class F>
+void parse_verbosity_list(const std::string& str, const char* option, F f) {
+  std::vector<std::string> entries;
+  split(entries, str, ",", token_compress_on);
+  for (auto& entry : entries) {
+    std::vector<std::string> kvp;
+    split(kvp, entry, "= ", token_compress_on);
+    int level;
+    if (kvp.size() != 2 || !logger::parse_verbosity(kvp[1], level)
+        || !f(kvp[0], level))
+      std::cerr << "[WARNING] invalid entry \"" << entry << "\" in "
+                << option << " ignored" << std::endl;
+  }
+}
+
+} // namespace <anonymous>
+
 logger::line_builder::line_builder() : behind_arg_(false) {
   // nop
 }
@@ -152,8 +256,8 @@ logger::line_builder& logger::line_builder::operator<<(const char* str) {
   return *this;
 }
 
-std::string logger::line_builder::get() const {
-  return std::move(str_);
+const std::string& logger::line_builder::get() const {
+  return str_;
 }
 
 std::string logger::render_type_name(const std::type_info& ti) {
@@ -195,55 +299,235 @@ std::string logger::extract_class_name(const char* prettyfun, size_t strsize) {
 
 // returns the actor ID for the current thread
 actor_id logger::thread_local_aid() {
-  shared_lock<detail::shared_spinlock> guard{aids_lock_};
-  auto i = aids_.find(std::this_thread::get_id());
-  if (i != aids_.end())
-    return i->second;
-  return 0;
+  return current_actor_id;
 }
 
 actor_id logger::thread_local_aid(actor_id aid) {
-  auto tid = std::this_thread::get_id();
-  upgrade_lock<detail::shared_spinlock> guard{aids_lock_};
-  auto i = aids_.find(tid);
-  if (i != aids_.end()) {
-    // we modify it despite the shared lock because the elements themselves
-    // are considered thread-local
-    auto res = i->second;
-    i->second = aid;
-    return res;
-  }
-  // upgrade to unique lock and insert new element
-  upgrade_to_unique_lock<detail::shared_spinlock> uguard{guard};
-  aids_.emplace(tid, aid);
-  return 0; // was empty before
+  std::swap(current_actor_id, aid);
+  return aid;
 }
 
-void logger::log(int level, const char* component,
-                 const std::string& class_name, const char* function_name,
-                 const char* c_full_file_name, int line_num,
-                 const std::string& msg) {
+void logger::log(int level, const char* component, const char* pretty_fun,
+                 const char* function_name, const char* file_name,
+                 int line_num, const std::string& msg) {
   CAF_ASSERT(level >= 0 && level <= 4);
-  std::string file_name;
-  std::string full_file_name = c_full_file_name;
-  auto ri = find(full_file_name.rbegin(), full_file_name.rend(), '/');
-  if (ri != full_file_name.rend()) {
-    auto i = ri.base();
-    if (i == full_file_name.end())
-      file_name = std::move(full_file_name);
-    else
-      file_name = std::string(i, full_file_name.end());
+  auto& buf = thread_buffer();
+  auto t0 = std::chrono::high_resolution_clock::now().time_since_epoch();
+  auto f = [&](char* ptr) {
+    auto x = new (ptr) log_record;
+    x->timestamp = t0.count();
+    x->aid = current_actor_id;
+    x->tid = buf.owner;
+    x->component = component;
+    x->pretty_fun = pretty_fun;
+    x->function_name = function_name;
+    x->file_name = file_name;
+    x->level = level;
+    x->line_num = line_num;
+    memcpy(ptr + sizeof(log_record), msg.data(), msg.size());
+  };
+  if (buf.events.push(sizeof(log_record) + msg.size(), f))
+    events_.notify_one();
+  else
+    buf.dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t logger::dropped_events() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+constexpr int logger::quiet;
+
+constexpr int logger::call_site::unregistered;
+
+std::atomic<int> logger::max_verbosity_{logger::quiet};
+
+int logger::verbosity() const {
+  shared_lock<detail::shared_spinlock> guard{filter_lock_};
+  return verbosity_;
+}
+
+void logger::verbosity(int level) {
+  CAF_ASSERT(level >= quiet && level <= CAF_LOG_LEVEL_TRACE);
+  unique_lock<detail::shared_spinlock> guard{filter_lock_};
+  verbosity_ = level;
+  guard.unlock();
+  update_max_verbosity();
+}
+
+void logger::component_verbosity(const std::string& component, int level) {
+  CAF_ASSERT(level >= quiet && level <= CAF_LOG_LEVEL_TRACE);
+  unique_lock<detail::shared_spinlock> guard{filter_lock_};
+  auto& xs = component_verbosity_;
+  auto pred = [&](const std::pair<std::string, int>& x) {
+    return x.first == component;
+  };
+  auto i = std::find_if(xs.begin(), xs.end(), pred);
+  if (i != xs.end()) {
+    i->second = level;
   } else {
-    file_name = std::move(full_file_name);
+    xs.emplace_back(component, level);
+    // check more specific components first
+    std::stable_sort(xs.begin(), xs.end(),
+                     [](const std::pair<std::string, int>& x,
+                        const std::pair<std::string, int>& y) {
+                       return x.first.size() > y.first.size();
+                     });
   }
-  auto t0 = std::chrono::high_resolution_clock::now().time_since_epoch();
-  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t0).count();
-  std::ostringstream line;
-  line << ms << " " << component << " " << log_level_name[level] << " "
-       << "actor" << thread_local_aid() << " " << std::this_thread::get_id()
-       << " " << class_name << " " << function_name << " " << file_name << ":"
-       << line_num << " " << msg << std::endl;
-  queue_.synchronized_enqueue(queue_mtx_, queue_cv_, new event{line.str()});
+  guard.unlock();
+  update_max_verbosity();
+}
+
+void logger::erase_component_verbosity(const std::string& component) {
+  unique_lock<detail::shared_spinlock> guard{filter_lock_};
+  auto& xs = component_verbosity_;
+  auto pred = [&](const std::pair<std::string, int>& x) {
+    return x.first == component;
+  };
+  xs.erase(std::remove_if(xs.begin(), xs.end(), pred), xs.end());
+  guard.unlock();
+  update_max_verbosity();
+}
+
+void logger::actor_verbosity(actor_id aid, int level) {
+  CAF_ASSERT(level >= quiet && level <= CAF_LOG_LEVEL_TRACE);
+  unique_lock<detail::shared_spinlock> guard{filter_lock_};
+  actor_verbosity_[aid] = level;
+  guard.unlock();
+  update_max_verbosity();
+}
+
+void logger::erase_actor_verbosity(actor_id aid) {
+  unique_lock<detail::shared_spinlock> guard{filter_lock_};
+  actor_verbosity_.erase(aid);
+  guard.unlock();
+  update_max_verbosity();
+}
+
+bool logger::parse_verbosity(const std::string& name, int& level) {
+  const char* names[] = {"error", "warning", "info", "debug", "trace"};
+  if (name == "quiet") {
+    level = quiet;
+    return true;
+  }
+  auto first = std::begin(names);
+  auto last = std::end(names);
+  auto i = std::find(first, last, name);
+  if (i == last)
+    return false;
+  level = static_cast<int>(std::distance(first, i));
+  return true;
+}
+
+bool logger::accepts_impl(int level, const char* component) {
+  auto ptr = get_current_logger();
+  return ptr != nullptr && ptr->filter(level, component);
+}
+
+bool logger::accepts_impl(call_site& site, int level) {
+  if (site.threshold() == call_site::unregistered) {
+    std::unique_lock<std::mutex> guard{loggers_mtx()};
+    // another thread may have registered the call site in the meantime
+    if (site.threshold() == call_site::unregistered) {
+      site.next_ = call_sites();
+      call_sites() = &site;
+      refresh(site);
+    }
+    guard.unlock();
+    if (level > site.threshold())
+      return false;
+  }
+  return accepts_impl(level, site.component());
+}
+
+void logger::refresh(call_site& site) {
+  auto result = quiet;
+  for (auto ptr : loggers())
+    result = std::max(result, ptr->max_level(site.component()));
+  site.threshold_.store(result, std::memory_order_relaxed);
+}
+
+int logger::component_level(const char* component) const {
+  for (auto& x : component_verbosity_)
+    if (is_subcomponent(component, x.first))
+      return x.second;
+  return verbosity_;
+}
+
+bool logger::filter(int level, const char* component) const {
+  shared_lock<detail::shared_spinlock> guard{filter_lock_};
+  if (level <= component_level(component))
+    return true;
+  if (actor_verbosity_.empty())
+    return false;
+  auto i = actor_verbosity_.find(current_actor_id);
+  return i != actor_verbosity_.end() && level <= i->second;
+}
+
+int logger::max_level(const char* component) const {
+  shared_lock<detail::shared_spinlock> guard{filter_lock_};
+  auto result = component_level(component);
+  for (auto& x : actor_verbosity_)
+    result = std::max(result, x.second);
+  return result;
+}
+
+int logger::max_level() const {
+  shared_lock<detail::shared_spinlock> guard{filter_lock_};
+  auto result = verbosity_;
+  for (auto& x : component_verbosity_)
+    result = std::max(result, x.second);
+  for (auto& x : actor_verbosity_)
+    result = std::max(result, x.second);
+  return result;
+}
+
+void logger::update_max_verbosity() {
+  std::unique_lock<std::mutex> guard{loggers_mtx()};
+  auto result = quiet;
+  for (auto ptr : loggers())
+    result = std::max(result, ptr->max_level());
+  max_verbosity_.store(result, std::memory_order_relaxed);
+  for (auto site = call_sites(); site != nullptr; site = site->next_)
+    refresh(*site);
+}
+
+void logger::init_filters(const actor_system_config& cfg) {
+  int level;
+  if (parse_verbosity(to_string(cfg.logger_verbosity), level))
+    verbosity(level);
+  parse_verbosity_list(cfg.logger_component_verbosity,
+                       "logger.component-verbosity",
+                       [&](const std::string& component, int lvl) {
+    component_verbosity(component, lvl);
+    return true;
+  });
+  parse_verbosity_list(cfg.logger_actor_verbosity, "logger.actor-verbosity",
+                       [&](const std::string& str, int lvl) {
+    char* end = nullptr;
+    auto aid = strtoull(str.c_str(), &end, 10);
+    if (end == str.c_str() || *end != '\0')
+      return false;
+    actor_verbosity(static_cast<actor_id>(aid), lvl);
+    return true;
+  });
+}
+
+detail::log_thread_buffer& logger::thread_buffer() {
+  auto& xs = thread_buffers.buffers;
+  for (auto& x : xs)
+    if (x.first == id_)
+      return *x.second;
+  // first event of this thread, drop buffers of loggers that shut down
+  using value_type = thread_buffer_cache::value_type;
+  auto closed = [](const value_type& x) { return x.second->closed.load(); };
+  xs.erase(std::remove_if(xs.begin(), xs.end(), closed), xs.end());
+  auto ptr = std::make_shared<detail::log_thread_buffer>(buffer_size_);
+  std::unique_lock<std::mutex> guard{buffers_mtx_};
+  buffers_.push_back(ptr);
+  guard.unlock();
+  xs.emplace_back(id_, ptr);
+  return *ptr;
 }
 
 void logger::set_current_actor_system(actor_system* x) {
@@ -255,21 +539,38 @@ logger* logger::current_logger() {
 }
 
 void logger::log_static(int level, const char* component,
-                        const std::string& class_name,
+                        const char* pretty_fun,
                         const char* function_name, const char* file_name,
                         int line_num, const std::string& msg) {
   auto ptr = get_current_logger();
   if (ptr)
-    ptr->log(level, component, class_name, function_name, file_name, line_num,
+    ptr->log(level, component, pretty_fun, function_name, file_name, line_num,
              msg);
 }
 
 logger::~logger() {
-  // nop
+  std::unique_lock<std::mutex> guard{loggers_mtx()};
+  auto& xs = loggers();
+  xs.erase(std::find(xs.begin(), xs.end(), this));
+  guard.unlock();
+  update_max_verbosity();
 }
 
-logger::logger(actor_system& sys) : system_(sys) {
-  // nop
+logger::logger(actor_system& sys)
+    : system_(sys),
+      id_(next_logger_id++),
+      buffer_size_(default_buffer_size),
+      running_(false),
+      dropped_(0) {
+#ifdef CAF_LOG_LEVEL
+  verbosity_ = CAF_LOG_LEVEL;
+#else
+  verbosity_ = quiet;
+#endif
+  std::unique_lock<std::mutex> guard{loggers_mtx()};
+  loggers().push_back(this);
+  guard.unlock();
+  update_max_verbosity();
 }
 
 void logger::run() {
@@ -278,36 +579,108 @@ void logger::run() {
         << "_" << to_string(system_.node())
         << ".log";
   std::fstream out(fname.str().c_str(), std::ios::out | std::ios::app);
-  std::unique_ptr<event> ptr;
+  // extracting class names is expensive, hence we cache them for
+  // each (unique) pointer to a function signature
+  std::unordered_map<const char*, std::string> class_names;
+  auto class_name = [&](const char* pretty_fun) -> const std::string& {
+    auto i = class_names.find(pretty_fun);
+    if (i == class_names.end())
+      i = class_names.emplace(pretty_fun,
+                              extract_class_name(pretty_fun,
+                                                 strlen(pretty_fun) + 1)).first;
+    return i->second;
+  };
+  auto write = [&](const char* ptr, size_t size) {
+    auto& x = *reinterpret_cast<const log_record*>(ptr);
+    using std::chrono::high_resolution_clock;
+    high_resolution_clock::duration t0{x.timestamp};
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t0).count();
+    out << ms << " " << x.component << " " << log_level_name[x.level] << " "
+        << "actor" << x.aid << " " << x.tid << " " << class_name(x.pretty_fun)
+        << " " << x.function_name << " " << strip_path(x.file_name) << ":"
+        << x.line_num << " ";
+    out.write(ptr + sizeof(log_record),
+              static_cast<std::streamsize>(size - sizeof(log_record)));
+    out << '\n';
+  };
+  std::vector<std::shared_ptr<detail::log_thread_buffer>> buffers;
+  // registers as waiter before draining the buffers while idle, because
+  // producers only notify the logger if it waits for events
+  auto idle = false;
+  detail::event_count::key_type key = 0;
   for (;;) {
-    // make sure we have data to read
-    queue_.synchronized_await(queue_mtx_, queue_cv_);
-    // read & process event
-    ptr.reset(queue_.try_pop());
-    CAF_ASSERT(ptr != nullptr);
-    if (ptr->msg.empty()) {
-      out.close();
-      return;
+    if (idle)
+      key = events_.prepare_wait();
+    // read the flag before draining the buffers to make sure we
+    // write all events logged before calling stop()
+    auto running = running_.load();
+    std::unique_lock<std::mutex> guard{buffers_mtx_};
+    buffers = buffers_;
+    guard.unlock();
+    size_t events = 0;
+    for (auto& buf : buffers) {
+      auto closed = buf->closed.load();
+      events += buf->events.consume(write);
+      auto dropped = buf->dropped.exchange(0, std::memory_order_relaxed);
+      if (dropped > 0) {
+        dropped_ += dropped;
+        auto t0 = std::chrono::high_resolution_clock::now().time_since_epoch();
+        out << std::chrono::duration_cast<std::chrono::milliseconds>(t0).count()
+            << " caf " << log_level_name[CAF_LOG_LEVEL_WARNING] << " actor0 "
+            << std::this_thread::get_id() << " caf.logger run "
+            << strip_path(__FILE__) << ":" << __LINE__ << " dropped "
+            << dropped << " events of thread " << buf->owner << '\n';
+      }
+      if (closed) {
+        // the owning thread terminated and we have read its last event
+        guard.lock();
+        buffers_.erase(std::find(buffers_.begin(), buffers_.end(), buf));
+        guard.unlock();
+      }
+    }
+    if (events > 0)
+      out << std::flush;
+    if (!running) {
+      if (idle)
+        events_.cancel_wait();
+      break;
+    }
+    if (idle) {
+      if (events == 0)
+        events_.wait(key);
+      else
+        events_.cancel_wait();
     }
-    out << ptr->msg << std::flush;
+    idle = events == 0;
   }
+  out.close();
+  // threads remove buffers of stopped loggers from their caches
+  std::unique_lock<std::mutex> guard{buffers_mtx_};
+  for (auto& buf : buffers_)
+    buf->closed = true;
+  buffers_.clear();
 }
 
 void logger::start() {
+  init_filters(system_.config());
 #if defined(CAF_LOG_LEVEL) && CAF_LOG_LEVEL >= CAF_LOG_LEVEL_INFO
   const char* log_level_table[] = {"ERROR", "WARN", "INFO", "DEBUG", "TRACE"};
+  buffer_size_ = system_.config().logger_buffer_size;
+  running_ = true;
   thread_ = std::thread{[this] { this->run(); }};
   std::string msg = "ENTRY log level = ";
   msg += log_level_table[global_log_level];
-  log(CAF_LOG_LEVEL_INFO, "caf", "caf::logger", "run", __FILE__, __LINE__, msg);
+  log(CAF_LOG_LEVEL_INFO, "caf", "void caf::logger::run()", "run", __FILE__,
+      __LINE__, msg);
 #endif
 }
 
 void logger::stop() {
 #if defined(CAF_LOG_LEVEL) && CAF_LOG_LEVEL >= CAF_LOG_LEVEL_INFO
-  log(CAF_LOG_LEVEL_INFO, "caf", "caf::logger", "run", __FILE__, __LINE__, "EXIT");
-  // an empty string means: shut down
-  queue_.synchronized_enqueue(queue_mtx_, queue_cv_, new event{""});
+  log(CAF_LOG_LEVEL_INFO, "caf", "void caf::logger::run()", "run", __FILE__,
+      __LINE__, "EXIT");
+  running_ = false;
+  events_.notify_one();
   thread_.join();
 #endif
 }
@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/detail/mailbox_lanes.hpp"
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+// the weighted policy takes up to 2^(n-1-i) elements in a row from lane i
+constexpr size_t weight(size_t lane) {
+  return size_t{1} << (message_priorities - 1 - lane);
+}
+
+} // namespace <anonymous>
+
+mailbox_lanes::mailbox_lanes(priority_policy policy)
+    : policy_(policy),
+      size_(0),
+      current_(0),
+      credit_(weight(0)) {
+  // nop
+}
+
+mailbox_lanes::~mailbox_lanes() {
+  auto nop = [](const mailbox_element&) {};
+  clear(nop);
+}
+
+void mailbox_lanes::push_back(pointer x) {
+  CAF_ASSERT(x != nullptr);
+  auto& l = lanes_[lane_of(x->mid)];
+  x->next = nullptr;
+  if (l.tail == nullptr)
+    l.head = x;
+  else
+    l.tail->next = x;
+  l.tail = x;
+  ++size_;
+}
+
+mailbox_lanes::pointer mailbox_lanes::take_front() {
+  if (size_ == 0)
+    return nullptr;
+  if (policy_ == priority_policy::strict) {
+    for (auto& l : lanes_)
+      if (l.head != nullptr)
+        return take_front(l);
+    return nullptr;
+  }
+  // weighted round-robin: stay on the current lane while it has elements
+  // and credit left, otherwise move on and refill the credit
+  for (;;) {
+    auto& l = lanes_[current_];
+    if (l.head != nullptr && credit_ > 0) {
+      --credit_;
+      return take_front(l);
+    }
+    current_ = (current_ + 1) % message_priorities;
+    credit_ = weight(current_);
+  }
+}
+
+mailbox_lanes::pointer mailbox_lanes::pop_front(size_t lane) {
+  auto& l = lanes_[lane];
+  return l.head != nullptr ? take_front(l) : nullptr;
+}
+
+mailbox_lanes::pointer mailbox_lanes::take_front(lane& l) {
+  auto result = l.head;
+  l.head = result->next;
+  if (l.head == nullptr)
+    l.tail = nullptr;
+  result->next = nullptr;
+  --size_;
+  return result;
+}
+
+} // namespace detail
+} // namespace caf
@@ -0,0 +1,198 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/telemetry/metric.hpp"
+
+#include <algorithm>
+
+namespace caf {
+namespace telemetry {
+
+// -- free functions -----------------------------------------------------------
+
+size_t next_shard() {
+  static std::atomic<size_t> next{0};
+  return next.fetch_add(1, std::memory_order_relaxed) % num_shards;
+}
+
+namespace {
+
+void append(std::string& out, uint64_t x) {
+  out += std::to_string(x);
+}
+
+void append(std::string& out, int64_t x) {
+  out += std::to_string(x);
+}
+
+} // namespace <anonymous>
+
+// -- metric -------------------------------------------------------------------
+
+metric::metric(metric_type type, std::string name, std::string help,
+               std::string labels)
+    : type_(type),
+      name_(std::move(name)),
+      help_(std::move(help)),
+      labels_(std::move(labels)) {
+  // nop
+}
+
+metric::~metric() {
+  // nop
+}
+
+const char* metric::name_of(metric_type x) {
+  switch (x) {
+    case counter_type:
+      return "counter";
+    case gauge_type:
+      return "gauge";
+    default:
+      return "histogram";
+  }
+}
+
+void metric::render_name(std::string& out, const char* suffix,
+                         const std::string& extra_label) const {
+  out += name_;
+  out += suffix;
+  if (labels_.empty() && extra_label.empty())
+    return;
+  out += '{';
+  out += labels_;
+  if (!labels_.empty() && !extra_label.empty())
+    out += ',';
+  out += extra_label;
+  out += '}';
+}
+
+// -- counter ------------------------------------------------------------------
+
+counter::counter(std::string name, std::string help, std::string labels)
+    : metric(counter_type, std::move(name), std::move(help),
+             std::move(labels)) {
+  // nop
+}
+
+uint64_t counter::value() const {
+  uint64_t result = 0;
+  for (auto& x : shards_)
+    result += x.value.load(std::memory_order_relaxed);
+  return result;
+}
+
+void counter::render(std::string& out) const {
+  render_name(out, "");
+  out += ' ';
+  append(out, value());
+  out += '\n';
+}
+
+// -- gauge --------------------------------------------------------------------
+
+gauge::gauge(std::string name, std::string help, std::string labels,
+             callback f)
+    : metric(gauge_type, std::move(name), std::move(help), std::move(labels)),
+      value_(0),
+      f_(std::move(f)) {
+  // nop
+}
+
+int64_t gauge::value() const {
+  return f_ ? f_() : value_.load(std::memory_order_relaxed);
+}
+
+void gauge::render(std::string& out) const {
+  render_name(out, "");
+  out += ' ';
+  append(out, value());
+  out += '\n';
+}
+
+// -- histogram ----------------------------------------------------------------
+
+histogram::histogram(std::string name, std::string help, std::string labels,
+                     std::vector<uint64_t> upper_bounds)
+    : metric(histogram_type, std::move(name), std::move(help),
+             std::move(labels)),
+      bounds_(std::move(upper_bounds)) {
+  CAF_ASSERT(std::is_sorted(bounds_.begin(), bounds_.end()));
+  auto n = bounds_.size() + 1;
+  for (auto& x : shards_) {
+    x.buckets.reset(new std::atomic<uint64_t>[n]);
+    for (size_t i = 0; i < n; ++i)
+      x.buckets[i] = 0;
+  }
+}
+
+void histogram::observe(uint64_t x) {
+  // linear search, since histograms usually have only a handful of buckets
+  size_t i = 0;
+  while (i < bounds_.size() && x > bounds_[i])
+    ++i;
+  auto& s = shards_[this_shard()];
+  s.buckets[i].fetch_add(1, std::memory_order_relaxed);
+  s.sum.value.fetch_add(x, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> histogram::buckets() const {
+  std::vector<uint64_t> result(bounds_.size() + 1, 0);
+  for (auto& s : shards_)
+    for (size_t i = 0; i < result.size(); ++i)
+      result[i] += s.buckets[i].load(std::memory_order_relaxed);
+  return result;
+}
+
+uint64_t histogram::sum() const {
+  uint64_t result = 0;
+  for (auto& s : shards_)
+    result += s.sum.value.load(std::memory_order_relaxed);
+  return result;
+}
+
+void histogram::render(std::string& out) const {
+  auto xs = buckets();
+  uint64_t total = 0;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    // the exposition format uses cumulative bucket counts
+    total += xs[i];
+    std::string le = "le=\"";
+    if (i < bounds_.size())
+      le += std::to_string(bounds_[i]);
+    else
+      le += "+Inf";
+    le += '"';
+    render_name(out, "_bucket", le);
+    out += ' ';
+    append(out, total);
+    out += '\n';
+  }
+  render_name(out, "_sum");
+  out += ' ';
+  append(out, sum());
+  out += '\n';
+  render_name(out, "_count");
+  out += ' ';
+  append(out, total);
+  out += '\n';
+}
+
+} // namespace telemetry
+} // namespace caf
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/telemetry/metric_registry.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "caf/config.hpp"
+
+namespace caf {
+namespace telemetry {
+
+metric_registry::metric_registry() {
+  // nop
+}
+
+metric_registry::~metric_registry() {
+  // nop
+}
+
+template <class T, class... Ts>
+T& metric_registry::get_or_add(metric::metric_type type, std::string name,
+                               std::string help, std::string labels,
+                               Ts&&... xs) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  auto ptr = find(name, labels);
+  if (ptr != nullptr) {
+    if (ptr->type() != type)
+      CAF_RAISE_ERROR("metric type mismatch: " + name);
+    return static_cast<T&>(*ptr);
+  }
+  auto res = new T(std::move(name), std::move(help), std::move(labels),
+                   std::forward<Ts>(xs)...);
+  insert_impl(res);
+  return *res;
+}
+
+counter& metric_registry::add_counter(std::string name, std::string help,
+                                      std::string labels) {
+  return get_or_add<counter>(metric::counter_type, std::move(name),
+                             std::move(help), std::move(labels));
+}
+
+gauge& metric_registry::add_gauge(std::string name, std::string help,
+                                  std::string labels) {
+  return get_or_add<gauge>(metric::gauge_type, std::move(name),
+                           std::move(help), std::move(labels));
+}
+
+gauge& metric_registry::add_gauge(std::string name, std::string help,
+                                  gauge::callback f, std::string labels) {
+  auto& res = get_or_add<gauge>(metric::gauge_type, std::move(name),
+                                std::move(help), std::move(labels));
+  // rendering holds the same lock, i.e., never runs concurrently
+  std::unique_lock<std::mutex> guard{mtx_};
+  res.f_ = std::move(f);
+  return res;
+}
+
+histogram& metric_registry::add_histogram(std::string name, std::string help,
+                                          std::vector<uint64_t> upper_bounds,
+                                          std::string labels) {
+  return get_or_add<histogram>(metric::histogram_type, std::move(name),
+                               std::move(help), std::move(labels),
+                               std::move(upper_bounds));
+}
+
+void metric_registry::erase(const metric& x) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  erase_impl(x);
+}
+
+size_t metric_registry::size() const {
+  std::unique_lock<std::mutex> guard{mtx_};
+  return metrics_.size();
+}
+
+void metric_registry::render(std::string& out) const {
+  std::unique_lock<std::mutex> guard{mtx_};
+  const std::string* family = nullptr;
+  for (auto& ptr : metrics_) {
+    if (family == nullptr || *family != ptr->name()) {
+      family = &ptr->name();
+      out += "# HELP ";
+      out += ptr->name();
+      out += ' ';
+      out += ptr->help();
+      out += "\n# TYPE ";
+      out += ptr->name();
+      out += ' ';
+      out += metric::name_of(ptr->type());
+      out += '\n';
+    }
+    ptr->render(out);
+  }
+}
+
+std::string metric_registry::render() const {
+  std::string result;
+  render(result);
+  return result;
+}
+
+metric* metric_registry::find(const std::string& name,
+                              const std::string& labels) const {
+  for (auto& ptr : metrics_)
+    if (ptr->name() == name && ptr->labels() == labels)
+      return ptr.get();
+  return nullptr;
+}
+
+void metric_registry::insert_impl(metric* x) {
+  std::unique_ptr<metric> ptr{x};
+  auto pred = [](const std::unique_ptr<metric>& y, const std::string& name) {
+    return y->name() < name;
+  };
+  auto i = std::lower_bound(metrics_.begin(), metrics_.end(), x->name(), pred);
+  // keep insertion order within a family
+  while (i != metrics_.end() && (*i)->name() == x->name())
+    ++i;
+  metrics_.insert(i, std::move(ptr));
+}
+
+void metric_registry::erase_impl(const metric& x) {
+  auto pred = [&](const std::unique_ptr<metric>& y) {
+    return y.get() == &x;
+  };
+  auto i = std::find_if(metrics_.begin(), metrics_.end(), pred);
+  if (i != metrics_.end())
+    metrics_.erase(i);
+}
+
+} // namespace telemetry
+} // namespace caf
@@ -0,0 +1,51 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/overload_policy.hpp"
+
+#include "caf/detail/enum_to_string.hpp"
+
+namespace caf {
+
+namespace {
+
+const char* overload_policy_strings[] = {
+  "drop_newest",
+  "drop_oldest",
+  "reject",
+  "back_pressure"
+};
+
+} // namespace <anonymous>
+
+overload_policy to_overload_policy(atom_value x) {
+  if (x == atom("drop-old"))
+    return overload_policy::drop_oldest;
+  if (x == atom("reject"))
+    return overload_policy::reject;
+  if (x == atom("back-press"))
+    return overload_policy::back_pressure;
+  return overload_policy::drop_newest;
+}
+
+std::string to_string(overload_policy x) {
+  return detail::enum_to_string(x, overload_policy_strings);
+}
+
+} // namespace caf
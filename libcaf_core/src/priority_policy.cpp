@@ -0,0 +1,45 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/priority_policy.hpp"
+
+#include "caf/detail/enum_to_string.hpp"
+
+namespace caf {
+
+namespace {
+
+const char* priority_policy_strings[] = {
+  "strict",
+  "weighted"
+};
+
+} // namespace <anonymous>
+
+priority_policy to_priority_policy(atom_value x) {
+  if (x == atom("weighted"))
+    return priority_policy::weighted;
+  return priority_policy::strict;
+}
+
+std::string to_string(priority_policy x) {
+  return detail::enum_to_string(x, priority_policy_strings);
+}
+
+} // namespace caf
@@ -0,0 +1,133 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/detail/response_handler.hpp"
+
+#include "caf/message.hpp"
+#include "caf/make_type_erased_tuple_view.hpp"
+
+namespace caf {
+namespace detail {
+
+namespace {
+
+// response handlers have no result, we only care whether a callback matched
+class discarding_visitor : public invoke_result_visitor {
+public:
+  void operator()() override {
+    // nop
+  }
+
+  void operator()(error&) override {
+    // nop
+  }
+
+  void operator()(message&) override {
+    // nop
+  }
+
+  void operator()(const none_t&) override {
+    // nop
+  }
+};
+
+} // namespace <anonymous>
+
+class response_handler::behavior_callback final : public impl {
+public:
+  explicit behavior_callback(behavior bhvr) : bhvr_(std::move(bhvr)) {
+    // nop
+  }
+
+  match_case::result invoke(invoke_result_visitor& f,
+                            type_erased_tuple& xs) override {
+    return bhvr_(f, xs);
+  }
+
+  impl* move_to(void* storage) override {
+    return new (storage) behavior_callback(std::move(bhvr_));
+  }
+
+private:
+  behavior bhvr_;
+};
+
+constexpr size_t response_handler::inline_size;
+
+response_handler::impl::~impl() {
+  // nop
+}
+
+response_handler::response_handler(behavior bhvr) : ptr_(nullptr) {
+  if (bhvr)
+    emplace<behavior_callback>(std::move(bhvr));
+}
+
+response_handler::response_handler(response_handler&& other) : ptr_(nullptr) {
+  *this = std::move(other);
+}
+
+response_handler& response_handler::operator=(response_handler&& other) {
+  if (this == &other)
+    return *this;
+  reset();
+  if (other.is_inline()) {
+    ptr_ = other.ptr_->move_to(&storage_);
+    other.reset();
+  } else {
+    ptr_ = other.ptr_;
+    other.ptr_ = nullptr;
+  }
+  return *this;
+}
+
+response_handler::~response_handler() {
+  reset();
+}
+
+bool response_handler::operator()(type_erased_tuple& xs) {
+  if (!ptr_)
+    return false;
+  discarding_visitor f;
+  return ptr_->invoke(f, xs) == match_case::match;
+}
+
+bool response_handler::operator()(message& xs) {
+  if (xs.empty()) {
+    auto ys = make_type_erased_tuple_view();
+    return (*this)(ys);
+  }
+  // the following const-cast is safe, because invoke() is aware of
+  // copy-on-write and does not modify x if it's shared
+  return (*this)(*const_cast<message_data*>(xs.cvals().get()));
+}
+
+void response_handler::reset() {
+  if (!ptr_)
+    return;
+  if (is_inline())
+    ptr_->~impl();
+  else
+    delete ptr_;
+  ptr_ = nullptr;
+}
+
+} // namespace detail
+} // namespace caf
@@ -21,7 +21,11 @@
 
 #include "caf/config.hpp"
 #include "caf/to_string.hpp"
+#include "caf/actor_system.hpp"
 #include "caf/actor_ostream.hpp"
+#include "caf/actor_system_config.hpp"
+
+#include "caf/scheduler/abstract_coordinator.hpp"
 
 #include "caf/detail/private_thread.hpp"
 #include "caf/detail/sync_request_bouncer.hpp"
@@ -92,21 +96,39 @@ error scheduled_actor::default_exception_handler(pointer ptr,
 }
 # endif // CAF_NO_EXCEPTIONS
 
+namespace {
+
+// values for `suspend_state_`
+constexpr int not_suspended = 0;
+constexpr int suspend_pending = 1;
+constexpr int suspended = 2;
+
+} // namespace <anonymous>
+
 // -- constructors and destructors ---------------------------------------------
 
 scheduled_actor::scheduled_actor(actor_config& cfg)
     : local_actor(cfg),
       timeout_id_(0),
+      timeout_handle_(scheduler::clock_service::invalid_handle),
       default_handler_(print_and_drop),
       error_handler_(default_error_handler),
       down_handler_(default_down_handler),
       exit_handler_(default_exit_handler),
-      private_thread_(nullptr)
+      mailbox_capacity_(cfg.mailbox_capacity),
+      overload_policy_(cfg.mailbox_overload_policy),
+      mailbox_size_(0),
+      suspend_state_(not_suspended),
+      has_suspended_senders_(false),
+      private_thread_(nullptr),
+      dequeued_msgs_(0),
+      handler_kind_(actor_metrics::behavior_handler)
 # ifndef CAF_NO_EXCEPTIONS
       , exception_handler_(default_exception_handler)
 # endif // CAF_NO_EXCEPTIONS
       {
-  // nop
+  if (home_system().config().scheduler_enable_actor_metrics)
+    metrics_ = make_counted<actor_metrics>(id());
 }
 
 scheduled_actor::~scheduled_actor() {
@@ -124,8 +146,16 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr,
   CAF_LOG_TRACE(CAF_ARG(*ptr));
   CAF_ASSERT(ptr != nullptr);
   CAF_ASSERT(!getf(is_blocking_flag));
+  if (mailbox_capacity_ > 0
+      && mailbox_size_.fetch_add(1, std::memory_order_relaxed)
+         >= mailbox_capacity_
+      && !handle_overload(*ptr, eu))
+    return;
   auto mid = ptr->mid;
   auto sender = ptr->sender;
+  // count before enqueueing, because the reader may already run afterwards
+  if (metrics_)
+    metrics_->enqueued();
   switch (mailbox().enqueue(ptr.release())) {
     case detail::enqueue_result::unblocked_reader: {
       // add a reference count to this actor and re-schedule it
@@ -142,6 +172,8 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr,
       break;
     }
     case detail::enqueue_result::queue_closed: {
+      if (metrics_)
+        metrics_->dequeued();
       if (mid.is_request()) {
         detail::sync_request_bouncer f{exit_reason()};
         f(sender, mid);
@@ -154,6 +186,12 @@ void scheduled_actor::enqueue(mailbox_element_ptr ptr,
   }
 }
 
+size_t scheduled_actor::mailbox_depth() const {
+  if (mailbox_capacity_ > 0)
+    return mailbox_size();
+  return metrics_ ? static_cast<size_t>(metrics_->mailbox_size()) : 0;
+}
+
 // -- overridden functions of local_actor --------------------------------------
 
 const char* scheduled_actor::name() const {
@@ -165,6 +203,10 @@ void scheduled_actor::launch(execution_unit* eu, bool lazy, bool hide) {
   CAF_ASSERT(!getf(is_blocking_flag));
   if (!hide)
     register_at_system();
+  if (metrics_) {
+    metrics_->name(name());
+    home_system().actor_metrics().put(id(), metrics_);
+  }
   if (getf(is_detached_flag)) {
     private_thread_ = new detail::private_thread(this);
     private_thread_->start();
@@ -188,9 +230,40 @@ bool scheduled_actor::cleanup(error&& fail_state, execution_unit* host) {
   }
   awaited_responses_.clear();
   multiplexed_responses_.clear();
+  // free all slots at the clock service, since nobody is going to wait
+  // for any of our timeouts after this point
+  auto& clock = system().scheduler().clock();
+  clock.cancel(timeout_handle_);
+  timeout_handle_ = scheduler::clock_service::invalid_handle;
+  response_timeouts_.for_each([&](message_id, uint64_t hdl) {
+    clock.cancel(hdl);
+  });
+  response_timeouts_.clear();
+  if (metrics_)
+    home_system().actor_metrics().erase(id());
+  // nobody makes room for suspended senders after this point
+  if (mailbox_capacity_ > 0)
+    resume_suspended_senders(host);
   return local_actor::cleanup(std::move(fail_state), host);
 }
 
+void scheduled_actor::request_response_timeout(const duration& d,
+                                               message_id mid) {
+  CAF_LOG_TRACE(CAF_ARG(d) << CAF_ARG(mid));
+  if (!d.valid())
+    return;
+  auto rid = mid.response_id();
+  auto hdl = system().scheduler().delayed_send(d, ctrl(), ctrl(), rid,
+                                               make_message(
+                                                 sec::request_timeout));
+  auto res = response_timeouts_.emplace(rid, hdl);
+  if (!res.second) {
+    // a response handler with a timeout overrides the request timeout
+    system().scheduler().clock().cancel(*res.first);
+    *res.first = hdl;
+  }
+}
+
 // -- overridden functions of resumable ----------------------------------------
 
 resumable::subtype_t scheduled_actor::subtype() const {
@@ -215,18 +288,43 @@ scheduled_actor::resume(execution_unit* ctx, size_t max_throughput) {
     if (handled_msgs > 0 && !bhvr_stack_.empty())
       request_timeout(bhvr_stack_.back().timeout());
   };
+  // updates the metrics once per activation instead of once per message;
+  // must run before giving up control, because the counters have a single
+  // writer and another thread may resume this actor afterwards
+  auto report_dequeued = [&] {
+    if (metrics_ && dequeued_msgs_ > 0)
+      metrics_->dequeued(dequeued_msgs_);
+    dequeued_msgs_ = 0;
+  };
   mailbox_element_ptr ptr;
   while (handled_msgs < max_throughput) {
     do {
       ptr = next_message();
       if (!ptr) {
         reset_timeout_if_needed();
+        report_dequeued();
         if (mailbox().try_block())
           return resumable::awaiting_message;
+        continue;
+      }
+      ++dequeued_msgs_;
+      if (mailbox_capacity_ > 0 && !handle_dequeue(*ptr)) {
+        ptr.reset();
       }
     } while (!ptr);
-    switch (reactivate(*ptr)) {
+    activation_result res;
+    auto bh = batch_handler_for(*ptr);
+    if (bh != nullptr) {
+      // the switch below counts the batch as a single message
+      handled_msgs += collect_batch(*bh, std::move(ptr),
+                                    max_throughput - handled_msgs) - 1;
+      res = reactivate_batch(*bh);
+    } else {
+      res = reactivate(*ptr);
+    }
+    switch (res) {
       case activation_result::terminated:
+        report_dequeued();
         return resume_result::done;
       case activation_result::success:
         ++handled_msgs;
@@ -237,6 +335,7 @@ scheduled_actor::resume(execution_unit* ctx, size_t max_throughput) {
           bhvr_stack_.cleanup();
           if (finalize()) {
             CAF_LOG_DEBUG("actor finalized while processing cache");
+            report_dequeued();
             return resume_result::done;
           }
         }
@@ -247,8 +346,19 @@ scheduled_actor::resume(execution_unit* ctx, size_t max_throughput) {
       default:
         break;
     }
+    if (suspend_state_.load() == suspend_pending) {
+      // a receiver signaled back pressure and reschedules us once its
+      // mailbox has room again; we must not touch any state after the
+      // CAS, because the receiver may resume us on another thread
+      reset_timeout_if_needed();
+      report_dequeued();
+      auto expected = suspend_pending;
+      if (suspend_state_.compare_exchange_strong(expected, suspended))
+        return resumable::awaiting_message;
+    }
   }
   reset_timeout_if_needed();
+  report_dequeued();
   if (!has_next_message() && mailbox().try_block())
     return resumable::awaiting_message;
   // time's up
@@ -280,12 +390,16 @@ uint32_t scheduled_actor::request_timeout(const duration& d) {
   auto result = ++timeout_id_;
   auto msg = make_message(timeout_msg{++timeout_id_});
   CAF_LOG_TRACE("send new timeout_msg, " << CAF_ARG(timeout_id_));
+  // the previous timeout expires in any case, no need to deliver it
+  auto& sched = system().scheduler();
+  sched.clock().cancel(timeout_handle_);
+  timeout_handle_ = scheduler::clock_service::invalid_handle;
   if (d.is_zero())
     // immediately enqueue timeout message if duration == 0s
     enqueue(ctrl(), invalid_message_id, std::move(msg), context());
   else
-    system().scheduler().delayed_send(d, ctrl(), strong_actor_ptr(ctrl()),
-                                      message_id::make(), std::move(msg));
+    timeout_handle_ = sched.delayed_send(d, ctrl(), strong_actor_ptr(ctrl()),
+                                         message_id::make(), std::move(msg));
   return result;
 }
 
@@ -298,20 +412,43 @@ bool scheduled_actor::is_active_timeout(uint32_t tid) const {
   return getf(has_timeout_flag) && timeout_id_ == tid;
 }
 
+void scheduled_actor::cancel_response_timeout(message_id mid) {
+  if (response_timeouts_.empty())
+    return;
+  auto hdl = response_timeouts_.find(mid);
+  if (hdl != nullptr) {
+    // no-op if `mid` belongs to the timeout message itself
+    system().scheduler().clock().cancel(*hdl);
+    response_timeouts_.erase(mid);
+  }
+}
+
 // -- message processing -------------------------------------------------------
 
 void scheduled_actor::add_awaited_response_handler(message_id response_id,
                                                    behavior bhvr) {
   if (bhvr.timeout().valid())
     request_response_timeout(bhvr.timeout(), response_id);
-  awaited_responses_.emplace_front(response_id, std::move(bhvr));
+  add_awaited_response_handler(response_id,
+                               detail::response_handler{std::move(bhvr)});
+}
+
+void scheduled_actor::add_awaited_response_handler(
+    message_id response_id, detail::response_handler f) {
+  awaited_responses_.emplace_back(response_id, std::move(f));
 }
 
 void scheduled_actor::add_multiplexed_response_handler(message_id response_id,
                                                        behavior bhvr) {
   if (bhvr.timeout().valid())
     request_response_timeout(bhvr.timeout(), response_id);
-  multiplexed_responses_.emplace(response_id, std::move(bhvr));
+  add_multiplexed_response_handler(response_id,
+                                   detail::response_handler{std::move(bhvr)});
+}
+
+void scheduled_actor::add_multiplexed_response_handler(
+    message_id response_id, detail::response_handler f) {
+  multiplexed_responses_.emplace(response_id, std::move(f));
 }
 
 scheduled_actor::message_category
@@ -374,36 +511,61 @@ scheduled_actor::categorize(mailbox_element& x) {
 }
 
 invoke_message_result scheduled_actor::consume(mailbox_element& x) {
+  if (!metrics_)
+    return consume_impl(x);
+  // skipped and dropped messages do not count as processed
+  if (!metrics_->sample()) {
+    auto res = consume_impl(x);
+    if (res == im_success)
+      metrics_->processed(handler_kind_);
+    return res;
+  }
+  auto t0 = actor_metrics::clock_type::now();
+  auto res = consume_impl(x);
+  if (res == im_success)
+    metrics_->processed(handler_kind_, actor_metrics::clock_type::now() - t0);
+  return res;
+}
+
+invoke_message_result scheduled_actor::consume_impl(mailbox_element& x) {
   CAF_LOG_TRACE(CAF_ARG(x));
   current_element_ = &x;
   // short-circuit awaited responses
   if (!awaited_responses_.empty()) {
-    auto& pr = awaited_responses_.front();
+    auto& pr = awaited_responses_.back();
     // skip all messages until we receive the currently awaited response
     if (x.mid != pr.first)
       return im_skipped;
-    if (!pr.second(x.content())) {
+    cancel_response_timeout(x.mid);
+    handler_kind_ = actor_metrics::response_handler;
+    // remove the handler before calling it, since it may add new handlers
+    auto f = std::move(pr.second);
+    awaited_responses_.pop_back();
+    if (!f(x.content())) {
       // try again with error if first attempt failed
       auto msg = make_message(make_error(sec::unexpected_response,
                                          x.move_content_to_message()));
-      pr.second(msg);
+      f(msg);
     }
-    awaited_responses_.pop_front();
     return im_success;
   }
   // handle multiplexed responses
   if (x.mid.is_response()) {
+    cancel_response_timeout(x.mid);
     auto mrh = multiplexed_responses_.find(x.mid);
     // neither awaited nor multiplexed, probably an expired timeout
-    if (mrh == multiplexed_responses_.end())
+    if (mrh == nullptr)
       return im_dropped;
-    if (!mrh->second(x.content())) {
+    handler_kind_ = actor_metrics::response_handler;
+    // remove the handler before calling it, since it may add new handlers
+    auto f = std::move(*mrh);
+    multiplexed_responses_.erase(x.mid);
+    if (!f(x.content())) {
       // try again with error if first attempt failed
       auto msg = make_message(make_error(sec::unexpected_response,
                                          x.move_content_to_message()));
-      mrh->second(msg);
+      f(msg);
     }
-    multiplexed_responses_.erase(mrh);
     return im_success;
   }
   // dispatch on the content of x
@@ -413,9 +575,11 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
       return im_dropped;
     case message_category::internal:
       CAF_LOG_DEBUG("handled system message");
+      handler_kind_ = actor_metrics::system_handler;
       return im_success;
     case message_category::timeout: {
       CAF_LOG_DEBUG("handle timeout message");
+      handler_kind_ = actor_metrics::behavior_handler;
       if (bhvr_stack_.empty())
         return im_dropped;
       bhvr_stack_.back().handle_timeout();
@@ -432,7 +596,9 @@ invoke_message_result scheduled_actor::consume(mailbox_element& x) {
         if (skipped && had_timeout)
           setf(has_timeout_flag);
       });
+      handler_kind_ = actor_metrics::behavior_handler;
       auto call_default_handler = [&] {
+        handler_kind_ = actor_metrics::default_handler;
         auto sres = default_handler_(this, x);
         switch (sres.flag) {
           default:
@@ -496,6 +662,153 @@ bool scheduled_actor::consume_from_cache() {
   return false;
 }
 
+namespace {
+
+// messages that are vital for the actor system and thus never get dropped
+bool is_exempt_from_overload(mailbox_element& x) {
+  if (x.mid.is_response())
+    return true;
+  auto& content = x.content();
+  auto token = content.type_token();
+  return token == make_type_token<exit_msg>()
+         || token == make_type_token<down_msg>()
+         || token == make_type_token<timeout_msg>();
+}
+
+} // namespace <anonymous>
+
+bool scheduled_actor::handle_overload(mailbox_element& x,
+                                      execution_unit* ctx) {
+  CAF_LOG_TRACE(CAF_ARG(x) << CAF_ARG(overload_policy_));
+  switch (overload_policy_) {
+    case overload_policy::drop_oldest:
+      // the reader drops excess messages in `handle_dequeue`
+      return true;
+    case overload_policy::back_pressure:
+      if (suspend_sender(x, ctx))
+        return true;
+      break;
+    default:
+      break;
+  }
+  if (is_exempt_from_overload(x))
+    return true;
+  mailbox_size_.fetch_sub(1, std::memory_order_relaxed);
+  CAF_LOG_DEBUG("mailbox full, drop message");
+  if (x.sender == nullptr)
+    return false;
+  if (x.mid.is_request())
+    x.sender->enqueue(ctrl(), x.mid.response_id(),
+                      make_message(make_error(sec::mailbox_full)), ctx);
+  else if (overload_policy_ != overload_policy::drop_newest)
+    x.sender->enqueue(ctrl(), message_id::make(),
+                      make_message(make_error(sec::mailbox_full)), ctx);
+  return false;
+}
+
+bool scheduled_actor::handle_dequeue(mailbox_element& x) {
+  // pairs with the re-check in `suspend_sender`, hence no relaxed ordering
+  auto n = mailbox_size_.fetch_sub(1);
+  if (n <= mailbox_capacity_ && has_suspended_senders_.load())
+    resume_suspended_senders(context());
+  if (n <= mailbox_capacity_
+      || overload_policy_ != overload_policy::drop_oldest
+      || is_exempt_from_overload(x))
+    return true;
+  CAF_LOG_DEBUG("mailbox full, drop oldest message");
+  if (x.sender != nullptr && x.mid.is_request())
+    x.sender->enqueue(ctrl(), x.mid.response_id(),
+                      make_message(make_error(sec::mailbox_full)), context());
+  return false;
+}
+
+bool scheduled_actor::suspend_sender(mailbox_element& x, execution_unit* ctx) {
+  if (is_exempt_from_overload(x))
+    return true;
+  if (x.sender == nullptr)
+    return false;
+  auto src = dynamic_cast<scheduled_actor*>(x.sender->get());
+  if (src == nullptr || src == this || src->getf(is_detached_flag)
+      || !src->request_suspend())
+    return false;
+  CAF_LOG_DEBUG("mailbox full, suspend sender");
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard{suspended_senders_mtx_};
+    suspended_senders_.push_back(x.sender);
+    has_suspended_senders_ = true;
+  }
+  // the reader may have made room before it could see the new entry
+  if (mailbox_size_.load() <= mailbox_capacity_)
+    resume_suspended_senders(ctx);
+  return true;
+}
+
+void scheduled_actor::resume_suspended_senders(execution_unit* ctx) {
+  std::vector<strong_actor_ptr> xs;
+  { // lifetime scope of guard
+    std::unique_lock<std::mutex> guard{suspended_senders_mtx_};
+    xs.swap(suspended_senders_);
+    has_suspended_senders_ = false;
+  }
+  for (auto& x : xs)
+    static_cast<scheduled_actor*>(x->get())->resume_after_back_pressure(ctx);
+}
+
+bool scheduled_actor::request_suspend() {
+  auto expected = not_suspended;
+  return suspend_state_.compare_exchange_strong(expected, suspend_pending);
+}
+
+void scheduled_actor::resume_after_back_pressure(execution_unit* ctx) {
+  auto expected = suspend_pending;
+  if (suspend_state_.compare_exchange_strong(expected, not_suspended))
+    return; // still running, i.e., nothing to reschedule
+  if (expected != suspended
+      || !suspend_state_.compare_exchange_strong(expected, not_suspended))
+    return;
+  // add a reference count to this actor and re-schedule it
+  intrusive_ptr_add_ref(ctrl());
+  if (ctx)
+    ctx->exec_later(this);
+  else
+    home_system().scheduler().enqueue(this);
+}
+
+detail::batch_handler* scheduled_actor::batch_handler_for(mailbox_element& x) {
+  if (batch_handlers_.empty() || !x.mid.is_async()
+      || !awaited_responses_.empty())
+    return nullptr;
+  auto& content = x.content();
+  for (auto& bh : batch_handlers_)
+    if (bh->matches(content))
+      return bh.get();
+  return nullptr;
+}
+
+size_t scheduled_actor::collect_batch(detail::batch_handler& bh,
+                                      mailbox_element_ptr x,
+                                      size_t max_batch_size) {
+  CAF_LOG_TRACE(CAF_ARG(*x) << CAF_ARG(max_batch_size));
+  CAF_ASSERT(max_batch_size > 0);
+  bh.add(x->content());
+  // fetching new data swaps the entire LIFO stack of the mailbox into its
+  // FIFO cache with a single CAS, hence peeking is usually free; actors
+  // spawned with `priority_aware` collect the batch from the lane of `x`
+  size_t result = 1;
+  while (result < max_batch_size) {
+    auto next = peek_next_message(*x);
+    if (next == nullptr || batch_handler_for(*next) != &bh)
+      break;
+    x = take_next_message(*x);
+    ++dequeued_msgs_;
+    if (mailbox_capacity_ > 0 && !handle_dequeue(*x))
+      continue;
+    bh.add(x->content());
+    ++result;
+  }
+  return result;
+}
+
 bool scheduled_actor::activate(execution_unit* ctx) {
   CAF_LOG_TRACE("");
   CAF_ASSERT(ctx != nullptr);
@@ -581,6 +894,57 @@ auto scheduled_actor::reactivate(mailbox_element& x) -> activation_result {
 # endif // CAF_NO_EXCEPTIONS
 }
 
+auto scheduled_actor::reactivate_batch(detail::batch_handler& bh)
+-> activation_result {
+  CAF_LOG_TRACE(CAF_ARG(bh.size()));
+  // a batch has no single sender, hence the handler sees an empty
+  // asynchronous element without sender
+  mailbox_element batch_element;
+  current_element_ = &batch_element;
+  auto guard = detail::make_scope_guard([&] {
+    current_element_ = nullptr;
+  });
+  unsetf(has_timeout_flag);
+# ifndef CAF_NO_EXCEPTIONS
+  try {
+# endif // CAF_NO_EXCEPTIONS
+    if (metrics_ && !metrics_->sample()) {
+      auto n = bh.size();
+      bh.flush();
+      metrics_->processed(actor_metrics::batch_handler, n);
+    } else if (metrics_) {
+      auto n = bh.size();
+      auto t0 = actor_metrics::clock_type::now();
+      bh.flush();
+      metrics_->processed(actor_metrics::batch_handler,
+                          actor_metrics::clock_type::now() - t0, n);
+    } else {
+      bh.flush();
+    }
+    bhvr_stack_.cleanup();
+    if (finalize()) {
+      CAF_LOG_DEBUG("actor finalized");
+      return activation_result::terminated;
+    }
+    return activation_result::success;
+# ifndef CAF_NO_EXCEPTIONS
+  }
+  catch (std::exception& e) {
+    CAF_LOG_INFO("actor died because of an exception, what: " << e.what());
+    static_cast<void>(e); // keep compiler happy when not logging
+    auto eptr = std::current_exception();
+    quit(exception_handler_(this, eptr));
+  }
+  catch (...) {
+    CAF_LOG_INFO("actor died because of an unknown exception");
+    auto eptr = std::current_exception();
+    quit(exception_handler_(this, eptr));
+  }
+  finalize();
+  return activation_result::terminated;
+# endif // CAF_NO_EXCEPTIONS
+}
+
 // -- behavior management ----------------------------------------------------
 
 void scheduled_actor::do_become(behavior bhvr, bool discard_old) {
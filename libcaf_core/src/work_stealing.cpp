@@ -26,5 +26,9 @@ work_stealing::~work_stealing() {
   // nop
 }
 
+lock_free_work_stealing::~lock_free_work_stealing() {
+  // nop
+}
+
 } // namespace policy
 } // namespace caf
@@ -0,0 +1,239 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE actor_metrics
+#include "caf/test/unit_test.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "caf/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+using kind = actor_metrics::handler_kind;
+
+// takes a snapshot of its own metrics, i.e., after processing all
+// previously received messages
+behavior observed(event_based_actor* self) {
+  self->set_default_handler(drop);
+  return {
+    [](int) {
+      // nop
+    },
+    [=](get_atom) {
+      return self->metrics()->snapshot();
+    }
+  };
+}
+
+struct fixture {
+  actor_system_config cfg;
+
+  fixture() {
+    cfg.scheduler_enable_actor_metrics = true;
+  }
+
+  actor_metrics_snapshot snapshot_of(scoped_actor& self, const actor& aut) {
+    actor_metrics_snapshot result;
+    self->request(aut, infinite, get_atom::value).receive(
+      [&](actor_metrics_snapshot& x) {
+        result = std::move(x);
+      },
+      [&](error& err) {
+        CAF_FAIL(self->system().render(err));
+      }
+    );
+    return result;
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(actor_metrics_tests, fixture)
+
+CAF_TEST(disabled_by_default) {
+  actor_system_config default_cfg;
+  actor_system system{default_cfg};
+  auto aut = system.spawn(observed);
+  CAF_CHECK_EQUAL(system.actor_metrics().size(), 0u);
+  CAF_CHECK(system.registry().get(atom("MetricServ")) == nullptr);
+  anon_send_exit(aut, exit_reason::kill);
+}
+
+CAF_TEST(latency_buckets) {
+  CAF_CHECK_EQUAL(actor_metrics::latency_bucket(0), 0u);
+  CAF_CHECK_EQUAL(actor_metrics::latency_bucket(999), 0u);
+  CAF_CHECK_EQUAL(actor_metrics::latency_bucket(1000), 1u);
+  CAF_CHECK_EQUAL(actor_metrics::latency_bucket(3999), 2u);
+  CAF_CHECK_EQUAL(actor_metrics::latency_bucket(4000), 3u);
+  CAF_CHECK_EQUAL(actor_metrics::latency_bucket(uint64_t{1} << 62),
+                  actor_metrics::num_latency_buckets - 1);
+  for (size_t i = 0; i < actor_metrics::num_latency_buckets - 1; ++i) {
+    auto bound = actor_metrics::latency_bucket_bound(i);
+    CAF_CHECK_EQUAL(actor_metrics::latency_bucket(bound - 1), i);
+    CAF_CHECK_EQUAL(actor_metrics::latency_bucket(bound), i + 1);
+  }
+}
+
+CAF_TEST(counting_messages) {
+  actor_system system{cfg};
+  scoped_actor self{system};
+  auto aut = system.spawn(observed);
+  for (int i = 0; i < 10; ++i)
+    self->send(aut, i);
+  self->send(aut, "unexpected");
+  auto x = snapshot_of(self, aut);
+  CAF_CHECK_EQUAL(x.id, aut.id());
+  CAF_CHECK_EQUAL(x.enqueued, 12u);
+  // the actor reports dequeued messages at the end of an activation, i.e.,
+  // its own snapshot misses the messages of the running activation
+  CAF_CHECK_LESS_EQUAL(x.dequeued, 12u);
+  CAF_CHECK_EQUAL(x.mailbox_size, x.enqueued - x.dequeued);
+  CAF_REQUIRE_EQUAL(x.handled.size(), actor_metrics::num_handler_kinds);
+  CAF_CHECK_EQUAL(x.handled[kind::behavior_handler], 10u);
+  CAF_CHECK_EQUAL(x.handled[kind::default_handler], 1u);
+  CAF_CHECK_EQUAL(x.handled[kind::response_handler], 0u);
+  CAF_CHECK_EQUAL(x.processed(), 11u);
+  CAF_REQUIRE_EQUAL(x.latency_histogram.size(),
+                    actor_metrics::num_latency_buckets);
+  // only the first activation of the actor is a sample
+  uint64_t total = 0;
+  for (auto n : x.latency_histogram)
+    total += n;
+  CAF_CHECK_EQUAL(total, 1u);
+  CAF_CHECK(x.uptime_ns > 0);
+  CAF_CHECK(x.enqueue_rate() > 0.);
+  // the counters catch up once the actor runs out of messages
+  auto ptr = system.actor_metrics().get(aut.id());
+  CAF_REQUIRE(ptr != nullptr);
+  for (int i = 0; i < 1000 && ptr->snapshot().dequeued < 12; ++i)
+    this_thread::sleep_for(chrono::milliseconds(1));
+  CAF_CHECK_EQUAL(ptr->snapshot().dequeued, 12u);
+  CAF_CHECK_EQUAL(ptr->mailbox_size(), 0u);
+  anon_send_exit(aut, exit_reason::kill);
+}
+
+CAF_TEST(sampling_processing_times) {
+  actor_system system{cfg};
+  scoped_actor self{system};
+  auto aut = system.spawn(observed);
+  auto n = 10 * actor_metrics::sample_interval;
+  for (uint64_t i = 0; i < n; ++i)
+    self->send(aut, static_cast<int>(i));
+  auto x = snapshot_of(self, aut);
+  CAF_CHECK_EQUAL(x.handled[kind::behavior_handler], n);
+  uint64_t total = 0;
+  for (auto k : x.latency_histogram)
+    total += k;
+  CAF_CHECK_EQUAL(total, 10u);
+  // each sample stands for `sample_interval` activations
+  CAF_CHECK_EQUAL(x.handler_ns[kind::behavior_handler]
+                  % actor_metrics::sample_interval, 0u);
+  anon_send_exit(aut, exit_reason::kill);
+}
+
+CAF_TEST(response_and_system_handlers) {
+  actor_system system{cfg};
+  scoped_actor self{system};
+  auto server = system.spawn([]() -> behavior {
+    return {
+      [](int x) {
+        return x * 2;
+      }
+    };
+  });
+  auto aut = system.spawn([=](event_based_actor* ptr) -> behavior {
+    ptr->monitor(server);
+    return {
+      [=](int x) {
+        ptr->request(server, infinite, x).then([](int) {
+          // nop
+        });
+      },
+      [=](get_atom) {
+        return ptr->metrics()->snapshot();
+      }
+    };
+  });
+  self->send(aut, 21);
+  // wait until the response arrived before killing the server
+  for (;;) {
+    auto x = snapshot_of(self, aut);
+    if (x.handled[kind::response_handler] == 1)
+      break;
+  }
+  self->send_exit(server, exit_reason::kill);
+  self->wait_for(server);
+  for (;;) {
+    auto x = snapshot_of(self, aut);
+    if (x.handled[kind::system_handler] == 1)
+      break;
+  }
+  anon_send_exit(aut, exit_reason::kill);
+}
+
+CAF_TEST(metrics_server) {
+  actor_system system{cfg};
+  scoped_actor self{system};
+  auto serv = actor_cast<actor>(system.registry().get(atom("MetricServ")));
+  CAF_REQUIRE(serv != nullptr);
+  auto aut = system.spawn(observed);
+  self->send(aut, 42);
+  self->request(serv, infinite, get_atom::value, aut.id()).receive(
+    [&](const actor_metrics_snapshot& x) {
+      CAF_CHECK_EQUAL(x.id, aut.id());
+      CAF_CHECK_EQUAL(x.name, "scheduled_actor");
+    },
+    [&](error& err) {
+      CAF_FAIL(system.render(err));
+    }
+  );
+  self->request(serv, infinite, get_atom::value).receive(
+    [&](const vector<actor_metrics_snapshot>& xs) {
+      auto pred = [&](const actor_metrics_snapshot& x) {
+        return x.id == aut.id();
+      };
+      CAF_CHECK(std::any_of(xs.begin(), xs.end(), pred));
+    },
+    [&](error& err) {
+      CAF_FAIL(system.render(err));
+    }
+  );
+  anon_send_exit(aut, exit_reason::kill);
+  self->wait_for(aut);
+  CAF_CHECK(system.actor_metrics().get(aut.id()) == nullptr);
+  self->request(serv, infinite, get_atom::value, aut.id()).receive(
+    [&](const actor_metrics_snapshot&) {
+      CAF_FAIL("expected an error for a terminated actor");
+    },
+    [&](error& err) {
+      CAF_CHECK_EQUAL(err, sec::invalid_argument);
+    }
+  );
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -22,6 +22,8 @@
 #define CAF_SUITE actor_pool
 #include "caf/test/unit_test.hpp"
 
+#include <future>
+
 #include "caf/all.hpp"
 
 using namespace caf;
@@ -54,6 +56,32 @@ public:
   }
 };
 
+// keeps busy on `ok_atom` until `gate` opens to build up its mailbox, hence
+// tests must spawn it detached to not block a thread of the scheduler
+class gated_worker : public worker {
+public:
+  gated_worker(actor_config& cfg, std::shared_future<void> gate)
+      : worker(cfg),
+        gate_(std::move(gate)) {
+    // nop
+  }
+
+  behavior make_behavior() override {
+    auto gate = gate_;
+    return {
+      [](int x, int y) {
+        return x + y;
+      },
+      [=](ok_atom) {
+        gate.wait();
+      }
+    };
+  }
+
+private:
+  std::shared_future<void> gate_;
+};
+
 struct fixture {
   // allows us to check s_dtors after dtor of actor_system
   actor_system_config cfg;
@@ -82,6 +110,19 @@ void handle_err(const error& err) {
   throw std::runtime_error("AUT responded with an error: " + to_string(err));
 }
 
+// sends `{x, x}` to `pool` and returns the worker that handled it
+strong_actor_ptr handled_by(scoped_actor& self, const actor& pool, int x) {
+  strong_actor_ptr result;
+  self->request(pool, infinite, x, x).receive(
+    [&](int res) {
+      CAF_CHECK_EQUAL(res, x + x);
+      result = actor_cast<strong_actor_ptr>(self->current_sender());
+    },
+    handle_err
+  );
+  return result;
+}
+
 } // namespace <anonymous>
 
 CAF_TEST_FIXTURE_SCOPE(actor_pool_tests, fixture)
@@ -222,4 +263,103 @@ CAF_TEST(split_join_actor_pool) {
   self->send_exit(pool, exit_reason::user_shutdown);
 }
 
+CAF_TEST(delete_worker) {
+  scoped_actor self{system};
+  auto pool = actor_pool::make(&context, 2, spawn_worker,
+                               actor_pool::round_robin());
+  std::vector<actor> workers;
+  self->request(pool, infinite, sys_atom::value, get_atom::value).receive(
+    [&](std::vector<actor>& ws) {
+      workers = std::move(ws);
+    },
+    handle_err
+  );
+  CAF_REQUIRE_EQUAL(workers.size(), 2u);
+  self->send(pool, sys_atom::value, delete_atom::value, workers.front());
+  self->request(pool, infinite, sys_atom::value, get_atom::value).receive(
+    [&](std::vector<actor>& ws) {
+      CAF_REQUIRE_EQUAL(ws.size(), 1u);
+      CAF_CHECK(ws.front() == workers.back());
+    },
+    handle_err
+  );
+  anon_send_exit(workers.front(), exit_reason::user_shutdown);
+  self->send_exit(pool, exit_reason::user_shutdown);
+}
+
+CAF_TEST(join_shortest_queue_actor_pool) {
+  scoped_actor self{system};
+  std::promise<void> gate;
+  auto gate_opened = gate.get_future().share();
+  auto spawn_bounded_worker = [&] {
+    return system.spawn<gated_worker, detached + bounded_mailbox>(gate_opened);
+  };
+  auto pool = actor_pool::make(&context, 3, spawn_bounded_worker,
+                               actor_pool::join_shortest_queue());
+  std::vector<actor> workers;
+  self->request(pool, infinite, sys_atom::value, get_atom::value).receive(
+    [&](std::vector<actor>& ws) {
+      workers = std::move(ws);
+    },
+    handle_err
+  );
+  CAF_REQUIRE_EQUAL(workers.size(), 3u);
+  // idle workers have equal depth, i.e., the pool uses all of them
+  std::set<strong_actor_ptr> used;
+  for (int i = 0; i < 3; ++i)
+    used.insert(handled_by(self, pool, i));
+  CAF_CHECK_EQUAL(used.size(), 3u);
+  // the pool avoids a busy worker while it has a pending message, i.e., the
+  // worker blocks on the first ok_atom while the second one waits
+  auto busy_worker = actor_cast<strong_actor_ptr>(workers.front());
+  self->send(workers.front(), ok_atom::value);
+  self->send(workers.front(), ok_atom::value);
+  size_t busy = 0;
+  for (int i = 0; i < 10; ++i)
+    if (handled_by(self, pool, i) == busy_worker)
+      ++busy;
+  CAF_CHECK_EQUAL(busy, 0u);
+  gate.set_value();
+  self->send_exit(pool, exit_reason::user_shutdown);
+}
+
+CAF_TEST(power_of_two_choices_actor_pool) {
+  scoped_actor self{system};
+  auto pool = actor_pool::make(&context, 5, spawn_worker,
+                               actor_pool::power_of_two_choices());
+  for (int i = 0; i < 10; ++i)
+    CAF_CHECK(handled_by(self, pool, i) != nullptr);
+  self->send_exit(pool, exit_reason::user_shutdown);
+}
+
+CAF_TEST(consistent_hashing_actor_pool) {
+  scoped_actor self{system};
+  auto key = [](const type_erased_tuple& x) -> uint64_t {
+    return static_cast<uint64_t>(x.get_as<int>(0));
+  };
+  auto pool = actor_pool::make(&context, 4, spawn_worker,
+                               actor_pool::consistent_hashing(key));
+  std::map<int, strong_actor_ptr> mapping;
+  std::set<strong_actor_ptr> used;
+  for (int i = 0; i < 32; ++i) {
+    mapping[i] = handled_by(self, pool, i);
+    used.insert(mapping[i]);
+  }
+  CAF_CHECK_GREATER(used.size(), 1u);
+  for (int i = 0; i < 32; ++i)
+    CAF_CHECK(handled_by(self, pool, i) == mapping[i]);
+  // removing a worker only remaps the keys of that worker
+  auto removed = mapping[0];
+  self->send(pool, sys_atom::value, delete_atom::value,
+             actor_cast<actor>(removed));
+  for (int i = 0; i < 32; ++i) {
+    auto hdl = handled_by(self, pool, i);
+    CAF_CHECK(hdl != removed);
+    if (mapping[i] != removed)
+      CAF_CHECK(hdl == mapping[i]);
+  }
+  anon_send_exit(removed, exit_reason::user_shutdown);
+  self->send_exit(pool, exit_reason::user_shutdown);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
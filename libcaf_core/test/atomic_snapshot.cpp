@@ -0,0 +1,97 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE atomic_snapshot
+#include "caf/test/unit_test.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "caf/detail/atomic_snapshot.hpp"
+
+using caf::detail::atomic_snapshot;
+
+namespace {
+
+using int_vec = std::vector<int>;
+
+// all snapshots published by the writers below contain 0, 1, ..., n - 1
+bool consistent(const int_vec& xs) {
+  for (size_t i = 0; i < xs.size(); ++i)
+    if (xs[i] != static_cast<int>(i))
+      return false;
+  return true;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(copy_on_write) {
+  atomic_snapshot<int_vec> x{int_vec{1, 2}};
+  auto before = x.load();
+  CAF_CHECK(x.update([](int_vec& xs) {
+    xs.push_back(3);
+    return true;
+  }));
+  auto after = x.load();
+  CAF_CHECK_EQUAL(before->size(), 2u);
+  CAF_CHECK_EQUAL(after->size(), 3u);
+  CAF_CHECK(!x.update([](int_vec& xs) {
+    xs.clear();
+    return false;
+  }));
+  CAF_CHECK(x.load() == after);
+}
+
+CAF_TEST(concurrent_readers_and_writers) {
+  atomic_snapshot<int_vec> x;
+  std::atomic<bool> done{false};
+  std::atomic<size_t> failures{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i)
+    readers.emplace_back([&] {
+      while (!done) {
+        auto xs = x.load();
+        if (!consistent(*xs))
+          ++failures;
+      }
+    });
+  std::vector<std::thread> writers;
+  for (int i = 0; i < 2; ++i)
+    writers.emplace_back([&] {
+      for (int j = 0; j < 1000; ++j) {
+        x.update([](int_vec& xs) {
+          if (xs.size() < 64)
+            xs.push_back(static_cast<int>(xs.size()));
+          else
+            xs.clear();
+          return true;
+        });
+      }
+    });
+  for (auto& t : writers)
+    t.join();
+  done = true;
+  for (auto& t : readers)
+    t.join();
+  CAF_CHECK_EQUAL(failures.load(), 0u);
+  CAF_CHECK(consistent(*x.load()));
+}
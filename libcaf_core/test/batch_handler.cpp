@@ -0,0 +1,195 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE batch_handler
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+#include <string>
+
+#include "caf/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+struct batch_log {
+  // sizes of all batches received by the batch handler
+  vector<size_t> batches;
+  // all received values in processing order
+  vector<int> values;
+  // messages handled by the behavior
+  vector<string> others;
+};
+
+// fills its own mailbox before it starts processing
+// in order to get a deterministic sequence of batches
+behavior collector(event_based_actor* self, batch_log* result, int n, int m) {
+  self->set_batch_handler<int>([=](vector<int>& xs) {
+    result->batches.push_back(xs.size());
+    result->values.insert(result->values.end(), xs.begin(), xs.end());
+  });
+  for (int i = 0; i < n; ++i)
+    self->send(self, i);
+  self->send(self, "separator");
+  for (int i = n; i < n + m; ++i)
+    self->send(self, i);
+  self->send(self, ok_atom::value);
+  return {
+    [=](const string& x) {
+      result->others.push_back(x);
+    },
+    [=](ok_atom) {
+      self->quit();
+    }
+  };
+}
+
+// fills its mailbox with interleaved high and normal priority messages and
+// sends one more normal message while processing the first batch
+behavior prioritized_collector(event_based_actor* self, batch_log* result) {
+  self->set_batch_handler<int>([=](vector<int>& xs) {
+    if (result->batches.empty())
+      self->send(self, 10);
+    result->batches.push_back(xs.size());
+    result->values.insert(result->values.end(), xs.begin(), xs.end());
+  });
+  for (int i = 0; i < 5; ++i)
+    self->send(self, i);
+  self->send<message_priority::high>(self, 100);
+  self->send<message_priority::high>(self, 101);
+  for (int i = 5; i < 10; ++i)
+    self->send(self, i);
+  self->send<message_priority::bulk>(self, ok_atom::value);
+  return {
+    [=](ok_atom) {
+      self->quit();
+    }
+  };
+}
+
+struct fixture {
+  actor_system_config cfg;
+  batch_log result;
+
+  void run_collector(int n, int m) {
+    actor_system system{cfg};
+    system.spawn(collector, &result, n, m);
+    // destructor of system waits for the collector
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(batch_handler_tests, fixture)
+
+CAF_TEST(single_batch) {
+  run_collector(100, 0);
+  CAF_CHECK_EQUAL(result.batches, vector<size_t>{100});
+  CAF_REQUIRE_EQUAL(result.values.size(), 100u);
+  for (int i = 0; i < 100; ++i)
+    CAF_CHECK_EQUAL(result.values[static_cast<size_t>(i)], i);
+  CAF_CHECK_EQUAL(result.others, vector<string>{"separator"});
+}
+
+CAF_TEST(batches_end_at_other_messages) {
+  run_collector(30, 12);
+  CAF_CHECK_EQUAL(result.batches, (vector<size_t>{30, 12}));
+  CAF_REQUIRE_EQUAL(result.values.size(), 42u);
+  for (int i = 0; i < 42; ++i)
+    CAF_CHECK_EQUAL(result.values[static_cast<size_t>(i)], i);
+  CAF_CHECK_EQUAL(result.others, vector<string>{"separator"});
+}
+
+CAF_TEST(batches_respect_max_throughput) {
+  cfg.scheduler_max_throughput = 20;
+  run_collector(100, 10);
+  CAF_CHECK_EQUAL(result.batches, (vector<size_t>{20, 20, 20, 20, 20, 10}));
+  CAF_CHECK_EQUAL(result.values.size(), 110u);
+}
+
+CAF_TEST(requests_bypass_batch_handler) {
+  actor_system system{cfg};
+  auto aut = system.spawn([&](event_based_actor* self) -> behavior {
+    self->set_batch_handler<int>([&](vector<int>& xs) {
+      result.batches.push_back(xs.size());
+    });
+    return {
+      [](int x) {
+        return x + 1;
+      }
+    };
+  });
+  scoped_actor self{system};
+  self->request(aut, infinite, 41).receive(
+    [](int x) {
+      CAF_CHECK_EQUAL(x, 42);
+    },
+    [&](error& err) {
+      CAF_FAIL(system.render(err));
+    }
+  );
+  anon_send_exit(aut, exit_reason::kill);
+  CAF_CHECK(result.batches.empty());
+}
+
+CAF_TEST(batches_have_no_sender) {
+  actor_system system{cfg};
+  scoped_actor self{system};
+  actor observer{self};
+  auto aut = system.spawn([=](event_based_actor* ptr) -> behavior {
+    ptr->set_batch_handler<int>([=](vector<int>& xs) {
+      auto x = ptr->current_mailbox_element();
+      CAF_REQUIRE(x != nullptr);
+      CAF_CHECK(ptr->current_sender() == nullptr);
+      CAF_CHECK(x->mid.is_async());
+      CAF_CHECK(x->content().empty());
+      ptr->send(observer, static_cast<int>(xs.size()));
+    });
+    return {
+      [](const string&) {
+        // nop
+      }
+    };
+  });
+  self->send(aut, 1);
+  self->receive(
+    [](int n) {
+      CAF_CHECK_EQUAL(n, 1);
+    }
+  );
+  anon_send_exit(aut, exit_reason::kill);
+}
+
+CAF_TEST(priority_aware_batches_keep_lane_order) {
+  {
+    actor_system system{cfg};
+    system.spawn<priority_aware>(prioritized_collector, &result);
+  }
+  // the high lane comes first and the second batch includes the message
+  // that arrived in the mailbox after all other normal messages
+  CAF_CHECK_EQUAL(result.batches, (vector<size_t>{2, 11}));
+  CAF_CHECK_EQUAL(result.values,
+                  (vector<int>{100, 101, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
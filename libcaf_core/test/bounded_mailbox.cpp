@@ -0,0 +1,189 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE bounded_mailbox
+#include "caf/test/unit_test.hpp"
+
+#include <future>
+#include <thread>
+#include <chrono>
+#include <vector>
+
+#include "caf/all.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+struct consumer_state {
+  promise<void> entered;
+  promise<void> release;
+  vector<int> values;
+};
+
+// blocks its worker on `ok_atom` until the test releases it
+behavior consumer(event_based_actor*, consumer_state* st) {
+  return {
+    [=](ok_atom) {
+      st->entered.set_value();
+      st->release.get_future().wait();
+    },
+    [=](int x) {
+      st->values.push_back(x);
+    }
+  };
+}
+
+struct fixture {
+  actor_system_config cfg;
+  consumer_state st;
+
+  fixture() {
+    cfg.mailbox_capacity = 10;
+  }
+
+  // fills the mailbox of a blocked consumer with 20 integers
+  template <class F>
+  void fill_mailbox(atom_value policy, F after_send) {
+    cfg.mailbox_overload_policy = policy;
+    actor_system system{cfg};
+    scoped_actor self{system};
+    auto aut = system.spawn<bounded_mailbox>(consumer, &st);
+    self->send(aut, ok_atom::value);
+    st.entered.get_future().wait();
+    for (int i = 0; i < 20; ++i)
+      self->send(aut, i);
+    self->send_exit(aut, exit_reason::user_shutdown);
+    st.release.set_value();
+    self->wait_for(aut);
+    after_send(self);
+  }
+
+  static vector<int> ints(int first, int last) {
+    vector<int> result;
+    for (int i = first; i < last; ++i)
+      result.push_back(i);
+    return result;
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(bounded_mailbox_tests, fixture)
+
+CAF_TEST(drop_newest) {
+  fill_mailbox(atom("drop-new"), [](scoped_actor& self) {
+    CAF_CHECK(self->mailbox().empty());
+  });
+  CAF_CHECK_EQUAL(st.values, ints(0, 10));
+}
+
+CAF_TEST(drop_oldest) {
+  fill_mailbox(atom("drop-old"), [](scoped_actor&) {
+    // nop
+  });
+  // the exit message counts towards the capacity, hence the consumer
+  // only keeps the nine integers that arrived last
+  CAF_CHECK_EQUAL(st.values, ints(11, 20));
+}
+
+CAF_TEST(reject) {
+  fill_mailbox(atom("reject"), [](scoped_actor& self) {
+    size_t rejected = 0;
+    self->receive_for(rejected, size_t{10}) (
+      [](error& err) {
+        CAF_CHECK_EQUAL(err, sec::mailbox_full);
+      }
+    );
+    CAF_CHECK(self->mailbox().empty());
+  });
+  CAF_CHECK_EQUAL(st.values, ints(0, 10));
+}
+
+CAF_TEST(back_pressure_rejects_blocking_senders) {
+  fill_mailbox(atom("back-press"), [](scoped_actor& self) {
+    size_t rejected = 0;
+    self->receive_for(rejected, size_t{10}) (
+      [](error& err) {
+        CAF_CHECK_EQUAL(err, sec::mailbox_full);
+      }
+    );
+    CAF_CHECK(self->mailbox().empty());
+  });
+  CAF_CHECK_EQUAL(st.values, ints(0, 10));
+}
+
+CAF_TEST(back_pressure_suspends_event_based_senders) {
+  cfg.mailbox_overload_policy = atom("back-press");
+  actor_system system{cfg};
+  scoped_actor self{system};
+  auto aut = system.spawn<bounded_mailbox>(consumer, &st);
+  auto aut_ptr = static_cast<scheduled_actor*>(actor_cast<abstract_actor*>(aut));
+  self->send(aut, ok_atom::value);
+  st.entered.get_future().wait();
+  auto producer = system.spawn([=](event_based_actor* ptr) -> behavior {
+    return {
+      [=](int x) {
+        ptr->send(aut, x);
+        if (x < 19)
+          ptr->send(ptr, x + 1);
+        else
+          ptr->quit();
+      }
+    };
+  });
+  self->send(producer, 0);
+  // the producer exceeds the capacity by one message and then suspends
+  for (int i = 0; i < 1000 && aut_ptr->mailbox_size() < 11; ++i)
+    this_thread::sleep_for(chrono::milliseconds(1));
+  this_thread::sleep_for(chrono::milliseconds(20));
+  CAF_CHECK_EQUAL(aut_ptr->mailbox_size(), 11u);
+  st.release.set_value();
+  self->wait_for(producer);
+  self->send_exit(aut, exit_reason::user_shutdown);
+  self->wait_for(aut);
+  CAF_CHECK_EQUAL(st.values, ints(0, 20));
+}
+
+CAF_TEST(requests_receive_errors) {
+  actor_system system{cfg};
+  scoped_actor self{system};
+  auto aut = system.spawn<bounded_mailbox>(consumer, &st);
+  self->send(aut, ok_atom::value);
+  st.entered.get_future().wait();
+  for (int i = 0; i < 10; ++i)
+    self->send(aut, i);
+  self->request(aut, infinite, 10).receive(
+    [] {
+      CAF_FAIL("full mailbox accepted a request");
+    },
+    [](error& err) {
+      CAF_CHECK_EQUAL(err, sec::mailbox_full);
+    }
+  );
+  st.release.set_value();
+  self->send_exit(aut, exit_reason::user_shutdown);
+  self->wait_for(aut);
+  CAF_CHECK_EQUAL(st.values, ints(0, 10));
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
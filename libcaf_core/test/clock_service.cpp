@@ -0,0 +1,51 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE clock_service
+#include "caf/test/unit_test.hpp"
+
+#include "caf/all.hpp"
+
+#include "caf/scheduler/clock_service.hpp"
+
+using namespace caf;
+
+using clock_service = scheduler::clock_service;
+
+CAF_TEST(messages_before_start_remain_pending) {
+  clock_service uut;
+  auto hdl = uut.schedule(std::chrono::seconds(10), nullptr, nullptr,
+                          message_id::make(), make_message(1));
+  CAF_CHECK_NOT_EQUAL(hdl, clock_service::invalid_handle);
+  CAF_CHECK_EQUAL(uut.pending(), 1u);
+  uut.stop();
+  CAF_CHECK_EQUAL(uut.pending(), 0u);
+}
+
+CAF_TEST(stopped_clocks_drop_new_messages) {
+  clock_service uut;
+  uut.start();
+  uut.stop();
+  auto hdl = uut.schedule(std::chrono::seconds(10), nullptr, nullptr,
+                          message_id::make(), make_message(1));
+  CAF_CHECK_EQUAL(hdl, clock_service::invalid_handle);
+  CAF_CHECK_EQUAL(uut.pending(), 0u);
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE cpu_topology
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/cpu_topology.hpp"
+
+using namespace caf;
+using namespace caf::detail;
+
+namespace {
+
+using ivec = std::vector<int>;
+
+// two NUMA nodes with two L3 caches of two CPUs each
+std::vector<cpu_info> make_topology() {
+  std::vector<cpu_info> result;
+  for (int id = 0; id < 8; ++id) {
+    cpu_info x;
+    x.id = id;
+    x.package = id / 4;
+    x.numa_node = id / 4;
+    x.l3_cache = (id / 2) * 2;
+    result.push_back(x);
+  }
+  return result;
+}
+
+ivec ids(const std::vector<cpu_info>& xs) {
+  ivec result;
+  for (auto& x : xs)
+    result.push_back(x.id);
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(cpu_lists) {
+  CAF_CHECK_EQUAL(parse_cpu_list("0"), ivec({0}));
+  CAF_CHECK_EQUAL(parse_cpu_list("0-3"), ivec({0, 1, 2, 3}));
+  CAF_CHECK_EQUAL(parse_cpu_list("0-1,4,6-7\n"), ivec({0, 1, 4, 6, 7}));
+  CAF_CHECK_EQUAL(parse_cpu_list(""), ivec{});
+  CAF_CHECK_EQUAL(parse_cpu_list("3-1"), ivec{});
+  CAF_CHECK_EQUAL(parse_cpu_list("x"), ivec{});
+}
+
+CAF_TEST(distances) {
+  auto xs = make_topology();
+  CAF_CHECK_EQUAL(cpu_distance(xs[0], xs[1]), 0);
+  CAF_CHECK_EQUAL(cpu_distance(xs[0], xs[2]), 1);
+  CAF_CHECK_EQUAL(cpu_distance(xs[0], xs[4]), 2);
+}
+
+CAF_TEST(placement) {
+  auto xs = make_topology();
+  CAF_CHECK_EQUAL(ids(place_workers(xs, 3, atom("compact"))),
+                  ivec({0, 1, 2}));
+  CAF_CHECK_EQUAL(ids(place_workers(xs, 3, atom("scatter"))),
+                  ivec({0, 4, 1}));
+  CAF_CHECK_EQUAL(ids(place_workers(xs, 10, atom("compact"))),
+                  ivec({0, 1, 2, 3, 4, 5, 6, 7, 0, 1}));
+  CAF_CHECK(place_workers(xs, 3, atom("none")).empty());
+  CAF_CHECK(place_workers({}, 3, atom("compact")).empty());
+}
+
+CAF_TEST(affinity) {
+  // the topology of the host is unknown, but each worker must get a CPU
+  auto xs = get_cpu_topology();
+  if (!xs.empty())
+    CAF_CHECK_EQUAL(place_workers(xs, 4, atom("compact")).size(), 4u);
+  actor_system_config cfg;
+  cfg.scheduler_affinity = atom("compact");
+  actor_system sys{cfg};
+  auto& sched = sys.scheduler();
+  CAF_CHECK(sched.worker_placement().empty()
+            || sched.worker_placement().size() == sched.num_workers());
+}
@@ -0,0 +1,159 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE event_count
+#include "caf/test/unit_test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/event_count.hpp"
+
+#include "caf/policy/work_stealing.hpp"
+
+#include "caf/scheduler/coordinator.hpp"
+
+using namespace caf;
+
+using caf::detail::event_count;
+
+namespace {
+
+using stealing_coordinator = scheduler::coordinator<policy::work_stealing>;
+
+constexpr size_t num_workers = 4;
+
+class config : public actor_system_config {
+public:
+  config() {
+    scheduler_policy = atom("stealing");
+    scheduler_max_threads = num_workers;
+    work_stealing_poll_strategy = atom("park");
+    // skip most of the polling in order to park idle workers early
+    work_stealing_aggressive_poll_attempts = 1;
+    work_stealing_moderate_poll_attempts = 1;
+  }
+};
+
+// returns the number of parked workers after waiting up to 5s for `n`
+size_t await_parked_workers(stealing_coordinator& sched, size_t n) {
+  auto& idle_workers = sched.data().idle_workers;
+  for (int i = 0; i < 500 && idle_workers.waiters() != n; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return idle_workers.waiters();
+}
+
+behavior adder() {
+  return {
+    [](int x) {
+      return x + 1;
+    }
+  };
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(notify_without_waiters) {
+  event_count ec;
+  CAF_CHECK_EQUAL(ec.waiters(), 0u);
+  auto key = ec.prepare_wait();
+  CAF_CHECK_EQUAL(ec.waiters(), 1u);
+  ec.cancel_wait();
+  CAF_CHECK_EQUAL(ec.waiters(), 0u);
+  // notifying nobody leaves the epoch unchanged
+  ec.notify_one();
+  ec.notify_all();
+  CAF_CHECK_EQUAL(ec.prepare_wait(), key);
+  ec.cancel_wait();
+}
+
+CAF_TEST(notify_between_prepare_and_wait) {
+  // a notification after `prepare_wait` must not get lost, even if the
+  // waiter calls `wait` only afterwards
+  event_count ec;
+  bool condition = false;
+  auto key = ec.prepare_wait();
+  CAF_CHECK(!condition);
+  condition = true;
+  ec.notify_one();
+  ec.wait(key);
+  CAF_CHECK_EQUAL(ec.waiters(), 0u);
+  CAF_CHECK_NOT_EQUAL(ec.prepare_wait(), key);
+  ec.cancel_wait();
+}
+
+CAF_TEST(concurrent_handshake) {
+  // the consumer waits for each item individually, hence a lost wakeup
+  // blocks the consumer forever
+  constexpr int num_items = 10000;
+  event_count ec;
+  std::atomic<int> produced{0};
+  int consumed = 0;
+  std::thread consumer{[&] {
+    while (consumed < num_items) {
+      auto key = ec.prepare_wait();
+      if (produced.load() > consumed) {
+        ec.cancel_wait();
+        ++consumed;
+        continue;
+      }
+      ec.wait(key);
+    }
+  }};
+  for (int i = 0; i < num_items; ++i) {
+    produced.fetch_add(1);
+    ec.notify_one();
+    if (i % 100 == 0)
+      std::this_thread::yield();
+  }
+  consumer.join();
+  CAF_CHECK_EQUAL(consumed, num_items);
+  CAF_CHECK_EQUAL(ec.waiters(), 0u);
+}
+
+CAF_TEST(parking_workers) {
+  config cfg;
+  actor_system system{cfg};
+  auto sched = dynamic_cast<stealing_coordinator*>(&system.scheduler());
+  CAF_REQUIRE(sched != nullptr);
+  CAF_REQUIRE(sched->data().parking);
+  CAF_CHECK_EQUAL(await_parked_workers(*sched, num_workers), num_workers);
+  scoped_actor self{system};
+  auto aut = system.spawn(adder);
+  // each round wakes up parked workers, which park again afterwards
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 10; ++i) {
+      self->request(aut, infinite, i).receive(
+        [&](int y) {
+          CAF_CHECK_EQUAL(y, i + 1);
+        },
+        [&](error& err) {
+          CAF_FAIL(system.render(err));
+        }
+      );
+    }
+    CAF_CHECK_EQUAL(await_parked_workers(*sched, num_workers), num_workers);
+  }
+  anon_send_exit(aut, exit_reason::user_shutdown);
+}
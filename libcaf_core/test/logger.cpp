@@ -0,0 +1,141 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE logger
+#include "caf/test/unit_test.hpp"
+
+#include "caf/all.hpp"
+
+using namespace caf;
+
+namespace {
+
+struct fixture {
+  fixture() : sys(cfg), log(sys.logger()) {
+    // nop
+  }
+
+  actor_system_config cfg;
+  actor_system sys;
+  logger& log;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(logger_tests, fixture)
+
+CAF_TEST(parse_verbosity) {
+  int level = 0;
+  CAF_CHECK(logger::parse_verbosity("quiet", level));
+  CAF_CHECK_EQUAL(level, logger::quiet);
+  CAF_CHECK(logger::parse_verbosity("error", level));
+  CAF_CHECK_EQUAL(level, CAF_LOG_LEVEL_ERROR);
+  CAF_CHECK(logger::parse_verbosity("warning", level));
+  CAF_CHECK_EQUAL(level, CAF_LOG_LEVEL_WARNING);
+  CAF_CHECK(logger::parse_verbosity("trace", level));
+  CAF_CHECK_EQUAL(level, CAF_LOG_LEVEL_TRACE);
+  CAF_CHECK(!logger::parse_verbosity("verbose", level));
+}
+
+CAF_TEST(default_verbosity) {
+  log.verbosity(CAF_LOG_LEVEL_INFO);
+  CAF_CHECK(log.filter(CAF_LOG_LEVEL_ERROR, "caf"));
+  CAF_CHECK(log.filter(CAF_LOG_LEVEL_INFO, "caf.io"));
+  CAF_CHECK(!log.filter(CAF_LOG_LEVEL_DEBUG, "caf"));
+  log.verbosity(logger::quiet);
+  CAF_CHECK(!log.filter(CAF_LOG_LEVEL_ERROR, "caf"));
+}
+
+CAF_TEST(component_verbosity) {
+  log.verbosity(CAF_LOG_LEVEL_WARNING);
+  log.component_verbosity("caf.io", CAF_LOG_LEVEL_DEBUG);
+  log.component_verbosity("caf.io.basp", CAF_LOG_LEVEL_TRACE);
+  CAF_CHECK(!log.filter(CAF_LOG_LEVEL_INFO, "caf"));
+  CAF_CHECK(log.filter(CAF_LOG_LEVEL_DEBUG, "caf.io"));
+  CAF_CHECK(log.filter(CAF_LOG_LEVEL_DEBUG, "caf.io.network"));
+  CAF_CHECK(!log.filter(CAF_LOG_LEVEL_TRACE, "caf.io.network"));
+  CAF_CHECK(log.filter(CAF_LOG_LEVEL_TRACE, "caf.io.basp"));
+  // prefixes only match complete components
+  CAF_CHECK(!log.filter(CAF_LOG_LEVEL_DEBUG, "caf.iox"));
+  log.erase_component_verbosity("caf.io.basp");
+  CAF_CHECK(!log.filter(CAF_LOG_LEVEL_TRACE, "caf.io.basp"));
+  CAF_CHECK(log.filter(CAF_LOG_LEVEL_DEBUG, "caf.io.basp"));
+}
+
+CAF_TEST(actor_verbosity) {
+  log.verbosity(CAF_LOG_LEVEL_WARNING);
+  log.actor_verbosity(42, CAF_LOG_LEVEL_TRACE);
+  auto prev = log.thread_local_aid(42);
+  CAF_CHECK(log.filter(CAF_LOG_LEVEL_TRACE, "caf"));
+  log.thread_local_aid(7);
+  CAF_CHECK(!log.filter(CAF_LOG_LEVEL_INFO, "caf"));
+  log.erase_actor_verbosity(42);
+  log.thread_local_aid(42);
+  CAF_CHECK(!log.filter(CAF_LOG_LEVEL_INFO, "caf"));
+  log.thread_local_aid(prev);
+}
+
+CAF_TEST(fast_path) {
+  log.verbosity(logger::quiet);
+  CAF_CHECK(!logger::accepts(CAF_LOG_LEVEL_ERROR, "caf"));
+}
+
+CAF_TEST(call_sites) {
+  static logger::call_site io_site{"caf.io"};
+  log.verbosity(CAF_LOG_LEVEL_WARNING);
+  // the first check registers the call site
+  CAF_CHECK(!logger::accepts(io_site, CAF_LOG_LEVEL_INFO));
+  CAF_CHECK_EQUAL(io_site.threshold(), CAF_LOG_LEVEL_WARNING);
+  // other components leave the call site untouched
+  log.component_verbosity("caf.io.basp", CAF_LOG_LEVEL_TRACE);
+  CAF_CHECK_EQUAL(io_site.threshold(), CAF_LOG_LEVEL_WARNING);
+  CAF_CHECK(!logger::accepts(io_site, CAF_LOG_LEVEL_TRACE));
+  log.component_verbosity("caf.io", CAF_LOG_LEVEL_DEBUG);
+  CAF_CHECK_EQUAL(io_site.threshold(), CAF_LOG_LEVEL_DEBUG);
+  // actor verbosities apply to all components
+  log.actor_verbosity(42, CAF_LOG_LEVEL_TRACE);
+  CAF_CHECK_EQUAL(io_site.threshold(), CAF_LOG_LEVEL_TRACE);
+  CAF_CHECK(!logger::accepts(io_site, CAF_LOG_LEVEL_TRACE));
+  log.erase_actor_verbosity(42);
+  log.erase_component_verbosity("caf.io");
+  log.erase_component_verbosity("caf.io.basp");
+  CAF_CHECK_EQUAL(io_site.threshold(), CAF_LOG_LEVEL_WARNING);
+  log.verbosity(logger::quiet);
+  CAF_CHECK(!logger::accepts(io_site, CAF_LOG_LEVEL_ERROR));
+}
+
+CAF_TEST(config) {
+  actor_system_config other_cfg;
+  other_cfg.logger_verbosity = atom("error");
+  other_cfg.logger_component_verbosity = "caf.io.basp=trace, caf.io=info";
+  other_cfg.logger_actor_verbosity = "42=debug,foo=trace";
+  actor_system other{other_cfg};
+  auto& other_log = other.logger();
+  CAF_CHECK_EQUAL(other_log.verbosity(), CAF_LOG_LEVEL_ERROR);
+  CAF_CHECK(other_log.filter(CAF_LOG_LEVEL_TRACE, "caf.io.basp"));
+  CAF_CHECK(other_log.filter(CAF_LOG_LEVEL_INFO, "caf.io"));
+  CAF_CHECK(!other_log.filter(CAF_LOG_LEVEL_DEBUG, "caf.io"));
+  auto prev = other_log.thread_local_aid(42);
+  CAF_CHECK(other_log.filter(CAF_LOG_LEVEL_DEBUG, "caf"));
+  other_log.thread_local_aid(prev);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
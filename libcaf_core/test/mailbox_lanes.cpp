@@ -0,0 +1,177 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE mailbox_lanes
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/mailbox_lanes.hpp"
+
+using namespace caf;
+
+namespace {
+
+using prio = message_priority;
+
+const prio all_priorities[] = {prio::system, prio::urgent, prio::high,
+                               prio::normal, prio::bulk};
+
+void fill(detail::mailbox_lanes& lanes, size_t per_lane) {
+  for (auto p : all_priorities)
+    for (size_t i = 0; i < per_lane; ++i)
+      lanes.push_back(make_mailbox_element(nullptr, message_id::make(p), {},
+                                           static_cast<int>(i)).release());
+}
+
+std::vector<prio> drain(detail::mailbox_lanes& lanes, size_t n) {
+  std::vector<prio> result;
+  for (size_t i = 0; i < n; ++i) {
+    auto x = lanes.take_front();
+    if (x == nullptr)
+      break;
+    result.push_back(x->mid.priority());
+    detail::disposer{}(x);
+  }
+  return result;
+}
+
+size_t count(const std::vector<prio>& xs, prio p) {
+  size_t result = 0;
+  for (auto x : xs)
+    if (x == p)
+      ++result;
+  return result;
+}
+
+behavior prioritized_testee(event_based_actor* self, actor observer) {
+  // enqueue in reverse order, the actor receives nothing before returning
+  for (auto i = message_priorities; i > 0; --i) {
+    auto p = all_priorities[i - 1];
+    switch (p) {
+      case prio::system:
+        self->send<prio::system>(self, static_cast<int>(p));
+        break;
+      case prio::urgent:
+        self->send<prio::urgent>(self, static_cast<int>(p));
+        break;
+      case prio::high:
+        self->send<prio::high>(self, static_cast<int>(p));
+        break;
+      case prio::normal:
+        self->send<prio::normal>(self, static_cast<int>(p));
+        break;
+      case prio::bulk:
+        self->send<prio::bulk>(self, static_cast<int>(p));
+    }
+  }
+  return {
+    [=](int x) {
+      self->send(observer, x);
+      if (x == static_cast<int>(prio::bulk))
+        self->quit();
+    }
+  };
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(message_id_priorities) {
+  for (auto p : all_priorities) {
+    auto mid = message_id::make(p);
+    CAF_CHECK(mid.priority() == p);
+    CAF_CHECK(mid.is_async());
+    CAF_CHECK(!mid.valid());
+    CAF_CHECK_EQUAL(mid.is_high_priority(),
+                    detail::mailbox_lanes::lane_of(p) <= 2);
+    auto req = message_id::make();
+    ++req;
+    req = req.with_priority(p);
+    CAF_CHECK(req.priority() == p);
+    CAF_CHECK(req.is_request());
+    CAF_CHECK_EQUAL(req.request_id().integer_value(), 1u);
+    CAF_CHECK(req.response_id().priority() == p);
+  }
+  // `normal` and `high` keep the encoding of previous versions
+  uint64_t high_flag = message_id::high_prioity_flag_mask;
+  CAF_CHECK_EQUAL(message_id::make(prio::high).integer_value(), high_flag);
+  CAF_CHECK_EQUAL(message_id::make(prio::normal).integer_value(), 0u);
+  CAF_CHECK(prio{} == prio::normal);
+  CAF_CHECK(message_id{}.priority() == prio::normal);
+}
+
+CAF_TEST(strict_policy) {
+  detail::mailbox_lanes lanes{priority_policy::strict};
+  fill(lanes, 3);
+  CAF_CHECK_EQUAL(lanes.size(), 15u);
+  auto xs = drain(lanes, 15);
+  CAF_REQUIRE_EQUAL(xs.size(), 15u);
+  for (size_t i = 0; i < xs.size(); ++i)
+    CAF_CHECK(xs[i] == all_priorities[i / 3]);
+  CAF_CHECK(lanes.empty());
+  CAF_CHECK(lanes.take_front() == nullptr);
+}
+
+CAF_TEST(weighted_policy) {
+  detail::mailbox_lanes lanes{priority_policy::weighted};
+  fill(lanes, 32);
+  // one full round takes 16, 8, 4, 2 and 1 elements
+  auto xs = drain(lanes, 31);
+  CAF_CHECK_EQUAL(count(xs, prio::system), 16u);
+  CAF_CHECK_EQUAL(count(xs, prio::urgent), 8u);
+  CAF_CHECK_EQUAL(count(xs, prio::high), 4u);
+  CAF_CHECK_EQUAL(count(xs, prio::normal), 2u);
+  CAF_CHECK_EQUAL(count(xs, prio::bulk), 1u);
+  // lower lanes get all remaining capacity once higher lanes run dry
+  xs = drain(lanes, 200);
+  CAF_CHECK_EQUAL(xs.size(), 129u);
+  CAF_CHECK(xs.back() == prio::bulk);
+  CAF_CHECK(lanes.empty());
+}
+
+CAF_TEST(clear_lanes) {
+  detail::mailbox_lanes lanes{priority_policy::weighted};
+  fill(lanes, 2);
+  size_t visited = 0;
+  auto f = [&](const mailbox_element&) { ++visited; };
+  lanes.clear(f);
+  CAF_CHECK_EQUAL(visited, 10u);
+  CAF_CHECK(lanes.empty());
+}
+
+CAF_TEST(priority_aware_actor) {
+  actor_system_config cfg;
+  actor_system system{cfg};
+  scoped_actor self{system};
+  self->spawn<priority_aware>(prioritized_testee, actor{self});
+  std::vector<int> received;
+  size_t i = 0;
+  self->receive_for(i, message_priorities) (
+    [&](int x) {
+      received.push_back(x);
+    }
+  );
+  CAF_REQUIRE_EQUAL(received.size(), message_priorities);
+  for (i = 0; i < received.size(); ++i)
+    CAF_CHECK_EQUAL(received[i], static_cast<int>(all_priorities[i]));
+}
@@ -133,3 +133,43 @@ CAF_TEST(atom_constants) {
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST(indexed_dispatch) {
+  int res = -1;
+  // exceeds the linear_dispatch_limit and mixes cases with equal tokens
+  message_handler expr{
+    [&](int32_t, int32_t) { res = 0; },
+    [&](hi_atom) { res = 1; },
+    [&](const std::string&) { res = 2; },
+    [&](double) { res = 3; },
+    [&](ho_atom) { res = 4; },
+    [&](int32_t) { res = 5; },
+    [&](float) { res = 6; },
+    [&](atom_value) { res = 7; },
+    [&](hi_atom, int32_t) { res = 8; },
+    [&](uint8_t) { res = 9; },
+    [&](int64_t) { res = 10; },
+    [&](atom_value, int32_t) { res = 11; },
+    [&](int32_t) { res = 12; }
+  };
+  auto check = [&](message msg) -> int {
+    res = -1;
+    expr(msg);
+    return res;
+  };
+  CAF_CHECK_EQUAL(check(make_message(1, 2)), 0);
+  CAF_CHECK_EQUAL(check(make_message(hi_atom::value)), 1);
+  CAF_CHECK_EQUAL(check(make_message("hello")), 2);
+  CAF_CHECK_EQUAL(check(make_message(1.)), 3);
+  CAF_CHECK_EQUAL(check(make_message(ho_atom::value)), 4);
+  // the first matching case wins even if its token appears multiple times
+  CAF_CHECK_EQUAL(check(make_message(1)), 5);
+  CAF_CHECK_EQUAL(check(make_message(1.f)), 6);
+  CAF_CHECK_EQUAL(check(make_message(ok_atom::value)), 7);
+  CAF_CHECK_EQUAL(check(make_message(hi_atom::value, 1)), 8);
+  CAF_CHECK_EQUAL(check(make_message(ho_atom::value, 1)), 11);
+  CAF_CHECK_EQUAL(check(make_message(uint8_t{1})), 9);
+  CAF_CHECK_EQUAL(check(make_message(int64_t{1})), 10);
+  CAF_CHECK_EQUAL(check(make_message(int16_t{1})), -1);
+  CAF_CHECK_EQUAL(check(make_message()), -1);
+}
@@ -23,14 +23,51 @@
 #include "caf/test/unit_test.hpp"
 
 #include <atomic>
+#include <memory>
 #include <iostream>
 
 #include "caf/all.hpp"
 
+namespace {
+
+// counts how often the test copies a payload
+std::atomic<size_t> payload_copies;
+
+struct payload {
+  payload() = default;
+  payload(payload&&) = default;
+  payload& operator=(payload&&) = default;
+  payload(const payload&) {
+    ++payload_copies;
+  }
+  payload& operator=(const payload&) {
+    ++payload_copies;
+    return *this;
+  }
+};
+
+using unique_int = std::unique_ptr<int>;
+
+} // namespace <anonymous>
+
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(payload)
+CAF_ALLOW_UNSAFE_MESSAGE_TYPE(unique_int)
+
 using namespace caf;
 
 namespace {
 
+// passes each payload on to the next relay or to `sink`
+behavior relay(event_based_actor* self, int remaining, actor sink) {
+  auto next = remaining > 1 ? self->spawn(relay, remaining - 1, sink) : sink;
+  return {
+    [=](payload&& x) {
+      self->send(next, std::move(x));
+      self->quit();
+    }
+  };
+}
+
 class testee : public event_based_actor {
 public:
   testee(actor_config& cfg) : event_based_actor(cfg) {
@@ -127,6 +164,47 @@ CAF_TEST(message_lifetime_in_scoped_actor) {
   CAF_CHECK_EQUAL(msg.get_as<int>(0), 42);
 }
 
+CAF_TEST(move_only_payloads) {
+  scoped_actor self{system};
+  auto aut = system.spawn([](event_based_actor* ptr) -> behavior {
+    return {
+      [=](unique_int&& x) {
+        ++*x;
+        ptr->send(actor_cast<actor>(ptr->current_sender()), std::move(x));
+        ptr->quit();
+      }
+    };
+  });
+  self->send(aut, unique_int{new int(41)});
+  self->receive(
+    [](unique_int&& x) {
+      CAF_REQUIRE(x != nullptr);
+      CAF_CHECK_EQUAL(*x, 42);
+    }
+  );
+}
+
+CAF_TEST(rvalue_handlers_move_payloads) {
+  payload_copies = 0;
+  scoped_actor self{system};
+  self->send(system.spawn(relay, 10, actor{self}), payload{});
+  self->receive(
+    [](payload&&) {
+      // nop
+    }
+  );
+  CAF_CHECK_EQUAL(payload_copies.load(), 0u);
+  // moving out of a shared message detaches it first
+  auto msg = make_message(payload{});
+  self->send(self, msg);
+  self->receive(
+    [](payload&&) {
+      // nop
+    }
+  );
+  CAF_CHECK_EQUAL(payload_copies.load(), 1u);
+}
+
 CAF_TEST(message_lifetime_no_spawn_options) {
   test_message_lifetime<no_spawn_options>();
 }
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE metric_registry
+#include "caf/test/unit_test.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "caf/all.hpp"
+
+#include "caf/telemetry/metric_registry.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::telemetry;
+
+namespace {
+
+bool contains(const string& str, const string& what) {
+  return str.find(what) != string::npos;
+}
+
+struct fixture {
+  metric_registry reg;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(metric_registry_tests, fixture)
+
+CAF_TEST(counters) {
+  auto& x = reg.add_counter("foo_total", "Foo.");
+  CAF_CHECK_EQUAL(x.value(), 0u);
+  x.inc();
+  x.inc(41);
+  CAF_CHECK_EQUAL(x.value(), 42u);
+  // adding the same metric again returns the existing instance
+  CAF_CHECK_EQUAL(&reg.add_counter("foo_total", "Foo."), &x);
+  CAF_CHECK_NOT_EQUAL(&reg.add_counter("foo_total", "Foo.", "a=\"b\""), &x);
+  CAF_CHECK_EQUAL(reg.size(), 2u);
+  CAF_CHECK_EQUAL(reg.render(), "# HELP foo_total Foo.\n"
+                                "# TYPE foo_total counter\n"
+                                "foo_total 42\n"
+                                "foo_total{a=\"b\"} 0\n");
+}
+
+CAF_TEST(concurrent_counting) {
+  auto& x = reg.add_counter("bar_total", "Bar.");
+  vector<thread> threads;
+  for (int i = 0; i < 8; ++i)
+    threads.emplace_back([&] {
+      for (int j = 0; j < 10000; ++j)
+        x.inc();
+    });
+  for (auto& t : threads)
+    t.join();
+  CAF_CHECK_EQUAL(x.value(), 80000u);
+}
+
+CAF_TEST(gauges) {
+  auto& x = reg.add_gauge("level", "Level.");
+  x.inc(10);
+  x.dec(3);
+  CAF_CHECK_EQUAL(x.value(), 7);
+  x.set(-2);
+  CAF_CHECK_EQUAL(x.value(), -2);
+  int64_t backing = 23;
+  auto& y = reg.add_gauge("computed", "Computed.", [&] { return backing; });
+  CAF_CHECK_EQUAL(y.value(), 23);
+  backing = 24;
+  CAF_CHECK_EQUAL(y.value(), 24);
+  auto str = reg.render();
+  CAF_CHECK(contains(str, "# TYPE computed gauge\ncomputed 24\n"));
+  CAF_CHECK(contains(str, "# TYPE level gauge\nlevel -2\n"));
+}
+
+CAF_TEST(histograms) {
+  auto& x = reg.add_histogram("size_bytes", "Size.", {10, 100}, "k=\"v\"");
+  x.observe(1);
+  x.observe(10);
+  x.observe(11);
+  x.observe(1000);
+  CAF_CHECK_EQUAL(x.buckets(), (vector<uint64_t>{2, 1, 1}));
+  CAF_CHECK_EQUAL(x.sum(), 1022u);
+  CAF_CHECK_EQUAL(reg.render(),
+                  "# HELP size_bytes Size.\n"
+                  "# TYPE size_bytes histogram\n"
+                  "size_bytes_bucket{k=\"v\",le=\"10\"} 2\n"
+                  "size_bytes_bucket{k=\"v\",le=\"100\"} 3\n"
+                  "size_bytes_bucket{k=\"v\",le=\"+Inf\"} 4\n"
+                  "size_bytes_sum{k=\"v\"} 1022\n"
+                  "size_bytes_count{k=\"v\"} 4\n");
+}
+
+CAF_TEST(erase) {
+  auto& x = reg.add_counter("foo_total", "Foo.");
+  reg.add_counter("bar_total", "Bar.");
+  CAF_CHECK_EQUAL(reg.size(), 2u);
+  reg.erase(x);
+  CAF_CHECK_EQUAL(reg.size(), 1u);
+  CAF_CHECK(!contains(reg.render(), "foo_total"));
+}
+
+CAF_TEST(system_metrics) {
+  actor_system_config cfg;
+  actor_system sys{cfg};
+  auto aut = sys.spawn([]() -> behavior {
+    return {
+      [](int x) {
+        return x;
+      }
+    };
+  });
+  scoped_actor self{sys};
+  self->request(aut, infinite, 42).receive(
+    [](int) {
+      // nop
+    },
+    [&](error& err) {
+      CAF_FAIL(sys.render(err));
+    }
+  );
+  auto str = sys.metrics().render();
+  auto running = to_string(sys.registry().running());
+  CAF_CHECK(contains(str, "caf_running_actors " + running + "\n"));
+  CAF_CHECK(contains(str, "caf_scheduler_jobs_enqueued_total"));
+  CAF_CHECK(contains(str, "caf_scheduler_queued_jobs"));
+  anon_send_exit(aut, exit_reason::kill);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,173 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE response_table
+#include "caf/test/unit_test.hpp"
+
+#include <array>
+#include <vector>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/response_table.hpp"
+#include "caf/detail/response_handler.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+using table = detail::response_table<int>;
+
+message_id rid(uint64_t x) {
+  return message_id::from_integer_value(x).response_id();
+}
+
+behavior server(event_based_actor*) {
+  return {
+    [](int x) {
+      return x;
+    }
+  };
+}
+
+// issues the next request from within a response handler
+// until reaching 10 and finally sends an awaited request
+void next_request(event_based_actor* self, actor srv,
+                  shared_ptr<vector<int>> results, int x) {
+  results->push_back(x);
+  if (x < 10)
+    self->request(srv, infinite, x + 1).then([=](int y) {
+      next_request(self, srv, results, y);
+    });
+  else
+    self->request(srv, infinite, x * 10).await([=](int y) {
+      results->push_back(y);
+      self->quit();
+    });
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(insert_find_erase) {
+  table uut;
+  CAF_CHECK(uut.empty());
+  CAF_CHECK(uut.find(rid(1)) == nullptr);
+  for (uint64_t i = 1; i <= 100; ++i)
+    CAF_CHECK(uut.emplace(rid(i), static_cast<int>(i)).second);
+  CAF_CHECK_EQUAL(uut.size(), 100u);
+  auto res = uut.emplace(rid(42), 0);
+  CAF_CHECK(!res.second);
+  CAF_CHECK_EQUAL(*res.first, 42);
+  for (uint64_t i = 1; i <= 100; i += 2)
+    CAF_CHECK(uut.erase(rid(i)));
+  CAF_CHECK(!uut.erase(rid(1)));
+  CAF_CHECK_EQUAL(uut.size(), 50u);
+  for (uint64_t i = 1; i <= 100; ++i) {
+    auto x = uut.find(rid(i));
+    if (i % 2 == 1) {
+      CAF_CHECK(x == nullptr);
+    } else {
+      CAF_REQUIRE(x != nullptr);
+      CAF_CHECK_EQUAL(*x, static_cast<int>(i));
+    }
+  }
+  size_t visited = 0;
+  uut.for_each([&](message_id, int) { ++visited; });
+  CAF_CHECK_EQUAL(visited, 50u);
+  uut.clear();
+  CAF_CHECK(uut.empty());
+  CAF_CHECK(uut.find(rid(2)) == nullptr);
+}
+
+CAF_TEST(colliding_keys) {
+  // keys with the same lower bits share a probe sequence, erasing one of
+  // them must keep all others reachable
+  table uut;
+  for (uint64_t i = 1; i <= 8; ++i)
+    uut.emplace(rid(i * 1024), static_cast<int>(i));
+  uut.erase(rid(1024));
+  uut.erase(rid(4 * 1024));
+  for (uint64_t i = 1; i <= 8; ++i) {
+    auto x = uut.find(rid(i * 1024));
+    if (i == 1 || i == 4) {
+      CAF_CHECK(x == nullptr);
+    } else {
+      CAF_REQUIRE(x != nullptr);
+      CAF_CHECK_EQUAL(*x, static_cast<int>(i));
+    }
+  }
+}
+
+CAF_TEST(response_handlers) {
+  int result = 0;
+  detail::response_handler f{
+    [&](int x) {
+      result = x;
+    },
+    [&](error&) {
+      result = -1;
+    }
+  };
+  CAF_CHECK(f.is_inline());
+  auto msg = make_message(42);
+  CAF_CHECK(f(msg));
+  CAF_CHECK_EQUAL(result, 42);
+  // moving a handler keeps its callbacks
+  auto g = std::move(f);
+  CAF_CHECK(!f);
+  auto err = make_message(make_error(sec::request_timeout));
+  CAF_CHECK(g(err));
+  CAF_CHECK_EQUAL(result, -1);
+  auto str = make_message("hello");
+  CAF_CHECK(!g(str));
+  // large callbacks fall back to the heap
+  array<char, detail::response_handler::inline_size> buf{};
+  detail::response_handler h{
+    [buf](int) {
+      // nop
+    }
+  };
+  CAF_CHECK(!h.is_inline());
+  CAF_CHECK(h(msg));
+}
+
+CAF_TEST(nested_requests) {
+  actor_system_config cfg;
+  actor_system system{cfg};
+  auto srv = system.spawn(server);
+  auto results = make_shared<vector<int>>();
+  auto client = system.spawn([=](event_based_actor* self) {
+    for (int i = 0; i < 5; ++i)
+      self->request(srv, infinite, i * 100 + 100).then([=](int x) {
+        results->push_back(x);
+      });
+    self->request(srv, infinite, 1).then([=](int x) {
+      next_request(self, srv, results, x);
+    });
+  });
+  scoped_actor self{system};
+  self->wait_for(client);
+  anon_send_exit(srv, exit_reason::kill);
+  CAF_CHECK_EQUAL(results->size(), 16u);
+  CAF_CHECK_EQUAL(results->back(), 100);
+}
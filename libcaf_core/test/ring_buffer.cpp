@@ -0,0 +1,123 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE ring_buffer
+#include "caf/test/unit_test.hpp"
+
+#include <thread>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "caf/detail/ring_buffer.hpp"
+
+using caf::detail::ring_buffer;
+
+namespace {
+
+bool push(ring_buffer& buf, const std::string& str) {
+  return buf.push(str.size(), [&](char* ptr) {
+    memcpy(ptr, str.data(), str.size());
+  });
+}
+
+std::vector<std::string> consume(ring_buffer& buf) {
+  std::vector<std::string> result;
+  buf.consume([&](const char* ptr, size_t size) {
+    result.emplace_back(ptr, size);
+  });
+  return result;
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(capacity) {
+  CAF_CHECK_EQUAL(ring_buffer{1}.capacity(), 64u);
+  CAF_CHECK_EQUAL(ring_buffer{100}.capacity(), 128u);
+  CAF_CHECK_EQUAL(ring_buffer{128}.capacity(), 128u);
+}
+
+CAF_TEST(fifo_order) {
+  ring_buffer buf{256};
+  CAF_CHECK(buf.empty());
+  CAF_CHECK(push(buf, "hello"));
+  CAF_CHECK(push(buf, ""));
+  CAF_CHECK(push(buf, "world"));
+  CAF_CHECK(!buf.empty());
+  std::vector<std::string> expected{"hello", "", "world"};
+  CAF_CHECK(consume(buf) == expected);
+  CAF_CHECK(buf.empty());
+  CAF_CHECK(consume(buf).empty());
+}
+
+CAF_TEST(full_buffer) {
+  // each record occupies 32 bytes: 16 bytes for the header plus 16 bytes
+  // for the content
+  ring_buffer buf{64};
+  std::string str(16, 'x');
+  CAF_CHECK(push(buf, str));
+  CAF_CHECK(push(buf, str));
+  CAF_CHECK(!push(buf, str));
+  CAF_CHECK(!push(buf, std::string(100, 'y')));
+  CAF_CHECK_EQUAL(consume(buf).size(), 2u);
+  CAF_CHECK(push(buf, str));
+}
+
+CAF_TEST(wrap_around) {
+  ring_buffer buf{64};
+  // occupies 48 bytes, leaving 16 bytes at the end of the buffer
+  CAF_CHECK(push(buf, std::string(32, 'a')));
+  CAF_CHECK_EQUAL(consume(buf).size(), 1u);
+  // does not fit into the remaining 16 bytes, hence starts at offset 0
+  CAF_CHECK(push(buf, std::string(20, 'b')));
+  CAF_CHECK(!push(buf, std::string(20, 'c')));
+  auto xs = consume(buf);
+  CAF_REQUIRE_EQUAL(xs.size(), 1u);
+  CAF_CHECK_EQUAL(xs.front(), std::string(20, 'b'));
+  for (int i = 0; i < 100; ++i) {
+    auto str = std::to_string(i);
+    CAF_CHECK(push(buf, str));
+    auto ys = consume(buf);
+    CAF_REQUIRE_EQUAL(ys.size(), 1u);
+    CAF_CHECK_EQUAL(ys.front(), str);
+  }
+}
+
+CAF_TEST(concurrent_producer) {
+  ring_buffer buf{1024};
+  constexpr int num_records = 10000;
+  std::thread producer{[&] {
+    for (int i = 0; i < num_records; ++i) {
+      auto str = std::to_string(i);
+      while (!push(buf, str))
+        std::this_thread::yield();
+    }
+  }};
+  int next = 0;
+  while (next < num_records) {
+    buf.consume([&](const char* ptr, size_t size) {
+      CAF_CHECK_EQUAL(std::string(ptr, size), std::to_string(next));
+      ++next;
+    });
+  }
+  producer.join();
+  CAF_CHECK(buf.empty());
+}
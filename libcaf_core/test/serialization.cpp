@@ -134,6 +134,7 @@ public:
     add_message_type<raw_struct>("raw_struct");
     add_message_type<test_array>("test_array");
     add_message_type<test_empty_non_pod>("test_empty_non_pod");
+    add_message_type<vector<int64_t>>("vector<int64_t>");
   }
 };
 
@@ -172,6 +173,22 @@ struct fixture {
     bd(x, xs...);
   }
 
+  template <class T>
+  vector<char> serialize(binary_encoding enc, T& x) {
+    vector<char> buf;
+    binary_serializer bs{&context, buf};
+    bs.encoding(enc);
+    bs(x);
+    return buf;
+  }
+
+  template <class T>
+  error deserialize(binary_encoding enc, const vector<char>& buf, T& x) {
+    binary_deserializer bd{&context, buf};
+    bd.encoding(enc);
+    return bd(x);
+  }
+
   // serializes `x` and then deserializes and returns the serialized value
   template <class T>
   T roundtrip(T x) {
@@ -180,6 +197,16 @@ struct fixture {
     return result;
   }
 
+  // like `roundtrip`, but also checks the size of the serialized value
+  template <class T>
+  T roundtrip(binary_encoding enc, T x, size_t expected_size) {
+    T result{};
+    auto buf = serialize(enc, x);
+    CAF_CHECK_EQUAL(buf.size(), expected_size);
+    CAF_CHECK_EQUAL(deserialize(enc, buf, result), none);
+    return result;
+  }
+
   // converts `x` to a message, serialize it, then deserializes it, and
   // finally returns unboxed value
   template <class T>
@@ -437,4 +464,68 @@ CAF_TEST(byte_sequence_optimization) {
                         [](uint8_t c) { return c == 0x2a; }));
 }
 
+CAF_TEST(varint_integers) {
+  auto enc = binary_encoding::varint;
+  CAF_CHECK_EQUAL(roundtrip(enc, int16_t{0}, 1u), 0);
+  CAF_CHECK_EQUAL(roundtrip(enc, int16_t{-1}, 1u), -1);
+  CAF_CHECK_EQUAL(roundtrip(enc, int16_t{63}, 1u), 63);
+  CAF_CHECK_EQUAL(roundtrip(enc, int16_t{-64}, 1u), -64);
+  CAF_CHECK_EQUAL(roundtrip(enc, int16_t{64}, 2u), 64);
+  auto i16_min = numeric_limits<int16_t>::min();
+  CAF_CHECK_EQUAL(roundtrip(enc, i16_min, 3u), i16_min);
+  CAF_CHECK_EQUAL(roundtrip(enc, i32, 2u), i32);
+  auto i32_max = numeric_limits<int32_t>::max();
+  CAF_CHECK_EQUAL(roundtrip(enc, i32_max, 5u), i32_max);
+  auto i64_min = numeric_limits<int64_t>::min();
+  CAF_CHECK_EQUAL(roundtrip(enc, i64_min, 10u), i64_min);
+  CAF_CHECK_EQUAL(roundtrip(enc, uint16_t{127}, 1u), 127u);
+  CAF_CHECK_EQUAL(roundtrip(enc, uint32_t{128}, 2u), 128u);
+  auto u64_max = numeric_limits<uint64_t>::max();
+  CAF_CHECK_EQUAL(roundtrip(enc, u64_max, 10u), u64_max);
+  // 8-bit integers and floating point numbers keep their fixed width
+  CAF_CHECK_EQUAL(roundtrip(enc, int8_t{-1}, 1u), -1);
+  CAF_CHECK_EQUAL(roundtrip(enc, f64, 8u), f64);
+  // enums use the encoding of their underlying type
+  CAF_CHECK_EQUAL(roundtrip(enc, te, 1u), te);
+}
+
+CAF_TEST(compact_atoms) {
+  auto fixed = binary_encoding::fixed;
+  auto varint = binary_encoding::varint;
+  auto compact = binary_encoding::compact;
+  CAF_CHECK_EQUAL(roundtrip(fixed, atom("foo"), 8u), atom("foo"));
+  CAF_CHECK_EQUAL(roundtrip(varint, atom("foo"), 4u), atom("foo"));
+  CAF_CHECK_EQUAL(roundtrip(compact, atom("foo"), 3u), atom("foo"));
+  CAF_CHECK_EQUAL(roundtrip(compact, atom(""), 1u), atom(""));
+  CAF_CHECK_EQUAL(roundtrip(compact, atom("a"), 1u), atom("a"));
+  CAF_CHECK_EQUAL(roundtrip(compact, atom("abcdefgh"), 7u), atom("abcdefgh"));
+  CAF_CHECK_EQUAL(roundtrip(varint, atom("abcdefghij"), 10u),
+                  atom("abcdefghij"));
+  CAF_CHECK_EQUAL(roundtrip(compact, atom("abcdefghij"), 9u),
+                  atom("abcdefghij"));
+  // values without the 0xF prefix fall back to the fixed-width encoding
+  auto x = static_cast<atom_value>(42);
+  CAF_CHECK_EQUAL(roundtrip(compact, x, 9u), x);
+  // a deserializer rejects atoms without valid prefix bit
+  vector<char> buf{static_cast<char>(0x02)};
+  atom_value y;
+  CAF_CHECK_NOT_EQUAL(deserialize(compact, buf, y), none);
+}
+
+CAF_TEST(compact_messages) {
+  auto x = make_message(atom("get"), i32, str, vector<int64_t>{1, -2, 3});
+  auto fixed_buf = serialize(binary_encoding::fixed, x);
+  auto compact_buf = serialize(binary_encoding::compact, x);
+  CAF_MESSAGE("fixed: " << fixed_buf.size() << " bytes, compact: "
+              << compact_buf.size() << " bytes");
+  CAF_CHECK_LESS(compact_buf.size(), fixed_buf.size());
+  message y;
+  CAF_CHECK_EQUAL(deserialize(binary_encoding::compact, compact_buf, y), none);
+  CAF_CHECK_EQUAL(to_string(x), to_string(y));
+  // a truncated varint results in an error rather than a bogus value
+  compact_buf.resize(compact_buf.size() - 1);
+  CAF_CHECK_NOT_EQUAL(deserialize(binary_encoding::compact, compact_buf, y),
+                      none);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
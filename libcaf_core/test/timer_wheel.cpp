@@ -0,0 +1,162 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE timer_wheel
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+#include <chrono>
+
+#include "caf/all.hpp"
+
+#include "caf/detail/timer_wheel.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+using wheel = detail::timer_wheel<int>;
+
+struct fixture {
+  wheel uut;
+  vector<int> expired;
+
+  void advance(uint64_t t) {
+    uut.advance(t, [&](int x) { expired.push_back(x); });
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(timer_wheel_tests, fixture)
+
+CAF_TEST(expiry_order) {
+  uut.add(3, 3);
+  uut.add(1, 1);
+  uut.add(2, 2);
+  CAF_CHECK_EQUAL(uut.size(), 3u);
+  CAF_CHECK_EQUAL(uut.next_tick(), 1u);
+  advance(1);
+  CAF_CHECK_EQUAL(expired, vector<int>{1});
+  advance(3);
+  CAF_CHECK_EQUAL(expired, (vector<int>{1, 2, 3}));
+  CAF_CHECK(uut.empty());
+  // timeouts with the same expiry fire in insertion order
+  uut.add(5, 5);
+  uut.add(5, 4);
+  uut.add(300, 7);
+  uut.add(300, 6);
+  advance(300);
+  CAF_CHECK_EQUAL(expired, (vector<int>{1, 2, 3, 5, 4, 7, 6}));
+}
+
+CAF_TEST(past_expiries_fire_on_next_tick) {
+  advance(10);
+  uut.add(5, 5);
+  advance(10);
+  CAF_CHECK(expired.empty());
+  advance(11);
+  CAF_CHECK_EQUAL(expired, vector<int>{5});
+}
+
+CAF_TEST(cancel) {
+  auto h1 = uut.add(10, 1);
+  auto h2 = uut.add(10, 2);
+  CAF_CHECK(uut.cancel(h1));
+  CAF_CHECK(!uut.cancel(h1));
+  CAF_CHECK(!uut.cancel(wheel::invalid_handle));
+  advance(10);
+  CAF_CHECK_EQUAL(expired, vector<int>{2});
+  // handles of expired entries never match recycled entries
+  auto h3 = uut.add(20, 3);
+  CAF_CHECK(!uut.cancel(h2));
+  CAF_CHECK_EQUAL(uut.size(), 1u);
+  CAF_CHECK(uut.cancel(h3));
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(higher_levels) {
+  // spread timeouts over all levels and check that each
+  // one expires at exactly its tick after cascading down
+  vector<uint64_t> ticks{255, 256, 257, 1000, 65535, 65536, 65537,
+                         70000, 16777215, 16777216, 20000000};
+  for (auto t : ticks)
+    uut.add(t, static_cast<int>(t));
+  for (size_t i = 0; i < ticks.size(); ++i) {
+    auto t = ticks[i];
+    advance(t - 1);
+    CAF_CHECK_EQUAL(expired.size(), i);
+    advance(t);
+    CAF_REQUIRE(!expired.empty());
+    CAF_CHECK_EQUAL(expired.back(), static_cast<int>(t));
+  }
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(beyond_max_distance) {
+  auto t = wheel::max_distance + 1000;
+  uut.add(t, 1);
+  advance(wheel::max_distance);
+  CAF_CHECK(expired.empty());
+  advance(t - 1);
+  CAF_CHECK(expired.empty());
+  advance(t);
+  CAF_CHECK_EQUAL(expired, vector<int>{1});
+}
+
+CAF_TEST(clear) {
+  for (int i = 1; i <= 100; ++i)
+    uut.add(static_cast<uint64_t>(i * 100), i);
+  size_t cleared = 0;
+  uut.clear([&](int) { ++cleared; });
+  CAF_CHECK_EQUAL(cleared, 100u);
+  CAF_CHECK(uut.empty());
+  advance(20000);
+  CAF_CHECK(expired.empty());
+}
+
+CAF_TEST(response_timeouts_are_cancelled) {
+  actor_system_config cfg;
+  actor_system system{cfg};
+  auto& clock = system.scheduler().clock();
+  auto server = system.spawn([]() -> behavior {
+    return {
+      [](int x) {
+        return x;
+      }
+    };
+  });
+  auto client = system.spawn([=](event_based_actor* self) {
+    for (int i = 0; i < 100; ++i)
+      self->request(server, std::chrono::seconds(10), i).then(
+        [](int) {
+          // nop
+        }
+      );
+  });
+  scoped_actor self{system};
+  self->wait_for(client);
+  anon_send_exit(server, exit_reason::kill);
+  CAF_CHECK_EQUAL(clock.pending(), 0u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,150 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE work_stealing_deque
+#include "caf/test/unit_test.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <numeric>
+
+#include "caf/detail/work_stealing_deque.hpp"
+#include "caf/detail/work_stealing_queue.hpp"
+
+using caf::detail::work_stealing_deque;
+using caf::detail::work_stealing_queue;
+
+namespace {
+
+struct fixture {
+  fixture() : xs(1000) {
+    std::iota(xs.begin(), xs.end(), 0);
+  }
+
+  std::vector<int> xs;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(work_stealing_deque_tests, fixture)
+
+CAF_TEST(owner_operates_lifo) {
+  work_stealing_deque<int> q{4};
+  CAF_CHECK(q.empty());
+  CAF_CHECK_EQUAL(q.pop_bottom(), nullptr);
+  for (int i = 0; i < 3; ++i)
+    q.push_bottom(&xs[i]);
+  CAF_CHECK(!q.empty());
+  CAF_CHECK_EQUAL(*q.pop_bottom(), 2);
+  CAF_CHECK_EQUAL(*q.pop_bottom(), 1);
+  CAF_CHECK_EQUAL(*q.pop_bottom(), 0);
+  CAF_CHECK_EQUAL(q.pop_bottom(), nullptr);
+  CAF_CHECK(q.empty());
+}
+
+CAF_TEST(thieves_operate_fifo) {
+  work_stealing_deque<int> q{4};
+  CAF_CHECK_EQUAL(q.steal(), nullptr);
+  for (int i = 0; i < 3; ++i)
+    q.push_bottom(&xs[i]);
+  CAF_CHECK_EQUAL(*q.steal(), 0);
+  CAF_CHECK_EQUAL(*q.pop_bottom(), 2);
+  CAF_CHECK_EQUAL(*q.steal(), 1);
+  CAF_CHECK_EQUAL(q.steal(), nullptr);
+  CAF_CHECK_EQUAL(q.pop_bottom(), nullptr);
+}
+
+CAF_TEST(growing) {
+  work_stealing_deque<int> q{4};
+  CAF_CHECK_EQUAL(q.capacity(), 4);
+  for (auto& x : xs)
+    q.push_bottom(&x);
+  CAF_CHECK_EQUAL(q.capacity(), 1024);
+  for (size_t i = 0; i < 10; ++i)
+    CAF_CHECK_EQUAL(*q.steal(), xs[i]);
+  for (size_t i = xs.size(); i > 10; --i)
+    CAF_CHECK_EQUAL(*q.pop_bottom(), xs[i - 1]);
+  CAF_CHECK(q.empty());
+}
+
+CAF_TEST(concurrent_stealing) {
+  work_stealing_deque<int> q{4};
+  std::atomic<bool> done{false};
+  std::atomic<long> stolen_sum{0};
+  std::atomic<size_t> stolen_count{0};
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 3; ++i)
+    thieves.emplace_back([&] {
+      auto drain = [&] {
+        for (auto x = q.steal(); x != nullptr; x = q.steal()) {
+          stolen_sum += *x;
+          ++stolen_count;
+        }
+      };
+      while (!done)
+        drain();
+      drain();
+    });
+  long owned_sum = 0;
+  size_t owned_count = 0;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    q.push_bottom(&xs[i]);
+    if (i % 3 == 0) {
+      auto x = q.pop_bottom();
+      if (x) {
+        owned_sum += *x;
+        ++owned_count;
+      }
+    }
+  }
+  for (auto x = q.pop_bottom(); x != nullptr; x = q.pop_bottom()) {
+    owned_sum += *x;
+    ++owned_count;
+  }
+  done = true;
+  for (auto& t : thieves)
+    t.join();
+  CAF_CHECK_EQUAL(owned_count + stolen_count, xs.size());
+  CAF_CHECK_EQUAL(owned_sum + stolen_sum,
+                  std::accumulate(xs.begin(), xs.end(), 0l));
+}
+
+CAF_TEST(queue_adapter) {
+  work_stealing_queue<int> q;
+  CAF_CHECK(q.empty());
+  q.append(&xs[0]);
+  q.append(&xs[1]);
+  q.prepend(&xs[2]);
+  q.prepend(&xs[3]);
+  CAF_CHECK(!q.empty());
+  // thieves take the oldest prepended element first
+  CAF_CHECK_EQUAL(*q.take_tail(), 2);
+  // the owner takes the latest prepended element first
+  CAF_CHECK_EQUAL(*q.take_head(), 3);
+  CAF_CHECK_EQUAL(*q.take_head(), 0);
+  CAF_CHECK_EQUAL(*q.take_tail(), 1);
+  CAF_CHECK_EQUAL(q.take_head(), nullptr);
+  CAF_CHECK_EQUAL(q.take_tail(), nullptr);
+  CAF_CHECK(q.empty());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
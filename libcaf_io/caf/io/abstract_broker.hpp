@@ -257,6 +257,9 @@ public:
   /// Returns all handles of all `scribe` instances attached to this broker.
   std::vector<connection_handle> connections() const;
 
+  /// Returns the `multiplexer` running this broker.
+  network::multiplexer& backend();
+
 protected:
   void init_broker();
 
@@ -287,9 +290,6 @@ protected:
 
   /// @endcond
 
-  /// Returns the `multiplexer` running this broker.
-  network::multiplexer& backend();
-
   /// Returns a `scribe` or `doorman` identified by `hdl`.
   template <class Handle>
   auto by_id(Handle hdl) -> optional<decltype(*ptr_of(hdl))> {
@@ -316,6 +316,7 @@ protected:
   }
 
 private:
+  network::multiplexer* backend_;
   scribe_map scribes_;
   doorman_map doormen_;
   detail::intrusive_partitioned_list<mailbox_element, detail::disposer> cache_;
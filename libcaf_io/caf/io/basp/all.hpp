@@ -26,6 +26,9 @@
 #include "caf/io/basp/buffer_type.hpp"
 #include "caf/io/basp/message_type.hpp"
 #include "caf/io/basp/routing_table.hpp"
+#include "caf/io/basp/compact_codec.hpp"
+#include "caf/io/basp/compression.hpp"
+#include "caf/io/basp/node_directory.hpp"
 #include "caf/io/basp/connection_state.hpp"
 
 /// @defgroup BASP Binary Actor Sytem Protocol
@@ -132,6 +135,17 @@
 ///   This field contains the ID of the receiving actor or 0 for BASP
 ///   functions that do not require
 ///
+/// # Compact Header Format
+///
+/// A server sets `header::compact_header_flag` in its `server_handshake` if
+/// it supports the compact header format. A client that supports it as well
+/// echoes the flag in its `client_handshake`. Afterwards, both nodes send all
+/// further headers on this connection in compact form (see `compact_codec`):
+/// operation and flags as one byte each, payload length, operation data and
+/// actor IDs as variable-byte sequences, and node IDs as one-byte references
+/// into a per-connection table. Nodes that do not know the flag simply
+/// ignore it and keep using the header format described above.
+///
 /// # Example
 ///
 /// The following diagram models a distributed application
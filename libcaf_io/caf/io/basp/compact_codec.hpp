@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_BASP_COMPACT_CODEC_HPP
+#define CAF_IO_BASP_COMPACT_CODEC_HPP
+
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "caf/node_id.hpp"
+
+#include "caf/io/basp/header.hpp"
+
+namespace caf {
+namespace io {
+namespace basp {
+
+/// @addtogroup BASP
+
+/// Maximum number of bytes a broker reads at once from a connection
+/// that uses the compact header format.
+constexpr size_t compact_read_size = 65536;
+
+/// Encodes and decodes BASP headers in the compact format that two nodes
+/// agree on by setting `header::compact_header_flag` in their handshakes.
+///
+/// A compact header stores the operation and flags as single bytes, all
+/// integers as variable-byte sequences, and each node ID as a one-byte
+/// reference. The first occurrence of a node ID on a connection transmits
+/// it in full and assigns it the next free index in a per-connection table,
+/// i.e., each direction of a connection requires its own codec. Since both
+/// sides assign indexes in the same order, subsequent occurrences only cost
+/// a single byte.
+///
+/// A compact frame has no fixed size. Readers must buffer incoming data
+/// and call `decode` until it reports an incomplete frame.
+class compact_codec {
+public:
+  /// Maximum size of a header in compact form.
+  static constexpr size_t max_header_size = 2                    // op + flags
+                                            + 5                  // payload_len
+                                            + 10                 // op. data
+                                            + 2 * (1 + node_id::serialized_size)
+                                            + 2 * 10;            // actor IDs
+
+  /// Maximum number of node IDs a single table can hold.
+  static constexpr size_t max_table_size = 253;
+
+  /// Returned by `decode` when the input does not contain a valid frame.
+  static constexpr size_t malformed = std::numeric_limits<size_t>::max();
+
+  /// Minimum number of bytes for the payload length in padded headers,
+  /// i.e., padded headers have a fixed size for payloads below 2 MB.
+  static constexpr size_t padded_len_size = 3;
+
+  /// Writes `hdr` in compact form to `out`, which must provide at least
+  /// `max_header_size` bytes, and returns the number of written bytes.
+  size_t encode(char* out, const header& hdr);
+
+  /// Returns the number of bytes `encode_padded` is going to write for `hdr`
+  /// if its payload length fits into `padded_len_size` bytes. Allows writers
+  /// to reserve space for the header before serializing the payload.
+  size_t padded_size(const header& hdr) const;
+
+  /// Writes `hdr` like `encode`, but uses at least `padded_len_size` bytes
+  /// for the payload length by adding redundant continuation bytes.
+  size_t encode_padded(char* out, const header& hdr);
+
+  /// Tries to decode a single frame from the `size` bytes at `data`. On
+  /// success, stores the header in `hdr` and returns its size in bytes, i.e.,
+  /// the payload starts at `data + result` and has `hdr.payload_len` bytes.
+  /// Returns 0 if `data` does not contain a complete frame yet and
+  /// `malformed` if the input is corrupted.
+  size_t decode(header& hdr, const char* data, size_t size);
+
+private:
+  size_t encode(char* out, const header& hdr, size_t len_size);
+
+  size_t encode(char* out, const node_id& x);
+
+  std::unordered_map<node_id, uint8_t> encode_tbl_;
+  std::vector<node_id> decode_tbl_;
+};
+
+/// @}
+
+} // namespace basp
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_BASP_COMPACT_CODEC_HPP
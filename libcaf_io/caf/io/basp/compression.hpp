@@ -0,0 +1,109 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_BASP_COMPRESSION_HPP
+#define CAF_IO_BASP_COMPRESSION_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "caf/atom.hpp"
+
+#include "caf/io/basp/buffer_type.hpp"
+
+namespace caf {
+namespace io {
+namespace basp {
+
+/// @addtogroup BASP
+
+/// Identifies an algorithm for compressing the payload of BASP messages.
+/// Nodes announce all codecs they accept as a bitmask in their handshakes,
+/// where codec `x` sets the bit `1 << x`.
+enum class compression_codec : uint8_t {
+  /// Leaves payloads uncompressed.
+  none = 0x00,
+  /// Built-in LZ77 variant that is always available.
+  lz = 0x01,
+  /// LZ4 block format (requires compiling CAF with LZ4).
+  lz4 = 0x02,
+  /// Zstandard (requires compiling CAF with zstd).
+  zstd = 0x03
+};
+
+/// @relates compression_codec
+std::string to_string(compression_codec);
+
+/// Number of values in `compression_codec`.
+/// @relates compression_codec
+constexpr size_t num_compression_codecs = 4;
+
+/// Returns the bitmask for `x` in a set of codecs.
+/// @relates compression_codec
+inline uint8_t to_mask(compression_codec x) {
+  return x == compression_codec::none
+         ? 0
+         : static_cast<uint8_t>(1 << static_cast<uint8_t>(x));
+}
+
+/// Returns the set of codecs available in this build.
+/// @relates compression_codec
+uint8_t available_codecs();
+
+/// Returns the set of codecs accepted by a node configured with `x`, i.e.,
+/// `'none'`, `'auto'` (all available codecs), `'lz'`, `'lz4'` or `'zstd'`.
+/// @relates compression_codec
+uint8_t accepted_codecs(atom_value x);
+
+/// Selects the preferred codec among `mask`, preferring better compression
+/// ratios, or returns `compression_codec::none` if `mask` is empty.
+/// @relates compression_codec
+compression_codec select_codec(uint8_t mask);
+
+/// Maximum ratio between the original and the compressed size of a payload.
+/// Receivers reject payloads claiming a larger original size before
+/// allocating any memory for them, which prevents peers from exhausting the
+/// memory of a node with a few bytes on the wire.
+constexpr size_t max_compression_ratio = 255;
+
+/// Appends the compressed form of the `size` bytes at `data` to `out`.
+/// Compressed payloads start with their original size as 32-bit integer in
+/// little-endian byte order, followed by the codec-specific data.
+/// @returns `false` if the codec is unavailable or fails or if the payload
+///          shrinks by more than `max_compression_ratio`, in which case
+///          the content of `out` is unspecified.
+bool compress(compression_codec x, const char* data, size_t size,
+              buffer_type& out);
+
+/// Appends the original form of the `size` bytes at `data`, which were
+/// compressed with `compress`, to `out`.
+/// @returns `false` if the input is malformed, claims an original size above
+///          `max_compression_ratio` times its compressed size, or if `x` is
+///          unavailable.
+bool decompress(compression_codec x, const char* data, size_t size,
+                std::vector<char>& out);
+
+/// @}
+
+} // namespace basp
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_BASP_COMPRESSION_HPP
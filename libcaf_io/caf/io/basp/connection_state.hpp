@@ -35,15 +35,25 @@ enum connection_state {
   /// Indicates that this node has received a header with non-zero payload
   /// and is waiting for the data.
   await_payload,
+  /// Indicates that the connection uses the compact header format and this
+  /// node reads chunks of arbitrary size to extract messages from.
+  await_frames,
   /// Indicates that this connection no longer exists.
   close_connection
 };
 
 /// @relates connection_state
 inline std::string to_string(connection_state x) {
-  return x == await_header ? "await_header"
-                           : (x == await_payload ? "await_payload"
-                                                 : "close_connection");
+  switch (x) {
+    case await_header:
+      return "await_header";
+    case await_payload:
+      return "await_payload";
+    case await_frames:
+      return "await_frames";
+    default:
+      return "close_connection";
+  }
 }
 
 /// @}
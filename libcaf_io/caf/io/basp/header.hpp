@@ -73,6 +73,31 @@ struct header {
   /// Identifies a receiver by name rather than ID.
   static const uint8_t named_receiver_flag = 0x01;
 
+  /// Signals support for the compact header format in handshakes.
+  static const uint8_t compact_header_flag = 0x02;
+
+  /// Signals support for payload compression in handshakes. The payload of
+  /// the handshake then ends with the accepted codecs as bitmask (server) or
+  /// with the selected codec (client).
+  static const uint8_t compression_flag = 0x04;
+
+  /// Marks a payload that is compressed with the codec selected for the
+  /// connection.
+  static const uint8_t compressed_flag = 0x08;
+
+  /// Signals support for the compact payload encoding in handshakes.
+  static const uint8_t compact_encoding_flag = 0x10;
+
+  /// Marks a payload that uses `binary_encoding::compact` instead of the
+  /// fixed-width encoding. Only set for messages between direct peers,
+  /// since relays forward payloads unchanged.
+  static const uint8_t compact_payload_flag = 0x20;
+
+  /// Signals support for the message priorities `system`, `urgent` and
+  /// `bulk` in handshakes. Message IDs for peers without this flag only
+  /// carry the priorities `high` and `normal`.
+  static const uint8_t priority_lanes_flag = 0x40;
+
   /// Queries whether this header has the given flag.
   inline bool has(uint8_t flag) const {
     return (flags & flag) != 0;
@@ -20,8 +20,13 @@
 #ifndef CAF_IO_BASP_INSTANCE_HPP
 #define CAF_IO_BASP_INSTANCE_HPP
 
+#include <chrono>
+#include <unordered_set>
+
 #include "caf/error.hpp"
 
+#include "caf/telemetry/metric.hpp"
+
 #include "caf/io/hook.hpp"
 #include "caf/io/middleman.hpp"
 
@@ -29,6 +34,8 @@
 #include "caf/io/basp/buffer_type.hpp"
 #include "caf/io/basp/message_type.hpp"
 #include "caf/io/basp/routing_table.hpp"
+#include "caf/io/basp/compact_codec.hpp"
+#include "caf/io/basp/compression.hpp"
 #include "caf/io/basp/connection_state.hpp"
 
 namespace caf {
@@ -92,6 +99,16 @@ public:
     /// Called if a heartbeat was received from `nid`
     virtual void handle_heartbeat(const node_id& nid) = 0;
 
+    /// Called whenever the instance starts buffering outgoing messages for
+    /// coalescing. The callee must call `flush_coalesced` after `delay`.
+    virtual void schedule_flush(std::chrono::microseconds delay) = 0;
+
+    /// Called whenever a message needs forwarding but this instance has no
+    /// route to `hdr.dest_node`. Returns whether another BASP broker of this
+    /// node took over the message.
+    virtual bool forward_to_owner(const header& hdr,
+                                  std::vector<char>* payload) = 0;
+
     /// Returns the actor namespace associated to this BASP protocol instance.
     inline proxy_registry& proxies() {
       return namespace_;
@@ -126,6 +143,11 @@ public:
   /// all routes to `affected_node` from the routing table.
   void handle_node_shutdown(const node_id& affected_node);
 
+  /// Drops all state associated to the closed connection `hdl` that is
+  /// not covered by `handle_node_shutdown`, e.g., because the remote node
+  /// already has a direct connection via another handle.
+  void handle_connection_closed(connection_handle hdl);
+
   /// Returns a route to `target` or `none` on error.
   optional<routing_table::route> lookup(const node_id& target);
 
@@ -133,10 +155,15 @@ public:
   void flush(const routing_table::route& path);
 
   /// Sends a BASP message and implicitly flushes the output buffer of `r`.
+  /// With coalescing enabled, the flush is deferred until the buffer reaches
+  /// the configured byte budget or until the callee calls `flush_coalesced`.
   /// This function will update `hdr.payload_len` if a payload was written.
   void write(execution_unit* ctx, const routing_table::route& r,
              header& hdr, payload_writer* writer = nullptr);
 
+  /// Flushes all output buffers with messages deferred for coalescing.
+  void flush_coalesced();
+
   /// Adds a new actor to the map of published actors.
   void add_published_actor(uint16_t port,
                            strong_actor_ptr published_actor,
@@ -151,12 +178,26 @@ public:
   size_t remove_published_actor(const actor_addr& whom, uint16_t port,
                                 removed_published_actor* cb = nullptr);
 
+  /// Forwards a message received from another node to `hdr.dest_node`
+  /// without touching its payload. Returns `true` if a path to destination
+  /// existed, `false` otherwise.
+  bool forward(execution_unit* ctx, header& hdr, std::vector<char>* payload);
+
   /// Returns `true` if a path to destination existed, `false` otherwise.
   bool dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
                 const std::vector<strong_actor_ptr>& forwarding_stack,
                 const strong_actor_ptr& receiver,
                 message_id mid, const message& msg);
 
+  /// Sends `msg` to all remote `receivers`, serializing the payload only
+  /// once per payload encoding and compressing it only once per encoding
+  /// and codec instead of once per receiver. Returns the number of
+  /// receivers with a path to their node.
+  size_t multicast(execution_unit* ctx, const strong_actor_ptr& sender,
+                   const std::vector<strong_actor_ptr>& forwarding_stack,
+                   const std::vector<strong_actor_ptr>& receivers,
+                   message_id mid, const message& msg);
+
   /// Returns the actor namespace associated to this BASP protocol instance.
   proxy_registry& proxies() {
     return callee_.proxies();
@@ -184,6 +225,48 @@ public:
   void write(execution_unit* ctx, buffer_type& storage, header& hdr,
              payload_writer* writer = nullptr);
 
+  /// Writes a header followed by its payload to `storage`, using the header
+  /// format negotiated for the connection `hdl`.
+  void write(execution_unit* ctx, connection_handle hdl, buffer_type& storage,
+             header& hdr, payload_writer* writer = nullptr);
+
+  /// Queries whether `hdl` uses the compact header format.
+  inline bool compact(connection_handle hdl) const {
+    auto i = framed_.find(hdl);
+    return i != framed_.end() && i->second.compact;
+  }
+
+  /// Returns the codec for compressing payloads on `hdl`.
+  inline compression_codec codec(connection_handle hdl) const {
+    auto i = codecs_.find(hdl);
+    return i != codecs_.end() ? i->second : compression_codec::none;
+  }
+
+  /// Queries whether payloads sent to `hdl` use `binary_encoding::compact`.
+  inline bool compact_encoding(connection_handle hdl) const {
+    return compact_encoded_.count(hdl) > 0;
+  }
+
+  /// Queries whether message IDs sent to `hdl` may use all priorities.
+  inline bool priority_lanes(connection_handle hdl) const {
+    return priority_lanes_.count(hdl) > 0;
+  }
+
+  /// Queries whether payloads for `dest` sent via `r` use
+  /// `binary_encoding::compact`. Relays forward payloads unchanged, hence
+  /// only direct connections to `dest` use the compact encoding.
+  inline bool compact_encoding(const routing_table::route& r,
+                               const node_id& dest) const {
+    return r.next_hop == dest && compact_encoding(r.hdl);
+  }
+
+  /// Queries whether BASP reads arbitrary chunks from `hdl` and handles all
+  /// complete messages at once instead of reading header and payload
+  /// separately.
+  inline bool framed(connection_handle hdl) const {
+    return framed_.count(hdl) > 0;
+  }
+
   /// Writes the server handshake containing the information of the
   /// actor published at `port` to `buf`. If `port == none` or
   /// if no actor is published at this port then a standard handshake is
@@ -191,21 +274,29 @@ public:
   void write_server_handshake(execution_unit* ctx,
                               buffer_type& buf, optional<uint16_t> port);
 
-  /// Writes the client handshake to `buf`.
+  /// Writes the client handshake to `buf`, accepting the compact header
+  /// format if `compact == true`, selecting `codec` for compressing
+  /// payloads, and accepting the compact payload encoding if
+  /// `compact_encoding == true`.
   void write_client_handshake(execution_unit* ctx,
-                              buffer_type& buf, const node_id& remote_side);
-
-  /// Writes an `announce_proxy` to `buf`.
-  void write_announce_proxy(execution_unit* ctx, buffer_type& buf,
-                            const node_id& dest_node, actor_id aid);
-
-  /// Writes a `kill_proxy` to `buf`.
-  void write_kill_proxy(execution_unit* ctx, buffer_type& buf,
-                        const node_id& dest_node, actor_id aid,
-                        const error& fail_state);
-
-  /// Writes a `heartbeat` to `buf`.
-  void write_heartbeat(execution_unit* ctx,
+                              buffer_type& buf, const node_id& remote_side,
+                              bool compact = false,
+                              compression_codec codec
+                              = compression_codec::none,
+                              bool compact_encoding = false);
+
+  /// Writes an `announce_proxy` to `buf`, the output buffer of `hdl`.
+  void write_announce_proxy(execution_unit* ctx, connection_handle hdl,
+                            buffer_type& buf, const node_id& dest_node,
+                            actor_id aid);
+
+  /// Writes a `kill_proxy` to `buf`, the output buffer of `hdl`.
+  void write_kill_proxy(execution_unit* ctx, connection_handle hdl,
+                        buffer_type& buf, const node_id& dest_node,
+                        actor_id aid, const error& fail_state);
+
+  /// Writes a `heartbeat` to `buf`, the output buffer of `hdl`.
+  void write_heartbeat(execution_unit* ctx, connection_handle hdl,
                        buffer_type& buf, const node_id& remote_side);
 
   inline const node_id& this_node() const {
@@ -223,10 +314,128 @@ public:
   }
 
 private:
+  // state of a connection reading multiple messages at once, i.e., a
+  // connection using the compact header format or coalescing
+  struct frame_state {
+    // denotes whether both sides use the compact header format
+    bool compact = false;
+    // encodes outgoing headers if `compact == true`
+    compact_codec out;
+    // decodes incoming headers if `compact == true`
+    compact_codec in;
+    // stores data of incomplete frames
+    buffer_type rd_buf;
+    // decodes a single frame in the header format of this connection,
+    // using the same conventions as `compact_codec::decode`
+    size_t decode(execution_unit* ctx, header& hdr, char* data, size_t size);
+  };
+
+  // traffic counters of a directly connected node
+  struct peer_metrics {
+    telemetry::counter* messages_sent;
+    telemetry::counter* bytes_sent;
+    telemetry::counter* messages_received;
+    telemetry::counter* bytes_received;
+    telemetry::counter* compression_input;
+    telemetry::counter* compression_output;
+  };
+
+  // returns the counters for the node at the other end of `hdl`
+  // or `nullptr` if the handshake did not complete yet
+  peer_metrics* metrics_for(connection_handle hdl);
+
+  // handles a message with complete header and `hdr.payload_len` bytes
+  // of payload at `payload`
+  connection_state handle(execution_unit* ctx, connection_handle hdl,
+                          header& hdr, const char* payload);
+
+  // forwards `payload_size` bytes at `payload` to `hdr.dest_node`
+  bool forward(execution_unit* ctx, header& hdr, const char* payload,
+               size_t payload_size);
+
+  // invokes hooks expecting the payload as vector, which requires a copy
+  template <hook::event_type Event>
+  void notify_payload(const header& hdr, const char* payload, size_t size) {
+    if (!system().middleman().has_hook())
+      return;
+    std::vector<char> buf;
+    if (payload != nullptr)
+      buf.assign(payload, payload + size);
+    notify<Event>(hdr, payload != nullptr ? &buf : nullptr);
+  }
+
+  // extracts and handles all complete frames of a framed connection
+  connection_state handle_frames(execution_unit* ctx, new_data_msg& dm,
+                                 header& hdr, frame_state& st);
+
+  // updates the metrics for a frame written to `r` at `pos` and flushes
+  // `r` unless coalescing defers the flush
+  void finish_write(const routing_table::route& r, size_t pos,
+                    const header& hdr);
+
+  // writes a frame for `hdl` without compressing its payload
+  void write_frame(execution_unit* ctx, connection_handle hdl,
+                   buffer_type& buf, header& hdr, payload_writer* pw);
+
+  // writes a frame for `hdl` after trying to compress its payload
+  void write_compressed(execution_unit* ctx, connection_handle hdl,
+                        compression_codec codec, buffer_type& buf,
+                        header& hdr, payload_writer& pw);
+
+  // replaces `payload` with its decompressed form, returns `false` if
+  // `hdl` has no codec or the payload is malformed
+  bool decompress_payload(connection_handle hdl, header& hdr,
+                          const char*& payload);
+
+  // queries whether the route to `dest` uses the same codec as `hdl`,
+  // i.e., whether compressed payloads can get forwarded as they are
+  bool same_codec_on_route(connection_handle hdl, const node_id& dest);
+
+  // switches `hdl` to framed reads if either side enabled a feature
+  // requiring it after the handshake
+  void enable_framing(connection_handle hdl, bool compact);
+
+  // purges all state for `hdl` after an error
+  connection_state handle_error(connection_handle hdl);
+
+  // queries whether this node offers and accepts the compact header format
+  bool compact_enabled() const;
+
+  // queries whether this node offers and accepts the compact payload encoding
+  bool compact_encoding_enabled() const;
+
+  // queries whether this node coalesces outgoing messages
+  inline bool coalescing_enabled() const {
+    return coalescing_delay_.count() > 0;
+  }
+
   routing_table tbl_;
   published_actor_map published_actors_;
   node_id this_node_;
   callee& callee_;
+  std::unordered_map<connection_handle, frame_state> framed_;
+  // connections with buffered messages that await `flush_coalesced`
+  std::unordered_set<connection_handle> coalesced_;
+  std::chrono::microseconds coalescing_delay_;
+  size_t coalescing_bytes_;
+  // codecs for compressing payloads per connection
+  std::unordered_map<connection_handle, compression_codec> codecs_;
+  uint8_t accepted_codecs_;
+  size_t compression_threshold_;
+  // scratch buffers for compressing and decompressing payloads
+  buffer_type uncompressed_buf_;
+  buffer_type compressed_buf_;
+  buffer_type decompressed_buf_;
+  // connections using the compact payload encoding
+  std::unordered_set<connection_handle> compact_encoded_;
+  // connections to peers that understand all message priorities
+  std::unordered_set<connection_handle> priority_lanes_;
+  // payloads serialized by `multicast`, indexed by the compact encoding
+  buffer_type multicast_bufs_[2];
+  // payloads compressed by `multicast`, indexed by encoding and codec
+  buffer_type multicast_compressed_bufs_[2][num_compression_codecs];
+  std::unordered_map<connection_handle, peer_metrics> peer_metrics_;
+  telemetry::histogram* message_sizes_;
 };
 
 /// @}
@@ -0,0 +1,67 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_BASP_NODE_DIRECTORY_HPP
+#define CAF_IO_BASP_NODE_DIRECTORY_HPP
+
+#include <mutex>
+#include <unordered_map>
+
+#include "caf/actor.hpp"
+#include "caf/node_id.hpp"
+
+namespace caf {
+namespace io {
+namespace basp {
+
+/// @addtogroup BASP
+
+/// Maps nodes to the BASP broker owning the direct connection to them.
+/// The middleman runs one BASP broker per I/O loop and each broker only
+/// knows its own routing table. Requests addressing a node rather than an
+/// actor, e.g., remote lookups and spawns, consult this directory in order
+/// to reach the broker that is actually connected to the node.
+/// @note This class is thread-safe.
+class node_directory {
+public:
+  /// Stores `owner` as the broker for `nid` unless another broker already
+  /// owns a direct connection to `nid`. Returns whether `owner` was stored.
+  bool add(const node_id& nid, const actor& owner);
+
+  /// Removes the entry for `nid` if it belongs to `owner`.
+  void erase(const node_id& nid, const actor& owner);
+
+  /// Returns the broker connected to `nid` or an invalid handle.
+  actor lookup(const node_id& nid) const;
+
+  /// Removes all entries.
+  void clear();
+
+private:
+  mutable std::mutex mtx_;
+  std::unordered_map<node_id, actor> owners_;
+};
+
+/// @}
+
+} // namespace basp
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_BASP_NODE_DIRECTORY_HPP
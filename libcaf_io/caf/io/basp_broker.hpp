@@ -94,6 +94,16 @@ struct basp_broker_state : proxy_registry::backend, basp::instance::callee {
     // nop
   }
 
+  // inherited from basp::instance::listener
+  void schedule_flush(std::chrono::microseconds delay) override;
+
+  // inherited from basp::instance::listener
+  bool forward_to_owner(const basp::header& hdr,
+                        std::vector<char>* payload) override;
+
+  // sends `msg` to the BASP brokers of all other I/O loops
+  void send_to_other_loops(const message& msg);
+
   // stores meta information for open connections
   struct connection_context {
     // denotes what message we expect from the remote node next
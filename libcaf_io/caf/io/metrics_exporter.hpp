@@ -0,0 +1,40 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_METRICS_EXPORTER_HPP
+#define CAF_IO_METRICS_EXPORTER_HPP
+
+#include "caf/behavior.hpp"
+
+#include "caf/io/broker.hpp"
+
+namespace caf {
+namespace io {
+
+/// Serves the metrics of `self->system().metrics()` to HTTP clients in the
+/// text exposition format of Prometheus. Each connection receives a single
+/// response and gets closed afterwards. The middleman spawns this broker
+/// at startup if `middleman.metrics-port` is not 0 and binds it to
+/// `middleman.metrics-host`, i.e., only to the loopback interface by default.
+behavior metrics_exporter(broker* self);
+
+} // namespace io
+} // namespace caf
+
+#endif // CAF_IO_METRICS_EXPORTER_HPP
@@ -21,6 +21,7 @@
 #define CAF_IO_MIDDLEMAN_HPP
 
 #include <map>
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <thread>
@@ -35,6 +36,7 @@
 #include "caf/io/hook.hpp"
 #include "caf/io/broker.hpp"
 #include "caf/io/middleman_actor.hpp"
+#include "caf/io/basp/node_directory.hpp"
 #include "caf/io/network/multiplexer.hpp"
 
 namespace caf {
@@ -144,7 +146,31 @@ public:
   /// Returns the IO backend used by this middleman.
   virtual network::multiplexer& backend() = 0;
 
+  /// Returns all I/O loops of this middleman, starting with `backend()`.
+  /// Holds more than one element only if `middleman.network-threads` is
+  /// greater than 1 and the backend runs in a thread of its own.
+  inline const std::vector<network::multiplexer*>& backends() const {
+    return backends_;
+  }
+
+  /// Selects an I/O loop for a new broker in round-robin order.
+  /// @threadsafe
+  network::multiplexer& next_backend();
+
+  /// Returns the BASP brokers of this middleman, one per I/O loop.
+  inline const std::vector<actor>& basp_brokers() const {
+    return basp_brokers_;
+  }
+
+  /// Returns the directory of nodes with a direct connection to one
+  /// of the BASP brokers.
+  inline basp::node_directory& nodes() {
+    return nodes_;
+  }
+
   /// Invokes the callback(s) associated with given event.
+  /// @note BASP brokers invoke hooks from all I/O loops concurrently
+  ///       if `middleman.network-threads` is greater than 1.
   template <hook::event_type Event, typename... Ts>
   void notify(Ts&&... ts) {
     for (auto& hook : hooks_)
@@ -203,7 +229,7 @@ public:
             class F = std::function<void(broker*)>, class... Ts>
   typename infer_handle_from_fun<F>::type
   spawn_broker(F fun, Ts&&... xs) {
-    actor_config cfg{&backend()};
+    actor_config cfg{&next_backend()};
     return system().spawn_functor<Os>(cfg, fun, std::forward<Ts>(xs)...);
   }
 
@@ -258,6 +284,11 @@ public:
         return backend_;
       }
 
+    protected:
+      backend_pointer make_backend() override {
+        return backend_pointer{new Backend(&system())};
+      }
+
     private:
       Backend backend_;
     };
@@ -267,6 +298,10 @@ public:
 protected:
   middleman(actor_system& ref);
 
+  /// Creates an additional I/O loop of the same type as `backend()`
+  /// or returns `nullptr` if the backend does not support multiple loops.
+  virtual backend_pointer make_backend();
+
 private:
   template <spawn_options Os, class Impl, class F, class... Ts>
   expected<typename infer_handle_from_class<Impl>::type>
@@ -276,7 +311,7 @@ private:
       return ehdl.error();
     auto hdl = *ehdl;
     detail::init_fun_factory<Impl, F> fac;
-    actor_config cfg{&backend()};
+    actor_config cfg{&next_backend()};
     auto init_fun = fac(std::move(fun), hdl, std::forward<Ts>(xs)...);
     cfg.init_fun = [hdl, init_fun](local_actor* ptr) -> behavior {
       static_cast<abstract_broker*>(ptr)->assign_tcp_scribe(hdl);
@@ -295,7 +330,7 @@ private:
       return ehdl.error();
     auto hdl = ehdl->first;
     port = ehdl->second;
-    actor_config cfg{&backend()};
+    actor_config cfg{&next_backend()};
     cfg.init_fun = [hdl, init_fun](local_actor* ptr) -> behavior {
       static_cast<abstract_broker*>(ptr)->assign_tcp_doorman(hdl);
       return init_fun(ptr);
@@ -326,6 +361,20 @@ private:
   network::multiplexer::supervisor_ptr backend_supervisor_;
   // runs the backend
   std::thread thread_;
+  // additional I/O loops if `middleman.network-threads > 1`
+  std::vector<backend_pointer> extra_backends_;
+  // prevents additional I/O loops from shutting down
+  std::vector<network::multiplexer::supervisor_ptr> extra_supervisors_;
+  // runs the additional I/O loops
+  std::vector<std::thread> extra_threads_;
+  // all I/O loops, starting with `backend()`
+  std::vector<network::multiplexer*> backends_;
+  // selects the I/O loop for the next broker
+  std::atomic<size_t> next_backend_;
+  // BASP brokers, one per I/O loop
+  std::vector<actor> basp_brokers_;
+  // maps connected nodes to BASP brokers
+  basp::node_directory nodes_;
   // keeps track of "singleton-like" brokers
   std::map<atom_value, actor> named_brokers_;
   // user-defined hooks
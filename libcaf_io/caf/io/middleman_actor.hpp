@@ -20,6 +20,8 @@
 #ifndef CAF_IO_MIDDLEMAN_ACTOR_HPP
 #define CAF_IO_MIDDLEMAN_ACTOR_HPP
 
+#include <vector>
+
 #include "caf/fwd.hpp"
 #include "caf/typed_actor.hpp"
 
@@ -110,6 +112,12 @@ using middleman_actor =
 /// @relates middleman_actor
 middleman_actor make_middleman_actor(actor_system& sys, actor default_broker);
 
+/// Creates a middleman actor that distributes new connections among
+/// `brokers`. The first element serves as default broker.
+/// @relates middleman_actor
+middleman_actor make_middleman_actor(actor_system& sys,
+                                     std::vector<actor> brokers);
+
 } // namespace io
 } // namespace caf
 
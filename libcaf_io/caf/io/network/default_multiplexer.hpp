@@ -64,6 +64,7 @@
 #else
 # include <unistd.h>
 # include <errno.h>
+# include <sys/uio.h>
 # include <sys/socket.h>
 #endif
 
@@ -95,6 +96,13 @@ namespace network {
   using socket_recv_ptr = char*;
   using socklen_t = int;
   using ssize_t = std::make_signed<size_t>::type;
+  using io_vec = WSABUF;
+  inline io_vec make_io_vec(const char* buf, size_t len) {
+    io_vec result;
+    result.buf = const_cast<char*>(buf);
+    result.len = static_cast<ULONG>(len);
+    return result;
+  }
   inline int last_socket_error() { return WSAGetLastError(); }
   inline bool would_block_or_temporarily_unavailable(int errcode) {
     return errcode == WSAEWOULDBLOCK || errcode == WSATRY_AGAIN;
@@ -105,6 +113,13 @@ namespace network {
   using setsockopt_ptr = const void*;
   using socket_send_ptr = const void*;
   using socket_recv_ptr = void*;
+  using io_vec = iovec;
+  inline io_vec make_io_vec(const char* buf, size_t len) {
+    io_vec result;
+    result.iov_base = const_cast<char*>(buf);
+    result.iov_len = len;
+    return result;
+  }
   inline void closesocket(int fd) { close(fd); }
   inline int last_socket_error() { return errno; }
   inline bool would_block_or_temporarily_unavailable(int errcode) {
@@ -289,6 +304,10 @@ public:
   expected<void> assign_tcp_doorman(abstract_broker *ptr,
                                     accept_handle hdl) override;
 
+  expected<std::pair<std::vector<accept_handle>, uint16_t>>
+  new_tcp_doormen(size_t num, uint16_t port, const char* in,
+                  bool reuse_addr) override;
+
   accept_handle add_tcp_doorman(abstract_broker*, native_socket fd) override;
 
   expected<std::pair<accept_handle, uint16_t>>
@@ -499,7 +518,13 @@ expected<native_socket> new_tcp_connection(const std::string& host,
                                            optional<protocol> preferred = none);
 
 expected<std::pair<native_socket, uint16_t>>
-new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr);
+new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr,
+                      bool reuse_port = false);
+
+/// Opens up to `num` sockets accepting connections on the same port.
+expected<std::pair<std::vector<native_socket>, uint16_t>>
+new_tcp_acceptors_impl(size_t num, uint16_t port, const char* addr,
+                       bool reuse_addr);
 
 } // namespace network
 } // namespace io
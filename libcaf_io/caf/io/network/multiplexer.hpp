@@ -30,6 +30,8 @@
 #include "caf/make_counted.hpp"
 #include "caf/execution_unit.hpp"
 
+#include "caf/telemetry/metric.hpp"
+
 #include "caf/io/fwd.hpp"
 #include "caf/io/accept_handle.hpp"
 #include "caf/io/connection_handle.hpp"
@@ -86,6 +88,18 @@ public:
   virtual expected<void>
   assign_tcp_doorman(abstract_broker* ptr, accept_handle hdl) = 0;
 
+  /// Tries to create up to `num` unbound TCP doormen bound to the same
+  /// `port`, each with its own socket and accept queue, which allows multiple
+  /// event loops to accept connections on a single port without waking each
+  /// other up. The kernel distributes incoming connections among the sockets
+  /// (`SO_REUSEPORT`). Returns fewer doormen if the platform cannot bind
+  /// more sockets to the port. The default implementation creates a single
+  /// doorman via `new_tcp_doorman`.
+  /// @warning Do not call from outside the multiplexer's event loop.
+  virtual expected<std::pair<std::vector<accept_handle>, uint16_t>>
+  new_tcp_doormen(size_t num, uint16_t port, const char* in = nullptr,
+                  bool reuse_addr = false);
+
   /// Creates a new TCP doorman from a native socket handle.
   /// @warning Do not call from outside the multiplexer's event loop.
   virtual accept_handle add_tcp_doorman(abstract_broker* ptr,
@@ -168,6 +182,16 @@ protected:
   /// Identifies the thread this multiplexer
   /// is running in. Must be set by the subclass.
   std::thread::id tid_;
+
+  /// Counts socket events per operation. All I/O loops
+  /// of an actor system share the same counters.
+  telemetry::counter* read_events_;
+  telemetry::counter* write_events_;
+  telemetry::counter* error_events_;
+
+  /// Counts iterations of the event loop, i.e., how often the
+  /// multiplexer woke up to handle at least one event.
+  telemetry::counter* wakeups_;
 };
 
 using multiplexer_ptr = std::unique_ptr<multiplexer>;
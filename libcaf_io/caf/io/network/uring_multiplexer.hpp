@@ -0,0 +1,434 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_NETWORK_URING_MULTIPLEXER_HPP
+#define CAF_IO_NETWORK_URING_MULTIPLEXER_HPP
+
+#include "caf/config.hpp"
+
+#ifdef CAF_USE_URING
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <sys/uio.h>
+#include <sys/socket.h>
+
+#include <linux/io_uring.h>
+
+#include "caf/logger.hpp"
+
+#include "caf/io/fwd.hpp"
+#include "caf/io/accept_handle.hpp"
+#include "caf/io/receive_policy.hpp"
+#include "caf/io/connection_handle.hpp"
+
+#include "caf/io/network/multiplexer.hpp"
+#include "caf/io/network/native_socket.hpp"
+#include "caf/io/network/stream_manager.hpp"
+#include "caf/io/network/acceptor_manager.hpp"
+
+namespace caf {
+namespace io {
+namespace network {
+
+class uring_multiplexer;
+
+/// Identifies the operation a completion belongs to.
+enum class uring_op : uint8_t {
+  read,
+  write,
+  poll,
+  accept,
+  cancel,
+  resume,
+  write_poll
+};
+
+/// An I/O object receiving completions from the submission queue
+/// of a `uring_multiplexer`.
+class uring_handler {
+public:
+  uring_handler(uring_multiplexer& backend_ref, native_socket sockfd);
+
+  virtual ~uring_handler();
+
+  /// Processes the completion of an operation of type `op`, where `res` is
+  /// the result of the operation and `flags` are the `IORING_CQE_F_*` flags.
+  virtual void handle_completion(uring_op op, int res, uint32_t flags) = 0;
+
+  /// Returns the native socket handle for this handler.
+  inline native_socket fd() const {
+    return fd_;
+  }
+
+  /// Returns the `multiplexer` this handler belongs to.
+  inline uring_multiplexer& backend() {
+    return backend_;
+  }
+
+protected:
+  native_socket fd_;
+  uring_multiplexer& backend_;
+};
+
+/// A multiplexer submitting all socket operations to an io_uring instance.
+/// Operations issued during one iteration of the event loop are passed to the
+/// kernel in a single batch, usually together with waiting for the next
+/// completions. Hence, the event loop performs at most one system call per
+/// iteration under load, regardless of how many sockets are active.
+class uring_multiplexer : public multiplexer {
+public:
+  friend class io::middleman;
+  friend class supervisor;
+
+  expected<connection_handle> new_tcp_scribe(const std::string&,
+                                             uint16_t) override;
+
+  expected<void> assign_tcp_scribe(abstract_broker* ptr,
+                                   connection_handle hdl) override;
+
+  connection_handle add_tcp_scribe(abstract_broker*,
+                                   native_socket fd) override;
+
+  expected<connection_handle> add_tcp_scribe(abstract_broker*,
+                                             const std::string& h,
+                                             uint16_t port) override;
+
+  expected<std::pair<accept_handle, uint16_t>>
+  new_tcp_doorman(uint16_t p, const char* in, bool rflag) override;
+
+  expected<void> assign_tcp_doorman(abstract_broker* ptr,
+                                    accept_handle hdl) override;
+
+  expected<std::pair<std::vector<accept_handle>, uint16_t>>
+  new_tcp_doormen(size_t num, uint16_t port, const char* in,
+                  bool reuse_addr) override;
+
+  accept_handle add_tcp_doorman(abstract_broker*, native_socket fd) override;
+
+  expected<std::pair<accept_handle, uint16_t>>
+  add_tcp_doorman(abstract_broker*, uint16_t, const char*, bool) override;
+
+  void exec_later(resumable* ptr) override;
+
+  explicit uring_multiplexer(actor_system* sys);
+
+  ~uring_multiplexer();
+
+  supervisor_ptr make_supervisor() override;
+
+  void run() override;
+
+  /// Checks whether the running kernel supports all io_uring features
+  /// required by this multiplexer.
+  static bool available();
+
+  /// Returns a free submission queue entry for an operation of type `op`
+  /// on `ptr`. The entry gets passed to the kernel on the next iteration
+  /// of the event loop.
+  io_uring_sqe* prepare(uring_op op, uring_handler* ptr);
+
+  /// Cancels all pending operations of type `op` on `ptr`.
+  void cancel(uring_op op, uring_handler* ptr);
+
+  /// Calls `ptr->handle_completion(uring_op::resume, 0, 0)` on the next
+  /// iteration of the event loop.
+  void resume_later(uring_handler* ptr);
+
+  /// Reserves a slot in the table of registered buffers.
+  /// @returns the slot index or -1 if no slot is available.
+  int acquire_buffer_slot();
+
+  /// Returns `slot` to the table of registered buffers.
+  void release_buffer_slot(int slot);
+
+  /// Registers `size` bytes at `buf` in `slot`, allowing the kernel to
+  /// skip mapping the buffer on each read.
+  /// @returns `true` on success, `false` otherwise.
+  bool register_buffer(int slot, void* buf, size_t size);
+
+  /// Checks whether the kernel supports multishot accept.
+  inline bool multishot_accept() const {
+    return multishot_accept_;
+  }
+
+  /// Disables multishot accept after the kernel rejected it.
+  inline void disable_multishot_accept() {
+    multishot_accept_ = false;
+  }
+
+private:
+  // maps the rings shared with the kernel into our address space
+  void init();
+
+  // passes all prepared entries to the kernel and waits for at least
+  // `min_complete` completions
+  void submit(unsigned min_complete);
+
+  // dispatches all available completions to their handlers
+  void handle_completions();
+
+  // moves all available completions to `reaped_` for dispatching them
+  // later, which frees space in the completion queue without calling
+  // any handler
+  void reap_completions();
+
+  // passes `cqe` to its handler
+  void handle_completion(const io_uring_cqe& cqe);
+
+  // reads pointers to resumables from the pipe
+  void submit_pipe_read();
+
+  // dispatches resumables received from the pipe
+  void handle_pipe_read(int res);
+
+  void close_pipe();
+
+  void wr_dispatch_request(resumable* ptr);
+
+  // file descriptor of the io_uring instance
+  int ring_fd_;
+
+  // configuration as reported by the kernel
+  io_uring_params params_;
+
+  // memory regions shared with the kernel
+  void* sq_ring_;
+  size_t sq_ring_size_;
+  void* cq_ring_;
+  size_t cq_ring_size_;
+  io_uring_sqe* sqes_;
+
+  // pointers into the submission queue ring
+  unsigned* sq_head_;
+  unsigned* sq_tail_;
+  unsigned sq_mask_;
+
+  // pointers into the completion queue ring
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned cq_mask_;
+  io_uring_cqe* cqes_;
+
+  // tail of the submission queue including not yet submitted entries
+  unsigned sqe_tail_;
+
+  // number of operations that did not produce their last completion yet
+  size_t inflight_;
+
+  // completions removed from the ring while preparing new entries
+  std::vector<io_uring_cqe> reaped_;
+
+  bool multishot_accept_;
+
+  // free slots in the table of registered buffers
+  std::vector<int> buffer_slots_;
+
+  // pipe for passing resumables from other threads into the event loop
+  std::pair<native_socket, native_socket> pipe_;
+  bool pipe_open_;
+  std::vector<intptr_t> pipe_buf_;
+};
+
+/// A stream capable of both reading and writing. The stream's input
+/// data is forwarded to its {@link stream_manager manager}.
+class uring_stream : public uring_handler {
+public:
+  /// A smart pointer to a stream manager.
+  using manager_ptr = intrusive_ptr<stream_manager>;
+
+  /// A buffer class providing a compatible
+  /// interface to `std::vector`.
+  using buffer_type = std::vector<char>;
+
+  uring_stream(uring_multiplexer& backend_ref, native_socket sockfd);
+
+  ~uring_stream();
+
+  /// Starts reading data from the socket, forwarding incoming data to `mgr`.
+  void start(stream_manager* mgr);
+
+  /// Activates the stream.
+  void activate(stream_manager* mgr);
+
+  /// Stops forwarding incoming data until the next call to `activate`.
+  void passivate();
+
+  /// Configures how much data will be provided for the next `consume` callback.
+  /// @warning Must not be called outside the IO multiplexers event loop
+  ///          once the stream has been started.
+  void configure_read(receive_policy::config config);
+
+  void ack_writes(bool x);
+
+  /// Copies data to the write buffer.
+  /// @warning Not thread safe.
+  void write(const void* buf, size_t num_bytes);
+
+  /// Returns the write buffer of this stream.
+  /// @warning Must not be modified outside the IO multiplexers event loop
+  ///          once the stream has been started.
+  inline buffer_type& wr_buf() {
+    return wr_offline_buf_;
+  }
+
+  /// Returns the read buffer of this stream.
+  /// @warning Must not be modified outside the IO multiplexers event loop
+  ///          once the stream has been started.
+  inline buffer_type& rd_buf() {
+    return rd_buf_;
+  }
+
+  /// Appends the content of the write buffer to the queue of pending writes
+  /// and submits a gather write unless a write is already in flight.
+  /// @warning Must not be called outside the IO multiplexers event loop
+  ///          once the stream has been started.
+  void flush(const manager_ptr& mgr);
+
+  /// Closes the read channel of the underlying socket and cancels
+  /// pending reads.
+  void stop_reading();
+
+  void handle_completion(uring_op op, int res, uint32_t flags) override;
+
+private:
+  void prepare_next_read();
+
+  // consumes collected data and submits the next read while reading
+  void read_loop();
+
+  void submit_read();
+
+  void submit_write();
+
+  void handle_read(int res);
+
+  void handle_write(int res);
+
+  // moves `wr_offline_buf_` to the queue of pending writes
+  void enqueue_offline_buf();
+
+  // removes `num_bytes` written bytes from the queue of pending writes
+  void drop_written(size_t num_bytes);
+
+  // returns the number of bytes in the queue of pending writes
+  size_t pending_bytes() const;
+
+  // state for reading
+  manager_ptr reader_;
+  bool reading_;
+  bool read_pending_;
+  bool read_channel_closed_;
+  // set while passing data to the manager
+  bool consuming_;
+  size_t read_threshold_;
+  size_t collected_;
+  size_t max_;
+  receive_policy_flag rd_flag_;
+  buffer_type rd_buf_;
+  // slot of `rd_buf_` in the table of registered buffers or -1
+  int rd_buf_slot_;
+  const char* rd_buf_registered_;
+  size_t rd_buf_registered_size_;
+
+  // state for writing
+  manager_ptr writer_;
+  bool ack_writes_;
+  bool write_pending_;
+  // number of bytes already written from `wr_queue_.front()`
+  size_t written_;
+  std::deque<buffer_type> wr_queue_;
+  // recycles buffers of `wr_queue_` for `wr_offline_buf_`
+  std::vector<buffer_type> wr_pool_;
+  // arguments of the pending gather write, must remain valid until
+  // the kernel reports its completion
+  std::vector<iovec> wr_vecs_;
+  msghdr wr_msg_;
+  buffer_type wr_offline_buf_;
+};
+
+/// An acceptor is responsible for accepting incoming connections.
+class uring_acceptor : public uring_handler {
+public:
+  /// A manager providing the `accept` member function.
+  using manager_type = acceptor_manager;
+
+  /// A smart pointer to an acceptor manager.
+  using manager_ptr = intrusive_ptr<manager_type>;
+
+  uring_acceptor(uring_multiplexer& backend_ref, native_socket sockfd);
+
+  ~uring_acceptor();
+
+  /// Returns the accepted socket. This member function should
+  /// be called only from the `new_connection` callback.
+  inline native_socket& accepted_socket() {
+    return sock_;
+  }
+
+  /// Starts this acceptor, forwarding all incoming connections to
+  /// `manager`. The intrusive pointer will be released after the
+  /// acceptor has been closed or an IO error occured.
+  void start(acceptor_manager* mgr);
+
+  /// Activates the acceptor.
+  void activate(acceptor_manager* mgr);
+
+  /// Stops forwarding new connections until the next call to `activate`.
+  void passivate();
+
+  /// Cancels all pending accept operations.
+  void stop_reading();
+
+  void handle_completion(uring_op op, int res, uint32_t flags) override;
+
+private:
+  void submit_accept();
+
+  // waits for the socket to become readable after an accept reported EAGAIN
+  void submit_poll();
+
+  // delivers connections accepted while being passive
+  void drain_backlog();
+
+  // forwards `fd` to the manager, returns `false` if the manager
+  // no longer accepts connections
+  bool deliver(native_socket fd);
+
+  manager_ptr mgr_;
+  native_socket sock_;
+  bool accepting_;
+  bool accept_pending_;
+  bool multishot_;
+  // set while waiting for the event loop to call `drain_backlog`
+  bool resume_pending_;
+  // connections accepted while being passive
+  std::deque<native_socket> backlog_;
+};
+
+} // namespace network
+} // namespace io
+} // namespace caf
+
+#endif // CAF_USE_URING
+
+#endif // CAF_IO_NETWORK_URING_MULTIPLEXER_HPP
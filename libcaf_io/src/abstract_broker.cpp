@@ -17,6 +17,8 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io"
+
 #include "caf/none.hpp"
 #include "caf/config.hpp"
 #include "caf/logger.hpp"
@@ -227,12 +229,16 @@ void abstract_broker::init_broker() {
 
 }
 
-abstract_broker::abstract_broker(actor_config& cfg) : scheduled_actor(cfg) {
-  // nop
+abstract_broker::abstract_broker(actor_config& cfg)
+    : scheduled_actor(cfg),
+      backend_(dynamic_cast<network::multiplexer*>(cfg.host)) {
+  // brokers run in the event loop they were spawned in
+  if (backend_ == nullptr)
+    backend_ = &system().middleman().backend();
 }
 
 network::multiplexer& abstract_broker::backend() {
-  return system().middleman().backend();
+  return *backend_;
 }
 
 } // namespace io
@@ -17,10 +17,13 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io.basp"
+
 #include "caf/io/basp_broker.hpp"
 
 #include <limits>
 #include <chrono>
+#include <algorithm>
 
 #include "caf/sec.hpp"
 #include "caf/send.hpp"
@@ -66,32 +69,53 @@ strong_actor_ptr basp_broker_state::make_proxy(node_id nid, actor_id aid) {
   CAF_ASSERT(nid != this_node());
   if (nid == none || aid == invalid_actor_id)
     return nullptr;
-  // this member function is being called whenever we deserialize a
-  // payload received from a remote node; if a remote node A sends
-  // us a handle to a third node B, then we assume that A offers a route to B
-  if (nid != this_context->id
-      && instance.tbl().lookup_direct(nid) == invalid_connection_handle
-      && instance.tbl().add_indirect(this_context->id, nid))
-    learned_new_node_indirectly(nid);
-  // we need to tell remote side we are watching this actor now;
-  // use a direct route if possible, i.e., when talking to a third node
-  auto path = instance.tbl().lookup(nid);
-  if (!path) {
-    // this happens if and only if we don't have a path to `nid`
-    // and current_context_->hdl has been blacklisted
-    CAF_LOG_INFO("cannot create a proxy instance for an actor "
-                 "running on a node we don't have a route to");
-    return nullptr;
+  auto mm = &system().middleman();
+  // another I/O loop may own a direct connection to `nid`, in which case
+  // the proxy talks to the BASP broker of that loop instead of taking a
+  // detour via the node that sent us the handle
+  auto owner = mm->nodes().lookup(nid);
+  auto foreign = !owner.unsafe() && owner != self
+                 && instance.tbl().lookup_direct(nid)
+                    == invalid_connection_handle;
+  if (foreign) {
+    // tell remote side we are monitoring this actor now
+    basp::header hdr{basp::message_type::announce_proxy, 0, 0, 0,
+                     this_node(), nid, invalid_actor_id, aid};
+    anon_send(owner, forward_atom::value, hdr, std::vector<char>{});
+  } else {
+    // this member function is being called whenever we deserialize a
+    // payload received from a remote node; if a remote node A sends
+    // us a handle to a third node B, then we assume that A offers a route
+    // to B
+    if (nid != this_context->id
+        && instance.tbl().lookup_direct(nid) == invalid_connection_handle
+        && instance.tbl().add_indirect(this_context->id, nid))
+      learned_new_node_indirectly(nid);
+    // we need to tell remote side we are watching this actor now;
+    // use a direct route if possible, i.e., when talking to a third node
+    auto path = instance.tbl().lookup(nid);
+    if (!path) {
+      // this happens if and only if we don't have a path to `nid`
+      // and current_context_->hdl has been blacklisted
+      CAF_LOG_INFO("cannot create a proxy instance for an actor "
+                   "running on a node we don't have a route to");
+      return nullptr;
+    }
+    // tell remote side we are monitoring this actor now
+    instance.write_announce_proxy(self->context(), this_context->hdl,
+                                  self->wr_buf(this_context->hdl), nid, aid);
+    instance.tbl().flush(*path);
   }
   // create proxy and add functor that will be called if we
   // receive a kill_proxy_instance message
-  auto mm = &system().middleman();
+  auto mx = &self->backend();
   actor_config cfg;
   auto res = make_actor<forwarding_actor_proxy, strong_actor_ptr>(
-        aid, nid, &(self->home_system()), cfg, self);
+        aid, nid, &(self->home_system()), cfg,
+        foreign ? owner : actor_cast<actor>(self));
   strong_actor_ptr selfptr{self->ctrl()};
   res->get()->attach_functor([=](const error& rsn) {
-    mm->backend().post([=] {
+    mx->post([=] {
       // using res->id() instead of aid keeps this actor instance alive
       // until the original instance terminates, thus preventing subtle
       // bugs with attachables
@@ -100,13 +124,8 @@ strong_actor_ptr basp_broker_state::make_proxy(node_id nid, actor_id aid) {
         bptr->state.proxies().erase(nid, res->id(), rsn);
     });
   });
-  CAF_LOG_INFO("successfully created proxy instance, "
-               "write announce_proxy_instance:"
-               << CAF_ARG(nid) << CAF_ARG(aid));
-  // tell remote side we are monitoring this actor now
-  instance.write_announce_proxy(self->context(),
-                                self->wr_buf(this_context->hdl), nid, aid);
-  instance.tbl().flush(*path);
+  CAF_LOG_INFO("successfully created proxy instance:"
+               << CAF_ARG(nid) << CAF_ARG(aid) << CAF_ARG(foreign));
   mm->notify<hook::new_remote_actor>(res);
   return res;
 }
@@ -146,6 +165,7 @@ void basp_broker_state::finalize_handshake(const node_id& nid, actor_id aid,
 
 void basp_broker_state::purge_state(const node_id& nid) {
   CAF_LOG_TRACE(CAF_ARG(nid));
+  system().middleman().nodes().erase(nid, actor_cast<actor>(self));
   auto hdl = instance.tbl().lookup_direct(nid);
   if (hdl == invalid_connection_handle)
     return;
@@ -159,6 +179,8 @@ void basp_broker_state::purge_state(const node_id& nid) {
     ctx.erase(i);
   }
   proxies().erase(nid);
+  // other I/O loops may have proxies talking to us for reaching `nid`
+  send_to_other_loops(make_message(delete_atom::value, nid));
 }
 
 void basp_broker_state::proxy_announced(const node_id& nid, actor_id aid) {
@@ -170,12 +192,19 @@ void basp_broker_state::proxy_announced(const node_id& nid, actor_id aid) {
       rsn = exit_reason::unknown;
     auto path = instance.tbl().lookup(nid);
     if (!path) {
-      CAF_LOG_INFO("cannot send exit message for proxy, no route to host:"
-                   << CAF_ARG(nid));
+      // the BASP broker of another I/O loop may have a connection to `nid`
+      std::vector<char> buf;
+      binary_serializer bs{self->context(), buf};
+      auto err = bs(rsn);
+      basp::header hdr{basp::message_type::kill_proxy, 0, 0, 0,
+                       this_node(), nid, aid, invalid_actor_id};
+      if (err || !forward_to_owner(hdr, &buf))
+        CAF_LOG_INFO("cannot send exit message for proxy, no route to host:"
+                     << CAF_ARG(nid));
       return;
     }
-    instance.write_kill_proxy(self->context(), path->wr_buf,
-                                       nid, aid, rsn);
+    instance.write_kill_proxy(self->context(), path->hdl, path->wr_buf,
+                              nid, aid, rsn);
     instance.tbl().flush(*path);
   };
   auto ptr = actor_cast<strong_actor_ptr>(entry);
@@ -186,12 +215,16 @@ void basp_broker_state::proxy_announced(const node_id& nid, actor_id aid) {
   } else {
     strong_actor_ptr tmp{self->ctrl()};
     auto mm = &system().middleman();
+    auto mx = &self->backend();
     ptr->get()->attach_functor([=](const error& fail_state) {
-      mm->backend().dispatch([=] {
+      // run in the event loop of this broker ...
+      mx->dispatch([=] {
         CAF_LOG_TRACE(CAF_ARG(fail_state));
         auto bptr = static_cast<basp_broker*>(tmp->get());
         // ... to make sure this is safe
-        if (bptr == mm->named_broker<basp_broker>(atom("BASP"))
+        auto& brokers = mm->basp_brokers();
+        auto is_bptr = [&](const actor& x) { return x == bptr; };
+        if (std::any_of(brokers.begin(), brokers.end(), is_bptr)
             && !bptr->getf(abstract_actor::is_terminated_flag))
           send_kill_proxy_instance(fail_state);
       });
@@ -203,6 +236,8 @@ void basp_broker_state::kill_proxy(const node_id& nid, actor_id aid,
                                    const error& rsn) {
   CAF_LOG_TRACE(CAF_ARG(nid) << CAF_ARG(aid) << CAF_ARG(rsn));
   proxies().erase(nid, aid, rsn);
+  // proxies of other I/O loops may talk to `nid` via our connection
+  send_to_other_loops(make_message(delete_atom::value, nid, aid, rsn));
 }
 
 void basp_broker_state::deliver(const node_id& src_nid, actor_id src_aid,
@@ -356,14 +391,16 @@ void basp_broker_state::learned_new_node(const node_id& nid) {
                    0, 0, this_node(), nid, tmp.id(), invalid_actor_id};
   // writing std::numeric_limits<actor_id>::max() is a hack to get
   // this send-to-named-actor feature working with older CAF releases
-  instance.write(self->context(), path->wr_buf, hdr, &writer);
-  instance.flush(*path);
+  instance.write(self->context(), *path, hdr, &writer);
 }
 
 void basp_broker_state::learned_new_node_directly(const node_id& nid,
                                                   bool was_indirectly_before) {
   CAF_ASSERT(this_context != nullptr);
   CAF_LOG_TRACE(CAF_ARG(nid));
+  // another I/O loop may already own a direct connection to `nid`,
+  // in which case node-addressed requests keep using that one
+  system().middleman().nodes().add(nid, actor_cast<actor>(self));
   if (!was_indirectly_before)
     learned_new_node(nid);
 }
@@ -442,8 +479,29 @@ void basp_broker_state::learned_new_node_indirectly(const node_id& nid) {
   basp::header hdr{basp::message_type::dispatch_message,
                    basp::header::named_receiver_flag,
                    0, 0, this_node(), nid, tmp.id(), invalid_actor_id};
-  instance.write(self->context(), path->wr_buf, hdr, &writer);
-  instance.flush(*path);
+  instance.write(self->context(), *path, hdr, &writer);
+}
+
+void basp_broker_state::schedule_flush(std::chrono::microseconds delay) {
+  CAF_LOG_TRACE(CAF_ARG(delay.count()));
+  self->delayed_send(self, delay, flush_atom::value);
+}
+
+bool basp_broker_state::forward_to_owner(const basp::header& hdr,
+                                         std::vector<char>* payload) {
+  CAF_LOG_TRACE(CAF_ARG(hdr));
+  auto owner = system().middleman().nodes().lookup(hdr.dest_node);
+  if (owner.unsafe() || owner == self)
+    return false;
+  anon_send(owner, forward_atom::value, hdr,
+            payload ? *payload : std::vector<char>{});
+  return true;
+}
+
+void basp_broker_state::send_to_other_loops(const message& msg) {
+  for (auto& hdl : system().middleman().basp_brokers())
+    if (hdl != self)
+      anon_send(hdl, msg);
 }
 
 void basp_broker_state::set_context(connection_handle hdl) {
@@ -476,7 +534,9 @@ basp_broker::basp_broker(actor_config& cfg)
 
 behavior basp_broker::make_behavior() {
   CAF_LOG_TRACE(CAF_ARG(system().node()));
-  if (system().config().middleman_enable_automatic_connections) {
+  // only the broker of the primary I/O loop offers automatic connections
+  if (system().config().middleman_enable_automatic_connections
+      && &backend() == &system().middleman().backend()) {
     CAF_LOG_INFO("enable automatic connections");
     // open a random port and store a record for our peers how to
     // connect to this broker directly in the configuration server
@@ -514,10 +574,15 @@ behavior basp_broker::make_behavior() {
         close(msg.handle);
         state.ctx.erase(msg.handle);
       } else if (next != ctx.cstate) {
-        auto rd_size = next == basp::await_payload
-                       ? ctx.hdr.payload_len
-                       : basp::header_size;
-        configure_read(msg.handle, receive_policy::exactly(rd_size));
+        if (next == basp::await_frames) {
+          configure_read(msg.handle,
+                         receive_policy::at_most(basp::compact_read_size));
+        } else {
+          auto rd_size = next == basp::await_payload
+                         ? ctx.hdr.payload_len
+                         : basp::header_size;
+          configure_read(msg.handle, receive_policy::exactly(rd_size));
+        }
         ctx.cstate = next;
       }
     },
@@ -541,6 +606,17 @@ behavior basp_broker::make_behavior() {
         srb(src, mid);
       }
     },
+    // received from local groups with multiple remote subscribers
+    [=](forward_atom, strong_actor_ptr& src,
+        const std::vector<strong_actor_ptr>& fwd_stack,
+        const std::vector<strong_actor_ptr>& dests, message_id mid,
+        const message& msg) {
+      CAF_LOG_TRACE(CAF_ARG(src) << CAF_ARG(dests)
+                    << CAF_ARG(mid) << CAF_ARG(msg));
+      if (src && system().node() == src->node())
+        system().registry().put(src->id(), src);
+      state.instance.multicast(context(), src, fwd_stack, dests, mid, msg);
+    },
     // received from some system calls like whereis
     [=](forward_atom, const node_id& dest_node, atom_value dest_name,
         const message& msg) -> result<message> {
@@ -568,8 +644,7 @@ behavior basp_broker::make_behavior() {
                        basp::header::named_receiver_flag,
                        0, cme->mid.integer_value(), state.this_node(),
                        dest_node, src->id(), invalid_actor_id};
-      state.instance.write(context(), path->wr_buf, hdr, &writer);
-      state.instance.flush(*path);
+      state.instance.write(context(), *path, hdr, &writer);
       return delegated<message>();
     },
     // received from underlying broker implementation
@@ -591,6 +666,8 @@ behavior basp_broker::make_behavior() {
       auto nid = state.instance.tbl().lookup_direct(msg.handle);
       // tell BASP instance we've lost connection
       state.instance.handle_node_shutdown(nid);
+      // drop compact header state of this connection
+      state.instance.handle_connection_closed(msg.handle);
       CAF_ASSERT(nid == none
                  || !state.instance.tbl().reachable(nid));
     },
@@ -644,6 +721,23 @@ behavior basp_broker::make_behavior() {
       CAF_LOG_TRACE(CAF_ARG(nid) << ", " << CAF_ARG(aid));
       state.proxies().erase(nid, aid);
     },
+    // received from the BASP broker of another I/O loop
+    [=](delete_atom, const node_id& nid, actor_id aid, const error& rsn) {
+      CAF_LOG_TRACE(CAF_ARG(nid) << ", " << CAF_ARG(aid) << CAF_ARG(rsn));
+      state.proxies().erase(nid, aid, rsn);
+    },
+    // received from the BASP broker of another I/O loop
+    [=](delete_atom, const node_id& nid) {
+      CAF_LOG_TRACE(CAF_ARG(nid));
+      if (!state.instance.tbl().reachable(nid))
+        state.proxies().erase(nid);
+    },
+    // received from the BASP broker of another I/O loop
+    [=](forward_atom, basp::header& hdr, std::vector<char>& payload) {
+      CAF_LOG_TRACE(CAF_ARG(hdr));
+      if (!state.instance.forward(context(), hdr, &payload))
+        CAF_LOG_INFO("cannot forward message, no route to destination");
+    },
     [=](unpublish_atom, const actor_addr& whom, uint16_t port) -> result<void> {
       CAF_LOG_TRACE(CAF_ARG(whom) << CAF_ARG(port));
       auto cb = make_callback([&](const strong_actor_ptr&, uint16_t x) -> error {
@@ -679,6 +773,10 @@ behavior basp_broker::make_behavior() {
       }
       return std::make_tuple(x, std::move(addr), port);
     },
+    // deferred flush of coalesced messages
+    [=](flush_atom) {
+      state.instance.flush_coalesced();
+    },
     [=](tick_atom, size_t interval) {
       state.instance.handle_heartbeat(context());
       delayed_send(this, std::chrono::milliseconds{interval},
@@ -17,6 +17,8 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io"
+
 #include "caf/none.hpp"
 #include "caf/config.hpp"
 #include "caf/make_counted.hpp"
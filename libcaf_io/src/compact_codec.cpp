@@ -0,0 +1,226 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/compact_codec.hpp"
+
+#include "caf/streambuf.hpp"
+#include "caf/stream_serializer.hpp"
+#include "caf/stream_deserializer.hpp"
+
+namespace caf {
+namespace io {
+namespace basp {
+
+constexpr size_t compact_codec::max_header_size;
+constexpr size_t compact_codec::padded_len_size;
+constexpr size_t compact_codec::max_table_size;
+constexpr size_t compact_codec::malformed;
+
+namespace {
+
+// node reference for `none`
+constexpr uint8_t no_node = 0x00;
+
+// node reference for a node ID that follows in full and gets interned
+constexpr uint8_t interned_literal = 0xFE;
+
+// node reference for a node ID that follows in full (table is full)
+constexpr uint8_t plain_literal = 0xFF;
+
+// writes at least `min_size` bytes by adding redundant continuation bytes
+template <class T>
+size_t write_varbyte(char* out, T x, size_t min_size = 1) {
+  auto i = out;
+  while (x > 0x7f || static_cast<size_t>(i - out) + 1 < min_size) {
+    *i++ = static_cast<char>((static_cast<uint8_t>(x) & 0x7f) | 0x80);
+    x >>= 7;
+  }
+  *i++ = static_cast<char>(static_cast<uint8_t>(x) & 0x7f);
+  return static_cast<size_t>(i - out);
+}
+
+template <class T>
+size_t varbyte_size(T x) {
+  size_t result = 1;
+  for (; x > 0x7f; x >>= 7)
+    ++result;
+  return result;
+}
+
+// returns `false` if the input ends before the sequence, sets `err` on overflow
+template <class T>
+bool read_varbyte(T& x, const char*& first, const char* last, bool& err) {
+  x = 0;
+  for (unsigned shift = 0; first != last; shift += 7) {
+    if (shift >= sizeof(T) * 8) {
+      err = true;
+      return false;
+    }
+    auto byte = static_cast<uint8_t>(*first++);
+    x |= static_cast<T>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+// reading state for a single header that only commits
+// newly interned node IDs once the frame is complete
+class node_reader {
+public:
+  node_reader(const std::vector<node_id>& tbl) : tbl_(tbl), pending_(0) {
+    // nop
+  }
+
+  // returns `false` if the input ends before the reference
+  bool operator()(node_id& x, const char*& first, const char* last,
+                  bool& err) {
+    if (first == last)
+      return false;
+    auto ref = static_cast<uint8_t>(*first++);
+    switch (ref) {
+      case no_node:
+        x = none;
+        return true;
+      case interned_literal:
+      case plain_literal: {
+        if (static_cast<size_t>(last - first) < node_id::serialized_size)
+          return false;
+        stream_deserializer<charbuf> source{nullptr, const_cast<char*>(first),
+                                            node_id::serialized_size};
+        if (source(x) || x == none) {
+          err = true;
+          return false;
+        }
+        first += node_id::serialized_size;
+        if (ref == interned_literal) {
+          if (tbl_.size() + pending_ >= compact_codec::max_table_size) {
+            err = true;
+            return false;
+          }
+          fresh_[pending_++] = x;
+        }
+        return true;
+      }
+      default: {
+        auto idx = static_cast<size_t>(ref - 1);
+        if (idx < tbl_.size())
+          x = tbl_[idx];
+        else if (idx - tbl_.size() < pending_)
+          x = fresh_[idx - tbl_.size()];
+        else
+          err = true;
+        return !err;
+      }
+    }
+  }
+
+  void commit(std::vector<node_id>& tbl) {
+    for (size_t i = 0; i < pending_; ++i)
+      tbl.push_back(std::move(fresh_[i]));
+  }
+
+private:
+  const std::vector<node_id>& tbl_;
+  node_id fresh_[2];
+  size_t pending_;
+};
+
+} // namespace <anonymous>
+
+size_t compact_codec::encode(char* out, const header& hdr) {
+  return encode(out, hdr, 1);
+}
+
+size_t compact_codec::padded_size(const header& hdr) const {
+  auto node_size = [&](const node_id& x) -> size_t {
+    return x == none || encode_tbl_.count(x) > 0 ? 1
+                                                 : 1 + node_id::serialized_size;
+  };
+  return 2 + padded_len_size + varbyte_size(hdr.operation_data)
+         + node_size(hdr.source_node) + node_size(hdr.dest_node)
+         + varbyte_size(hdr.source_actor) + varbyte_size(hdr.dest_actor);
+}
+
+size_t compact_codec::encode_padded(char* out, const header& hdr) {
+  return encode(out, hdr, padded_len_size);
+}
+
+size_t compact_codec::encode(char* out, const header& hdr,
+                             size_t len_size) {
+  auto i = out;
+  *i++ = static_cast<char>(hdr.operation);
+  *i++ = static_cast<char>(hdr.flags);
+  i += write_varbyte(i, hdr.payload_len, len_size);
+  i += write_varbyte(i, hdr.operation_data);
+  i += encode(i, hdr.source_node);
+  i += encode(i, hdr.dest_node);
+  i += write_varbyte(i, hdr.source_actor);
+  i += write_varbyte(i, hdr.dest_actor);
+  return static_cast<size_t>(i - out);
+}
+
+size_t compact_codec::encode(char* out, const node_id& x) {
+  if (x == none) {
+    *out = static_cast<char>(no_node);
+    return 1;
+  }
+  auto i = encode_tbl_.find(x);
+  if (i != encode_tbl_.end()) {
+    *out = static_cast<char>(i->second);
+    return 1;
+  }
+  if (encode_tbl_.size() < max_table_size) {
+    auto ref = static_cast<uint8_t>(encode_tbl_.size() + 1);
+    encode_tbl_.emplace(x, ref);
+    *out = static_cast<char>(interned_literal);
+  } else {
+    *out = static_cast<char>(plain_literal);
+  }
+  stream_serializer<charbuf> sink{nullptr, out + 1, node_id::serialized_size};
+  sink(const_cast<node_id&>(x));
+  return 1 + node_id::serialized_size;
+}
+
+size_t compact_codec::decode(header& hdr, const char* data, size_t size) {
+  auto first = data;
+  auto last = data + size;
+  if (size < 2)
+    return 0;
+  hdr.operation = static_cast<message_type>(static_cast<uint8_t>(*first++));
+  hdr.flags = static_cast<uint8_t>(*first++);
+  bool err = false;
+  node_reader rd{decode_tbl_};
+  if (!read_varbyte(hdr.payload_len, first, last, err)
+      || !read_varbyte(hdr.operation_data, first, last, err)
+      || !rd(hdr.source_node, first, last, err)
+      || !rd(hdr.dest_node, first, last, err)
+      || !read_varbyte(hdr.source_actor, first, last, err)
+      || !read_varbyte(hdr.dest_actor, first, last, err))
+    return err ? malformed : 0;
+  auto hdr_size = static_cast<size_t>(first - data);
+  if (static_cast<size_t>(last - first) < hdr.payload_len)
+    return 0;
+  rd.commit(decode_tbl_);
+  return hdr_size;
+}
+
+} // namespace basp
+} // namespace io
+} // namespace caf
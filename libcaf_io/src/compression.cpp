@@ -0,0 +1,304 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/compression.hpp"
+
+#include <limits>
+#include <cstring>
+
+#include "caf/config.hpp"
+
+#include "caf/detail/enum_to_string.hpp"
+
+#ifdef CAF_USE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef CAF_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace caf {
+namespace io {
+namespace basp {
+
+namespace {
+
+const char* compression_codec_strings[] = {
+  "none",
+  "lz",
+  "lz4",
+  "zstd"
+};
+
+// size of the prefix storing the original size of a compressed payload
+constexpr size_t size_prefix = 4;
+
+#ifdef CAF_USE_ZSTD
+// trades speed for ratio, since we only compress for slow links
+constexpr int zstd_level = 3;
+#endif
+
+void write_size_prefix(buffer_type& out, uint32_t x) {
+  for (size_t i = 0; i < size_prefix; ++i)
+    out.push_back(static_cast<char>((x >> (i * 8)) & 0xFF));
+}
+
+// checks whether the codec-specific data of `compressed_size` bytes may
+// represent a payload of `orig_size` bytes
+bool valid_ratio(size_t orig_size, size_t compressed_size) {
+  return orig_size / max_compression_ratio <= compressed_size;
+}
+
+uint32_t read_size_prefix(const char* data) {
+  uint32_t result = 0;
+  for (size_t i = 0; i < size_prefix; ++i)
+    result |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (i * 8);
+  return result;
+}
+
+// -- built-in LZ77 variant ----------------------------------------------------
+//
+// Encodes the input as a sequence of literal runs and back references,
+// each starting with a control byte `c`:
+// - `c < 32`: a run of `c + 1` literal bytes follows
+// - otherwise: a back reference with length `(c >> 5) + 2` and offset
+//   `((c & 0x1F) << 8) + o + 1`, where `o` is the byte following `c` (or the
+//   byte after the extended length if `c >> 5 == 7`, which adds the next byte
+//   to the length)
+
+constexpr size_t lz_max_literals = 32;
+
+constexpr size_t lz_max_offset = 8192;
+
+constexpr size_t lz_max_match = 264;
+
+constexpr size_t lz_hash_bits = 13;
+
+inline size_t lz_hash(const uint8_t* x) {
+  auto v = (static_cast<uint32_t>(x[0]) << 16)
+           | (static_cast<uint32_t>(x[1]) << 8)
+           | x[2];
+  return (v * 2654435761u) >> (32 - lz_hash_bits);
+}
+
+void lz_literals(buffer_type& out, const uint8_t* first, const uint8_t* last) {
+  while (first != last) {
+    auto n = std::min(static_cast<size_t>(last - first), lz_max_literals);
+    out.push_back(static_cast<char>(n - 1));
+    out.insert(out.end(), first, first + n);
+    first += n;
+  }
+}
+
+void lz_compress(const char* data, size_t size, buffer_type& out) {
+  auto in = reinterpret_cast<const uint8_t*>(data);
+  // positions of the last occurrence of each hashed 3-byte sequence
+  static thread_local std::vector<size_t> tbl;
+  tbl.assign(size_t{1} << lz_hash_bits, std::numeric_limits<size_t>::max());
+  size_t lit = 0;
+  size_t pos = 0;
+  while (pos + 2 < size) {
+    auto& entry = tbl[lz_hash(in + pos)];
+    auto ref = entry;
+    entry = pos;
+    if (ref < pos && pos - ref <= lz_max_offset
+        && memcmp(in + ref, in + pos, 3) == 0) {
+      auto max_len = std::min(size - pos, lz_max_match);
+      size_t len = 3;
+      while (len < max_len && in[ref + len] == in[pos + len])
+        ++len;
+      lz_literals(out, in + lit, in + pos);
+      auto off = pos - ref - 1;
+      auto l = len - 2;
+      auto hi = static_cast<uint8_t>(off >> 8);
+      if (l < 7) {
+        out.push_back(static_cast<char>((l << 5) | hi));
+      } else {
+        out.push_back(static_cast<char>((7 << 5) | hi));
+        out.push_back(static_cast<char>(l - 7));
+      }
+      out.push_back(static_cast<char>(off & 0xFF));
+      pos += len;
+      lit = pos;
+    } else {
+      ++pos;
+    }
+  }
+  lz_literals(out, in + lit, in + size);
+}
+
+bool lz_decompress(const char* data, size_t size, size_t orig_size,
+                   std::vector<char>& out) {
+  auto in = reinterpret_cast<const uint8_t*>(data);
+  auto base = out.size();
+  auto limit = base + orig_size;
+  size_t pos = 0;
+  while (pos < size) {
+    size_t c = in[pos++];
+    if (c < lz_max_literals) {
+      auto n = c + 1;
+      if (n > size - pos || n > limit - out.size())
+        return false;
+      out.insert(out.end(), data + pos, data + pos + n);
+      pos += n;
+      continue;
+    }
+    auto len = c >> 5;
+    if (len == 7) {
+      if (pos == size)
+        return false;
+      len += in[pos++];
+    }
+    len += 2;
+    if (pos == size)
+      return false;
+    auto off = ((c & 0x1F) << 8) + in[pos++] + 1;
+    if (off > out.size() - base || len > limit - out.size())
+      return false;
+    // byte-wise copy, since source and destination may overlap
+    auto src = out.size() - off;
+    for (size_t i = 0; i < len; ++i)
+      out.push_back(out[src + i]);
+  }
+  return out.size() == limit;
+}
+
+} // namespace <anonymous>
+
+std::string to_string(compression_codec x) {
+  return detail::enum_to_string(x, compression_codec_strings);
+}
+
+uint8_t available_codecs() {
+  uint8_t result = to_mask(compression_codec::lz);
+# ifdef CAF_USE_LZ4
+  result |= to_mask(compression_codec::lz4);
+# endif
+# ifdef CAF_USE_ZSTD
+  result |= to_mask(compression_codec::zstd);
+# endif
+  return result;
+}
+
+uint8_t accepted_codecs(atom_value x) {
+  if (x == atom("auto"))
+    return available_codecs();
+  if (x == atom("lz"))
+    return to_mask(compression_codec::lz);
+  if (x == atom("lz4"))
+    return available_codecs() & to_mask(compression_codec::lz4);
+  if (x == atom("zstd"))
+    return available_codecs() & to_mask(compression_codec::zstd);
+  return 0;
+}
+
+compression_codec select_codec(uint8_t mask) {
+  compression_codec preferred[] = {compression_codec::zstd,
+                                   compression_codec::lz4,
+                                   compression_codec::lz};
+  for (auto x : preferred)
+    if ((mask & to_mask(x)) != 0)
+      return x;
+  return compression_codec::none;
+}
+
+bool compress(compression_codec x, const char* data, size_t size,
+              buffer_type& out) {
+  if (size > std::numeric_limits<uint32_t>::max())
+    return false;
+  write_size_prefix(out, static_cast<uint32_t>(size));
+  auto pos = out.size();
+  switch (x) {
+    case compression_codec::lz:
+      lz_compress(data, size, out);
+      return valid_ratio(size, out.size() - pos);
+#   ifdef CAF_USE_LZ4
+    case compression_codec::lz4: {
+      if (size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE))
+        return false;
+      auto bound = LZ4_compressBound(static_cast<int>(size));
+      out.resize(pos + static_cast<size_t>(bound));
+      auto n = LZ4_compress_default(data, out.data() + pos,
+                                    static_cast<int>(size), bound);
+      if (n <= 0)
+        return false;
+      out.resize(pos + static_cast<size_t>(n));
+      return valid_ratio(size, static_cast<size_t>(n));
+    }
+#   endif
+#   ifdef CAF_USE_ZSTD
+    case compression_codec::zstd: {
+      auto bound = ZSTD_compressBound(size);
+      out.resize(pos + bound);
+      auto n = ZSTD_compress(out.data() + pos, bound, data, size, zstd_level);
+      if (ZSTD_isError(n))
+        return false;
+      out.resize(pos + n);
+      return valid_ratio(size, n);
+    }
+#   endif
+    default:
+      return false;
+  }
+}
+
+bool decompress(compression_codec x, const char* data, size_t size,
+                std::vector<char>& out) {
+  if (size < size_prefix)
+    return false;
+  auto orig_size = static_cast<size_t>(read_size_prefix(data));
+  data += size_prefix;
+  size -= size_prefix;
+  // check the claimed size before allocating memory for it
+  if (!valid_ratio(orig_size, size))
+    return false;
+  switch (x) {
+    case compression_codec::lz:
+      out.reserve(out.size() + orig_size);
+      return lz_decompress(data, size, orig_size, out);
+#   ifdef CAF_USE_LZ4
+    case compression_codec::lz4: {
+      if (orig_size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)
+          || size > static_cast<size_t>(std::numeric_limits<int>::max()))
+        return false;
+      auto pos = out.size();
+      out.resize(pos + orig_size);
+      auto n = LZ4_decompress_safe(data, out.data() + pos,
+                                   static_cast<int>(size),
+                                   static_cast<int>(orig_size));
+      return n >= 0 && static_cast<size_t>(n) == orig_size;
+    }
+#   endif
+#   ifdef CAF_USE_ZSTD
+    case compression_codec::zstd: {
+      auto pos = out.size();
+      out.resize(pos + orig_size);
+      auto n = ZSTD_decompress(out.data() + pos, orig_size, data, size);
+      return !ZSTD_isError(n) && n == orig_size;
+    }
+#   endif
+    default:
+      return false;
+  }
+}
+
+} // namespace basp
+} // namespace io
+} // namespace caf
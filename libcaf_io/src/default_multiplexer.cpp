@@ -17,6 +17,8 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io.network"
+
 #include "caf/io/network/default_multiplexer.hpp"
 
 #include "caf/config.hpp"
@@ -334,6 +336,7 @@ expected<uint16_t> remote_port_of_fd(native_socket fd);
           }
         }
       }
+      wakeups_->inc();
       auto iter = pollset_.begin();
       auto last = iter + presult;
       for (; iter != last; ++iter) {
@@ -487,6 +490,7 @@ expected<uint16_t> remote_port_of_fd(native_socket fd);
         }
         continue; // rince and repeat
       }
+      wakeups_->inc();
       // scan pollset for events first, because we might alter pollset_
       // while running callbacks (not a good idea while traversing it)
       CAF_LOG_DEBUG("scan pollset for socket events");
@@ -671,14 +675,18 @@ void default_multiplexer::handle_socket_event(native_socket fd, int mask,
     checkerror = false;
     // ignore read events if a previous event caused
     // this socket to be shut down for reading
-    if (!ptr->read_channel_closed())
+    if (!ptr->read_channel_closed()) {
+      read_events_->inc();
       ptr->handle_event(operation::read);
+    }
   }
   if (mask & output_mask) {
     checkerror = false;
+    write_events_->inc();
     ptr->handle_event(operation::write);
   }
   if (checkerror && (mask & error_mask)) {
+    error_events_->inc();
     CAF_LOG_DEBUG("error occured on socket:"
                   << CAF_ARG(fd) << CAF_ARG(last_socket_error())
                   << CAF_ARG(last_socket_error_as_string()));
@@ -898,6 +906,18 @@ expected<void> default_multiplexer::assign_tcp_doorman(abstract_broker* ptr,
   return unit;
 }
 
+expected<std::pair<std::vector<accept_handle>, uint16_t>>
+default_multiplexer::new_tcp_doormen(size_t num, uint16_t port,
+                                     const char* in, bool reuse_addr) {
+  auto res = new_tcp_acceptors_impl(num, port, in, reuse_addr);
+  if (!res)
+    return std::move(res.error());
+  std::vector<accept_handle> hdls;
+  for (auto fd : res->first)
+    hdls.push_back(accept_handle::from_int(int64_from_native_socket(fd)));
+  return std::make_pair(std::move(hdls), res->second);
+}
+
 expected<std::pair<accept_handle, uint16_t>>
 default_multiplexer::add_tcp_doorman(abstract_broker* self, uint16_t port,
                                      const char* host, bool reuse_addr) {
@@ -1436,7 +1456,8 @@ expected<uint16_t> new_ip_acceptor_impl(native_socket fd, uint16_t port,
 }
 
 expected<std::pair<native_socket, uint16_t>>
-new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr) {
+new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr,
+                      bool reuse_port) {
   CAF_LOG_TRACE(CAF_ARG(port) << ", addr = " << (addr ? addr : "nullptr"));
   protocol proto = ipv6;
   if (addr) {
@@ -1457,6 +1478,17 @@ new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr) {
                          reinterpret_cast<setsockopt_ptr>(&on),
                          static_cast<socklen_t>(sizeof(on))));
   }
+# ifdef SO_REUSEPORT
+  if (reuse_port) {
+    int on = 1;
+    CALL_CFUN(tmp3, cc_zero, "setsockopt",
+              setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+                         reinterpret_cast<setsockopt_ptr>(&on),
+                         static_cast<socklen_t>(sizeof(on))));
+  }
+# else
+  static_cast<void>(reuse_port);
+# endif
   auto p = proto == ipv4 ? new_ip_acceptor_impl<AF_INET>(fd, port, addr)
                          : new_ip_acceptor_impl<AF_INET6>(fd, port, addr);
   if (!p)
@@ -1467,6 +1499,35 @@ new_tcp_acceptor_impl(uint16_t port, const char* addr, bool reuse_addr) {
   return std::make_pair(sguard.release(), *p);
 }
 
+expected<std::pair<std::vector<native_socket>, uint16_t>>
+new_tcp_acceptors_impl(size_t num, uint16_t port, const char* addr,
+                       bool reuse_addr) {
+  CAF_LOG_TRACE(CAF_ARG(num) << CAF_ARG(port));
+# ifdef SO_REUSEPORT
+  auto reuse_port = num > 1;
+# else
+  // without SO_REUSEPORT, only a single socket can accept on the port
+  num = 1;
+  auto reuse_port = false;
+# endif
+  auto first = new_tcp_acceptor_impl(port, addr, reuse_addr, reuse_port);
+  if (!first)
+    return std::move(first.error());
+  std::vector<native_socket> fds{first->first};
+  // bind all other sockets to the port of the first one, which the
+  // OS picks if `port` is 0
+  for (size_t i = 1; i < num; ++i) {
+    auto res = new_tcp_acceptor_impl(first->second, addr, reuse_addr, true);
+    if (!res) {
+      CAF_LOG_WARNING("cannot open more sockets for port:"
+                      << CAF_ARG(first->second) << CAF_ARG(res.error()));
+      break;
+    }
+    fds.push_back(res->first);
+  }
+  return std::make_pair(std::move(fds), first->second);
+}
+
 expected<std::string> local_addr_of_fd(native_socket fd) {
   sockaddr_storage st;
   socklen_t st_len = sizeof(st);
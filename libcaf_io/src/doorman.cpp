@@ -17,6 +17,8 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io"
+
 #include "caf/io/doorman.hpp"
 
 #include "caf/logger.hpp"
@@ -27,6 +27,8 @@ namespace basp {
 
 const uint8_t header::named_receiver_flag;
 
+const uint8_t header::compact_header_flag;
+
 std::string to_bin(uint8_t x) {
   std::string res;
   for (auto offset = 7; offset > -1; --offset)
@@ -17,8 +17,12 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io.basp"
+
 #include "caf/io/basp/instance.hpp"
 
+#include <algorithm>
+
 #include "caf/streambuf.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/binary_deserializer.hpp"
@@ -30,6 +34,15 @@ namespace caf {
 namespace io {
 namespace basp {
 
+namespace {
+
+binary_encoding payload_encoding(const header& hdr) {
+  return hdr.has(header::compact_payload_flag) ? binary_encoding::compact
+                                               : binary_encoding::fixed;
+}
+
+} // namespace <anonymous>
+
 instance::callee::callee(actor_system& sys, proxy_registry::backend& backend)
     : namespace_(sys, backend) {
   // nop
@@ -44,55 +57,202 @@ instance::instance(abstract_broker* parent, callee& lstnr)
       this_node_(parent->system().node()),
       callee_(lstnr) {
   CAF_ASSERT(this_node_ != none);
+  auto& cfg = system().config();
+  coalescing_delay_ = std::chrono::microseconds{
+    cfg.middleman_coalescing_delay_us};
+  coalescing_bytes_ = cfg.middleman_coalescing_bytes;
+  accepted_codecs_ = accepted_codecs(cfg.middleman_compression);
+  compression_threshold_ = cfg.middleman_compression_threshold;
+  message_sizes_ = &system().metrics().add_histogram(
+    "caf_basp_message_size_bytes", "Payload size of sent BASP messages.",
+    {64, 256, 1024, 4096, 16384, 65536, 262144, 1048576});
 }
 
 connection_state instance::handle(execution_unit* ctx,
                                   new_data_msg& dm, header& hdr,
                                   bool is_payload) {
   CAF_LOG_TRACE(CAF_ARG(dm) << CAF_ARG(is_payload));
-  // function object providing cleanup code on errors
-  auto err = [&]() -> connection_state {
-    auto cb = make_callback([&](const node_id& nid) -> error {
-      callee_.purge_state(nid);
-      return none;
-    });
-    tbl_.erase_direct(dm.handle, cb);
-    return close_connection;
-  };
-  std::vector<char>* payload = nullptr;
+  auto pm = metrics_for(dm.handle);
+  if (pm != nullptr)
+    pm->bytes_received->inc(dm.buf.size());
+  auto i = framed_.find(dm.handle);
+  if (i != framed_.end())
+    return handle_frames(ctx, dm, hdr, i->second);
+  const char* payload = nullptr;
   if (is_payload) {
-    payload = &dm.buf;
-    if (payload->size() != hdr.payload_len) {
+    payload = dm.buf.data();
+    if (dm.buf.size() != hdr.payload_len) {
       CAF_LOG_WARNING("received invalid payload");
-      return err();
+      return handle_error(dm.handle);
     }
   } else {
     binary_deserializer bd{ctx, dm.buf};
     auto e = bd(hdr);
     if (e || !valid(hdr)) {
       CAF_LOG_WARNING("received invalid header:" << CAF_ARG(hdr));
-      return err();
+      return handle_error(dm.handle);
     }
     if (hdr.payload_len > 0) {
       CAF_LOG_DEBUG("await payload before processing further");
       return await_payload;
     }
   }
+  auto result = handle(ctx, dm.handle, hdr, payload);
+  // a handshake may have switched this connection to framed reads
+  if (result == await_header && framed(dm.handle))
+    return await_frames;
+  return result;
+}
+
+connection_state instance::handle_frames(execution_unit* ctx,
+                                         new_data_msg& dm, header& hdr,
+                                         frame_state& st) {
+  // avoid copying into our buffer unless the last read left a partial frame
+  auto in = &dm.buf;
+  if (!st.rd_buf.empty()) {
+    st.rd_buf.insert(st.rd_buf.end(), dm.buf.begin(), dm.buf.end());
+    in = &st.rd_buf;
+  }
+  size_t pos = 0;
+  for (;;) {
+    auto n = st.decode(ctx, hdr, in->data() + pos, in->size() - pos);
+    if (n == 0)
+      break;
+    if (n == compact_codec::malformed || !valid(hdr)) {
+      CAF_LOG_WARNING("received invalid header:" << CAF_ARG(hdr));
+      return handle_error(dm.handle);
+    }
+    // the payload points into the receive buffer, which remains unchanged
+    // until we have handled all complete frames
+    const char* payload = nullptr;
+    if (hdr.payload_len > 0)
+      payload = in->data() + pos + n;
+    pos += n + hdr.payload_len;
+    // `st` is no longer valid if the connection has been closed
+    if (handle(ctx, dm.handle, hdr, payload) == close_connection)
+      return close_connection;
+  }
+  if (in == &dm.buf)
+    st.rd_buf.assign(dm.buf.begin() + static_cast<ptrdiff_t>(pos),
+                     dm.buf.end());
+  else
+    st.rd_buf.erase(st.rd_buf.begin(),
+                    st.rd_buf.begin() + static_cast<ptrdiff_t>(pos));
+  return await_frames;
+}
+
+size_t instance::frame_state::decode(execution_unit* ctx, header& hdr,
+                                     char* data, size_t size) {
+  if (compact)
+    return in.decode(hdr, data, size);
+  if (size < header_size)
+    return 0;
+  binary_deserializer bd{ctx, data, header_size};
+  if (bd(hdr) || !valid(hdr))
+    return compact_codec::malformed;
+  // unlike compact frames, regular headers do not imply a complete payload
+  if (size - header_size < hdr.payload_len)
+    return 0;
+  return header_size;
+}
+
+connection_state instance::handle_error(connection_handle hdl) {
+  auto cb = make_callback([&](const node_id& nid) -> error {
+    callee_.purge_state(nid);
+    return none;
+  });
+  tbl_.erase_direct(hdl, cb);
+  framed_.erase(hdl);
+  coalesced_.erase(hdl);
+  codecs_.erase(hdl);
+  compact_encoded_.erase(hdl);
+  priority_lanes_.erase(hdl);
+  peer_metrics_.erase(hdl);
+  return close_connection;
+}
+
+void instance::enable_framing(connection_handle hdl, bool compact) {
+  // reading multiple messages at once only pays off if the remote side
+  // either uses compact headers or coalesces its messages
+  if (compact || coalescing_enabled())
+    framed_[hdl].compact = compact;
+}
+
+bool instance::compact_enabled() const {
+  return callee_.system().config().middleman_enable_compact_header;
+}
+
+bool instance::compact_encoding_enabled() const {
+  return callee_.system().config().middleman_enable_compact_encoding;
+}
+
+auto instance::metrics_for(connection_handle hdl) -> peer_metrics* {
+  auto i = peer_metrics_.find(hdl);
+  if (i != peer_metrics_.end())
+    return &i->second;
+  auto nid = tbl_.lookup_direct(hdl);
+  if (nid == none)
+    return nullptr;
+  auto& reg = system().metrics();
+  auto labels = "peer=\"" + to_string(nid) + '"';
+  auto& result = peer_metrics_[hdl];
+  result.messages_sent = &reg.add_counter(
+    "caf_basp_messages_sent_total", "Number of BASP messages sent to a peer.",
+    labels);
+  result.bytes_sent = &reg.add_counter(
+    "caf_basp_bytes_sent_total", "Number of bytes sent to a peer.", labels);
+  result.messages_received = &reg.add_counter(
+    "caf_basp_messages_received_total",
+    "Number of BASP messages received from a peer.", labels);
+  result.bytes_received = &reg.add_counter(
+    "caf_basp_bytes_received_total", "Number of bytes received from a peer.",
+    labels);
+  // the ratio of both counters is the compression ratio for a peer
+  result.compression_input = &reg.add_counter(
+    "caf_basp_compression_input_bytes_total",
+    "Number of payload bytes passed to the compression codec of a peer.",
+    labels);
+  result.compression_output = &reg.add_counter(
+    "caf_basp_compression_output_bytes_total",
+    "Number of payload bytes sent after compressing them for a peer.",
+    labels);
+  return &result;
+}
+
+connection_state instance::handle(execution_unit* ctx, connection_handle hdl,
+                                  header& hdr, const char* payload) {
+  // function object providing cleanup code on errors
+  auto err = [&] {
+    return handle_error(hdl);
+  };
+  auto pm = metrics_for(hdl);
+  if (pm != nullptr)
+    pm->messages_received->inc();
   CAF_LOG_DEBUG(CAF_ARG(hdr));
-  // needs forwarding?
-  if (!is_handshake(hdr) && !is_heartbeat(hdr) && hdr.dest_node != this_node_) {
+  auto needs_forwarding = !is_handshake(hdr) && !is_heartbeat(hdr)
+                          && hdr.dest_node != this_node_;
+  // forwarded messages keep their compressed payload if the next hop uses
+  // the same codec and get compressed again with its codec otherwise
+  if (hdr.has(header::compressed_flag)
+      && !(needs_forwarding && same_codec_on_route(hdl, hdr.dest_node))
+      && !decompress_payload(hdl, hdr, payload)) {
+    CAF_LOG_WARNING("received invalid compressed payload");
+    return err();
+  }
+  if (needs_forwarding) {
     CAF_LOG_DEBUG("forward message");
-    auto path = lookup(hdr.dest_node);
-    if (path) {
-      binary_serializer bs{ctx, path->wr_buf};
-      auto e = bs(hdr);
-      if (e)
-        return err();
-      if (payload)
-        bs.apply_raw(payload->size(), payload->data());
-      tbl_.flush(*path);
-      notify<hook::message_forwarded>(hdr, payload);
-    } else {
+    // the payload stays unchanged, because senders only use the compact
+    // encoding when talking directly to the destination node; nodes
+    // connected to another I/O loop are reachable via its BASP broker
+    auto forward_to_owner = [&] {
+      // other brokers receive the payload as part of a message anyway
+      std::vector<char> buf;
+      if (payload != nullptr)
+        buf.assign(payload, payload + hdr.payload_len);
+      return callee_.forward_to_owner(hdr, payload != nullptr ? &buf
+                                                              : nullptr);
+    };
+    if (!forward(ctx, hdr, payload, hdr.payload_len) && !forward_to_owner()) {
       CAF_LOG_INFO("cannot forward message, no route to destination");
       if (hdr.source_node != this_node_) {
         // TODO: signalize error back to sending node
@@ -105,21 +265,24 @@ connection_state instance::handle(execution_unit* ctx,
       } else {
         CAF_LOG_WARNING("lost packet with probably spoofed source");
       }
-      notify<hook::message_forwarding_failed>(hdr, payload);
+      notify_payload<hook::message_forwarding_failed>(hdr, payload,
+                                                      hdr.payload_len);
     }
     return await_header;
   }
   // function object for checking payload validity
   auto payload_valid = [&]() -> bool {
-    return payload != nullptr && payload->size() == hdr.payload_len;
+    return payload != nullptr;
   };
   // handle message to ourselves
   switch (hdr.operation) {
     case message_type::server_handshake: {
       actor_id aid = invalid_actor_id;
       std::set<std::string> sigs;
+      uint8_t remote_codecs = 0;
       if (payload_valid()) {
-        binary_deserializer bd{ctx, *payload};
+        binary_deserializer bd{ctx, const_cast<char*>(payload),
+                               hdr.payload_len};
         std::string remote_appid;
         auto e = bd(remote_appid);
         if (e)
@@ -131,6 +294,11 @@ connection_state instance::handle(execution_unit* ctx,
         e = bd(aid, sigs);
         if (e)
           return err();
+        if (hdr.has(header::compression_flag)) {
+          e = bd(remote_codecs);
+          if (e)
+            return err();
+        }
       } else {
         CAF_LOG_ERROR("fail to receive the app identifier");
         return err();
@@ -150,7 +318,7 @@ connection_state instance::handle(execution_unit* ctx,
       }
       // add direct route to this node and remove any indirect entry
       CAF_LOG_INFO("new direct connection:" << CAF_ARG(hdr.source_node));
-      tbl_.add_direct(dm.handle, hdr.source_node);
+      tbl_.add_direct(hdl, hdr.source_node);
       auto was_indirect = tbl_.erase_indirect(hdr.source_node);
       // write handshake as client in response
       auto path = tbl_.lookup(hdr.source_node);
@@ -158,20 +326,30 @@ connection_state instance::handle(execution_unit* ctx,
         CAF_LOG_ERROR("no route to host after server handshake");
         return err();
       }
-      write_client_handshake(ctx, path->wr_buf, hdr.source_node);
+      // the server only sends compact headers after our handshake arrived
+      auto use_compact = hdr.has(header::compact_header_flag)
+                         && compact_enabled();
+      auto codec = select_codec(remote_codecs & accepted_codecs_);
+      auto use_encoding = hdr.has(header::compact_encoding_flag)
+                          && compact_encoding_enabled();
+      write_client_handshake(ctx, path->wr_buf, hdr.source_node, use_compact,
+                             codec, use_encoding);
+      enable_framing(hdl, use_compact);
+      if (codec != compression_codec::none)
+        codecs_[hdl] = codec;
+      if (use_encoding)
+        compact_encoded_.emplace(hdl);
+      if (hdr.has(header::priority_lanes_flag))
+        priority_lanes_.emplace(hdl);
       callee_.learned_new_node_directly(hdr.source_node, was_indirect);
       callee_.finalize_handshake(hdr.source_node, aid, sigs);
       flush(*path);
       break;
     }
     case message_type::client_handshake: {
-      if (tbl_.lookup_direct(hdr.source_node) != invalid_connection_handle) {
-        CAF_LOG_INFO("received second client handshake:"
-                     << CAF_ARG(hdr.source_node));
-        break;
-      }
       if (payload_valid()) {
-        binary_deserializer bd{ctx, *payload};
+        binary_deserializer bd{ctx, const_cast<char*>(payload),
+                               hdr.payload_len};
         std::string remote_appid;
         auto e = bd(remote_appid);
         if (e)
@@ -180,13 +358,37 @@ connection_state instance::handle(execution_unit* ctx,
           CAF_LOG_ERROR("app identifier mismatch");
           return err();
         }
+        if (hdr.has(header::compression_flag)) {
+          uint8_t x = 0;
+          e = bd(x);
+          auto codec = static_cast<compression_codec>(x);
+          if (e || (to_mask(codec) & accepted_codecs_) == 0) {
+            CAF_LOG_ERROR("client selected an unaccepted codec");
+            return err();
+          }
+          codecs_[hdl] = codec;
+        }
       } else {
         CAF_LOG_ERROR("fail to receive the app identifier");
         return err();
       }
+      // the client sends compact headers and compressed payloads right after
+      // its handshake, even if we keep using another connection for messages
+      // to this node
+      enable_framing(hdl, hdr.has(header::compact_header_flag)
+                          && compact_enabled());
+      if (hdr.has(header::compact_encoding_flag) && compact_encoding_enabled())
+        compact_encoded_.emplace(hdl);
+      if (hdr.has(header::priority_lanes_flag))
+        priority_lanes_.emplace(hdl);
+      if (tbl_.lookup_direct(hdr.source_node) != invalid_connection_handle) {
+        CAF_LOG_INFO("received second client handshake:"
+                     << CAF_ARG(hdr.source_node));
+        break;
+      }
       // add direct route to this node and remove any indirect entry
       CAF_LOG_INFO("new direct connection:" << CAF_ARG(hdr.source_node));
-      tbl_.add_direct(dm.handle, hdr.source_node);
+      tbl_.add_direct(hdl, hdr.source_node);
       auto was_indirect = tbl_.erase_indirect(hdr.source_node);
       callee_.learned_new_node_directly(hdr.source_node, was_indirect);
       break;
@@ -196,14 +398,16 @@ connection_state instance::handle(execution_unit* ctx,
         return err();
       // in case the sender of this message was received via a third node,
       // we assume that that node to offers a route to the original source
-      auto last_hop = tbl_.lookup_direct(dm.handle);
+      auto last_hop = tbl_.lookup_direct(hdl);
       if (hdr.source_node != none
           && hdr.source_node != this_node_
           && last_hop != hdr.source_node
           && tbl_.lookup_direct(hdr.source_node) == invalid_connection_handle
           && tbl_.add_indirect(last_hop, hdr.source_node))
         callee_.learned_new_node_indirectly(hdr.source_node);
-      binary_deserializer bd{ctx, *payload};
+      binary_deserializer bd{ctx, const_cast<char*>(payload),
+                             hdr.payload_len};
+      bd.encoding(payload_encoding(hdr));
       auto receiver_name = static_cast<atom_value>(0);
       std::vector<strong_actor_ptr> forwarding_stack;
       message msg;
@@ -232,7 +436,9 @@ connection_state instance::handle(execution_unit* ctx,
     case message_type::kill_proxy: {
       if (!payload_valid())
         return err();
-      binary_deserializer bd{ctx, *payload};
+      binary_deserializer bd{ctx, const_cast<char*>(payload),
+                             hdr.payload_len};
+      bd.encoding(payload_encoding(hdr));
       error fail_state;
       auto e = bd(fail_state);
       if (e)
@@ -256,16 +462,34 @@ void instance::handle_heartbeat(execution_unit* ctx) {
   CAF_LOG_TRACE("");
   for (auto& kvp: tbl_.direct_by_hdl_) {
     CAF_LOG_TRACE(CAF_ARG(kvp.first) << CAF_ARG(kvp.second));
-    write_heartbeat(ctx, tbl_.parent_->wr_buf(kvp.first), kvp.second);
+    write_heartbeat(ctx, kvp.first, tbl_.parent_->wr_buf(kvp.first),
+                    kvp.second);
     tbl_.parent_->flush(kvp.first);
   }
 }
 
+void instance::handle_connection_closed(connection_handle hdl) {
+  CAF_LOG_TRACE(CAF_ARG(hdl));
+  framed_.erase(hdl);
+  coalesced_.erase(hdl);
+  codecs_.erase(hdl);
+  compact_encoded_.erase(hdl);
+  priority_lanes_.erase(hdl);
+  peer_metrics_.erase(hdl);
+}
+
 void instance::handle_node_shutdown(const node_id& affected_node) {
   CAF_LOG_TRACE(CAF_ARG(affected_node));
   if (affected_node == none)
     return;
   CAF_LOG_INFO("lost direct connection:" << CAF_ARG(affected_node));
+  auto hdl = tbl_.lookup_direct(affected_node);
+  framed_.erase(hdl);
+  coalesced_.erase(hdl);
+  codecs_.erase(hdl);
+  compact_encoded_.erase(hdl);
+  priority_lanes_.erase(hdl);
+  peer_metrics_.erase(hdl);
   auto cb = make_callback([&](const node_id& nid) -> error {
     callee_.purge_state(nid);
     return none;
@@ -285,8 +509,34 @@ void instance::write(execution_unit* ctx, const routing_table::route& r,
                      header& hdr, payload_writer* writer) {
   CAF_LOG_TRACE(CAF_ARG(hdr));
   CAF_ASSERT(hdr.payload_len == 0 || writer != nullptr);
-  write(ctx, r.wr_buf, hdr, writer);
-  tbl_.flush(r);
+  auto pos = r.wr_buf.size();
+  write(ctx, r.hdl, r.wr_buf, hdr, writer);
+  finish_write(r, pos, hdr);
+}
+
+void instance::finish_write(const routing_table::route& r, size_t pos,
+                            const header& hdr) {
+  message_sizes_->observe(hdr.payload_len);
+  auto pm = metrics_for(r.hdl);
+  if (pm != nullptr) {
+    pm->messages_sent->inc();
+    pm->bytes_sent->inc(r.wr_buf.size() - pos);
+  }
+  if (!coalescing_enabled() || r.wr_buf.size() >= coalescing_bytes_) {
+    tbl_.flush(r);
+    return;
+  }
+  // defer the flush to combine this message with subsequent ones
+  if (coalesced_.empty())
+    callee_.schedule_flush(coalescing_delay_);
+  coalesced_.emplace(r.hdl);
+}
+
+void instance::flush_coalesced() {
+  CAF_LOG_TRACE(CAF_ARG(coalesced_.size()));
+  for (auto hdl : coalesced_)
+    tbl_.parent_->flush(hdl);
+  coalesced_.clear();
 }
 
 void instance::add_published_actor(uint16_t port,
@@ -342,6 +592,27 @@ size_t instance::remove_published_actor(const actor_addr& whom,
   return result;
 }
 
+bool instance::forward(execution_unit* ctx, header& hdr,
+                       std::vector<char>* payload) {
+  return payload != nullptr ? forward(ctx, hdr, payload->data(),
+                                      payload->size())
+                            : forward(ctx, hdr, nullptr, 0);
+}
+
+bool instance::forward(execution_unit* ctx, header& hdr, const char* payload,
+                       size_t payload_size) {
+  CAF_LOG_TRACE(CAF_ARG(hdr));
+  auto path = lookup(hdr.dest_node);
+  if (!path)
+    return false;
+  auto writer = make_callback([&](serializer& sink) -> error {
+    return sink.apply_raw(payload_size, const_cast<char*>(payload));
+  });
+  write(ctx, *path, hdr, payload ? &writer : nullptr);
+  notify_payload<hook::message_forwarded>(hdr, payload, payload_size);
+  return true;
+}
+
 bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
                         const std::vector<strong_actor_ptr>& forwarding_stack,
                         const strong_actor_ptr& receiver, message_id mid,
@@ -358,15 +629,101 @@ bool instance::dispatch(execution_unit* ctx, const strong_actor_ptr& sender,
     return sink(const_cast<std::vector<strong_actor_ptr>&>(forwarding_stack),
                 const_cast<message&>(msg));
   });
-  header hdr{message_type::dispatch_message, 0, 0, mid.integer_value(),
+  uint8_t flags = compact_encoding(*path, receiver->node())
+                  ? header::compact_payload_flag
+                  : 0;
+  header hdr{message_type::dispatch_message, flags, 0, mid.integer_value(),
              sender ? sender->node() : this_node(), receiver->node(),
              sender ? sender->id() : invalid_actor_id, receiver->id()};
-  write(ctx, path->wr_buf, hdr, &writer);
-  flush(*path);
+  write(ctx, *path, hdr, &writer);
   notify<hook::message_sent>(sender, path->next_hop, receiver, mid, msg);
   return true;
 }
 
+size_t instance::multicast(execution_unit* ctx, const strong_actor_ptr& sender,
+                           const std::vector<strong_actor_ptr>& forwarding_stack,
+                           const std::vector<strong_actor_ptr>& receivers,
+                           message_id mid, const message& msg) {
+  CAF_LOG_TRACE(CAF_ARG(sender) << CAF_ARG(receivers.size())
+                << CAF_ARG(mid) << CAF_ARG(msg));
+  // the payload is identical for all receivers, hence we only serialize it
+  // once for each encoding and copy the bytes for each outgoing message
+  bool serialized[] = {false, false};
+  auto payload = [&](bool compact) -> buffer_type& {
+    auto& buf = multicast_bufs_[compact ? 1 : 0];
+    if (!serialized[compact ? 1 : 0]) {
+      serialized[compact ? 1 : 0] = true;
+      buf.clear();
+      binary_serializer bs{ctx, buf};
+      bs.encoding(compact ? binary_encoding::compact : binary_encoding::fixed);
+      auto err = bs(const_cast<std::vector<strong_actor_ptr>&>(forwarding_stack),
+                    const_cast<message&>(msg));
+      if (err)
+        CAF_LOG_ERROR(CAF_ARG(err));
+    }
+    return buf;
+  };
+  // compressed payloads, indexed by the encoding and the codec, remain
+  // empty if compressing does not shrink the payload
+  bool compressed[2][num_compression_codecs] = {};
+  auto compressed_payload = [&](bool compact,
+                                compression_codec codec) -> buffer_type& {
+    auto i = compact ? 1 : 0;
+    auto j = static_cast<size_t>(codec);
+    auto& buf = multicast_compressed_bufs_[i][j];
+    if (!compressed[i][j]) {
+      compressed[i][j] = true;
+      auto& in = payload(compact);
+      buf.clear();
+      if (!compress(codec, in.data(), in.size(), buf)
+          || buf.size() >= in.size())
+        buf.clear();
+    }
+    return buf;
+  };
+  size_t result = 0;
+  for (auto& receiver : receivers) {
+    if (!receiver || receiver->node() == this_node())
+      continue;
+    auto path = lookup(receiver->node());
+    if (!path) {
+      notify<hook::message_sending_failed>(sender, receiver, mid, msg);
+      continue;
+    }
+    auto compact = compact_encoding(*path, receiver->node());
+    auto out = &payload(compact);
+    uint8_t flags = compact ? header::compact_payload_flag : 0;
+    auto path_codec = codec(path->hdl);
+    if (path_codec != compression_codec::none
+        && out->size() >= compression_threshold_) {
+      auto in_size = out->size();
+      auto& buf = compressed_payload(compact, path_codec);
+      if (!buf.empty()) {
+        flags |= header::compressed_flag;
+        out = &buf;
+      }
+      auto pm = metrics_for(path->hdl);
+      if (pm != nullptr) {
+        pm->compression_input->inc(in_size);
+        pm->compression_output->inc(out->size());
+      }
+    }
+    auto writer = make_callback([&](serializer& sink) -> error {
+      return sink.apply_raw(out->size(), out->data());
+    });
+    header hdr{message_type::dispatch_message, flags, 0, mid.integer_value(),
+               sender ? sender->node() : this_node(), receiver->node(),
+               sender ? sender->id() : invalid_actor_id, receiver->id()};
+    // the payload is already in its final form for this connection
+    auto pos = path->wr_buf.size();
+    write_frame(ctx, path->hdl, path->wr_buf, hdr, &writer);
+    finish_write(*path, pos, hdr);
+    notify<hook::message_sent>(sender, path->next_hop, receiver, mid, msg);
+    ++result;
+  }
+  return result;
+}
+
 void instance::write(execution_unit* ctx, buffer_type& buf,
                      header& hdr, payload_writer* pw) {
   CAF_LOG_TRACE(CAF_ARG(hdr));
@@ -377,6 +734,7 @@ void instance::write(execution_unit* ctx, buffer_type& buf,
     char placeholder[basp::header_size];
     buf.insert(buf.end(), std::begin(placeholder), std::end(placeholder));
     binary_serializer bs{ctx, buf};
+    bs.encoding(payload_encoding(hdr));
     (*pw)(bs);
     auto plen = buf.size() - pos - basp::header_size;
     CAF_ASSERT(plen <= std::numeric_limits<uint32_t>::max());
@@ -391,6 +749,121 @@ void instance::write(execution_unit* ctx, buffer_type& buf,
     CAF_LOG_ERROR(CAF_ARG(err));
 }
 
+void instance::write(execution_unit* ctx, connection_handle hdl,
+                     buffer_type& buf, header& hdr, payload_writer* pw) {
+  // only forwarded payloads arrive here in compressed form, after
+  // `same_codec_on_route` made sure that `hdl` uses the same codec
+  if (hdr.has(header::compressed_flag)) {
+    write_frame(ctx, hdl, buf, hdr, pw);
+    return;
+  }
+  if (pw != nullptr && hdr.operation == message_type::dispatch_message) {
+    auto i = codecs_.find(hdl);
+    if (i != codecs_.end()) {
+      write_compressed(ctx, hdl, i->second, buf, hdr, *pw);
+      return;
+    }
+  }
+  write_frame(ctx, hdl, buf, hdr, pw);
+}
+
+void instance::write_frame(execution_unit* ctx, connection_handle hdl,
+                           buffer_type& buf, header& hdr, payload_writer* pw) {
+  // peers without multi-lane mailboxes interpret the bits for `system`,
+  // `urgent` and `bulk` as part of the request ID
+  if (hdr.operation == message_type::dispatch_message
+      && !priority_lanes(hdl)) {
+    auto mid = message_id::from_integer_value(hdr.operation_data);
+    auto prio = mid.is_high_priority() ? message_priority::high
+                                       : message_priority::normal;
+    hdr.operation_data = mid.with_priority(prio).integer_value();
+  }
+  auto i = framed_.find(hdl);
+  if (i == framed_.end() || !i->second.compact) {
+    write(ctx, buf, hdr, pw);
+    return;
+  }
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(hdr));
+  auto& codec = i->second.out;
+  // the size of a compact header depends on the payload size, hence we
+  // reserve space for a padded header, write the payload behind it and
+  // fill in the header afterwards
+  auto pos = buf.size();
+  auto reserved = codec.padded_size(hdr);
+  buf.resize(pos + reserved);
+  if (pw) {
+    binary_serializer bs{ctx, buf};
+    bs.encoding(payload_encoding(hdr));
+    auto err = (*pw)(bs);
+    if (err)
+      CAF_LOG_ERROR(CAF_ARG(err));
+    auto plen = buf.size() - pos - reserved;
+    CAF_ASSERT(plen <= std::numeric_limits<uint32_t>::max());
+    hdr.payload_len = static_cast<uint32_t>(plen);
+  }
+  char tmp[compact_codec::max_header_size];
+  auto n = codec.encode_padded(tmp, hdr);
+  // only payloads of 2 MB or more exceed the padded size of the header
+  auto first = buf.begin() + static_cast<ptrdiff_t>(pos);
+  if (n > reserved)
+    buf.insert(first, n - reserved, '\0');
+  std::copy(tmp, tmp + n, buf.begin() + static_cast<ptrdiff_t>(pos));
+}
+
+void instance::write_compressed(execution_unit* ctx, connection_handle hdl,
+                                compression_codec codec, buffer_type& buf,
+                                header& hdr, payload_writer& pw) {
+  CAF_LOG_TRACE(CAF_ARG(hdl) << CAF_ARG(hdr));
+  // the payload size is only known after serializing it
+  uncompressed_buf_.clear();
+  binary_serializer bs{ctx, uncompressed_buf_};
+  bs.encoding(payload_encoding(hdr));
+  auto err = pw(bs);
+  if (err)
+    CAF_LOG_ERROR(CAF_ARG(err));
+  auto out = &uncompressed_buf_;
+  if (uncompressed_buf_.size() >= compression_threshold_) {
+    compressed_buf_.clear();
+    if (compress(codec, uncompressed_buf_.data(), uncompressed_buf_.size(),
+                 compressed_buf_)
+        && compressed_buf_.size() < uncompressed_buf_.size()) {
+      hdr.flags |= header::compressed_flag;
+      out = &compressed_buf_;
+    }
+    auto pm = metrics_for(hdl);
+    if (pm != nullptr) {
+      pm->compression_input->inc(uncompressed_buf_.size());
+      pm->compression_output->inc(out->size());
+    }
+  }
+  auto writer = make_callback([&](serializer& sink) -> error {
+    return sink.apply_raw(out->size(), out->data());
+  });
+  write_frame(ctx, hdl, buf, hdr, &writer);
+}
+
+bool instance::decompress_payload(connection_handle hdl, header& hdr,
+                                  const char*& payload) {
+  auto i = codecs_.find(hdl);
+  if (i == codecs_.end() || payload == nullptr)
+    return false;
+  // `decompress` rejects oversized payloads before allocating any memory
+  decompressed_buf_.clear();
+  if (!decompress(i->second, payload, hdr.payload_len, decompressed_buf_))
+    return false;
+  hdr.flags &= ~header::compressed_flag;
+  hdr.payload_len = static_cast<uint32_t>(decompressed_buf_.size());
+  payload = decompressed_buf_.data();
+  return true;
+}
+
+bool instance::same_codec_on_route(connection_handle hdl,
+                                   const node_id& dest) {
+  auto path = lookup(dest);
+  return path && codec(hdl) != compression_codec::none
+         && codec(path->hdl) == codec(hdl);
+}
+
 void instance::write_server_handshake(execution_unit* ctx,
                                       buffer_type& out_buf,
                                       optional<uint16_t> port) {
@@ -410,14 +883,23 @@ void instance::write_server_handshake(execution_unit* ctx,
       return e;
     if (pa) {
       auto i = pa->first ? pa->first->id() : invalid_actor_id;
-      return sink(i, pa->second);
+      e = sink(i, pa->second);
     } else {
       auto aid = invalid_actor_id;
       std::set<std::string> tmp;
-      return sink(aid, tmp);
+      e = sink(aid, tmp);
     }
+    if (e || accepted_codecs_ == 0)
+      return e;
+    return sink(accepted_codecs_);
   });
-  header hdr{message_type::server_handshake, 0, 0, version,
+  uint8_t flags = compact_enabled() ? header::compact_header_flag : 0;
+  if (accepted_codecs_ != 0)
+    flags |= header::compression_flag;
+  if (compact_encoding_enabled())
+    flags |= header::compact_encoding_flag;
+  flags |= header::priority_lanes_flag;
+  header hdr{message_type::server_handshake, flags, 0, version,
              this_node_, none,
              pa && pa->first ? pa->first->id() : invalid_actor_id,
              invalid_actor_id};
@@ -426,44 +908,62 @@ void instance::write_server_handshake(execution_unit* ctx,
 
 void instance::write_client_handshake(execution_unit* ctx,
                                       buffer_type& buf,
-                                      const node_id& remote_side) {
-  CAF_LOG_TRACE(CAF_ARG(remote_side));
+                                      const node_id& remote_side,
+                                      bool compact, compression_codec codec,
+                                      bool compact_encoding) {
+  CAF_LOG_TRACE(CAF_ARG(remote_side) << CAF_ARG(compact) << CAF_ARG(codec)
+                << CAF_ARG(compact_encoding));
   auto writer = make_callback([&](serializer& sink) -> error {
     auto& str = callee_.system().config().middleman_app_identifier;
-    return sink(const_cast<std::string&>(str));
+    auto e = sink(const_cast<std::string&>(str));
+    if (e || codec == compression_codec::none)
+      return e;
+    auto x = static_cast<uint8_t>(codec);
+    return sink(x);
   });
-  header hdr{message_type::client_handshake, 0, 0, 0,
+  uint8_t flags = compact ? header::compact_header_flag : 0;
+  if (codec != compression_codec::none)
+    flags |= header::compression_flag;
+  if (compact_encoding)
+    flags |= header::compact_encoding_flag;
+  flags |= header::priority_lanes_flag;
+  header hdr{message_type::client_handshake, flags, 0, 0,
              this_node_, remote_side, invalid_actor_id, invalid_actor_id};
   write(ctx, buf, hdr, &writer);
 }
 
-void instance::write_announce_proxy(execution_unit* ctx, buffer_type& buf,
+void instance::write_announce_proxy(execution_unit* ctx,
+                                    connection_handle hdl, buffer_type& buf,
                                     const node_id& dest_node, actor_id aid) {
   CAF_LOG_TRACE(CAF_ARG(dest_node) << CAF_ARG(aid));
   header hdr{message_type::announce_proxy, 0, 0, 0,
              this_node_, dest_node, invalid_actor_id, aid};
-  write(ctx, buf, hdr);
+  write(ctx, hdl, buf, hdr);
 }
 
-void instance::write_kill_proxy(execution_unit* ctx, buffer_type& buf,
-                                const node_id& dest_node, actor_id aid,
-                                const error& rsn) {
+void instance::write_kill_proxy(execution_unit* ctx, connection_handle hdl,
+                                buffer_type& buf, const node_id& dest_node,
+                                actor_id aid, const error& rsn) {
   CAF_LOG_TRACE(CAF_ARG(dest_node) << CAF_ARG(aid) << CAF_ARG(rsn));
   auto writer = make_callback([&](serializer& sink) -> error {
     return sink(const_cast<error&>(rsn));
   });
-  header hdr{message_type::kill_proxy, 0, 0, 0,
+  uint8_t flags = compact_encoding(hdl)
+                  && tbl_.lookup_direct(hdl) == dest_node
+                  ? header::compact_payload_flag
+                  : 0;
+  header hdr{message_type::kill_proxy, flags, 0, 0,
              this_node_, dest_node, aid, invalid_actor_id};
-  write(ctx, buf, hdr, &writer);
+  write(ctx, hdl, buf, hdr, &writer);
 }
 
-void instance::write_heartbeat(execution_unit* ctx,
+void instance::write_heartbeat(execution_unit* ctx, connection_handle hdl,
                                buffer_type& buf,
                                const node_id& remote_side) {
   CAF_LOG_TRACE(CAF_ARG(remote_side));
   header hdr{message_type::heartbeat, 0, 0, 0,
              this_node_, remote_side, invalid_actor_id, invalid_actor_id};
-  write(ctx, buf, hdr);
+  write(ctx, hdl, buf, hdr);
 }
 
 } // namespace basp
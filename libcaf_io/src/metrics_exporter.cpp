@@ -0,0 +1,102 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_LOG_COMPONENT "caf.io"
+
+#include "caf/io/metrics_exporter.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "caf/logger.hpp"
+#include "caf/actor_system.hpp"
+
+#include "caf/io/receive_policy.hpp"
+#include "caf/io/system_messages.hpp"
+
+namespace caf {
+namespace io {
+
+namespace {
+
+// drops clients sending oversized request headers
+constexpr size_t max_request_size = 8192;
+
+constexpr const char http_ok[] = "HTTP/1.1 200 OK\r\n"
+                                 "Content-Type: text/plain; version=0.0.4\r\n"
+                                 "Connection: close\r\n"
+                                 "Content-Length: ";
+
+constexpr const char http_bad_request[] = "HTTP/1.1 400 Bad Request\r\n"
+                                          "Connection: close\r\n"
+                                          "Content-Length: 0\r\n"
+                                          "\r\n";
+
+using request_map = std::unordered_map<connection_handle, std::string>;
+
+} // namespace <anonymous>
+
+behavior metrics_exporter(broker* self) {
+  CAF_LOG_TRACE("");
+  // buffers incomplete requests
+  auto requests = std::make_shared<request_map>();
+  auto respond = [=](connection_handle hdl, const std::string& response) {
+    self->write(hdl, response.size(), response.data());
+    self->flush(hdl);
+    // closing a connection still sends all unwritten data
+    self->close(hdl);
+    requests->erase(hdl);
+  };
+  return {
+    [=](const new_connection_msg& msg) {
+      CAF_LOG_DEBUG("new scrape connection:" << CAF_ARG(msg.handle));
+      self->configure_read(msg.handle, receive_policy::at_most(1024));
+    },
+    [=](const new_data_msg& msg) {
+      auto& req = (*requests)[msg.handle];
+      req.insert(req.end(), msg.buf.begin(), msg.buf.end());
+      if (req.find("\r\n\r\n") == std::string::npos) {
+        if (req.size() > max_request_size)
+          respond(msg.handle, http_bad_request);
+        return;
+      }
+      // we serve all metrics regardless of the requested path
+      if (req.compare(0, 4, "GET ") != 0) {
+        respond(msg.handle, http_bad_request);
+        return;
+      }
+      auto body = self->system().metrics().render();
+      std::string response = http_ok;
+      response += std::to_string(body.size());
+      response += "\r\n\r\n";
+      response += body;
+      respond(msg.handle, response);
+    },
+    [=](const connection_closed_msg& msg) {
+      requests->erase(msg.handle);
+    },
+    [=](const acceptor_closed_msg&) {
+      self->quit();
+    }
+  };
+}
+
+} // namespace io
+} // namespace caf
@@ -17,11 +17,14 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io"
+
 #include <tuple>
 #include <cerrno>
 #include <memory>
 #include <cstring>
 #include <sstream>
+#include <iostream>
 #include <stdexcept>
 
 #include "caf/sec.hpp"
@@ -42,6 +45,7 @@
 #include "caf/io/middleman.hpp"
 #include "caf/io/basp_broker.hpp"
 #include "caf/io/system_messages.hpp"
+#include "caf/io/metrics_exporter.hpp"
 
 #include "caf/io/network/interfaces.hpp"
 #include "caf/io/network/default_multiplexer.hpp"
@@ -59,6 +63,10 @@
 #include "caf/io/network/asio_multiplexer_impl.hpp"
 #endif // CAF_USE_ASIO
 
+#ifdef CAF_USE_URING
+#include "caf/io/network/uring_multiplexer.hpp"
+#endif // CAF_USE_URING
+
 #ifdef CAF_WINDOWS
 #include <io.h>
 #include <fcntl.h>
@@ -67,6 +75,23 @@
 namespace caf {
 namespace io {
 
+namespace {
+
+broker* broker_ptr(const actor& hdl) {
+  return static_cast<broker*>(actor_cast<abstract_actor*>(hdl));
+}
+
+// terminates `ptr` from within its I/O loop `mx`
+void stop_broker(broker* ptr, network::multiplexer* mx) {
+  if (ptr == nullptr || ptr->getf(abstract_actor::is_terminated_flag))
+    return;
+  ptr->context(mx);
+  ptr->setf(abstract_actor::is_terminated_flag);
+  ptr->finalize();
+}
+
+} // namespace <anonymous>
+
 actor_system::module* middleman::make(actor_system& sys, detail::type_list<>) {
   class impl : public middleman {
   public:
@@ -78,6 +103,11 @@ actor_system::module* middleman::make(actor_system& sys, detail::type_list<>) {
       return backend_;
     }
 
+  protected:
+    backend_pointer make_backend() override {
+      return backend_pointer{new network::default_multiplexer(&system())};
+    }
+
   private:
     network::default_multiplexer backend_;
   };
@@ -92,21 +122,64 @@ actor_system::module* middleman::make(actor_system& sys, detail::type_list<>) {
       return backend_;
     }
 
+  protected:
+    backend_pointer make_backend() override {
+      return backend_pointer{new network::asio_multiplexer(&system())};
+    }
+
   private:
     network::asio_multiplexer backend_;
   };
   if (sys.config().middleman_network_backend == atom("asio"))
     return new asio_impl(sys);
 # endif // CAF_USE_ASIO
+# ifdef CAF_USE_URING
+  class uring_impl : public middleman {
+  public:
+    uring_impl(actor_system& ref) : middleman(ref), backend_(&ref) {
+      // nop
+    }
+
+    network::multiplexer& backend() override {
+      return backend_;
+    }
+
+  protected:
+    backend_pointer make_backend() override {
+      return backend_pointer{new network::uring_multiplexer(&system())};
+    }
+
+  private:
+    network::uring_multiplexer backend_;
+  };
+  if (sys.config().middleman_network_backend == atom("io_uring")) {
+    if (network::uring_multiplexer::available())
+      return new uring_impl(sys);
+    std::cerr << "[WARNING] io_uring not supported by the kernel, "
+                 "falling back to the default network backend" << std::endl;
+  }
+# endif // CAF_USE_URING
   return new impl(sys);
 }
 
 middleman::middleman(actor_system& sys)
     : system_(sys),
+      next_backend_(0),
       manager_(unsafe_actor_handle_init) {
   // nop
 }
 
+network::multiplexer& middleman::next_backend() {
+  if (backends_.size() < 2)
+    return backend();
+  auto i = next_backend_.fetch_add(1, std::memory_order_relaxed);
+  return *backends_[i % backends_.size()];
+}
+
+middleman::backend_pointer middleman::make_backend() {
+  return nullptr;
+}
+
 expected<strong_actor_ptr> middleman::remote_spawn_impl(const node_id& nid,
                                                         std::string& name,
                                                         message& args,
@@ -235,7 +308,10 @@ strong_actor_ptr middleman::remote_lookup(atom_value name, const node_id& nid) {
   CAF_LOG_TRACE(CAF_ARG(name) << CAF_ARG(nid));
   if (system().node() == nid)
     return system().registry().get(name);
-  auto basp = named_broker<basp_broker>(atom("BASP"));
+  // ask the BASP broker that has a direct connection to `nid`, if any
+  auto basp = nodes_.lookup(nid);
+  if (basp.unsafe())
+    basp = named_broker<basp_broker>(atom("BASP"));
   strong_actor_ptr result;
   scoped_actor self{system(), true};
   try {
@@ -262,6 +338,7 @@ void middleman::start() {
     hooks_.emplace_back(f(system_));
   // launch backend
   backend_supervisor_ = backend().make_supervisor();
+  backends_.push_back(&backend());
   if (!backend_supervisor_) {
     // the only backend that returns a `nullptr` is the `test_multiplexer`
     // which does not have its own thread but uses the main thread instead
@@ -273,9 +350,56 @@ void middleman::start() {
       backend().run();
     }};
     backend().thread_id(thread_.get_id());
+    // launch additional I/O loops
+    auto num_loops = system().config().middleman_network_threads;
+    for (size_t i = 1; i < num_loops; ++i) {
+      auto ptr = make_backend();
+      if (!ptr)
+        break;
+      auto mx = ptr.get();
+      extra_supervisors_.emplace_back(mx->make_supervisor());
+      extra_threads_.emplace_back([this, mx] {
+        CAF_SET_LOGGER_SYS(&system());
+        CAF_LOG_TRACE("");
+        mx->run();
+      });
+      mx->thread_id(extra_threads_.back().get_id());
+      backends_.push_back(mx);
+      extra_backends_.emplace_back(std::move(ptr));
+    }
+  }
+  // each I/O loop runs its own BASP broker
+  basp_brokers_.push_back(named_broker<basp_broker>(atom("BASP")));
+  for (size_t i = 1; i < backends_.size(); ++i) {
+    actor_config cfg{backends_[i]};
+    basp_brokers_.push_back(system().spawn_impl<basp_broker, hidden>(cfg));
+  }
+  manager_ = make_middleman_actor(system(), basp_brokers_);
+  // serve metrics via HTTP if configured
+  auto port = system().config().middleman_metrics_port;
+  if (port != 0) {
+    auto& host = system().config().middleman_metrics_host;
+    auto ehdl = backend().new_tcp_doorman(port, host.empty() ? nullptr
+                                                             : host.c_str(),
+                                          true);
+    if (!ehdl) {
+      CAF_LOG_ERROR("unable to serve metrics:" << CAF_ARG(port)
+                    << CAF_ARG(host) << CAF_ARG(ehdl.error()));
+      std::cerr << "[WARNING] unable to serve metrics on port " << port
+                << ": " << system().render(ehdl.error()) << std::endl;
+      return;
+    }
+    auto hdl = ehdl->first;
+    actor_config cfg{&backend()};
+    cfg.init_fun = [hdl](local_actor* ptr) -> behavior {
+      auto self = static_cast<broker*>(ptr);
+      self->assign_tcp_doorman(hdl);
+      return metrics_exporter(self);
+    };
+    // stopped along with all other named brokers
+    named_brokers_.emplace(atom("Exporter"),
+                           system().spawn_impl<broker, hidden>(cfg));
   }
-  auto basp = named_broker<basp_broker>(atom("BASP"));
-  manager_ = make_middleman_actor(system(), basp);
 }
 
 void middleman::stop() {
@@ -285,20 +409,27 @@ void middleman::stop() {
     notify<hook::before_shutdown>();
     // managers_ will be modified while we are stopping each manager,
     // because each manager will call remove(...)
-    for (auto& kvp : named_brokers_) {
-      auto& hdl = kvp.second;
-      auto ptr = static_cast<broker*>(actor_cast<abstract_actor*>(hdl));
-      if (!ptr->getf(abstract_actor::is_terminated_flag)) {
-        ptr->context(&backend());
-        ptr->setf(abstract_actor::is_terminated_flag);
-        ptr->finalize();
-      }
-    }
+    for (auto& kvp : named_brokers_)
+      stop_broker(broker_ptr(kvp.second), &backend());
   });
+  // BASP brokers of additional I/O loops must stop in their own loop
+  for (size_t i = 1; i < basp_brokers_.size(); ++i) {
+    auto ptr = broker_ptr(basp_brokers_[i]);
+    auto mx = backends_[i];
+    mx->dispatch([=] {
+      stop_broker(ptr, mx);
+    });
+  }
   backend_supervisor_.reset();
+  extra_supervisors_.clear();
   if (thread_.joinable())
     thread_.join();
+  for (auto& t : extra_threads_)
+    t.join();
+  extra_threads_.clear();
   hooks_.clear();
+  nodes_.clear();
+  basp_brokers_.clear();
   named_brokers_.clear();
   scoped_actor self{system(), true};
   self->send_exit(manager_, exit_reason::kill);
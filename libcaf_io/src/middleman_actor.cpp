@@ -17,6 +17,8 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io"
+
 #include "caf/io/middleman_actor.hpp"
 
 #include <tuple>
@@ -43,9 +45,11 @@ namespace {
 
 class middleman_actor_impl : public middleman_actor::base {
 public:
-  middleman_actor_impl(actor_config& cfg, actor default_broker)
+  middleman_actor_impl(actor_config& cfg, std::vector<actor> brokers)
       : middleman_actor::base(cfg),
-        broker_(default_broker) {
+        broker_(brokers.front()),
+        brokers_(std::move(brokers)),
+        next_broker_(0) {
     set_down_handler([=](down_msg& dm) {
       auto i = cached_.begin();
       auto e = cached_.end();
@@ -65,6 +69,7 @@ public:
   void on_exit() override {
     CAF_LOG_TRACE("");
     destroy(broker_);
+    brokers_.clear();
   }
 
   const char* name() const override {
@@ -124,7 +129,7 @@ public:
         auto hdl = *y;
         std::vector<response_promise> tmp{std::move(rp)};
         pending_.emplace(key, std::move(tmp));
-        request(broker_, infinite, connect_atom::value, hdl, port).then(
+        request(next_broker(), infinite, connect_atom::value, hdl, port).then(
           [=](node_id& nid, strong_actor_ptr& addr, mpi_set& sigs) {
             auto i = pending_.find(key);
             if (i == pending_.end())
@@ -152,11 +157,15 @@ public:
       },
       [=](unpublish_atom atm, actor_addr addr, uint16_t p) -> del_res {
         CAF_LOG_TRACE("");
+        for (size_t i = 1; i < brokers_.size(); ++i)
+          anon_send(brokers_[i], atm, addr, p);
         delegate(broker_, atm, std::move(addr), p);
         return {};
       },
       [=](close_atom atm, uint16_t p) -> del_res {
         CAF_LOG_TRACE("");
+        for (size_t i = 1; i < brokers_.size(); ++i)
+          anon_send(brokers_[i], atm, p);
         delegate(broker_, atm, p);
         return {};
       },
@@ -164,7 +173,7 @@ public:
           message& msg, std::set<std::string>& ifs)
       -> delegated<strong_actor_ptr> {
         CAF_LOG_TRACE("");
-        delegate(broker_, forward_atom::value, nid, atom("SpawnServ"),
+        delegate(broker_for(nid), forward_atom::value, nid, atom("SpawnServ"),
                  make_message(atm, std::move(str),
                               std::move(msg), std::move(ifs)));
         return {};
@@ -172,7 +181,7 @@ public:
       [=](get_atom atm, node_id nid)
       -> delegated<node_id, std::string, uint16_t> {
         CAF_LOG_TRACE("");
-        delegate(broker_, atm, std::move(nid));
+        delegate(broker_for(nid), atm, std::move(nid));
         return {};
       }
     };
@@ -184,22 +193,39 @@ private:
               bool reuse_addr = false) {
     CAF_LOG_TRACE(CAF_ARG(port) << CAF_ARG(whom) << CAF_ARG(sigs)
                   << CAF_ARG(in) << CAF_ARG(reuse_addr));
-    accept_handle hdl;
-    uint16_t actual_port;
     // treat empty strings like nullptr
     if (in != nullptr && in[0] == '\0')
       in = nullptr;
-    auto res = system().middleman().backend().new_tcp_doorman(port, in,
+    // each broker accepts connections on its own socket for the port
+    auto res = system().middleman().backend().new_tcp_doormen(brokers_.size(),
+                                                              port, in,
                                                               reuse_addr);
     if (!res)
       return std::move(res.error());
-    hdl = res->first;
-    actual_port = res->second;
-    anon_send(broker_, publish_atom::value, hdl, actual_port,
+    auto& hdls = res->first;
+    auto actual_port = res->second;
+    CAF_ASSERT(!hdls.empty() && hdls.size() <= brokers_.size());
+    for (size_t i = 1; i < hdls.size(); ++i)
+      anon_send(brokers_[i], publish_atom::value, hdls[i], actual_port,
+                whom, sigs);
+    anon_send(broker_, publish_atom::value, hdls.front(), actual_port,
               std::move(whom), std::move(sigs));
     return actual_port;
   }
 
+  // selects the broker for a new outgoing connection in round-robin order
+  const actor& next_broker() {
+    return brokers_[next_broker_++ % brokers_.size()];
+  }
+
+  // returns the broker connected to `nid` or the default broker
+  actor broker_for(const node_id& nid) {
+    auto x = system().middleman().nodes().lookup(nid);
+    if (x.unsafe())
+      return broker_;
+    return x;
+  }
+
   optional<endpoint_data&> cached(const endpoint& ep) {
     auto i = cached_.find(ep);
     if (i != cached_.end())
@@ -215,6 +241,8 @@ private:
   }
 
   actor broker_;
+  std::vector<actor> brokers_;
+  size_t next_broker_;
   std::map<endpoint, endpoint_data> cached_;
   std::map<endpoint, std::vector<response_promise>> pending_;
 };
@@ -222,7 +250,13 @@ private:
 } // namespace <anonymous>
 
 middleman_actor make_middleman_actor(actor_system& sys, actor db) {
-  return sys.spawn<middleman_actor_impl, detached + hidden>(std::move(db));
+  return make_middleman_actor(sys, std::vector<actor>{std::move(db)});
+}
+
+middleman_actor make_middleman_actor(actor_system& sys,
+                                     std::vector<actor> brokers) {
+  CAF_ASSERT(!brokers.empty());
+  return sys.spawn<middleman_actor_impl, detached + hidden>(std::move(brokers));
 }
 
 } // namespace io
@@ -17,7 +17,13 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io.network"
+
 #include "caf/io/network/multiplexer.hpp"
+
+#include "caf/sec.hpp"
+#include "caf/actor_system.hpp"
+
 #include "caf/io/network/default_multiplexer.hpp" // default singleton
 
 namespace caf {
@@ -25,7 +31,17 @@ namespace io {
 namespace network {
 
 multiplexer::multiplexer(actor_system* sys) : execution_unit(sys) {
-  // nop
+  auto& reg = sys->metrics();
+  auto events = [&](const char* type) {
+    return &reg.add_counter("caf_multiplexer_events_total",
+                            "Number of socket events handled by I/O loops.",
+                            std::string{"type=\""} + type + '"');
+  };
+  read_events_ = events("read");
+  write_events_ = events("write");
+  error_events_ = events("error");
+  wakeups_ = &reg.add_counter("caf_multiplexer_wakeups_total",
+                              "Number of event loop iterations.");
 }
 
 boost::asio::io_service* pimpl() {
@@ -41,6 +57,15 @@ boost::asio::io_service* multiplexer::pimpl() {
   return nullptr;
 }
 
+expected<std::pair<std::vector<accept_handle>, uint16_t>>
+multiplexer::new_tcp_doormen(size_t, uint16_t port, const char* in,
+                             bool reuse_addr) {
+  auto res = new_tcp_doorman(port, in, reuse_addr);
+  if (!res)
+    return std::move(res.error());
+  return std::make_pair(std::vector<accept_handle>{res->first}, res->second);
+}
+
 multiplexer::supervisor::~supervisor() {
   // nop
 }
@@ -0,0 +1,53 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/io/basp/node_directory.hpp"
+
+namespace caf {
+namespace io {
+namespace basp {
+
+bool node_directory::add(const node_id& nid, const actor& owner) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  return owners_.emplace(nid, owner).second;
+}
+
+void node_directory::erase(const node_id& nid, const actor& owner) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  auto i = owners_.find(nid);
+  if (i != owners_.end() && i->second == owner)
+    owners_.erase(i);
+}
+
+actor node_directory::lookup(const node_id& nid) const {
+  std::unique_lock<std::mutex> guard{mtx_};
+  auto i = owners_.find(nid);
+  if (i != owners_.end())
+    return i->second;
+  return actor{unsafe_actor_handle_init};
+}
+
+void node_directory::clear() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  owners_.clear();
+}
+
+} // namespace basp
+} // namespace io
+} // namespace caf
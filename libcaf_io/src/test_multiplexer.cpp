@@ -17,6 +17,8 @@
  * http://www.boost.org/LICENSE_1_0.txt.                                      *
  ******************************************************************************/
 
+#define CAF_LOG_COMPONENT "caf.io.network"
+
 #include "caf/io/network/test_multiplexer.hpp"
 
 #include "caf/scheduler/abstract_coordinator.hpp"
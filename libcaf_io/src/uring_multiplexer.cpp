@@ -0,0 +1,1168 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_LOG_COMPONENT "caf.io.network"
+
+#include "caf/io/network/uring_multiplexer.hpp"
+
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include "caf/sec.hpp"
+#include "caf/make_counted.hpp"
+#include "caf/actor_system_config.hpp"
+
+#include "caf/scheduler/abstract_coordinator.hpp"
+
+#include "caf/io/broker.hpp"
+#include "caf/io/middleman.hpp"
+
+#include "caf/io/network/default_multiplexer.hpp"
+
+namespace {
+
+// number of entries in the submission queue, the kernel allocates
+// twice as many entries for the completion queue
+constexpr unsigned submission_queue_size = 1024;
+
+// number of slots in the table of registered buffers
+constexpr unsigned max_registered_buffers = 1024;
+
+// maximum number of buffers per gather write
+constexpr size_t max_gather_buffers = 64;
+
+// maximum number of recycled write buffers per stream
+constexpr size_t max_pooled_buffers = 8;
+
+// maximum number of resumables read from the pipe at once
+constexpr size_t pipe_batch_size = 64;
+
+// the lower bits of user data in submission and completion
+// queue entries store the operation type
+constexpr uint64_t op_mask = 0x7;
+
+int io_uring_setup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                   unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+int io_uring_register(int fd, unsigned opcode, const void* arg,
+                      unsigned nr_args) {
+  return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg,
+                                  nr_args));
+}
+
+uint64_t to_user_data(caf::io::network::uring_op op,
+                      caf::io::network::uring_handler* ptr) {
+  return reinterpret_cast<uint64_t>(ptr) | static_cast<uint64_t>(op);
+}
+
+} // namespace <anonymous>
+
+namespace caf {
+namespace io {
+namespace network {
+
+// helper function
+expected<std::string> local_addr_of_fd(native_socket fd);
+expected<uint16_t> local_port_of_fd(native_socket fd);
+expected<std::string> remote_addr_of_fd(native_socket fd);
+expected<uint16_t> remote_port_of_fd(native_socket fd);
+
+/******************************************************************************
+ *                             uring_multiplexer                              *
+ ******************************************************************************/
+
+uring_multiplexer::uring_multiplexer(actor_system* sys)
+    : multiplexer(sys),
+      ring_fd_(-1),
+      sq_ring_(nullptr),
+      sq_ring_size_(0),
+      cq_ring_(nullptr),
+      cq_ring_size_(0),
+      sqes_(nullptr),
+      sqe_tail_(0),
+      inflight_(0),
+      multishot_accept_(true),
+      pipe_open_(true),
+      pipe_buf_(pipe_batch_size) {
+  init();
+  pipe_ = create_pipe();
+  submit_pipe_read();
+}
+
+uring_multiplexer::~uring_multiplexer() {
+  // close write handle first
+  closesocket(pipe_.second);
+  // closing the ring cancels all operations still in flight
+  if (sqes_)
+    munmap(sqes_, params_.sq_entries * sizeof(io_uring_sqe));
+  if (cq_ring_ && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_)
+    munmap(sq_ring_, sq_ring_size_);
+  if (ring_fd_ != -1)
+    close(ring_fd_);
+  // flush pipe before closing it
+  nonblocking(pipe_.first, true);
+  intptr_t ptrval;
+  while (read(pipe_.first, &ptrval, sizeof(ptrval)) == sizeof(ptrval))
+    scheduler::abstract_coordinator::cleanup_and_release(
+      reinterpret_cast<resumable*>(ptrval));
+  closesocket(pipe_.first);
+}
+
+bool uring_multiplexer::available() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  auto fd = io_uring_setup(1, &params);
+  if (fd < 0)
+    return false;
+  // ask the kernel whether it implements all operations we need
+  std::vector<char> storage(sizeof(io_uring_probe)
+                            + 256 * sizeof(io_uring_probe_op));
+  auto probe = reinterpret_cast<io_uring_probe*>(storage.data());
+  auto res = io_uring_register(fd, IORING_REGISTER_PROBE, probe, 256);
+  close(fd);
+  if (res < 0)
+    return false;
+  auto supported = [&](int op) {
+    return op <= probe->last_op
+           && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+  };
+  return supported(IORING_OP_READ) && supported(IORING_OP_READ_FIXED)
+         && supported(IORING_OP_RECV) && supported(IORING_OP_SENDMSG)
+         && supported(IORING_OP_ACCEPT) && supported(IORING_OP_POLL_ADD)
+         && supported(IORING_OP_ASYNC_CANCEL);
+}
+
+void uring_multiplexer::init() {
+  memset(&params_, 0, sizeof(params_));
+  // the kernel only needs to interrupt us while we wait for completions
+  params_.flags = IORING_SETUP_COOP_TASKRUN;
+  ring_fd_ = io_uring_setup(submission_queue_size, &params_);
+  if (ring_fd_ < 0 && errno == EINVAL) {
+    memset(&params_, 0, sizeof(params_));
+    ring_fd_ = io_uring_setup(submission_queue_size, &params_);
+  }
+  if (ring_fd_ < 0) {
+    CAF_LOG_ERROR("io_uring_setup: " << strerror(errno));
+    perror("io_uring_setup() failed");
+    CAF_CRITICAL("io_uring_setup() failed");
+  }
+  sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params_.cq_off.cqes
+                  + params_.cq_entries * sizeof(io_uring_cqe);
+  auto single_mmap = (params_.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  auto map = [&](size_t size, off_t offset) {
+    auto res = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+    if (res == MAP_FAILED) {
+      CAF_LOG_ERROR("mmap: " << strerror(errno));
+      perror("mmap() failed");
+      CAF_CRITICAL("mmap() failed");
+    }
+    return res;
+  };
+  sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+  cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+  sqes_ = reinterpret_cast<io_uring_sqe*>(
+    map(params_.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+  auto sq_ptr = reinterpret_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq_ptr + params_.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq_ptr + params_.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<unsigned*>(sq_ptr + params_.sq_off.ring_mask);
+  auto cq_ptr = reinterpret_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq_ptr + params_.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq_ptr + params_.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned*>(cq_ptr + params_.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ptr + params_.cq_off.cqes);
+  // we always fill the submission queue in order, hence the indirection
+  // array maps each position in the ring to the entry at the same index
+  auto array = reinterpret_cast<unsigned*>(sq_ptr + params_.sq_off.array);
+  for (unsigned i = 0; i < params_.sq_entries; ++i)
+    array[i] = i;
+  sqe_tail_ = *sq_tail_;
+  // register an empty table for read buffers, streams fill in their
+  // buffers later on and fall back to unregistered buffers on error
+  io_uring_rsrc_register reg;
+  memset(&reg, 0, sizeof(reg));
+  reg.nr = max_registered_buffers;
+  reg.flags = IORING_RSRC_REGISTER_SPARSE;
+  if (io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS2, &reg,
+                        sizeof(reg)) == 0) {
+    for (auto i = static_cast<int>(max_registered_buffers); i > 0; --i)
+      buffer_slots_.push_back(i - 1);
+  } else {
+    CAF_LOG_INFO("unable to register buffers: " << strerror(errno));
+  }
+}
+
+io_uring_sqe* uring_multiplexer::prepare(uring_op op, uring_handler* ptr) {
+  auto full = [&] {
+    return sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)
+           >= params_.sq_entries;
+  };
+  // we must not dispatch completions here, because handlers calling us
+  // would run again before returning from prepare() and could overwrite
+  // state of the operation they are about to submit
+  while (full()) {
+    submit(0);
+    if (full())
+      reap_completions();
+  }
+  auto sqe = &sqes_[sqe_tail_ & sq_mask_];
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  sqe->user_data = to_user_data(op, ptr);
+  ++sqe_tail_;
+  // each operation produces at least one completion
+  ++inflight_;
+  return sqe;
+}
+
+void uring_multiplexer::cancel(uring_op op, uring_handler* ptr) {
+  CAF_LOG_TRACE(CAF_ARG(static_cast<int>(op)));
+  auto sqe = prepare(uring_op::cancel, nullptr);
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->addr = to_user_data(op, ptr);
+  sqe->cancel_flags = IORING_ASYNC_CANCEL_ALL;
+}
+
+void uring_multiplexer::resume_later(uring_handler* ptr) {
+  auto sqe = prepare(uring_op::resume, ptr);
+  sqe->opcode = IORING_OP_NOP;
+}
+
+int uring_multiplexer::acquire_buffer_slot() {
+  if (buffer_slots_.empty())
+    return -1;
+  auto result = buffer_slots_.back();
+  buffer_slots_.pop_back();
+  return result;
+}
+
+void uring_multiplexer::release_buffer_slot(int slot) {
+  CAF_ASSERT(slot >= 0);
+  // an empty buffer removes the previous buffer from the table
+  register_buffer(slot, nullptr, 0);
+  buffer_slots_.push_back(slot);
+}
+
+bool uring_multiplexer::register_buffer(int slot, void* buf, size_t size) {
+  CAF_LOG_TRACE(CAF_ARG(slot) << CAF_ARG(size));
+  iovec vec;
+  vec.iov_base = buf;
+  vec.iov_len = size;
+  io_uring_rsrc_update2 update;
+  memset(&update, 0, sizeof(update));
+  update.offset = static_cast<uint32_t>(slot);
+  update.data = reinterpret_cast<uint64_t>(&vec);
+  update.nr = 1;
+  auto res = io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS_UPDATE,
+                               &update, sizeof(update));
+  if (res < 0) {
+    CAF_LOG_DEBUG("unable to register buffer: " << strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+void uring_multiplexer::submit(unsigned min_complete) {
+  auto flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0u;
+  for (;;) {
+    auto to_submit = sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+    CAF_LOG_DEBUG("io_uring_enter() with" << CAF_ARG(to_submit)
+                  << CAF_ARG(min_complete));
+    if (io_uring_enter(ring_fd_, to_submit, min_complete, flags) >= 0)
+      return;
+    switch (errno) {
+      case EINTR:
+        // a signal was caught, the kernel has either consumed
+        // our submissions or will do so on the next try
+        continue;
+      case EAGAIN:
+      case EBUSY:
+        // the completion queue is full, the caller needs
+        // to dispatch completions before trying again
+        return;
+      default:
+        perror("io_uring_enter() failed");
+        CAF_CRITICAL("io_uring_enter() failed");
+    }
+  }
+}
+
+void uring_multiplexer::reap_completions() {
+  auto head = *cq_head_;
+  auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head)
+    reaped_.push_back(cqes_[head & cq_mask_]);
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+}
+
+void uring_multiplexer::handle_completions() {
+  // handlers may call prepare(), which in turn moves completions from the
+  // ring to reaped_ when running out of submission queue entries, hence we
+  // dispatch until both are empty and must not cache the head of the ring
+  for (;;) {
+    for (size_t i = 0; i < reaped_.size(); ++i) {
+      auto cqe = reaped_[i];
+      handle_completion(cqe);
+    }
+    reaped_.clear();
+    auto head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+      return;
+    auto cqe = cqes_[head & cq_mask_];
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    handle_completion(cqe);
+  }
+}
+
+void uring_multiplexer::handle_completion(const io_uring_cqe& cqe) {
+  auto res = cqe.res;
+  auto flags = cqe.flags;
+  if ((flags & IORING_CQE_F_MORE) == 0)
+    --inflight_;
+  auto op = static_cast<uring_op>(cqe.user_data & op_mask);
+  auto ptr = reinterpret_cast<uring_handler*>(cqe.user_data & ~op_mask);
+  CAF_LOG_DEBUG("completion:" << CAF_ARG(static_cast<int>(op))
+                << CAF_ARG(res) << CAF_ARG(flags));
+  if (res < 0 && res != -ECANCELED)
+    error_events_->inc();
+  else if (op == uring_op::write || op == uring_op::write_poll)
+    write_events_->inc();
+  else if (op != uring_op::cancel && op != uring_op::resume)
+    read_events_->inc();
+  if (ptr)
+    ptr->handle_completion(op, res, flags);
+  else if (op == uring_op::read)
+    handle_pipe_read(res);
+}
+
+void uring_multiplexer::run() {
+  CAF_LOG_TRACE("io_uring-based multiplexer");
+  // each iteration passes all operations issued by handlers to the kernel
+  // and waits for the next completions using a single system call
+  while (inflight_ > 0) {
+    submit(1);
+    wakeups_->inc();
+    handle_completions();
+  }
+}
+
+void uring_multiplexer::submit_pipe_read() {
+  auto sqe = prepare(uring_op::read, nullptr);
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = pipe_.first;
+  sqe->addr = reinterpret_cast<uint64_t>(pipe_buf_.data());
+  sqe->len = static_cast<uint32_t>(pipe_buf_.size() * sizeof(intptr_t));
+}
+
+void uring_multiplexer::handle_pipe_read(int res) {
+  CAF_LOG_TRACE(CAF_ARG(res));
+  if (res > 0) {
+    // writes of a single pointer to a pipe are atomic, hence
+    // we always receive a multiple of sizeof(intptr_t)
+    CAF_ASSERT(res % sizeof(intptr_t) == 0);
+    auto mt = system().config().scheduler_max_throughput;
+    auto n = static_cast<size_t>(res) / sizeof(intptr_t);
+    for (size_t i = 0; i < n; ++i) {
+      auto cb = reinterpret_cast<resumable*>(pipe_buf_[i]);
+      switch (cb->resume(this, mt)) {
+        case resumable::resume_later:
+          exec_later(cb);
+          break;
+        case resumable::done:
+        case resumable::awaiting_message:
+          intrusive_ptr_release(cb);
+          break;
+        default:
+          break; // ignored
+      }
+    }
+  } else if (res < 0 && res != -ECANCELED && res != -EINTR) {
+    CAF_LOG_ERROR("unable to read from pipe: " << strerror(-res));
+  }
+  if (pipe_open_ && res != 0 && res != -ECANCELED)
+    submit_pipe_read();
+}
+
+void uring_multiplexer::close_pipe() {
+  CAF_LOG_TRACE("");
+  pipe_open_ = false;
+  cancel(uring_op::read, nullptr);
+}
+
+void uring_multiplexer::wr_dispatch_request(resumable* ptr) {
+  intptr_t ptrval = reinterpret_cast<intptr_t>(ptr);
+  auto res = ::write(pipe_.second, &ptrval, sizeof(ptrval));
+  if (res <= 0) {
+    // pipe closed, discard resumable
+    intrusive_ptr_release(ptr);
+  } else if (static_cast<size_t>(res) < sizeof(ptrval)) {
+    // must not happen: wrote invalid pointer to pipe
+    std::cerr << "[CAF] Fatal error: wrote invalid data to pipe" << std::endl;
+    abort();
+  }
+}
+
+void uring_multiplexer::exec_later(resumable* ptr) {
+  CAF_ASSERT(ptr);
+  switch (ptr->subtype()) {
+    case resumable::io_actor:
+    case resumable::function_object:
+      wr_dispatch_request(ptr);
+      break;
+    default:
+     system().scheduler().enqueue(ptr);
+  }
+}
+
+multiplexer::supervisor_ptr uring_multiplexer::make_supervisor() {
+  class impl : public multiplexer::supervisor {
+  public:
+    explicit impl(uring_multiplexer* thisptr) : this_(thisptr) {
+      // nop
+    }
+    ~impl() {
+      auto ptr = this_;
+      ptr->dispatch([=] { ptr->close_pipe(); });
+    }
+  private:
+    uring_multiplexer* this_;
+  };
+  return supervisor_ptr{new impl(this)};
+}
+
+connection_handle uring_multiplexer::add_tcp_scribe(abstract_broker* self,
+                                                    native_socket fd) {
+  CAF_LOG_TRACE("");
+  class impl : public scribe {
+  public:
+    impl(abstract_broker* ptr, uring_multiplexer& mx, native_socket sockfd)
+        : scribe(ptr, network::conn_hdl_from_socket(sockfd)),
+          launched_(false),
+          stream_(mx, sockfd) {
+      // nop
+    }
+    void configure_read(receive_policy::config config) override {
+      CAF_LOG_TRACE("");
+      stream_.configure_read(config);
+      if (!launched_)
+        launch();
+    }
+    void ack_writes(bool enable) override {
+      CAF_LOG_TRACE(CAF_ARG(enable));
+      stream_.ack_writes(enable);
+    }
+    std::vector<char>& wr_buf() override {
+      return stream_.wr_buf();
+    }
+    std::vector<char>& rd_buf() override {
+      return stream_.rd_buf();
+    }
+    void stop_reading() override {
+      CAF_LOG_TRACE("");
+      stream_.stop_reading();
+      detach(&stream_.backend(), false);
+    }
+    void flush() override {
+      CAF_LOG_TRACE("");
+      stream_.flush(this);
+    }
+    std::string addr() const override {
+      auto x = remote_addr_of_fd(stream_.fd());
+      if (!x)
+        return "";
+      return *x;
+    }
+    uint16_t port() const override {
+      auto x = remote_port_of_fd(stream_.fd());
+      if (!x)
+        return 0;
+      return *x;
+    }
+    void launch() {
+      CAF_LOG_TRACE("");
+      CAF_ASSERT(!launched_);
+      launched_ = true;
+      stream_.start(this);
+    }
+    void add_to_loop() override {
+      stream_.activate(this);
+    }
+    void remove_from_loop() override {
+      stream_.passivate();
+    }
+  private:
+    bool launched_;
+    uring_stream stream_;
+  };
+  auto ptr = make_counted<impl>(self, *this, fd);
+  self->add_scribe(ptr);
+  return ptr->hdl();
+}
+
+accept_handle uring_multiplexer::add_tcp_doorman(abstract_broker* self,
+                                                 native_socket fd) {
+  CAF_LOG_TRACE(CAF_ARG(fd));
+  CAF_ASSERT(fd != network::invalid_native_socket);
+  class impl : public doorman {
+  public:
+    impl(abstract_broker* ptr, uring_multiplexer& mx, native_socket sockfd)
+        : doorman(ptr, network::accept_hdl_from_socket(sockfd)),
+          acceptor_(mx, sockfd) {
+      // nop
+    }
+    bool new_connection() override {
+      CAF_LOG_TRACE("");
+      if (detached()) {
+        // we are already disconnected from the broker while the kernel
+        // still reported connections accepted by a pending operation
+        closesocket(acceptor_.accepted_socket());
+        return false;
+      }
+      auto& mx = acceptor_.backend();
+      auto hdl = mx.add_tcp_scribe(parent(), acceptor_.accepted_socket());
+      return doorman::new_connection(&mx, hdl);
+    }
+    void stop_reading() override {
+      CAF_LOG_TRACE("");
+      acceptor_.stop_reading();
+      detach(&acceptor_.backend(), false);
+    }
+    void launch() override {
+      CAF_LOG_TRACE("");
+      acceptor_.start(this);
+    }
+    std::string addr() const override {
+      auto x = local_addr_of_fd(acceptor_.fd());
+      if (!x)
+        return "";
+      return std::move(*x);
+    }
+    uint16_t port() const override {
+      auto x = local_port_of_fd(acceptor_.fd());
+      if (!x)
+        return 0;
+      return *x;
+    }
+    void add_to_loop() override {
+      acceptor_.activate(this);
+    }
+    void remove_from_loop() override {
+      acceptor_.passivate();
+    }
+  private:
+    uring_acceptor acceptor_;
+  };
+  auto ptr = make_counted<impl>(self, *this, fd);
+  self->add_doorman(ptr);
+  return ptr->hdl();
+}
+
+expected<connection_handle>
+uring_multiplexer::new_tcp_scribe(const std::string& host, uint16_t port) {
+  auto fd = new_tcp_connection(host, port);
+  if (!fd)
+    return std::move(fd.error());
+  return connection_handle::from_int(int64_from_native_socket(*fd));
+}
+
+expected<void> uring_multiplexer::assign_tcp_scribe(abstract_broker* self,
+                                                    connection_handle hdl) {
+  CAF_LOG_TRACE(CAF_ARG(self->id()) << CAF_ARG(hdl));
+  add_tcp_scribe(self, static_cast<native_socket>(hdl.id()));
+  return unit;
+}
+
+expected<connection_handle>
+uring_multiplexer::add_tcp_scribe(abstract_broker* self,
+                                  const std::string& host, uint16_t port) {
+  CAF_LOG_TRACE(CAF_ARG(self->id()) << CAF_ARG(host) << CAF_ARG(port));
+  auto fd = new_tcp_connection(host, port);
+  if (!fd)
+    return std::move(fd.error());
+  return add_tcp_scribe(self, *fd);
+}
+
+expected<std::pair<accept_handle, uint16_t>>
+uring_multiplexer::new_tcp_doorman(uint16_t port, const char* in,
+                                   bool reuse_addr) {
+  auto res = new_tcp_acceptor_impl(port, in, reuse_addr);
+  if (!res)
+    return std::move(res.error());
+  return std::make_pair(
+    accept_handle::from_int(int64_from_native_socket(res->first)),
+    res->second);
+}
+
+expected<void> uring_multiplexer::assign_tcp_doorman(abstract_broker* ptr,
+                                                     accept_handle hdl) {
+  add_tcp_doorman(ptr, static_cast<native_socket>(hdl.id()));
+  return unit;
+}
+
+expected<std::pair<std::vector<accept_handle>, uint16_t>>
+uring_multiplexer::new_tcp_doormen(size_t num, uint16_t port,
+                                   const char* in, bool reuse_addr) {
+  auto res = new_tcp_acceptors_impl(num, port, in, reuse_addr);
+  if (!res)
+    return std::move(res.error());
+  std::vector<accept_handle> hdls;
+  for (auto fd : res->first)
+    hdls.push_back(accept_handle::from_int(int64_from_native_socket(fd)));
+  return std::make_pair(std::move(hdls), res->second);
+}
+
+expected<std::pair<accept_handle, uint16_t>>
+uring_multiplexer::add_tcp_doorman(abstract_broker* self, uint16_t port,
+                                   const char* host, bool reuse_addr) {
+  auto acceptor = new_tcp_acceptor_impl(port, host, reuse_addr);
+  if (!acceptor)
+    return std::move(acceptor.error());
+  auto bound_port = acceptor->second;
+  return std::make_pair(add_tcp_doorman(self, acceptor->first), bound_port);
+}
+
+/******************************************************************************
+ *                               uring_handler                                *
+ ******************************************************************************/
+
+uring_handler::uring_handler(uring_multiplexer& backend_ref,
+                             native_socket sockfd)
+    : fd_(sockfd),
+      backend_(backend_ref) {
+  // nop
+}
+
+uring_handler::~uring_handler() {
+  if (fd_ != invalid_native_socket)
+    closesocket(fd_);
+}
+
+/******************************************************************************
+ *                                uring_stream                                *
+ ******************************************************************************/
+
+uring_stream::uring_stream(uring_multiplexer& backend_ref,
+                           native_socket sockfd)
+    : uring_handler(backend_ref, sockfd),
+      reading_(false),
+      read_pending_(false),
+      read_channel_closed_(false),
+      consuming_(false),
+      read_threshold_(1),
+      collected_(0),
+      rd_buf_slot_(backend_ref.acquire_buffer_slot()),
+      rd_buf_registered_(nullptr),
+      rd_buf_registered_size_(0),
+      ack_writes_(false),
+      write_pending_(false),
+      written_(0) {
+  tcp_nodelay(fd_, true);
+  allow_sigpipe(fd_, false);
+  memset(&wr_msg_, 0, sizeof(wr_msg_));
+  configure_read(receive_policy::at_most(1024));
+}
+
+uring_stream::~uring_stream() {
+  if (rd_buf_slot_ >= 0)
+    backend().release_buffer_slot(rd_buf_slot_);
+}
+
+void uring_stream::start(stream_manager* mgr) {
+  CAF_ASSERT(mgr != nullptr);
+  activate(mgr);
+}
+
+void uring_stream::activate(stream_manager* mgr) {
+  CAF_ASSERT(mgr != nullptr);
+  if (reading_ || read_channel_closed_)
+    return;
+  reading_ = true;
+  reader_.reset(mgr);
+  if (rd_buf_.empty())
+    prepare_next_read();
+  // a pending read resumes the read loop once it completes
+  if (read_pending_ || consuming_)
+    return;
+  // the manager usually activates us from within a message handler, hence
+  // we must not pass it data received while being passive before returning
+  if (collected_ > 0 && collected_ >= read_threshold_) {
+    backend().resume_later(this);
+    read_pending_ = true;
+  } else {
+    submit_read();
+  }
+}
+
+void uring_stream::passivate() {
+  // data arriving for a pending read remains in
+  // the buffer until the next call to activate()
+  reading_ = false;
+}
+
+void uring_stream::configure_read(receive_policy::config config) {
+  rd_flag_ = config.first;
+  max_ = config.second;
+}
+
+void uring_stream::ack_writes(bool x) {
+  ack_writes_ = x;
+}
+
+void uring_stream::write(const void* buf, size_t num_bytes) {
+  CAF_LOG_TRACE(CAF_ARG(num_bytes));
+  auto first = reinterpret_cast<const char*>(buf);
+  auto last  = first + num_bytes;
+  wr_offline_buf_.insert(wr_offline_buf_.end(), first, last);
+}
+
+void uring_stream::flush(const manager_ptr& mgr) {
+  CAF_ASSERT(mgr != nullptr);
+  CAF_LOG_TRACE(CAF_ARG(wr_offline_buf_.size()) << CAF_ARG(wr_queue_.size()));
+  if (wr_offline_buf_.empty())
+    return;
+  enqueue_offline_buf();
+  if (!write_pending_) {
+    writer_ = mgr;
+    submit_write();
+  }
+}
+
+void uring_stream::stop_reading() {
+  CAF_LOG_TRACE("");
+  reading_ = false;
+  if (!read_channel_closed_) {
+    ::shutdown(fd_, SHUT_RD);
+    read_channel_closed_ = true;
+  }
+  if (read_pending_) {
+    backend().cancel(uring_op::read, this);
+    backend().cancel(uring_op::poll, this);
+  }
+}
+
+void uring_stream::handle_completion(uring_op op, int res, uint32_t) {
+  CAF_LOG_TRACE(CAF_ARG(static_cast<int>(op)) << CAF_ARG(res));
+  switch (op) {
+    case uring_op::read:
+      handle_read(res);
+      break;
+    case uring_op::poll:
+      if (res < 0) {
+        handle_read(res);
+      } else {
+        // the socket became readable after a read reported EAGAIN
+        manager_ptr guard = reader_;
+        read_pending_ = false;
+        if (reading_)
+          submit_read();
+        else
+          reader_.reset();
+      }
+      break;
+    case uring_op::write:
+      handle_write(res);
+      break;
+    case uring_op::write_poll:
+      if (res < 0) {
+        handle_write(res);
+      } else {
+        // the socket became writable after a write reported EAGAIN
+        manager_ptr guard = writer_;
+        write_pending_ = false;
+        submit_write();
+      }
+      break;
+    case uring_op::resume: {
+      manager_ptr guard = reader_;
+      read_pending_ = false;
+      if (reading_)
+        read_loop();
+      else
+        reader_.reset();
+      break;
+    }
+    default:
+      CAF_LOG_ERROR("unexpected operation");
+  }
+}
+
+void uring_stream::read_loop() {
+  // consume data received while being passive or by the last read
+  if (collected_ > 0 && collected_ >= read_threshold_) {
+    consuming_ = true;
+    auto res = reader_->consume(&backend(), rd_buf_.data(), collected_);
+    consuming_ = false;
+    prepare_next_read();
+    if (!res)
+      reading_ = false;
+  }
+  if (reading_)
+    submit_read();
+  else
+    reader_.reset();
+}
+
+void uring_stream::submit_read() {
+  CAF_ASSERT(!read_pending_ && collected_ < rd_buf_.size());
+  if (rd_buf_slot_ >= 0
+      && (rd_buf_registered_ != rd_buf_.data()
+          || rd_buf_registered_size_ != rd_buf_.capacity())) {
+    // register the buffer again after it has been reallocated
+    if (backend().register_buffer(rd_buf_slot_, rd_buf_.data(),
+                                  rd_buf_.capacity())) {
+      rd_buf_registered_ = rd_buf_.data();
+      rd_buf_registered_size_ = rd_buf_.capacity();
+    } else {
+      backend().release_buffer_slot(rd_buf_slot_);
+      rd_buf_slot_ = -1;
+    }
+  }
+  auto sqe = backend().prepare(uring_op::read, this);
+  if (rd_buf_slot_ >= 0) {
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->buf_index = static_cast<uint16_t>(rd_buf_slot_);
+  } else {
+    sqe->opcode = IORING_OP_RECV;
+  }
+  sqe->fd = fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(rd_buf_.data() + collected_);
+  sqe->len = static_cast<uint32_t>(rd_buf_.size() - collected_);
+  read_pending_ = true;
+}
+
+void uring_stream::submit_write() {
+  CAF_ASSERT(!write_pending_ && !wr_queue_.empty());
+  // pass all pending buffers to a single gather write
+  wr_vecs_.clear();
+  for (auto& buf : wr_queue_) {
+    if (wr_vecs_.size() == max_gather_buffers)
+      break;
+    auto offset = wr_vecs_.empty() ? written_ : 0;
+    wr_vecs_.push_back(make_io_vec(buf.data() + offset, buf.size() - offset));
+  }
+  wr_msg_.msg_iov = wr_vecs_.data();
+  wr_msg_.msg_iovlen = wr_vecs_.size();
+  auto sqe = backend().prepare(uring_op::write, this);
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(&wr_msg_);
+  sqe->len = 1;
+  sqe->msg_flags = MSG_NOSIGNAL;
+  write_pending_ = true;
+}
+
+void uring_stream::handle_read(int res) {
+  // keeps this stream alive until we return
+  manager_ptr guard = reader_;
+  read_pending_ = false;
+  if (res > 0) {
+    collected_ += static_cast<size_t>(res);
+    read_loop();
+    return;
+  }
+  if (reading_ && (res == -EAGAIN || res == -EINTR)) {
+    // wait for the socket to become readable before trying again
+    auto sqe = backend().prepare(uring_op::poll, this);
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd_;
+    sqe->poll32_events = POLLIN;
+    read_pending_ = true;
+    return;
+  }
+  if (reading_) {
+    // the peer has performed an orderly shutdown or an I/O error occured
+    CAF_LOG_DEBUG("read failed:" << CAF_ARG(fd_) << CAF_ARG(res));
+    reading_ = false;
+    reader_->io_failure(&backend(), operation::read);
+  }
+  reader_.reset();
+}
+
+void uring_stream::handle_write(int res) {
+  // keeps this stream alive until we return
+  manager_ptr guard = writer_;
+  write_pending_ = false;
+  if (res == -EINTR) {
+    submit_write();
+    return;
+  }
+  if (res == -EAGAIN) {
+    // wait for the socket to become writable before trying again
+    auto sqe = backend().prepare(uring_op::write_poll, this);
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd_;
+    sqe->poll32_events = POLLOUT;
+    write_pending_ = true;
+    return;
+  }
+  if (res < 0) {
+    CAF_LOG_DEBUG("write failed:" << CAF_ARG(fd_) << CAF_ARG(res));
+    writer_->io_failure(&backend(), operation::write);
+    writer_.reset();
+    return;
+  }
+  auto wb = static_cast<size_t>(res);
+  drop_written(wb);
+  if (ack_writes_)
+    writer_->data_transferred(&backend(), wb,
+                              pending_bytes() + wr_offline_buf_.size());
+  // implicitly flush data written since the last flush
+  if (wr_queue_.empty() && !wr_offline_buf_.empty())
+    enqueue_offline_buf();
+  if (write_pending_)
+    return; // data_transferred() called flush()
+  if (wr_queue_.empty())
+    writer_.reset();
+  else
+    submit_write();
+}
+
+void uring_stream::prepare_next_read() {
+  collected_ = 0;
+  switch (rd_flag_) {
+    case receive_policy_flag::exactly:
+      if (rd_buf_.size() != max_)
+        rd_buf_.resize(max_);
+      read_threshold_ = max_;
+      break;
+    case receive_policy_flag::at_most:
+      if (rd_buf_.size() != max_)
+        rd_buf_.resize(max_);
+      read_threshold_ = 1;
+      break;
+    case receive_policy_flag::at_least: {
+      // read up to 10% more, but at least allow 100 bytes more
+      auto max_size = max_ + std::max<size_t>(100, max_ / 10);
+      if (rd_buf_.size() != max_size)
+        rd_buf_.resize(max_size);
+      read_threshold_ = max_;
+      break;
+    }
+  }
+}
+
+void uring_stream::enqueue_offline_buf() {
+  wr_queue_.emplace_back();
+  wr_queue_.back().swap(wr_offline_buf_);
+  if (!wr_pool_.empty()) {
+    wr_offline_buf_.swap(wr_pool_.back());
+    wr_pool_.pop_back();
+  }
+}
+
+void uring_stream::drop_written(size_t num_bytes) {
+  written_ += num_bytes;
+  while (!wr_queue_.empty() && written_ >= wr_queue_.front().size()) {
+    auto& buf = wr_queue_.front();
+    written_ -= buf.size();
+    if (wr_pool_.size() < max_pooled_buffers) {
+      buf.clear();
+      wr_pool_.emplace_back(std::move(buf));
+    }
+    wr_queue_.pop_front();
+  }
+  CAF_ASSERT(!wr_queue_.empty() || written_ == 0);
+}
+
+size_t uring_stream::pending_bytes() const {
+  size_t result = 0;
+  for (auto& buf : wr_queue_)
+    result += buf.size();
+  return result - written_;
+}
+
+/******************************************************************************
+ *                               uring_acceptor                               *
+ ******************************************************************************/
+
+uring_acceptor::uring_acceptor(uring_multiplexer& backend_ref,
+                               native_socket sockfd)
+    : uring_handler(backend_ref, sockfd),
+      sock_(invalid_native_socket),
+      accepting_(false),
+      accept_pending_(false),
+      multishot_(backend_ref.multishot_accept()),
+      resume_pending_(false) {
+  // nop
+}
+
+uring_acceptor::~uring_acceptor() {
+  for (auto fd : backlog_)
+    closesocket(fd);
+}
+
+void uring_acceptor::start(acceptor_manager* mgr) {
+  CAF_LOG_TRACE(CAF_ARG(fd_));
+  CAF_ASSERT(mgr != nullptr);
+  activate(mgr);
+}
+
+void uring_acceptor::activate(acceptor_manager* mgr) {
+  CAF_ASSERT(mgr != nullptr);
+  if (accepting_)
+    return;
+  accepting_ = true;
+  mgr_.reset(mgr);
+  // the manager usually activates us from within a message handler, hence
+  // we deliver connections accepted while being passive after returning
+  if (!backlog_.empty()) {
+    if (!resume_pending_) {
+      backend().resume_later(this);
+      resume_pending_ = true;
+    }
+    return;
+  }
+  // a canceled operation resumes accepting once it completes
+  if (!accept_pending_ && !resume_pending_)
+    submit_accept();
+}
+
+void uring_acceptor::passivate() {
+  accepting_ = false;
+  if (accept_pending_) {
+    backend().cancel(uring_op::accept, this);
+    backend().cancel(uring_op::poll, this);
+  }
+}
+
+void uring_acceptor::stop_reading() {
+  CAF_LOG_TRACE(CAF_ARG(fd_));
+  passivate();
+}
+
+void uring_acceptor::handle_completion(uring_op op, int res, uint32_t flags) {
+  CAF_LOG_TRACE(CAF_ARG(fd_) << CAF_ARG(res) << CAF_ARG(flags));
+  if (op == uring_op::resume) {
+    drain_backlog();
+    return;
+  }
+  // keeps this acceptor alive until we return
+  manager_ptr guard = mgr_;
+  if (op == uring_op::poll) {
+    // the socket became readable after an accept reported EAGAIN
+    accept_pending_ = false;
+    if (accepting_ && !resume_pending_)
+      submit_accept();
+    else if (!accepting_ && !resume_pending_)
+      mgr_.reset();
+    return;
+  }
+  if (op != uring_op::accept) {
+    CAF_LOG_ERROR("unexpected operation");
+    return;
+  }
+  // multishot accepts remain active as long as the kernel sets this flag
+  if ((flags & IORING_CQE_F_MORE) == 0)
+    accept_pending_ = false;
+  if (res >= 0) {
+    // the manager may also passivate this acceptor while handling
+    // the new connection, hence we must not set accepting_ to true here
+    if (accepting_ && !resume_pending_) {
+      if (!deliver(res))
+        accepting_ = false;
+    } else
+      backlog_.push_back(res);
+  } else if (res == -EINVAL && multishot_) {
+    CAF_LOG_INFO("kernel does not support multishot accept");
+    backend().disable_multishot_accept();
+    multishot_ = false;
+  } else if (accepting_ && res != -ECANCELED && res != -EINTR
+             && res != -EAGAIN && res != -ECONNABORTED) {
+    CAF_LOG_DEBUG("accept failed:" << CAF_ARG(fd_) << CAF_ARG(res));
+    accepting_ = false;
+    mgr_->io_failure(&backend(), operation::read);
+  }
+  if (!accept_pending_) {
+    if (accepting_ && !resume_pending_ && res == -EAGAIN)
+      submit_poll();
+    else if (accepting_ && !resume_pending_)
+      submit_accept();
+    else if (!accepting_ && !resume_pending_)
+      mgr_.reset();
+  } else if (!accepting_ && res >= 0) {
+    // stop a multishot accept after the manager refused further connections
+    backend().cancel(uring_op::accept, this);
+  }
+}
+
+void uring_acceptor::submit_accept() {
+  auto sqe = backend().prepare(uring_op::accept, this);
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = fd_;
+  sqe->accept_flags = SOCK_CLOEXEC;
+  if (multishot_)
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  accept_pending_ = true;
+}
+
+void uring_acceptor::submit_poll() {
+  // wait for incoming connections on nonblocking sockets
+  auto sqe = backend().prepare(uring_op::poll, this);
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd_;
+  sqe->poll32_events = POLLIN;
+  accept_pending_ = true;
+}
+
+void uring_acceptor::drain_backlog() {
+  // keeps this acceptor alive until we return
+  manager_ptr guard = mgr_;
+  resume_pending_ = false;
+  while (accepting_ && !backlog_.empty()) {
+    auto fd = backlog_.front();
+    backlog_.pop_front();
+    if (!deliver(fd))
+      accepting_ = false;
+  }
+  if (accepting_) {
+    if (!accept_pending_)
+      submit_accept();
+  } else if (!accept_pending_) {
+    mgr_.reset();
+  }
+}
+
+bool uring_acceptor::deliver(native_socket fd) {
+  sock_ = fd;
+  return mgr_->new_connection();
+}
+
+} // namespace network
+} // namespace io
+} // namespace caf
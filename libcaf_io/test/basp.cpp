@@ -291,7 +291,8 @@ public:
           n.id, this_node(),
           invalid_actor_id, invalid_actor_id}, std::string{})
     .expect(hdl,
-            basp::message_type::server_handshake, no_flags,
+            basp::message_type::server_handshake,
+            basp::header::priority_lanes_flag,
             any_vals, basp::version, this_node(), node_id{none},
             published_actor_id, invalid_actor_id, std::string{},
             published_actor_id,
@@ -466,7 +467,8 @@ CAF_TEST(empty_server_handshake) {
   basp::header hdr;
   buffer payload;
   std::tie(hdr, payload) = from_buf(buf);
-  basp::header expected{basp::message_type::server_handshake, 0,
+  basp::header expected{basp::message_type::server_handshake,
+                        basp::header::priority_lanes_flag,
                         static_cast<uint32_t>(payload.size()),
                         basp::version,
                         this_node(), none,
@@ -484,7 +486,8 @@ CAF_TEST(non_empty_server_handshake) {
                                  {"caf::replies_to<@u16>::with<@u16>"});
   instance().write_server_handshake(mpx(), buf, uint16_t{4242});
   buffer expected_buf;
-  basp::header expected{basp::message_type::server_handshake, 0, 0,
+  basp::header expected{basp::message_type::server_handshake,
+                        basp::header::priority_lanes_flag, 0,
                         basp::version, this_node(), none,
                         self()->id(), invalid_actor_id};
   to_buf(expected_buf, expected, nullptr, std::string{},
@@ -598,7 +601,8 @@ CAF_TEST(remote_actor_and_send) {
        jupiter().dummy_actor->id(),
        uint32_t{0})
   .expect(jupiter().connection,
-          basp::message_type::client_handshake, no_flags, 1u,
+          basp::message_type::client_handshake,
+          basp::header::priority_lanes_flag, 1u,
           no_operation_data, this_node(), jupiter().id,
           invalid_actor_id, invalid_actor_id, std::string{})
   .expect(jupiter().connection,
@@ -701,6 +705,38 @@ CAF_TEST(actor_serialize_and_deserialize) {
           std::vector<actor_id>{}, msg);
 }
 
+CAF_TEST(priorities_for_legacy_peers) {
+  // the client handshake of Jupiter does not set `priority_lanes_flag`
+  connect_node(jupiter());
+  auto prx = proxies().get_or_put(jupiter().id, jupiter().dummy_actor->id());
+  mock()
+  .expect(jupiter().connection,
+          basp::message_type::announce_proxy, no_flags, no_payload,
+          no_operation_data, this_node(), prx->node(),
+          invalid_actor_id, prx->id());
+  auto dest = actor_cast<actor>(prx);
+  auto high = message_id::make(message_priority::high).integer_value();
+  auto send_and_expect = [&](uint64_t operation_data) {
+    mock()
+    .expect(jupiter().connection,
+            basp::message_type::dispatch_message, no_flags, any_vals,
+            operation_data, this_node(), prx->node(),
+            invalid_actor_id, prx->id(),
+            std::vector<actor_id>{},
+            make_message(42));
+  };
+  CAF_MESSAGE("system and urgent map to high");
+  anon_send<message_priority::system>(dest, 42);
+  send_and_expect(high);
+  anon_send<message_priority::urgent>(dest, 42);
+  send_and_expect(high);
+  anon_send<message_priority::high>(dest, 42);
+  send_and_expect(high);
+  CAF_MESSAGE("bulk maps to normal");
+  anon_send<message_priority::bulk>(dest, 42);
+  send_and_expect(no_operation_data);
+}
+
 CAF_TEST(indirect_connections) {
   // this node receives a message from jupiter via mars and responds via mars
   // and any ad-hoc automatic connection requests are ignored
@@ -831,7 +867,8 @@ CAF_TEST(automatic_connection) {
        jupiter().dummy_actor->id(),
        uint32_t{0})
   .expect(jupiter().connection,
-          basp::message_type::client_handshake, no_flags, 1u,
+          basp::message_type::client_handshake,
+          basp::header::priority_lanes_flag, 1u,
           no_operation_data, this_node(), jupiter().id,
           invalid_actor_id, invalid_actor_id, std::string{});
   CAF_CHECK_EQUAL(tbl().lookup_indirect(jupiter().id), none);
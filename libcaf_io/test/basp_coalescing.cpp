@@ -0,0 +1,125 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_basp_coalescing
+#include "caf/test/unit_test.hpp"
+
+#include <memory>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "basp_nodes.hpp"
+
+using namespace caf;
+
+using caf::test::local_host;
+
+namespace {
+
+constexpr int num_messages = 5000;
+
+class config : public test::basp_config {
+public:
+  config(size_t delay_us, size_t bytes, bool compact) {
+    middleman_coalescing_delay_us = delay_us;
+    middleman_coalescing_bytes = bytes;
+    middleman_enable_compact_header = compact;
+  }
+};
+
+// checks that all integers arrive in order and reports the number of
+// received messages to the sender of the last one
+behavior sink(event_based_actor* self) {
+  auto expected = std::make_shared<int>(0);
+  return {
+    [=](int x) {
+      CAF_CHECK_EQUAL(x, *expected);
+      if (++*expected == num_messages)
+        self->send(actor_cast<actor>(self->current_sender()), ok_atom::value,
+                   *expected);
+    }
+  };
+}
+
+struct fixture {
+  std::unique_ptr<config> server_side_config;
+  std::unique_ptr<actor_system> server_side;
+  std::unique_ptr<config> client_side_config;
+  std::unique_ptr<actor_system> client_side;
+
+  ~fixture() {
+    // shut down the client before the server
+    client_side.reset();
+    server_side.reset();
+  }
+
+  void init(size_t delay_us, size_t bytes, bool compact) {
+    server_side_config.reset(new config(delay_us, bytes, compact));
+    server_side.reset(new actor_system(*server_side_config));
+    client_side_config.reset(new config(delay_us, bytes, compact));
+    client_side.reset(new actor_system(*client_side_config));
+  }
+
+  // sends a burst of messages to a remote sink and awaits its confirmation
+  void run_burst() {
+    auto& server_side_mm = server_side->middleman();
+    auto& client_side_mm = client_side->middleman();
+    auto dest = server_side->spawn(sink);
+    CAF_EXP_THROW(port, server_side_mm.publish(dest, 0, local_host));
+    CAF_EXP_THROW(remote_dest, client_side_mm.remote_actor(local_host, port));
+    scoped_actor self{*client_side};
+    for (int i = 0; i < num_messages; ++i)
+      self->send(remote_dest, i);
+    self->receive(
+      [&](ok_atom, int received) {
+        CAF_CHECK_EQUAL(received, num_messages);
+      },
+      after(std::chrono::seconds(10)) >> [] {
+        CAF_FAIL("remote sink did not receive all messages");
+      }
+    );
+    anon_send_exit(dest, exit_reason::user_shutdown);
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(basp_coalescing_tests, fixture)
+
+CAF_TEST(regular_headers) {
+  init(1000, 16384, false);
+  run_burst();
+}
+
+CAF_TEST(compact_headers) {
+  init(1000, 16384, true);
+  run_burst();
+}
+
+CAF_TEST(byte_budget) {
+  // the delay exceeds the timeout of `run_burst`, i.e., this test only
+  // succeeds if filling the byte budget flushes the buffers
+  init(60 * 1000 * 1000, 1, false);
+  run_burst();
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
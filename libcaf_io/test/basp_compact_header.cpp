@@ -0,0 +1,194 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_basp_compact_header
+#include "caf/test/unit_test.hpp"
+
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+#include "caf/io/basp/all.hpp"
+
+#include "basp_nodes.hpp"
+
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+class config : public test::basp_config {
+public:
+  config(bool compact_header) {
+    middleman_enable_compact_header = compact_header;
+  }
+};
+
+// sends small requests to a remote actor, checks whether the client uses the
+// compact header format, and returns the number of bytes the client sent
+uint64_t exchange(bool server_compact, bool client_compact) {
+  test::basp_nodes<config> nodes{server_compact, client_compact};
+  auto dest = nodes.server_side.spawn([]() -> behavior {
+    return {
+      [](int32_t x) {
+        return x + 1;
+      }
+    };
+  });
+  auto remote_dest = nodes.connect(dest);
+  scoped_actor self{nodes.client_side};
+  for (int32_t i = 0; i < 100; ++i) {
+    self->request(remote_dest, infinite, i).receive(
+      [&](int32_t y) {
+        CAF_CHECK_EQUAL(y, i + 1);
+      },
+      [&](error& err) {
+        CAF_FAIL("request failed: " << nodes.client_side.render(err));
+      }
+    );
+  }
+  auto check = [&](basp::instance& instance,
+                   const std::vector<connection_handle>& hdls) {
+    CAF_CHECK_EQUAL(hdls.size(), 1u);
+    for (auto& hdl : hdls)
+      CAF_CHECK_EQUAL(instance.compact(hdl), server_compact && client_compact);
+  };
+  test::with_basp_instance(nodes.client_side, check);
+  anon_send_exit(dest, exit_reason::user_shutdown);
+  return test::sample(nodes.client_side, "caf_basp_bytes_sent_total");
+}
+
+struct fixture {
+  basp::compact_codec out;
+  basp::compact_codec in;
+  std::vector<char> buf;
+  node_id earth{42, "0102030405060708090A0B0C0D0E0F1011121314"};
+  node_id mars{43, "1112131415161718191A1B1C1D1E1F2021222324"};
+
+  basp::header dispatch(const node_id& src, const node_id& dest,
+                        uint32_t payload_len) {
+    return {basp::message_type::dispatch_message, 0, payload_len, 7,
+            src, dest, 10, 200};
+  }
+
+  // appends `hdr` and `payload_len` dummy bytes to `buf`
+  size_t append(const basp::header& hdr) {
+    char tmp[basp::compact_codec::max_header_size];
+    auto n = out.encode(tmp, hdr);
+    buf.insert(buf.end(), tmp, tmp + n);
+    buf.insert(buf.end(), hdr.payload_len, 'x');
+    return n;
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(compact_header_tests, fixture)
+
+CAF_TEST(round_trip) {
+  auto hdr = dispatch(earth, mars, 3);
+  auto n = append(hdr);
+  basp::header res;
+  CAF_CHECK_EQUAL(in.decode(res, buf.data(), buf.size()), n);
+  CAF_CHECK_EQUAL(res, hdr);
+}
+
+CAF_TEST(header_bytes) {
+  basp::header hdr{basp::message_type::dispatch_message, 1, 300, 7,
+                   none, none, 10, 200};
+  char tmp[basp::compact_codec::max_header_size];
+  std::vector<char> expected{static_cast<char>(hdr.operation), 1,
+                             static_cast<char>(0xAC), 0x02, 7, 0, 0,
+                             10, static_cast<char>(0xC8), 0x01};
+  CAF_REQUIRE_EQUAL(out.encode(tmp, hdr), expected.size());
+  CAF_CHECK_EQUAL(std::vector<char>(tmp, tmp + expected.size()), expected);
+  // padded headers use redundant continuation bytes for the payload length
+  expected.insert(expected.begin() + 3, static_cast<char>(0x82));
+  expected[4] = 0;
+  CAF_CHECK_EQUAL(out.padded_size(hdr), expected.size());
+  CAF_REQUIRE_EQUAL(out.encode_padded(tmp, hdr), expected.size());
+  CAF_CHECK_EQUAL(std::vector<char>(tmp, tmp + expected.size()), expected);
+  hdr.payload_len = 0;
+  CAF_CHECK_EQUAL(out.padded_size(hdr), expected.size());
+  CAF_CHECK_EQUAL(out.encode_padded(tmp, hdr), expected.size());
+  std::vector<char> buf{tmp, tmp + expected.size()};
+  basp::header res;
+  CAF_CHECK_EQUAL(in.decode(res, buf.data(), buf.size()), buf.size());
+  CAF_CHECK_EQUAL(res, hdr);
+}
+
+CAF_TEST(interned_node_ids) {
+  auto first = append(dispatch(earth, mars, 1));
+  auto second = append(dispatch(earth, mars, 1));
+  // both node IDs cost a single byte after their first occurrence
+  CAF_CHECK_EQUAL(first - second, 2 * node_id::serialized_size);
+  CAF_CHECK_LESS(second, basp::header_size / 4);
+  basp::header res;
+  auto pos = in.decode(res, buf.data(), buf.size()) + 1;
+  CAF_CHECK_EQUAL(res, dispatch(earth, mars, 1));
+  CAF_CHECK_EQUAL(in.decode(res, buf.data() + pos, buf.size() - pos), second);
+  CAF_CHECK_EQUAL(res, dispatch(earth, mars, 1));
+}
+
+CAF_TEST(incomplete_frames) {
+  auto hdr = dispatch(earth, mars, 300);
+  auto n = append(hdr);
+  auto frame_size = n + hdr.payload_len;
+  append(dispatch(mars, earth, 0));
+  basp::header res;
+  // no prefix of a frame decodes or interns any node ID
+  for (size_t i = 0; i < frame_size; ++i)
+    CAF_CHECK_EQUAL(in.decode(res, buf.data(), i), 0u);
+  CAF_CHECK_EQUAL(in.decode(res, buf.data(), buf.size()), n);
+  CAF_CHECK_EQUAL(res, hdr);
+  CAF_CHECK_EQUAL(in.decode(res, buf.data() + frame_size,
+                            buf.size() - frame_size),
+                  buf.size() - frame_size);
+  CAF_CHECK_EQUAL(res, dispatch(mars, earth, 0));
+}
+
+CAF_TEST(malformed_input) {
+  // references an empty table slot
+  std::vector<char> bogus{static_cast<char>(basp::message_type::heartbeat),
+                          0, 0, 0, 5, 6, 0, 0};
+  basp::header res;
+  CAF_CHECK_EQUAL(in.decode(res, bogus.data(), bogus.size()),
+                  basp::compact_codec::malformed);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST(disabled_by_default) {
+  actor_system_config cfg;
+  CAF_CHECK(!cfg.middleman_enable_compact_header);
+}
+
+CAF_TEST(opt_in) {
+  auto fixed_bytes = exchange(false, false);
+  auto compact_bytes = exchange(true, true);
+  CAF_MESSAGE("fixed: " << fixed_bytes << " bytes, compact: " << compact_bytes
+              << " bytes");
+  CAF_CHECK_LESS(compact_bytes, fixed_bytes / 2);
+  // both sides must enable the format
+  CAF_CHECK_GREATER(exchange(true, false), compact_bytes);
+  CAF_CHECK_GREATER(exchange(false, true), compact_bytes);
+}
@@ -0,0 +1,213 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_basp_compression
+#include "caf/test/unit_test.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "caf/io/basp/compression.hpp"
+
+#include "basp_nodes.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+using buffer = vector<char>;
+
+buffer round_trip(basp::compression_codec codec, const buffer& in) {
+  buffer compressed;
+  CAF_REQUIRE(basp::compress(codec, in.data(), in.size(), compressed));
+  buffer out;
+  CAF_REQUIRE(basp::decompress(codec, compressed.data(), compressed.size(),
+                               out));
+  return out;
+}
+
+size_t compressed_size(basp::compression_codec codec, const buffer& in) {
+  buffer compressed;
+  CAF_REQUIRE(basp::compress(codec, in.data(), in.size(), compressed));
+  return compressed.size();
+}
+
+class config : public test::basp_config {
+public:
+  config(atom_value compression) {
+    middleman_compression = compression;
+    middleman_compression_threshold = 64;
+  }
+};
+
+struct fixture {
+  // sends large strings to a remote echo actor, checks the responses, and
+  // returns the codec the client selected for its connection to the server
+  basp::compression_codec echo(atom_value server_compression,
+                               atom_value client_compression) {
+    test::basp_nodes<config> nodes{server_compression, client_compression};
+    auto dest = nodes.server_side.spawn([]() -> behavior {
+      return {
+        [](const string& x) {
+          return x;
+        }
+      };
+    });
+    auto remote_dest = nodes.connect(dest);
+    scoped_actor self{nodes.client_side};
+    for (size_t i = 0; i < 10; ++i) {
+      string msg;
+      for (size_t j = 0; j < 100 * (i + 1); ++j)
+        msg += "message #" + to_string(j) + ';';
+      self->request(remote_dest, infinite, msg).receive(
+        [&](const string& res) {
+          CAF_CHECK_EQUAL(res, msg);
+        },
+        [&](error& err) {
+          CAF_FAIL("request failed: " << nodes.client_side.render(err));
+        }
+      );
+    }
+    client_input = test::sample(nodes.client_side,
+                                "caf_basp_compression_input_bytes_total");
+    client_output = test::sample(nodes.client_side,
+                                 "caf_basp_compression_output_bytes_total");
+    server_input = test::sample(nodes.server_side,
+                                "caf_basp_compression_input_bytes_total");
+    auto result = basp::compression_codec::none;
+    auto get_codec = [&](basp::instance& instance,
+                         const vector<connection_handle>& hdls) {
+      CAF_CHECK_EQUAL(hdls.size(), 1u);
+      if (!hdls.empty())
+        result = instance.codec(hdls.front());
+    };
+    test::with_basp_instance(nodes.client_side, get_codec);
+    anon_send_exit(dest, exit_reason::user_shutdown);
+    return result;
+  }
+
+  uint64_t client_input = 0;
+  uint64_t client_output = 0;
+  uint64_t server_input = 0;
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(basp_compression_tests, fixture)
+
+CAF_TEST(codec_selection) {
+  using basp::compression_codec;
+  CAF_CHECK_EQUAL(basp::accepted_codecs(atom("none")), 0);
+  CAF_CHECK_EQUAL(basp::accepted_codecs(atom("lz")),
+                  basp::to_mask(compression_codec::lz));
+  CAF_CHECK_EQUAL(basp::accepted_codecs(atom("auto")),
+                  basp::available_codecs());
+  CAF_CHECK_EQUAL(basp::select_codec(0), compression_codec::none);
+  CAF_CHECK_EQUAL(basp::select_codec(0xFF), compression_codec::zstd);
+  CAF_CHECK_EQUAL(basp::select_codec(basp::to_mask(compression_codec::lz)
+                                     | basp::to_mask(compression_codec::lz4)),
+                  compression_codec::lz4);
+}
+
+CAF_TEST(lz_round_trips) {
+  using basp::compression_codec;
+  auto codec = compression_codec::lz;
+  CAF_CHECK_EQUAL(round_trip(codec, buffer{}), buffer{});
+  buffer short_input{'a', 'b'};
+  CAF_CHECK_EQUAL(round_trip(codec, short_input), short_input);
+  // long runs exercise overlapping back references
+  buffer runs(10000, 'x');
+  CAF_CHECK_EQUAL(round_trip(codec, runs), runs);
+  CAF_CHECK_LESS(compressed_size(codec, runs), runs.size() / 50);
+  buffer text;
+  for (int i = 0; i < 1000; ++i) {
+    auto str = "hello world " + to_string(i % 37) + ' ';
+    text.insert(text.end(), str.begin(), str.end());
+  }
+  CAF_CHECK_EQUAL(round_trip(codec, text), text);
+  CAF_CHECK_LESS(compressed_size(codec, text), text.size() / 2);
+  // random data only grows by the literal run markers
+  minstd_rand rng{42};
+  buffer noise(10000);
+  for (auto& x : noise)
+    x = static_cast<char>(rng());
+  CAF_CHECK_EQUAL(round_trip(codec, noise), noise);
+  CAF_CHECK_LESS_EQUAL(compressed_size(codec, noise),
+                          noise.size() + noise.size() / 32 + 5);
+}
+
+CAF_TEST(malformed_input) {
+  using basp::compression_codec;
+  auto codec = compression_codec::lz;
+  buffer text(1000, 'x');
+  buffer compressed;
+  CAF_REQUIRE(basp::compress(codec, text.data(), text.size(), compressed));
+  buffer out;
+  // truncated input
+  CAF_CHECK(!basp::decompress(codec, compressed.data(), 3, out));
+  out.clear();
+  CAF_CHECK(!basp::decompress(codec, compressed.data(), compressed.size() - 1,
+                              out));
+  // back reference before the start of the output
+  buffer invalid_ref{10, 0, 0, 0, static_cast<char>(0x20), 5};
+  out.clear();
+  CAF_CHECK(!basp::decompress(codec, invalid_ref.data(), invalid_ref.size(),
+                              out));
+  // output exceeding the announced size
+  compressed[0] = 10;
+  out.clear();
+  CAF_CHECK(!basp::decompress(codec, compressed.data(), compressed.size(),
+                              out));
+  // original size exceeding the maximum ratio, e.g., 4 GB in a few bytes
+  buffer bomb{-1, -1, -1, -1, 0, 'x'};
+  for (auto codec : {compression_codec::lz, compression_codec::lz4,
+                     compression_codec::zstd}) {
+    buffer bomb_out;
+    CAF_CHECK(!basp::decompress(codec, bomb.data(), bomb.size(), bomb_out));
+    CAF_CHECK_EQUAL(bomb_out.capacity(), 0u);
+  }
+  // unavailable codecs
+  CAF_CHECK(!basp::compress(compression_codec::none, text.data(), text.size(),
+                            compressed));
+}
+
+CAF_TEST(negotiated_compression) {
+  CAF_CHECK_EQUAL(echo(atom("auto"), atom("lz")),
+                  basp::compression_codec::lz);
+  CAF_CHECK_GREATER(client_input, 0u);
+  CAF_CHECK_GREATER(server_input, 0u);
+  CAF_CHECK_LESS(client_output, client_input / 2);
+}
+
+CAF_TEST(compression_disabled_on_one_side) {
+  CAF_CHECK_EQUAL(echo(atom("none"), atom("auto")),
+                  basp::compression_codec::none);
+  CAF_CHECK_EQUAL(client_input, 0u);
+  CAF_CHECK_EQUAL(server_input, 0u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
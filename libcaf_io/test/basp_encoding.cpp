@@ -0,0 +1,134 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_basp_encoding
+#include "caf/test/unit_test.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "caf/streambuf.hpp"
+#include "caf/stream_serializer.hpp"
+
+#include "basp_nodes.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+class config : public test::basp_config {
+public:
+  config(bool compact_encoding) {
+    add_message_type<vector<int64_t>>("vector<int64_t>");
+    middleman_enable_compact_encoding = compact_encoding;
+  }
+};
+
+// returns the number of bytes for `x` in the binary format
+template <class T>
+size_t serialized_size(binary_encoding encoding, T x) {
+  vector<char> buf;
+  stream_serializer<vectorbuf> sink{nullptr, buf};
+  sink.encoding(encoding);
+  sink(x);
+  return buf.size();
+}
+
+struct fixture {
+  // sends small requests to a remote actor, checks the responses and
+  // whether the client uses the compact encoding, and returns the number of
+  // bytes the client sent
+  uint64_t exchange(bool server_encoding, bool client_encoding) {
+    test::basp_nodes<config> nodes{server_encoding, client_encoding};
+    auto dest = nodes.server_side.spawn([]() -> behavior {
+      return {
+        [](atom_value x, int32_t y, const vector<int64_t>& zs) {
+          return make_message(x, -y, static_cast<int64_t>(zs.size()));
+        }
+      };
+    });
+    auto remote_dest = nodes.connect(dest);
+    scoped_actor self{nodes.client_side};
+    for (int32_t i = 0; i < 100; ++i) {
+      vector<int64_t> zs(static_cast<size_t>(i), int64_t{-1});
+      self->request(remote_dest, infinite, atom("get"), i, zs).receive(
+        [&](atom_value x, int32_t y, int64_t n) {
+          CAF_CHECK_EQUAL(x, atom("get"));
+          CAF_CHECK_EQUAL(y, -i);
+          CAF_CHECK_EQUAL(n, i);
+        },
+        [&](error& err) {
+          CAF_FAIL("request failed: " << nodes.client_side.render(err));
+        }
+      );
+    }
+    auto check = [&](basp::instance& instance,
+                     const vector<connection_handle>& hdls) {
+      CAF_CHECK_EQUAL(hdls.size(), 1u);
+      for (auto& hdl : hdls)
+        CAF_CHECK_EQUAL(instance.compact_encoding(hdl),
+                        server_encoding && client_encoding);
+    };
+    test::with_basp_instance(nodes.client_side, check);
+    anon_send_exit(dest, exit_reason::user_shutdown);
+    return test::sample(nodes.client_side, "caf_basp_bytes_sent_total");
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(basp_encoding_tests, fixture)
+
+CAF_TEST(varint_width) {
+  auto compact = binary_encoding::compact;
+  CAF_CHECK_EQUAL(serialized_size(binary_encoding::fixed, int32_t{-1}), 4u);
+  CAF_CHECK_EQUAL(serialized_size(compact, int32_t{-1}), 1u);
+  CAF_CHECK_EQUAL(serialized_size(compact, int32_t{-64}), 1u);
+  CAF_CHECK_EQUAL(serialized_size(compact, int32_t{64}), 2u);
+  CAF_CHECK_EQUAL(serialized_size(compact, int64_t{-1}), 1u);
+  CAF_CHECK_EQUAL(serialized_size(compact, uint64_t{127}), 1u);
+  CAF_CHECK_EQUAL(serialized_size(compact, uint64_t{128}), 2u);
+  CAF_CHECK_EQUAL(serialized_size(compact, numeric_limits<int64_t>::min()),
+                  10u);
+}
+
+CAF_TEST(negotiated_encoding) {
+  auto fixed_bytes = exchange(false, false);
+  auto compact_bytes = exchange(true, true);
+  CAF_MESSAGE("fixed: " << fixed_bytes << " bytes, compact: " << compact_bytes
+              << " bytes");
+  CAF_CHECK_LESS(compact_bytes, fixed_bytes / 2);
+}
+
+CAF_TEST(encoding_disabled_on_one_side) {
+  // allow small differences in the compact headers, e.g., for actor IDs
+  auto fixed_bytes = exchange(false, false);
+  CAF_CHECK_GREATER(exchange(true, false), fixed_bytes - fixed_bytes / 100);
+  CAF_CHECK_GREATER(exchange(false, true), fixed_bytes - fixed_bytes / 100);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,104 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#ifndef CAF_IO_TEST_BASP_NODES_HPP
+#define CAF_IO_TEST_BASP_NODES_HPP
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "caf/test/unit_test.hpp"
+
+// Shared helpers for test suites connecting actor systems via BASP.
+
+namespace caf {
+namespace test {
+
+constexpr char local_host[] = "127.0.0.1";
+
+/// Loads the middleman and parses the arguments of the test runner. Suites
+/// set their middleman options in the constructor of a derived class.
+class basp_config : public actor_system_config {
+public:
+  basp_config() {
+    load<io::middleman>();
+    parse(engine::argc(), engine::argv());
+  }
+};
+
+/// Returns the value of the first sample of `name` in `sys`.
+inline uint64_t sample(actor_system& sys, const std::string& name) {
+  auto str = sys.metrics().render();
+  auto i = str.find('\n' + name + '{');
+  if (i == std::string::npos)
+    return 0;
+  auto eol = str.find('\n', i + 1);
+  auto j = str.rfind(' ', eol);
+  return std::stoull(str.substr(j + 1, eol - j - 1));
+}
+
+/// Runs `f` with the BASP instance and all connections of the BASP broker
+/// in the first I/O loop of `sys` inside its event loop and waits for it.
+template <class F>
+void with_basp_instance(actor_system& sys, F f) {
+  auto hdl = sys.middleman().basp_brokers().front();
+  auto bb = static_cast<io::basp_broker*>(actor_cast<abstract_actor*>(hdl));
+  std::promise<void> done;
+  bb->backend().dispatch([&] {
+    f(bb->state.instance, bb->connections());
+    done.set_value();
+  });
+  done.get_future().wait();
+}
+
+/// A server and a client node with individual configurations.
+template <class Config>
+struct basp_nodes {
+  Config server_side_config;
+  actor_system server_side;
+  Config client_side_config;
+  actor_system client_side;
+
+  template <class ServerArg, class ClientArg>
+  basp_nodes(ServerArg server_arg, ClientArg client_arg)
+      : server_side_config(server_arg),
+        server_side(server_side_config),
+        client_side_config(client_arg),
+        client_side(client_side_config) {
+    // nop
+  }
+
+  /// Publishes `dest` at the server and returns a proxy at the client.
+  actor connect(const actor& dest) {
+    auto port = server_side.middleman().publish(dest, 0, local_host);
+    CAF_REQUIRE(port);
+    auto proxy = client_side.middleman().remote_actor(local_host, *port);
+    CAF_REQUIRE(proxy);
+    return *proxy;
+  }
+};
+
+} // namespace test
+} // namespace caf
+
+#endif // CAF_IO_TEST_BASP_NODES_HPP
@@ -0,0 +1,129 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_gather_write
+#include "caf/test/unit_test.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+using namespace std;
+using namespace caf;
+using namespace caf::io;
+
+namespace {
+
+using publish_atom = caf::atom_constant<caf::atom("publish")>;
+
+constexpr size_t small_writes = 100;
+constexpr size_t small_size = 10;
+constexpr size_t large_size = 4 * 1024 * 1024;
+constexpr size_t total_size = 2 * small_writes * small_size + large_size;
+
+// computes the expected value of the byte at position `pos`
+char byte_at(size_t pos) {
+  return static_cast<char>(pos % 251);
+}
+
+// writes many small buffers with one flush each around a single large
+// buffer, forcing the stream to queue buffers while the socket is busy
+void sender(broker* self, connection_handle hdl) {
+  size_t pos = 0;
+  auto write = [&](size_t n) {
+    auto& buf = self->wr_buf(hdl);
+    for (size_t i = 0; i < n; ++i)
+      buf.push_back(byte_at(pos++));
+    self->flush(hdl);
+  };
+  for (size_t i = 0; i < small_writes; ++i)
+    write(small_size);
+  write(large_size);
+  for (size_t i = 0; i < small_writes; ++i)
+    write(small_size);
+  // wait for the receiver to close the connection before quitting
+  self->configure_read(hdl, receive_policy::at_most(1));
+  self->become(
+    [=](const connection_closed_msg&) {
+      self->quit();
+    }
+  );
+}
+
+void receiver(broker* self, connection_handle hdl, actor listener) {
+  auto received = make_shared<vector<char>>();
+  self->configure_read(hdl, receive_policy::at_most(65536));
+  self->become(
+    [=](const new_data_msg& msg) {
+      received->insert(received->end(), msg.buf.begin(), msg.buf.end());
+      if (received->size() < total_size)
+        return;
+      size_t errors = 0;
+      for (size_t i = 0; i < received->size(); ++i)
+        if ((*received)[i] != byte_at(i))
+          ++errors;
+      self->send(listener, received->size(), errors);
+      self->quit();
+    }
+  );
+}
+
+behavior acceptor(broker* self, actor listener) {
+  return {
+    [=](const new_connection_msg& msg) {
+      self->fork(receiver, msg.handle, listener);
+      self->quit();
+    },
+    [=](publish_atom) -> expected<uint16_t> {
+      auto res = self->add_tcp_doorman(0, "127.0.0.1");
+      if (!res)
+        return std::move(res.error());
+      return res->second;
+    }
+  };
+}
+
+} // namespace <anonymous>
+
+CAF_TEST(queued_buffers_arrive_in_order) {
+  actor_system_config cfg;
+  actor_system system{cfg.load<io::middleman>()};
+  scoped_actor self{system};
+  auto serv = system.middleman().spawn_broker(acceptor, actor{self});
+  self->request(serv, infinite, publish_atom::value).receive(
+    [&](uint16_t port) {
+      auto cl = system.middleman().spawn_client(sender, "127.0.0.1", port);
+      CAF_REQUIRE(cl);
+    },
+    [&](const error& err) {
+      CAF_FAIL("unable to publish acceptor: " << system.render(err));
+    }
+  );
+  self->receive(
+    [&](size_t received, size_t errors) {
+      CAF_CHECK_EQUAL(received, total_size);
+      CAF_CHECK_EQUAL(errors, 0u);
+    }
+  );
+}
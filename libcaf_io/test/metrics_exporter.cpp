@@ -0,0 +1,122 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_metrics_exporter
+#include "caf/test/unit_test.hpp"
+
+#include <memory>
+#include <string>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "caf/io/metrics_exporter.hpp"
+
+using namespace std;
+using namespace caf;
+
+namespace {
+
+class config : public actor_system_config {
+public:
+  config() {
+    load<io::middleman>();
+    parse(test::engine::argc(), test::engine::argv());
+  }
+};
+
+// Sends `request` and forwards the full response to `listener` once the
+// server closes the connection.
+behavior http_client(io::broker* self, io::connection_handle hdl,
+                     string request, actor listener) {
+  auto response = make_shared<string>();
+  self->configure_read(hdl, io::receive_policy::at_most(4096));
+  self->write(hdl, request.size(), request.data());
+  self->flush(hdl);
+  return {
+    [=](const io::new_data_msg& msg) {
+      response->insert(response->end(), msg.buf.begin(), msg.buf.end());
+    },
+    [=](const io::connection_closed_msg&) {
+      self->send(listener, *response);
+      self->quit();
+    }
+  };
+}
+
+bool contains(const string& str, const string& what) {
+  return str.find(what) != string::npos;
+}
+
+struct fixture {
+  config cfg;
+  actor_system system{cfg};
+  uint16_t port = 0;
+  actor exporter{unsafe_actor_handle_init};
+
+  fixture() {
+    auto res = system.middleman().spawn_server(io::metrics_exporter, port);
+    CAF_REQUIRE(res);
+    CAF_REQUIRE(port != 0);
+    CAF_MESSAGE("metrics exporter listens at port " << port);
+    exporter = std::move(*res);
+  }
+
+  ~fixture() {
+    anon_send_exit(exporter, exit_reason::user_shutdown);
+  }
+
+  string query(string request) {
+    scoped_actor self{system};
+    auto client = system.middleman().spawn_client(http_client, "localhost",
+                                                  port, move(request),
+                                                  actor{self});
+    CAF_REQUIRE(client);
+    string result;
+    self->receive(
+      [&](const string& response) {
+        result = response;
+      }
+    );
+    return result;
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(metrics_exporter_tests, fixture)
+
+CAF_TEST(scrape) {
+  auto res = query("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+  CAF_CHECK(res.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+  CAF_CHECK(contains(res, "Content-Type: text/plain; version=0.0.4"));
+  CAF_CHECK(contains(res, "# TYPE caf_running_actors gauge\n"));
+  CAF_CHECK(contains(res, "caf_scheduler_jobs_resumed_total"));
+  CAF_CHECK(contains(res, "caf_multiplexer_events_total{type=\"read\"}"));
+  CAF_CHECK(contains(res, "caf_multiplexer_wakeups_total"));
+}
+
+CAF_TEST(bad_request) {
+  auto res = query("POST /metrics HTTP/1.1\r\n\r\n");
+  CAF_CHECK(res.compare(0, 24, "HTTP/1.1 400 Bad Request") == 0);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
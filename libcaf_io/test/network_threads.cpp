@@ -0,0 +1,168 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_network_threads
+#include "caf/test/unit_test.hpp"
+
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "basp_nodes.hpp"
+
+using namespace caf;
+
+using caf::test::local_host;
+
+namespace {
+
+constexpr size_t num_threads = 3;
+
+class config : public test::basp_config {
+public:
+  config() {
+    middleman_network_threads = num_threads;
+  }
+};
+
+struct fixture {
+  config server_side_config;
+  actor_system server_side{server_side_config};
+  config client_side_config;
+  actor_system client_side{client_side_config};
+  io::middleman& server_side_mm = server_side.middleman();
+  io::middleman& client_side_mm = client_side.middleman();
+
+  // sends `x` to `whom` and checks the response
+  void ping(const actor& whom, int x) {
+    scoped_actor self{client_side};
+    self->request(whom, infinite, x).receive(
+      [&](int y) {
+        CAF_CHECK_EQUAL(y, x + 1);
+      },
+      [&](error& err) {
+        CAF_FAIL("request failed: " << client_side.render(err));
+      }
+    );
+  }
+};
+
+behavior make_pong_behavior() {
+  return {
+    [](int x) {
+      return x + 1;
+    }
+  };
+}
+
+} // namespace <anonymous>
+
+CAF_TEST_FIXTURE_SCOPE(network_threads_tests, fixture)
+
+CAF_TEST(one_basp_broker_per_loop) {
+  CAF_CHECK_EQUAL(server_side_mm.backends().size(), num_threads);
+  CAF_CHECK_EQUAL(server_side_mm.basp_brokers().size(), num_threads);
+  CAF_CHECK_EQUAL(&server_side_mm.next_backend(),
+                  server_side_mm.backends()[0]);
+  CAF_CHECK_EQUAL(&server_side_mm.next_backend(),
+                  server_side_mm.backends()[1]);
+}
+
+CAF_TEST(connections_across_loops) {
+  // publishing the same actor on several ports makes the client connect
+  // once per port, each time using the BASP broker of another I/O loop
+  auto pong = server_side.spawn(make_pong_behavior);
+  std::vector<actor> handles;
+  for (size_t i = 0; i < num_threads; ++i) {
+    CAF_EXP_THROW(port, server_side_mm.publish(pong, 0, local_host));
+    CAF_EXP_THROW(x, client_side_mm.remote_actor(local_host, port));
+    handles.push_back(x);
+  }
+  for (size_t i = 0; i < handles.size(); ++i)
+    ping(handles[i], static_cast<int>(i));
+  CAF_CHECK(!client_side_mm.nodes().lookup(server_side.node()).unsafe());
+  CAF_CHECK(!server_side_mm.nodes().lookup(client_side.node()).unsafe());
+  anon_send_exit(pong, exit_reason::user_shutdown);
+}
+
+CAF_TEST(remote_lookup_via_owning_loop) {
+  auto pong = server_side.spawn(make_pong_behavior);
+  server_side.registry().put(atom("pong"), actor_cast<strong_actor_ptr>(pong));
+  CAF_EXP_THROW(port, server_side_mm.publish(pong, 0, local_host));
+  // occupy the first loop of the client with a connection to itself
+  CAF_EXP_THROW(self_port, client_side_mm.publish(pong, 0, local_host));
+  CAF_EXP_THROW(local, client_side_mm.remote_actor(local_host, self_port));
+  CAF_CHECK_EQUAL(local, pong);
+  CAF_EXP_THROW(remote, client_side_mm.remote_actor(local_host, port));
+  static_cast<void>(remote);
+  auto ptr = client_side_mm.remote_lookup(atom("pong"), server_side.node());
+  CAF_REQUIRE(ptr != nullptr);
+  ping(actor_cast<actor>(ptr), 41);
+  server_side.registry().erase(atom("pong"));
+  anon_send_exit(pong, exit_reason::user_shutdown);
+}
+
+CAF_TEST(forwarding_across_loops) {
+  // the server talks to the pong node and to the client in different
+  // I/O loops, hence relaying messages between client and pong node
+  // requires handing them over to the BASP broker of the other loop
+  config pong_side_config;
+  actor_system pong_side{pong_side_config};
+  auto pong = pong_side.spawn(make_pong_behavior);
+  CAF_EXP_THROW(pong_port, pong_side.middleman().publish(pong, 0, local_host));
+  // occupy the first loop of the server with a connection to itself, since
+  // published actors accept connections in the first loop
+  auto dummy = server_side.spawn(make_pong_behavior);
+  CAF_EXP_THROW(self_port, server_side_mm.publish(dummy, 0, local_host));
+  CAF_EXP_THROW(local, server_side_mm.remote_actor(local_host, self_port));
+  CAF_CHECK_EQUAL(local, dummy);
+  CAF_EXP_THROW(pong_proxy, server_side_mm.remote_actor(local_host,
+                                                        pong_port));
+  auto relay = server_side.spawn([=]() -> behavior {
+    return {
+      [=](get_atom) {
+        return pong_proxy;
+      }
+    };
+  });
+  CAF_EXP_THROW(relay_port, server_side_mm.publish(relay, 0, local_host));
+  CAF_EXP_THROW(relay_proxy, client_side_mm.remote_actor(local_host,
+                                                         relay_port));
+  actor hdl{unsafe_actor_handle_init};
+  scoped_actor self{client_side};
+  self->request(relay_proxy, infinite, get_atom::value).receive(
+    [&](const actor& x) {
+      hdl = x;
+    },
+    [&](error& err) {
+      CAF_FAIL("request failed: " << client_side.render(err));
+    }
+  );
+  CAF_REQUIRE_EQUAL(hdl.node(), pong_side.node());
+  CAF_CHECK(client_side_mm.nodes().lookup(pong_side.node()).unsafe());
+  ping(hdl, 7);
+  anon_send_exit(dummy, exit_reason::user_shutdown);
+  anon_send_exit(relay, exit_reason::user_shutdown);
+  anon_send_exit(pong, exit_reason::user_shutdown);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,106 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright (C) 2011 - 2016                                                  *
+ * Dominik Charousset <dominik.charousset (at) haw-hamburg.de>                *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/config.hpp"
+
+#define CAF_SUITE io_remote_group_multicast
+#include "caf/test/unit_test.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "caf/all.hpp"
+#include "caf/io/all.hpp"
+
+#include "basp_nodes.hpp"
+
+using namespace caf;
+
+using caf::test::local_host;
+
+namespace {
+
+constexpr int num_clients = 3;
+
+constexpr int num_messages = 100;
+
+using ready_atom = atom_constant<atom("ready")>;
+
+class config : public test::basp_config {
+public:
+  config(bool compact_encoding) {
+    middleman_enable_compact_encoding = compact_encoding;
+  }
+};
+
+struct client {
+  config cfg;
+  actor_system sys;
+  scoped_actor self;
+
+  client(bool compact_encoding)
+      : cfg(compact_encoding),
+        sys(cfg),
+        self(sys) {
+    // nop
+  }
+};
+
+} // namespace <anonymous>
+
+CAF_TEST(multicast_to_remote_subscribers) {
+  config server_cfg{true};
+  actor_system server{server_cfg};
+  auto grp = server.groups().get_local("feed");
+  scoped_actor publisher{server};
+  publisher->join(grp);
+  CAF_EXP_THROW(port, server.middleman().publish_local_groups(0, local_host));
+  // mix clients with and without the compact payload encoding
+  std::vector<std::unique_ptr<client>> clients;
+  for (int i = 0; i < num_clients; ++i) {
+    clients.emplace_back(new client(i % 2 == 0));
+    auto& c = *clients.back();
+    CAF_EXP_THROW(remote_grp,
+                  c.sys.middleman().remote_group("feed", local_host, port));
+    c.self->join(remote_grp);
+    // the join request precedes this message on the same route, hence the
+    // server has a remote subscriber for this client once it arrives
+    c.self->send(remote_grp, ready_atom::value, i);
+  }
+  int ready = 0;
+  publisher->receive_while([&] { return ready < num_clients; }) (
+    [&](ready_atom, int) {
+      ++ready;
+    }
+  );
+  for (int i = 0; i < num_messages; ++i)
+    publisher->send(grp, i);
+  for (auto& c : clients) {
+    int next = 0;
+    c->self->receive_while([&] { return next < num_messages; }) (
+      [&](ready_atom, int) {
+        // nop
+      },
+      [&](int x) {
+        CAF_CHECK_EQUAL(x, next);
+        ++next;
+      }
+    );
+  }
+}